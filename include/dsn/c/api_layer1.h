@@ -632,6 +632,22 @@ extern DSN_API void         dsn_msg_get_options(
                                 /*out*/ dsn_msg_options_t* opts
                                 );
 
+/*!
+ get the full 64-bit hash given in \ref dsn_msg_create_request, which the options
+ above only expose as the (truncated) thread hash
+
+ \param msg  the message handle
+ */
+extern DSN_API uint64_t     dsn_msg_get_partition_hash(dsn_message_t msg);
+
+/*!
+ whether the partition hash above is the hash of the request key, which is false
+ for the requests of the older clients, as they send the hash of the partition id
+
+ \param msg  the message handle
+ */
+extern DSN_API bool         dsn_msg_has_key_hash(dsn_message_t msg);
+
 /*! rpc message header type */
 typedef enum dsn_msg_header_type {
     DHT_INVALID = 0,
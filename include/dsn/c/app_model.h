@@ -340,6 +340,11 @@ typedef dsn_error_t(*dsn_app_apply_checkpoint)(
     const dsn_app_learn_state* ///< learn state
     );
 
+typedef void(*dsn_app_set_partition_count)(
+    void*,    ///< context from dsn_app_create
+    int       ///< the app serves the key hashes h with h % count == its partition index, 0 for all
+    );
+
 # define DSN_APP_MASK_APP        0x01 ///< app mask
 # define DSN_APP_MASK_FRAMEWORK  0x02 ///< framework mask
 
@@ -363,6 +368,7 @@ typedef union dsn_app_callbacks
         dsn_app_prepare_get_checkpoint      prepare_get_checkpoint;
         dsn_app_get_checkpoint              get_checkpoint;
         dsn_app_apply_checkpoint            apply_checkpoint;
+        dsn_app_set_partition_count         set_partition_count; ///< optional, may be null
     } calls;    
 } dsn_app_callbacks;
 
@@ -480,6 +480,7 @@ namespace dsn
     DEFINE_ERR_CODE(ERR_BUSY_CREATING)
     DEFINE_ERR_CODE(ERR_BUSY_DROPPING)
     DEFINE_ERR_CODE(ERR_NETWORK_FAILURE)
+    DEFINE_ERR_CODE(ERR_PARENT_PARTITION_MISUSED)
 /*@}*/
 } // end namespace
 
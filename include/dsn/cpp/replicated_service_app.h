@@ -192,6 +192,14 @@ namespace dsn
             const dsn_app_learn_state& state
             ) = 0;
 
+        //
+        // the app serves only the key hashes h with h % partition_count == its partition
+        // index from now on, 0 when it serves all (the app is never split, or it is a split
+        // child not ready yet); called after start and whenever a split changes the count,
+        // so that the app can drop the pairs left to the other half
+        //
+        virtual void set_partition_count(int partition_count) { }
+
     public:
         static void app_on_batched_write_requests(void* app, int64_t decree, dsn_message_t* requests, int count)
         {
@@ -248,6 +256,11 @@ namespace dsn
         {
             return reinterpret_cast<replicated_service_app_type_1*>(app)->apply_checkpoint(mode, local_commit, *state);
         }
+
+        static void app_set_partition_count(void* app, int partition_count)
+        {
+            reinterpret_cast<replicated_service_app_type_1*>(app)->set_partition_count(partition_count);
+        }
     };
 
     /*! C++ wrapper of the \ref dsn_register_app function for layer 1 */
@@ -269,6 +282,7 @@ namespace dsn
         app.layer2.apps.calls.prepare_get_checkpoint = replicated_service_app_type_1::app_prepare_get_checkpoint;
         app.layer2.apps.calls.get_checkpoint = replicated_service_app_type_1::app_get_checkpoint;
         app.layer2.apps.calls.apply_checkpoint = replicated_service_app_type_1::app_apply_checkpoint;
+        app.layer2.apps.calls.set_partition_count = replicated_service_app_type_1::app_set_partition_count;
 
         if (std::is_same<decltype(&TServiceApp::on_batched_write_requests),
                          decltype(&replicated_service_app_type_1::on_batched_write_requests)>())
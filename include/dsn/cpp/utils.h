@@ -38,6 +38,7 @@
 # include <dsn/cpp/auto_codes.h>
 # include <dsn/internal/callocator.h>
 # include <functional>
+# include <cstdio>
 
 #ifdef DSN_USE_THRIFT_SERIALIZATION
 # include <thrift/protocol/TProtocol.h>
@@ -491,6 +492,12 @@ namespace dsn {
 
             extern bool last_write_time(std::string& path, time_t& tm);
 
+            // flush the data written into the file to the disk
+            extern bool sync_file(FILE* fp);
+
+            // flush the entries of the directory, e.g., after a file is renamed into it
+            extern bool sync_directory(const std::string& path);
+
             extern error_code get_process_image_path(int pid, std::string& path);
 
             inline error_code get_current_process_image_path(std::string& path)
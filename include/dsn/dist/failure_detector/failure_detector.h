@@ -53,6 +53,17 @@
  *
  * 4. The lease_periods must be less than the grace_periods, as required by prefect FD.
  *
+ * 5. With a phi threshold (see set_phi_threshold), the master declares a worker dead once the
+ *    suspicion level phi, computed from the recent inter-arrival times of its beacons, exceeds
+ *    the threshold and the worker has surely stopped serving, i.e., "lease" + "check_interval"
+ *    + max("check_interval", safety margin) after the last beacon; "grace" is still the upper
+ *    bound. The margin stands for what "grace" - "lease" covers otherwise: the worker's own check
+ *    tick, the asynchronous work after it finds its lease expired, and the clock rate drift. A
+ *    worker with regular beacons is thus declared dead soon after that, while a jittery one gets
+ *    up to "grace". All the four intervals may be sub-second (see start_ms), yet the earliest
+ *    detection is bounded by the margin, e.g., a 500 ms lease and a 100 ms check interval with
+ *    the default 2000 ms margin declare a worker dead about 2.6 seconds after its last beacon.
+ *
  */
 # pragma once
 
@@ -65,6 +76,32 @@ DEFINE_THREAD_POOL_CODE(THREAD_POOL_FD)
 DEFINE_TASK_CODE(LPC_BEACON_CHECK, TASK_PRIORITY_HIGH, THREAD_POOL_FD)
 DEFINE_TASK_CODE(LPC_BEACON_SEND, TASK_PRIORITY_HIGH, THREAD_POOL_FD)
 
+// sliding window of the inter-arrival times of the beacons from one worker,
+// phi = -log10(P(the next beacon arrives later than elapsed_ms)), assuming the
+// intervals are normally distributed
+class phi_accrual_window
+{
+public:
+    enum { max_samples = 100, min_samples = 8 };
+
+    phi_accrual_window() : _count(0), _next(0), _sum(0), _sum_squares(0) {}
+
+    void add(uint32_t interval_ms);
+    void clear() { _count = 0; _next = 0; _sum = 0; _sum_squares = 0; }
+    int  count() const { return _count; }
+
+    // the standard deviation is at least min_std_ms so that perfectly regular
+    // beacons do not make phi jump on a few milliseconds of delay
+    double phi(uint64_t elapsed_ms, double min_std_ms) const;
+
+private:
+    uint32_t _samples[max_samples];
+    int      _count;
+    int      _next;
+    uint64_t _sum;
+    uint64_t _sum_squares;
+};
+
 class failure_detector_callback
 {
 public:
@@ -101,8 +138,23 @@ public:
         bool use_allow_list = false
         );
 
+    error_code start_ms(
+        uint32_t check_interval_milliseconds,
+        uint32_t beacon_interval_milliseconds,
+        uint32_t lease_milliseconds,
+        uint32_t grace_milliseconds,
+        bool use_allow_list = false
+        );
+
     error_code stop();
 
+    // 0 disables the phi accrual suspicion, must be set before start
+    void set_phi_threshold(double threshold, uint32_t safety_margin_milliseconds = 2000)
+    {
+        _phi_threshold = threshold;
+        _phi_safety_margin_milliseconds = safety_margin_milliseconds;
+    }
+
     uint32_t get_lease_ms() const { return _lease_milliseconds; }
     uint32_t get_grace_ms() const { return _grace_milliseconds; }
 
@@ -143,9 +195,23 @@ protected:
 
     void report(::dsn::rpc_address node, bool is_master, bool is_connected);
 
+    // whether a worker without beacons for elapsed_ms is declared dead
+    bool is_worker_expired(uint64_t elapsed_ms, const phi_accrual_window& intervals) const;
+
+    // set the intervals used by check_all_records and the beacons, without starting the service
+    void set_intervals_ms(
+        uint32_t check_interval_milliseconds,
+        uint32_t beacon_interval_milliseconds,
+        uint32_t lease_milliseconds,
+        uint32_t grace_milliseconds
+        );
+
 private:
     void check_all_records();
 
+    // the only beacon timer, which sends to all the masters due
+    void send_beacons();
+
 private:
     class master_record
     {
@@ -154,7 +220,8 @@ private:
         uint64_t        last_send_time_for_beacon_with_ack;
         bool            is_alive;
         bool            rejected;
-        task_ptr        send_beacon_timer;
+        uint64_t        next_beacon_time;       // when the next beacon is due
+        uint64_t        beacon_in_flight_time;  // send time of the beacon waiting for its ack, 0 for none
 
         // masters are always considered *disconnected* initially which is ok even when master thinks workers are connected
         master_record(::dsn::rpc_address n, uint64_t last_send_time_for_beacon_with_ack_)
@@ -163,6 +230,8 @@ private:
             last_send_time_for_beacon_with_ack = last_send_time_for_beacon_with_ack_;
             is_alive = false;
             rejected = false;
+            next_beacon_time = last_send_time_for_beacon_with_ack_;
+            beacon_in_flight_time = 0;
         }
     };
 
@@ -172,6 +241,7 @@ private:
         ::dsn::rpc_address       node;
         uint64_t        last_beacon_recv_time;
         bool            is_alive;
+        phi_accrual_window intervals;
 
         // workers are always considered *connected* initially which is ok even when workers think master is disconnected
         worker_record(::dsn::rpc_address node, uint64_t last_beacon_recv_time)
@@ -186,6 +256,8 @@ private:
     typedef std::unordered_map< ::dsn::rpc_address, master_record>    master_map;
     typedef std::unordered_map< ::dsn::rpc_address, worker_record>    worker_map;
 
+    bool is_worker_expired(const worker_record& record, uint64_t now) const;
+
     // allow list are set on machine name (port can vary)
     typedef std::unordered_set< ::dsn::rpc_address>   allow_list;
 
@@ -198,6 +270,9 @@ private:
     uint32_t             _grace_milliseconds;
     bool                 _is_started;
     ::dsn::task_ptr      _check_task;
+    ::dsn::task_ptr      _send_beacon_task;
+    double               _phi_threshold;
+    uint32_t             _phi_safety_margin_milliseconds;
 
     bool                 _use_allow_list;
     allow_list           _allow_list;
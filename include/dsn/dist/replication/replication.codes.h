@@ -78,6 +78,8 @@ MAKE_EVENT_CODE_RPC(RPC_CM_LIST_NODES, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_RPC(RPC_CM_CLUSTER_INFO, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_RPC(RPC_CM_CONTROL_META, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_RPC(RPC_CM_PROPOSE_BALANCER, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_CM_SPLIT_APP, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_CM_NOTIFY_SPLIT_READY, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE(LPC_META_CALLBACK, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE(LPC_QUERY_PN_DECREE, TASK_PRIORITY_COMMON)
 #undef CURRENT_THREAD_POOL
@@ -93,6 +95,9 @@ MAKE_EVENT_CODE(RPC_REPLICATION_WRITE_EMPTY, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE(LPC_PER_REPLICA_CHECKPOINT_TIMER, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE(LPC_MUTATION_PENDING_TIMER, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE(LPC_GROUP_CHECK, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_GROUP_CHECK_BATCH_FLUSH, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_GROUP_CHECK_BATCH_DISPATCH, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_GROUP_CHECK_BATCH_REPLY, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE(LPC_CM_DISCONNECTED_SCATTER, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE(LPC_QUERY_NODE_CONFIGURATION_SCATTER, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE(LPC_DELAY_LEARN, TASK_PRIORITY_HIGH)
@@ -104,16 +109,27 @@ MAKE_EVENT_CODE_AIO(LPC_REPLICATION_ERROR, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_AIO(LPC_LERARN_REMOTE_DISK_STATE, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE(LPC_QUERY_CONFIGURATION_ALL, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_CONFIG_PROPOSAL, TASK_PRIORITY_HIGH)
+MAKE_EVENT_CODE_RPC(RPC_CONFIG_CHANGE_NOTIFY, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_QUERY_PN_DECREE, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_QUERY_REPLICA_INFO, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_PREPARE, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_GROUP_CHECK, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_GROUP_CHECK_BATCH, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_RPC(RPC_LEARN, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_LEARN_COMPLETION_NOTIFY, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_LEARN_ADD_LEARNER, TASK_PRIORITY_HIGH)
 MAKE_EVENT_CODE_RPC(RPC_REMOVE_REPLICA, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_RPC(RPC_REPLICA_COPY_LAST_CHECKPOINT, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_AIO(LPC_REPLICA_COPY_LAST_CHECKPOINT_DONE, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_BULK_LOAD, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_BULK_LOAD_STAGE, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_AIO(LPC_BULK_LOAD_STAGE_DONE, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_SPLIT_PARTITION, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_RPC(RPC_SPLIT_FORWARD, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_SPLIT_PARTITION_TIMER, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_PRIMARY_HANDOFF_TIMER, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE_AIO(LPC_LEARN_LOG_FILE_COPIED, TASK_PRIORITY_COMMON)
+MAKE_EVENT_CODE(LPC_LEARN_LOG_FILE_REPLAYED, TASK_PRIORITY_COMMON)
 MAKE_EVENT_CODE_AIO(LPC_WRITE_REPLICATION_LOG_SHARED, TASK_PRIORITY_HIGH)
 #undef CURRENT_THREAD_POOL
 
@@ -21,12 +21,16 @@ namespace dsn { namespace replication {
     GENERATED_TYPE_SERIALIZATION(learn_response, THRIFT)
     GENERATED_TYPE_SERIALIZATION(group_check_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(group_check_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(group_check_batch_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(group_check_batch_response, THRIFT)
     GENERATED_TYPE_SERIALIZATION(node_info, THRIFT)
     GENERATED_TYPE_SERIALIZATION(meta_response_header, THRIFT)
     GENERATED_TYPE_SERIALIZATION(configuration_update_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(configuration_update_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(replica_load, THRIFT)
     GENERATED_TYPE_SERIALIZATION(configuration_query_by_node_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(configuration_query_by_node_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(config_change_notification, THRIFT)
     GENERATED_TYPE_SERIALIZATION(create_app_options, THRIFT)
     GENERATED_TYPE_SERIALIZATION(configuration_create_app_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(drop_app_options, THRIFT)
@@ -50,5 +54,14 @@ namespace dsn { namespace replication {
     GENERATED_TYPE_SERIALIZATION(query_replica_info_request, THRIFT)
     GENERATED_TYPE_SERIALIZATION(query_replica_info_response, THRIFT)
     GENERATED_TYPE_SERIALIZATION(node_state, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(bulk_load_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(bulk_load_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(split_partition_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(split_forward_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(split_forward_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(notify_split_ready_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(notify_split_ready_response, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(configuration_split_app_request, THRIFT)
+    GENERATED_TYPE_SERIALIZATION(configuration_split_app_response, THRIFT)
 
 } } 
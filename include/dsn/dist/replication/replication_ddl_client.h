@@ -62,6 +62,15 @@ public:
     dsn::error_code control_meta_balancer_migration(bool start);
 
     dsn::error_code send_balancer_proposal(const configuration_balancer_request& request);
+
+    // ingest the files built offline for each partition, which are expected in
+    // <source_dir>/<partition_index>/ on the source node; the partitions are
+    // loaded one by one, and the state of each is replaced by its files
+    dsn::error_code bulk_load(const std::string& app_name, const dsn::rpc_address& source, const std::string& source_dir, const std::vector<std::string>& files, int timeout_seconds = 3600);
+
+    // double the partition count of the app online, the split goes on in the background
+    // after the new partition count is returned
+    dsn::error_code split_app(const std::string& app_name, /*out*/ int32_t& partition_count);
 private:
     bool static valid_app_char(int c);
 
@@ -158,6 +158,28 @@ namespace replication {
         static bool remove_node(::dsn::rpc_address node, /*inout*/ std::vector< ::dsn::rpc_address>& nodeList);
         static bool get_replica_config(const partition_configuration& partition_config, ::dsn::rpc_address node, /*out*/ replica_configuration& replica_config);
         static void load_meta_servers(/*out*/ std::vector<dsn::rpc_address>& servers, const char* section="meta_server", const char* key="server_list");
+
+        //
+        // online split: while an app is split from N to 2N partitions, its app_info
+        // already has partition_count = 2N, and the envs below record N and the
+        // children (N..2N-1) which have caught up with their parents; a child serves
+        // its keys only when it is ready, till then the parent serves them
+        //
+        static const char* split_parent_count_env;
+        static const char* split_ready_children_env;
+        // the partition count before the first split, which is never removed
+        static const char* split_original_count_env;
+
+        static int  get_split_parent_count(const ::dsn::app_info& info); // 0 when not splitting
+        static bool is_split_child_ready(const ::dsn::app_info& info, int child_index);
+        // returns false when the child is already ready, the envs are removed when all are
+        static bool mark_split_child_ready(/*inout*/ ::dsn::app_info& info, int child_index);
+
+        // the modulus of the key hashes served by the partition, 0 when it serves nothing
+        static int  get_serving_partition_count(const ::dsn::app_info& info, int partition_index);
+
+        // whether a split is ever started on the app
+        static bool is_app_ever_split(const ::dsn::app_info& info);
     };
 }
 } // namespace
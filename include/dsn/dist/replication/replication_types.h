@@ -141,6 +141,10 @@ class group_check_request;
 
 class group_check_response;
 
+class group_check_batch_request;
+
+class group_check_batch_response;
+
 class node_info;
 
 class meta_response_header;
@@ -149,10 +153,14 @@ class configuration_update_request;
 
 class configuration_update_response;
 
+class replica_load;
+
 class configuration_query_by_node_request;
 
 class configuration_query_by_node_response;
 
+class config_change_notification;
+
 class create_app_options;
 
 class configuration_create_app_request;
@@ -199,6 +207,24 @@ class query_replica_info_response;
 
 class node_state;
 
+class bulk_load_request;
+
+class bulk_load_response;
+
+class split_partition_request;
+
+class split_forward_request;
+
+class split_forward_response;
+
+class notify_split_ready_request;
+
+class notify_split_ready_response;
+
+class configuration_split_app_request;
+
+class configuration_split_app_response;
+
 typedef struct _mutation_header__isset {
   _mutation_header__isset() : pid(false), ballot(false), decree(false), log_offset(false), last_committed_decree(false) {}
   bool pid :1;
@@ -1121,6 +1147,104 @@ inline std::ostream& operator<<(std::ostream& out, const group_check_response& o
   return out;
 }
 
+typedef struct _group_check_batch_request__isset {
+  _group_check_batch_request__isset() : node(false), requests(false) {}
+  bool node :1;
+  bool requests :1;
+} _group_check_batch_request__isset;
+
+class group_check_batch_request {
+ public:
+
+  group_check_batch_request(const group_check_batch_request&);
+  group_check_batch_request& operator=(const group_check_batch_request&);
+  group_check_batch_request() {
+  }
+
+  virtual ~group_check_batch_request() throw();
+   ::dsn::rpc_address node;
+  std::vector<group_check_request>  requests;
+
+  _group_check_batch_request__isset __isset;
+
+  void __set_node(const  ::dsn::rpc_address& val);
+
+  void __set_requests(const std::vector<group_check_request> & val);
+
+  bool operator == (const group_check_batch_request & rhs) const
+  {
+    if (!(node == rhs.node))
+      return false;
+    if (!(requests == rhs.requests))
+      return false;
+    return true;
+  }
+  bool operator != (const group_check_batch_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const group_check_batch_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(group_check_batch_request &a, group_check_batch_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const group_check_batch_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _group_check_batch_response__isset {
+  _group_check_batch_response__isset() : responses(false) {}
+  bool responses :1;
+} _group_check_batch_response__isset;
+
+class group_check_batch_response {
+ public:
+
+  group_check_batch_response(const group_check_batch_response&);
+  group_check_batch_response& operator=(const group_check_batch_response&);
+  group_check_batch_response() {
+  }
+
+  virtual ~group_check_batch_response() throw();
+  std::vector<group_check_response>  responses;
+
+  _group_check_batch_response__isset __isset;
+
+  void __set_responses(const std::vector<group_check_response> & val);
+
+  bool operator == (const group_check_batch_response & rhs) const
+  {
+    if (!(responses == rhs.responses))
+      return false;
+    return true;
+  }
+  bool operator != (const group_check_batch_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const group_check_batch_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(group_check_batch_response &a, group_check_batch_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const group_check_batch_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 typedef struct _node_info__isset {
   _node_info__isset() : status(true), address(false) {}
   bool status :1;
@@ -1351,9 +1475,76 @@ inline std::ostream& operator<<(std::ostream& out, const configuration_update_re
   return out;
 }
 
+typedef struct _replica_load__isset {
+  _replica_load__isset() : pid(false), qps(false), bytes_per_second(false), disk_usage_mb(false) {}
+  bool pid :1;
+  bool qps :1;
+  bool bytes_per_second :1;
+  bool disk_usage_mb :1;
+} _replica_load__isset;
+
+class replica_load {
+ public:
+
+  replica_load(const replica_load&);
+  replica_load& operator=(const replica_load&);
+  replica_load() : qps(0), bytes_per_second(0), disk_usage_mb(0) {
+  }
+
+  virtual ~replica_load() throw();
+   ::dsn::gpid pid;
+  double qps;
+  double bytes_per_second;
+  int64_t disk_usage_mb;
+
+  _replica_load__isset __isset;
+
+  void __set_pid(const  ::dsn::gpid& val);
+
+  void __set_qps(const double val);
+
+  void __set_bytes_per_second(const double val);
+
+  void __set_disk_usage_mb(const int64_t val);
+
+  bool operator == (const replica_load & rhs) const
+  {
+    if (!(pid == rhs.pid))
+      return false;
+    if (!(qps == rhs.qps))
+      return false;
+    if (!(bytes_per_second == rhs.bytes_per_second))
+      return false;
+    if (!(disk_usage_mb == rhs.disk_usage_mb))
+      return false;
+    return true;
+  }
+  bool operator != (const replica_load &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const replica_load & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(replica_load &a, replica_load &b);
+
+inline std::ostream& operator<<(std::ostream& out, const replica_load& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 typedef struct _configuration_query_by_node_request__isset {
-  _configuration_query_by_node_request__isset() : node(false) {}
+  _configuration_query_by_node_request__isset() : node(false), config_epoch(false), config_version(false), loads(false) {}
   bool node :1;
+  bool config_epoch :1;
+  bool config_version :1;
+  bool loads :1;
 } _configuration_query_by_node_request__isset;
 
 class configuration_query_by_node_request {
@@ -1361,20 +1552,35 @@ class configuration_query_by_node_request {
 
   configuration_query_by_node_request(const configuration_query_by_node_request&);
   configuration_query_by_node_request& operator=(const configuration_query_by_node_request&);
-  configuration_query_by_node_request() {
+  configuration_query_by_node_request() : config_epoch(0), config_version(0) {
   }
 
   virtual ~configuration_query_by_node_request() throw();
    ::dsn::rpc_address node;
+  int64_t config_epoch;
+  int64_t config_version;
+  std::vector<replica_load>  loads;
 
   _configuration_query_by_node_request__isset __isset;
 
   void __set_node(const  ::dsn::rpc_address& val);
 
+  void __set_config_epoch(const int64_t val);
+
+  void __set_config_version(const int64_t val);
+
+  void __set_loads(const std::vector<replica_load> & val);
+
   bool operator == (const configuration_query_by_node_request & rhs) const
   {
     if (!(node == rhs.node))
       return false;
+    if (!(config_epoch == rhs.config_epoch))
+      return false;
+    if (!(config_version == rhs.config_version))
+      return false;
+    if (!(loads == rhs.loads))
+      return false;
     return true;
   }
   bool operator != (const configuration_query_by_node_request &rhs) const {
@@ -1398,9 +1604,13 @@ inline std::ostream& operator<<(std::ostream& out, const configuration_query_by_
 }
 
 typedef struct _configuration_query_by_node_response__isset {
-  _configuration_query_by_node_response__isset() : err(false), partitions(false) {}
+  _configuration_query_by_node_response__isset() : err(false), partitions(false), is_incremental(false), gone_partitions(false), config_epoch(false), config_version(false) {}
   bool err :1;
   bool partitions :1;
+  bool is_incremental :1;
+  bool gone_partitions :1;
+  bool config_epoch :1;
+  bool config_version :1;
 } _configuration_query_by_node_response__isset;
 
 class configuration_query_by_node_response {
@@ -1408,12 +1618,16 @@ class configuration_query_by_node_response {
 
   configuration_query_by_node_response(const configuration_query_by_node_response&);
   configuration_query_by_node_response& operator=(const configuration_query_by_node_response&);
-  configuration_query_by_node_response() {
+  configuration_query_by_node_response() : is_incremental(0), config_epoch(0), config_version(0) {
   }
 
   virtual ~configuration_query_by_node_response() throw();
    ::dsn::error_code err;
   std::vector<configuration_update_request>  partitions;
+  bool is_incremental;
+  std::vector< ::dsn::gpid>  gone_partitions;
+  int64_t config_epoch;
+  int64_t config_version;
 
   _configuration_query_by_node_response__isset __isset;
 
@@ -1421,12 +1635,28 @@ class configuration_query_by_node_response {
 
   void __set_partitions(const std::vector<configuration_update_request> & val);
 
+  void __set_is_incremental(const bool val);
+
+  void __set_gone_partitions(const std::vector< ::dsn::gpid> & val);
+
+  void __set_config_epoch(const int64_t val);
+
+  void __set_config_version(const int64_t val);
+
   bool operator == (const configuration_query_by_node_response & rhs) const
   {
     if (!(err == rhs.err))
       return false;
     if (!(partitions == rhs.partitions))
       return false;
+    if (!(is_incremental == rhs.is_incremental))
+      return false;
+    if (!(gone_partitions == rhs.gone_partitions))
+      return false;
+    if (!(config_epoch == rhs.config_epoch))
+      return false;
+    if (!(config_version == rhs.config_version))
+      return false;
     return true;
   }
   bool operator != (const configuration_query_by_node_response &rhs) const {
@@ -1449,6 +1679,58 @@ inline std::ostream& operator<<(std::ostream& out, const configuration_query_by_
   return out;
 }
 
+typedef struct _config_change_notification__isset {
+  _config_change_notification__isset() : config_epoch(false), config_version(false) {}
+  bool config_epoch :1;
+  bool config_version :1;
+} _config_change_notification__isset;
+
+class config_change_notification {
+ public:
+
+  config_change_notification(const config_change_notification&);
+  config_change_notification& operator=(const config_change_notification&);
+  config_change_notification() : config_epoch(0), config_version(0) {
+  }
+
+  virtual ~config_change_notification() throw();
+  int64_t config_epoch;
+  int64_t config_version;
+
+  _config_change_notification__isset __isset;
+
+  void __set_config_epoch(const int64_t val);
+
+  void __set_config_version(const int64_t val);
+
+  bool operator == (const config_change_notification & rhs) const
+  {
+    if (!(config_epoch == rhs.config_epoch))
+      return false;
+    if (!(config_version == rhs.config_version))
+      return false;
+    return true;
+  }
+  bool operator != (const config_change_notification &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const config_change_notification & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(config_change_notification &a, config_change_notification &b);
+
+inline std::ostream& operator<<(std::ostream& out, const config_change_notification& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 typedef struct _create_app_options__isset {
   _create_app_options__isset() : partition_count(false), replica_count(false), success_if_exist(false), app_type(false), is_stateful(false), envs(false) {}
   bool partition_count :1;
@@ -2671,6 +2953,510 @@ inline std::ostream& operator<<(std::ostream& out, const node_state& obj)
   return out;
 }
 
+typedef struct _bulk_load_request__isset {
+  _bulk_load_request__isset() : pid(false), source(false), source_dir(false), files(false), ballot(false), signature(false) {}
+  bool pid :1;
+  bool source :1;
+  bool source_dir :1;
+  bool files :1;
+  bool ballot :1;
+  bool signature :1;
+} _bulk_load_request__isset;
+
+class bulk_load_request {
+ public:
+
+  bulk_load_request(const bulk_load_request&);
+  bulk_load_request& operator=(const bulk_load_request&);
+  bulk_load_request() : source_dir(), ballot(0), signature(0) {
+  }
+
+  virtual ~bulk_load_request() throw();
+   ::dsn::gpid pid;
+   ::dsn::rpc_address source;
+  std::string source_dir;
+  std::vector<std::string>  files;
+  int64_t ballot;
+  int64_t signature;
+
+  _bulk_load_request__isset __isset;
+
+  void __set_pid(const  ::dsn::gpid& val);
+
+  void __set_source(const  ::dsn::rpc_address& val);
+
+  void __set_source_dir(const std::string& val);
+
+  void __set_files(const std::vector<std::string> & val);
+
+  void __set_ballot(const int64_t val);
+
+  void __set_signature(const int64_t val);
+
+  bool operator == (const bulk_load_request & rhs) const
+  {
+    if (!(pid == rhs.pid))
+      return false;
+    if (!(source == rhs.source))
+      return false;
+    if (!(source_dir == rhs.source_dir))
+      return false;
+    if (!(files == rhs.files))
+      return false;
+    if (!(ballot == rhs.ballot))
+      return false;
+    if (!(signature == rhs.signature))
+      return false;
+    return true;
+  }
+  bool operator != (const bulk_load_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const bulk_load_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(bulk_load_request &a, bulk_load_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const bulk_load_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _bulk_load_response__isset {
+  _bulk_load_response__isset() : err(false), decree(false) {}
+  bool err :1;
+  bool decree :1;
+} _bulk_load_response__isset;
+
+class bulk_load_response {
+ public:
+
+  bulk_load_response(const bulk_load_response&);
+  bulk_load_response& operator=(const bulk_load_response&);
+  bulk_load_response() : decree(0) {
+  }
+
+  virtual ~bulk_load_response() throw();
+   ::dsn::error_code err;
+  int64_t decree;
+
+  _bulk_load_response__isset __isset;
+
+  void __set_err(const  ::dsn::error_code& val);
+
+  void __set_decree(const int64_t val);
+
+  bool operator == (const bulk_load_response & rhs) const
+  {
+    if (!(err == rhs.err))
+      return false;
+    if (!(decree == rhs.decree))
+      return false;
+    return true;
+  }
+  bool operator != (const bulk_load_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const bulk_load_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(bulk_load_response &a, bulk_load_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const bulk_load_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _split_partition_request__isset {
+  _split_partition_request__isset() : parent(false), parent_ballot(false), child(false), child_primary(false), partition_count(false) {}
+  bool parent :1;
+  bool parent_ballot :1;
+  bool child :1;
+  bool child_primary :1;
+  bool partition_count :1;
+} _split_partition_request__isset;
+
+class split_partition_request {
+ public:
+
+  split_partition_request(const split_partition_request&);
+  split_partition_request& operator=(const split_partition_request&);
+  split_partition_request() : parent_ballot(0), partition_count(0) {
+  }
+
+  virtual ~split_partition_request() throw();
+   ::dsn::gpid parent;
+  int64_t parent_ballot;
+   ::dsn::gpid child;
+   ::dsn::rpc_address child_primary;
+  int32_t partition_count;
+
+  _split_partition_request__isset __isset;
+
+  void __set_parent(const  ::dsn::gpid& val);
+
+  void __set_parent_ballot(const int64_t val);
+
+  void __set_child(const  ::dsn::gpid& val);
+
+  void __set_child_primary(const  ::dsn::rpc_address& val);
+
+  void __set_partition_count(const int32_t val);
+
+  bool operator == (const split_partition_request & rhs) const
+  {
+    if (!(parent == rhs.parent))
+      return false;
+    if (!(parent_ballot == rhs.parent_ballot))
+      return false;
+    if (!(child == rhs.child))
+      return false;
+    if (!(child_primary == rhs.child_primary))
+      return false;
+    if (!(partition_count == rhs.partition_count))
+      return false;
+    return true;
+  }
+  bool operator != (const split_partition_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const split_partition_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(split_partition_request &a, split_partition_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const split_partition_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _split_forward_request__isset {
+  _split_forward_request__isset() : child(false), bulk_load_decree(false), updates(false) {}
+  bool child :1;
+  bool bulk_load_decree :1;
+  bool updates :1;
+} _split_forward_request__isset;
+
+class split_forward_request {
+ public:
+
+  split_forward_request(const split_forward_request&);
+  split_forward_request& operator=(const split_forward_request&);
+  split_forward_request() : bulk_load_decree(0) {
+  }
+
+  virtual ~split_forward_request() throw();
+   ::dsn::gpid child;
+  int64_t bulk_load_decree;
+  std::vector<mutation_update>  updates;
+
+  _split_forward_request__isset __isset;
+
+  void __set_child(const  ::dsn::gpid& val);
+
+  void __set_bulk_load_decree(const int64_t val);
+
+  void __set_updates(const std::vector<mutation_update> & val);
+
+  bool operator == (const split_forward_request & rhs) const
+  {
+    if (!(child == rhs.child))
+      return false;
+    if (!(bulk_load_decree == rhs.bulk_load_decree))
+      return false;
+    if (!(updates == rhs.updates))
+      return false;
+    return true;
+  }
+  bool operator != (const split_forward_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const split_forward_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(split_forward_request &a, split_forward_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const split_forward_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _split_forward_response__isset {
+  _split_forward_response__isset() : err(false) {}
+  bool err :1;
+} _split_forward_response__isset;
+
+class split_forward_response {
+ public:
+
+  split_forward_response(const split_forward_response&);
+  split_forward_response& operator=(const split_forward_response&);
+  split_forward_response() {
+  }
+
+  virtual ~split_forward_response() throw();
+   ::dsn::error_code err;
+
+  _split_forward_response__isset __isset;
+
+  void __set_err(const  ::dsn::error_code& val);
+
+  bool operator == (const split_forward_response & rhs) const
+  {
+    if (!(err == rhs.err))
+      return false;
+    return true;
+  }
+  bool operator != (const split_forward_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const split_forward_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(split_forward_response &a, split_forward_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const split_forward_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _notify_split_ready_request__isset {
+  _notify_split_ready_request__isset() : parent(false), parent_ballot(false), child(false) {}
+  bool parent :1;
+  bool parent_ballot :1;
+  bool child :1;
+} _notify_split_ready_request__isset;
+
+class notify_split_ready_request {
+ public:
+
+  notify_split_ready_request(const notify_split_ready_request&);
+  notify_split_ready_request& operator=(const notify_split_ready_request&);
+  notify_split_ready_request() : parent_ballot(0) {
+  }
+
+  virtual ~notify_split_ready_request() throw();
+   ::dsn::gpid parent;
+  int64_t parent_ballot;
+   ::dsn::gpid child;
+
+  _notify_split_ready_request__isset __isset;
+
+  void __set_parent(const  ::dsn::gpid& val);
+
+  void __set_parent_ballot(const int64_t val);
+
+  void __set_child(const  ::dsn::gpid& val);
+
+  bool operator == (const notify_split_ready_request & rhs) const
+  {
+    if (!(parent == rhs.parent))
+      return false;
+    if (!(parent_ballot == rhs.parent_ballot))
+      return false;
+    if (!(child == rhs.child))
+      return false;
+    return true;
+  }
+  bool operator != (const notify_split_ready_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const notify_split_ready_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(notify_split_ready_request &a, notify_split_ready_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const notify_split_ready_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _notify_split_ready_response__isset {
+  _notify_split_ready_response__isset() : err(false) {}
+  bool err :1;
+} _notify_split_ready_response__isset;
+
+class notify_split_ready_response {
+ public:
+
+  notify_split_ready_response(const notify_split_ready_response&);
+  notify_split_ready_response& operator=(const notify_split_ready_response&);
+  notify_split_ready_response() {
+  }
+
+  virtual ~notify_split_ready_response() throw();
+   ::dsn::error_code err;
+
+  _notify_split_ready_response__isset __isset;
+
+  void __set_err(const  ::dsn::error_code& val);
+
+  bool operator == (const notify_split_ready_response & rhs) const
+  {
+    if (!(err == rhs.err))
+      return false;
+    return true;
+  }
+  bool operator != (const notify_split_ready_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const notify_split_ready_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(notify_split_ready_response &a, notify_split_ready_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const notify_split_ready_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _configuration_split_app_request__isset {
+  _configuration_split_app_request__isset() : app_name(false) {}
+  bool app_name :1;
+} _configuration_split_app_request__isset;
+
+class configuration_split_app_request {
+ public:
+
+  configuration_split_app_request(const configuration_split_app_request&);
+  configuration_split_app_request& operator=(const configuration_split_app_request&);
+  configuration_split_app_request() : app_name() {
+  }
+
+  virtual ~configuration_split_app_request() throw();
+  std::string app_name;
+
+  _configuration_split_app_request__isset __isset;
+
+  void __set_app_name(const std::string& val);
+
+  bool operator == (const configuration_split_app_request & rhs) const
+  {
+    if (!(app_name == rhs.app_name))
+      return false;
+    return true;
+  }
+  bool operator != (const configuration_split_app_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const configuration_split_app_request & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(configuration_split_app_request &a, configuration_split_app_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const configuration_split_app_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _configuration_split_app_response__isset {
+  _configuration_split_app_response__isset() : err(false), partition_count(false) {}
+  bool err :1;
+  bool partition_count :1;
+} _configuration_split_app_response__isset;
+
+class configuration_split_app_response {
+ public:
+
+  configuration_split_app_response(const configuration_split_app_response&);
+  configuration_split_app_response& operator=(const configuration_split_app_response&);
+  configuration_split_app_response() : partition_count(0) {
+  }
+
+  virtual ~configuration_split_app_response() throw();
+   ::dsn::error_code err;
+  int32_t partition_count;
+
+  _configuration_split_app_response__isset __isset;
+
+  void __set_err(const  ::dsn::error_code& val);
+
+  void __set_partition_count(const int32_t val);
+
+  bool operator == (const configuration_split_app_response & rhs) const
+  {
+    if (!(err == rhs.err))
+      return false;
+    if (!(partition_count == rhs.partition_count))
+      return false;
+    return true;
+  }
+  bool operator != (const configuration_split_app_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const configuration_split_app_response & ) const;
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(configuration_split_app_response &a, configuration_split_app_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const configuration_split_app_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 }} // namespace
 
 #endif
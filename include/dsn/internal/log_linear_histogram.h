@@ -0,0 +1,195 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     log-linear histogram of uint64 values, e.g., latencies in ns
+ *
+ *     values below 2^(sub_bucket_bits + 1) have a bucket each, and every larger
+ *     power of two is split into 2^sub_bucket_bits linear buckets, so a value is
+ *     reported with a relative error below 2^-sub_bucket_bits (~3%) in 1920 buckets;
+ *     recording is one relaxed atomic increment, and as the layout is fixed, the
+ *     snapshots of many histograms (e.g., of many nodes) merge by adding the buckets
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include <atomic>
+# include <vector>
+# include <cstdint>
+# ifdef _MSC_VER
+# include <intrin.h>
+# endif
+
+namespace dsn {
+
+class histogram_snapshot
+{
+public:
+    enum
+    {
+        sub_bucket_bits = 5,
+        sub_bucket_count = 1 << sub_bucket_bits,
+        linear_limit = 2 * sub_bucket_count,      // values below are exact
+        bucket_count = linear_limit + (64 - sub_bucket_bits - 1) * sub_bucket_count
+    };
+
+    histogram_snapshot() : buckets(bucket_count, 0), count(0), sum(0) {}
+
+    // the index of the highest set bit, value must not be 0
+    static int most_significant_bit(uint64_t value)
+    {
+# if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+# elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long msb;
+        _BitScanReverse64(&msb, value);
+        return static_cast<int>(msb);
+# else
+        int msb = 0;
+        for (int step = 32; step > 0; step >>= 1)
+        {
+            if (value >> step)
+            {
+                value >>= step;
+                msb += step;
+            }
+        }
+        return msb;
+# endif
+    }
+
+    static int bucket_index(uint64_t value)
+    {
+        if (value < linear_limit)
+            return static_cast<int>(value);
+
+        int msb = most_significant_bit(value);
+        int shift = msb - sub_bucket_bits;
+        return linear_limit + (shift - 1) * sub_bucket_count
+            + static_cast<int>((value >> shift) - sub_bucket_count);
+    }
+
+    // the middle of the values of the bucket
+    static uint64_t bucket_value(int index)
+    {
+        if (index < linear_limit)
+            return static_cast<uint64_t>(index);
+
+        int shift = (index - linear_limit) / sub_bucket_count + 1;
+        uint64_t sub = static_cast<uint64_t>((index - linear_limit) % sub_bucket_count + sub_bucket_count);
+        return (sub << shift) + ((1ULL << shift) >> 1);
+    }
+
+    // percentile in [0, 100], 0 when empty
+    uint64_t value_at_percentile(double percentile) const
+    {
+        if (count == 0)
+            return 0;
+
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+        if (rank == 0)
+            rank = 1;
+        if (rank > count)
+            rank = count;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < bucket_count; i++)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return bucket_value(i);
+        }
+        return bucket_value(bucket_count - 1);
+    }
+
+    void merge(const histogram_snapshot& other)
+    {
+        for (int i = 0; i < bucket_count; i++)
+        {
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+        sum += other.sum;
+    }
+
+    // the values recorded after base, where base is an earlier snapshot of the same histogram
+    void subtract(const histogram_snapshot& base)
+    {
+        for (int i = 0; i < bucket_count; i++)
+        {
+            buckets[i] -= base.buckets[i];
+        }
+        count -= base.count;
+        sum -= base.sum;
+    }
+
+public:
+    std::vector<uint64_t> buckets;
+    uint64_t              count;
+    uint64_t              sum;
+};
+
+// the buckets only grow, and a window is the difference of two snapshots,
+// so no value is lost or counted twice by a reset racing with the writers
+class log_linear_histogram
+{
+public:
+    log_linear_histogram() : _sum(0)
+    {
+        for (auto& b : _buckets)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(uint64_t value)
+    {
+        _buckets[histogram_snapshot::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void snapshot(/*out*/ histogram_snapshot& snapshot) const
+    {
+        snapshot.count = 0;
+        for (int i = 0; i < histogram_snapshot::bucket_count; i++)
+        {
+            snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.buckets[i];
+        }
+        snapshot.sum = _sum.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> _buckets[histogram_snapshot::bucket_count];
+    std::atomic<uint64_t> _sum;
+};
+
+} // end namespace
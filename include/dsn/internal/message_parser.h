@@ -42,6 +42,7 @@
 # include <dsn/cpp/autoref_ptr.h>
 # include <dsn/cpp/utils.h>
 # include <vector>
+# include <unordered_set>
 
 namespace dsn 
 {
@@ -148,7 +149,14 @@ namespace dsn
         message_parser* create_parser(network_header_format fmt);
         const parser_factory_info& get(network_header_format fmt) { return _factory_vec[fmt]; }
 
+        // the rpcs an http client may call as "GET /<rpc_name>" without body, e.g., "metrics";
+        // the other rpcs expect a marshalled body, so such requests to them are refused
+        // called only during system init, thread-unsafe
+        void register_http_bodiless_rpc(const char* rpc_name);
+        bool is_http_bodiless_rpc(const char* rpc_name) const;
+
     private:
         std::vector<parser_factory_info> _factory_vec;
+        std::unordered_set<std::string>  _http_bodiless_rpcs;
     };
 }
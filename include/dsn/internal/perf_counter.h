@@ -39,6 +39,7 @@
 # include <dsn/internal/enum_helper.h>
 # include <dsn/service_api_c.h>
 # include <dsn/cpp/autoref_ptr.h>
+# include <dsn/internal/log_linear_histogram.h>
 # include <sstream>
 # include <vector>
 
@@ -95,6 +96,10 @@ public:
     // return the latest sample value
     virtual uint64_t get_latest_sample() const { return 0; }
 
+    // return false when the percentiles are not from a histogram, otherwise
+    // the histogram of the last complete window, which merges with the ones of other nodes
+    virtual bool get_histogram(/*out*/ histogram_snapshot& window) { return false; }
+
     const char* full_name() const { return _full_name.c_str(); }
     const char* app() const { return _app.c_str(); }
     const char* section() const { return _section.c_str(); }
@@ -41,6 +41,10 @@
 # include <map>
 # include <sstream>
 # include <queue>
+# include <unordered_map>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
 
 namespace dsn {
 
@@ -72,11 +76,19 @@ public:
     static std::string get_counter_value_i(const std::vector<std::string>& args);
     static std::string get_counter_sample_i(const std::vector<std::string>& args);
     static std::string get_counter_index(const std::vector<std::string>& args);
+    static std::string get_counter_history(const std::vector<std::string>& args);
+
+    // all counters in the prometheus text format, which is served at
+    // http://<any rpc address of this process>/metrics once registered
+    std::string get_prometheus_text();
+    static void register_http_metrics();
 
     typedef std::map<std::string, perf_counter_ptr > all_counters;
 
 private:
     std::string list_counter_internal(const std::vector<std::string>& args);
+    void history_sampler();
+    void sample_history();
     mutable utils::rw_lock_nr  _lock;
     all_counters               _counters;
     perf_counter::factory      _factory;
@@ -84,6 +96,23 @@ private:
     uint64_t                   _max_counter_count;
     perf_counter               **_quick_counters;
     std::queue<uint64_t>       _quick_counters_empty_slots;
+
+    // the values of each counter in the last _history_seconds, one per second,
+    // the value of a percentile counter is its p99
+    struct counter_history
+    {
+        std::vector<double> values; // ring
+        int                 next;
+        int                 count;
+    };
+
+    int                        _history_seconds;
+    std::mutex                 _history_lock;
+    std::unordered_map<std::string, counter_history> _histories; // by full name
+    uint64_t                   _history_last_sample_ms;
+    std::thread                _history_thread;
+    std::condition_variable    _history_stop_cond;
+    bool                       _history_stopped;
 };
 
 } // end namespace dsn::utils
@@ -109,6 +109,10 @@ namespace dsn
         static dsn_msg_header_type header_type_to_c_type(const header_type& hdr_type);
     };
 
+    // client.hash is the hash of the request key, which is kept when the request is resolved
+    // to a partition; the older clients replace it with the hash of the partition id
+    # define MSG_CLIENT_FLAG_KEY_HASH 0x1
+
     typedef struct message_header
     {
         header_type    hdr_type;
@@ -132,7 +136,7 @@ namespace dsn
         {
             uint64_t hash; // for both partition hash and thread hash for the exact location of this request
             int32_t  timeout_ms;
-            int32_t  padding;
+            int32_t  flags; // MSG_CLIENT_FLAG_*, 0 from the older clients where it was padding
         } client;
 
         struct
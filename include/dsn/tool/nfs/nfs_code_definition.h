@@ -53,4 +53,7 @@ namespace dsn { namespace service {
     DEFINE_TASK_CODE_AIO(LPC_NFS_WRITE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
 
     DEFINE_TASK_CODE_AIO(LPC_NFS_COPY_FILE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
+
+    // delayed copy/read when the nfs rate limit is exceeded
+    DEFINE_TASK_CODE(LPC_NFS_COPY_THROTTLE, TASK_PRIORITY_COMMON, THREAD_POOL_DEFAULT)
 } } 
@@ -184,16 +184,35 @@ namespace dsn {
                     if (req->is_valid)
                     {
                         req->add_ref();
-                        req->remote_copy_task = copy(
-                            req->copy_req,
-                            [=](error_code err, copy_response&& resp)
-                            {
-                                end_copy(err, std::move(resp), req.get());
-                            },
-                            std::chrono::milliseconds(0),
-                            0,
-                            0,
-                            req->file_ctx->user_req->file_size_req.source);
+
+                        uint64_t delay_ms = nfs_rate_limiter::copy_limiter().reserve(req->copy_req.size);
+                        if (delay_ms > 0)
+                        {
+                            // over the copy rate limit, issue the copy later
+                            req->remote_copy_task = tasking::enqueue(
+                                LPC_NFS_COPY_THROTTLE,
+                                this,
+                                [=]()
+                                {
+                                    zauto_lock l(req->lock);
+                                    if (req->is_valid)
+                                    {
+                                        begin_copy(req);
+                                    }
+                                    else
+                                    {
+                                        req->release_ref();
+                                        continue_copy(1);
+                                    }
+                                },
+                                0,
+                                std::chrono::milliseconds(delay_ms)
+                                );
+                        }
+                        else
+                        {
+                            begin_copy(req);
+                        }
 
                         if (++_concurrent_copy_request_count > _opts.max_concurrent_remote_copy_requests)
                         {
@@ -205,6 +224,21 @@ namespace dsn {
             }
         }
 
+        void nfs_client_impl::begin_copy(const ::dsn::ref_ptr<copy_request_ex>& req)
+        {
+            // req->lock is held and req is add_ref-ed by caller
+            req->remote_copy_task = copy(
+                req->copy_req,
+                [=](error_code err, copy_response&& resp)
+                {
+                    end_copy(err, std::move(resp), req.get());
+                },
+                std::chrono::milliseconds(0),
+                0,
+                0,
+                req->file_ctx->user_req->file_size_req.source);
+        }
+
         void nfs_client_impl::end_copy(
             ::dsn::error_code err,
             const copy_response& resp,
@@ -50,6 +50,9 @@ namespace dsn {
             int file_close_timer_interval_ms_on_server;
             int max_file_copy_request_count_per_file;
 
+            uint64_t max_copy_rate_megabytes;
+            uint64_t max_send_rate_megabytes;
+
             void init()
             {
                 nfs_copy_block_bytes = (uint32_t)dsn_config_get_value_uint64("nfs", "nfs_copy_block_bytes", 
@@ -64,7 +67,54 @@ namespace dsn {
                     30 * 1000, "time interval for checking whether cached file handles need to be closed");
                 max_file_copy_request_count_per_file = (int)dsn_config_get_value_uint64("nfs", "max_file_copy_request_count_per_file", 
                     10, "maximum concurrent remote copy requests for the same file on nfs client"); // limit each file copy speed
+                max_copy_rate_megabytes = dsn_config_get_value_uint64("nfs", "max_copy_rate_megabytes",
+                    0, "maximum rate (MB/s) of data copied from remote by all nfs clients in this process, 0 for unlimited");
+                max_send_rate_megabytes = dsn_config_get_value_uint64("nfs", "max_send_rate_megabytes",
+                    0, "maximum rate (MB/s) of data sent to remote by all nfs servers in this process, 0 for unlimited");
+            }
+        };
+
+        //
+        // token bucket shared by all nfs clients (or servers) in this process,
+        // callers reserve bytes and delay their requests by the returned time
+        //
+        class nfs_rate_limiter
+        {
+        public:
+            nfs_rate_limiter() : _rate_mb(0), _next_free_ts_us(0) {}
+
+            static nfs_rate_limiter& copy_limiter() { static nfs_rate_limiter l; return l; }
+            static nfs_rate_limiter& send_limiter() { static nfs_rate_limiter l; return l; }
+
+            void set_rate_mb(uint64_t mb)
+            {
+                zauto_lock l(_lock);
+                _rate_mb = mb;
+            }
+
+            uint64_t rate_mb() const { return _rate_mb; }
+
+            // return the delay (ms) before the reserved bytes may be transfered
+            uint64_t reserve(uint64_t bytes)
+            {
+                zauto_lock l(_lock);
+                if (_rate_mb == 0)
+                    return 0;
+
+                // at most one second of idle time can be used for bursts
+                uint64_t now_us = dsn_now_us();
+                if (_next_free_ts_us + 1000000 < now_us)
+                    _next_free_ts_us = now_us - 1000000;
+
+                uint64_t delay_ms = _next_free_ts_us > now_us ? (_next_free_ts_us - now_us) / 1000 : 0;
+                _next_free_ts_us += bytes / _rate_mb; // 1MB/s ~= 1 byte/us
+                return delay_ms;
             }
+
+        private:
+            zlock             _lock;
+            volatile uint64_t _rate_mb;
+            uint64_t          _next_free_ts_us;
         };
 
         class nfs_client_impl
@@ -163,6 +213,8 @@ namespace dsn {
 
             void continue_copy(int done_count);
 
+            void begin_copy(const ::dsn::ref_ptr<copy_request_ex>& req);
+
             void write_copy(::dsn::ref_ptr<copy_request_ex> reqc);
 
             void continue_write();
@@ -36,6 +36,8 @@
 # include <dsn/tool/nfs.h>
 # include "nfs_client_impl.h"
 # include "nfs_server_impl.h"
+# include <dsn/internal/command.h>
+# include <sstream>
 
 namespace dsn { 
     namespace service {
@@ -60,8 +62,42 @@ namespace dsn {
             _client->begin_remote_copy(rci, callback); // copy file request entry
         }
 
+        static void register_rate_limit_command()
+        {
+            static std::atomic<bool> registered(false);
+            bool expected = false;
+            if (!registered.compare_exchange_strong(expected, true))
+                return;
+
+            ::dsn::register_command("nfs-rate-limit",
+                "nfs-rate-limit [copy-MB/s send-MB/s]",
+                "nfs-rate-limit get or set the maximum copy (inbound) and send (outbound) rate of nfs in this process, 0 for unlimited",
+                [](const std::vector<std::string>& args)
+                {
+                    if (args.size() >= 2)
+                    {
+                        nfs_rate_limiter::copy_limiter().set_rate_mb(strtoull(args[0].c_str(), nullptr, 10));
+                        nfs_rate_limiter::send_limiter().set_rate_mb(strtoull(args[1].c_str(), nullptr, 10));
+                    }
+                    else if (args.size() == 1)
+                    {
+                        return std::string("invalid arguments for nfs-rate-limit command");
+                    }
+
+                    std::stringstream ss;
+                    ss << "copy = " << nfs_rate_limiter::copy_limiter().rate_mb() << " MB/s, "
+                       << "send = " << nfs_rate_limiter::send_limiter().rate_mb() << " MB/s";
+                    return ss.str();
+                }
+            );
+        }
+
         error_code nfs_node_simple::start(io_modifer& ctx)
         {
+            nfs_rate_limiter::copy_limiter().set_rate_mb(_opts->max_copy_rate_megabytes);
+            nfs_rate_limiter::send_limiter().set_rate_mb(_opts->max_send_rate_megabytes);
+            register_rate_limit_command();
+
             _server = new nfs_service_impl(*_opts);
             _server->open_service();
 
@@ -96,12 +96,38 @@ namespace dsn {
             cp.offset = request.offset;
             cp.size = request.size;
 
+            uint64_t delay_ms = nfs_rate_limiter::send_limiter().reserve(request.size);
+            if (delay_ms > 0)
+            {
+                // over the send rate limit, read (and reply) later
+                tasking::enqueue(
+                    LPC_NFS_COPY_THROTTLE,
+                    this,
+                    [this, cp_cap = std::move(cp)] () mutable
+                    {
+                        internal_read(std::move(cp_cap));
+                    },
+                    0,
+                    std::chrono::milliseconds(delay_ms)
+                    );
+            }
+            else
+            {
+                internal_read(std::move(cp));
+            }
+        }
+
+        void nfs_service_impl::internal_read(callback_para cp)
+        {
             auto buffer_save = cp.bb.buffer().get();
+            auto hfile = cp.hfile;
+            auto size = cp.size;
+            auto offset = cp.offset;
             file::read(
                 hfile,
                 buffer_save,
-                request.size,
-                request.offset,
+                size,
+                offset,
                 LPC_NFS_READ,
                 this,
                 [this, cp_cap = std::move(cp)] (error_code err, int sz)
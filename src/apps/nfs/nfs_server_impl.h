@@ -82,6 +82,8 @@ namespace dsn {
                 file_handle_info_on_server() : file_handle(nullptr), file_access_count(0), last_access_time(0) {}
             };
 
+            void internal_read(callback_para cp);
+
             void internal_read_callback(error_code err, size_t sz, callback_para cp);
 
             void close_file();
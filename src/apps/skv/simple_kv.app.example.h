@@ -35,6 +35,7 @@
 
 # pragma once
 # include "simple_kv.client.2.h"
+# include "simple_kv.client.scanner.h"
 # include "simple_kv.client.perf.h"
 # include "simple_kv.server.h"
 
@@ -119,6 +120,23 @@ public:
             //_simple_kv_client->append(req, empty_callback);
 
         }
+        {
+            scan_request req;
+            req.prefix = "hello";
+            //sync:
+            error_code err;
+            scan_response resp;
+            std::tie(err, resp) = _simple_kv_client->scan_sync(req);
+            std::cout << "call RPC_SIMPLE_KV_SIMPLE_KV_SCAN end, return " << err.to_string();
+            if (ERR_OK == err)
+                std::cout << ", scan result: " << resp.kvs.size() << " pairs";
+            std::cout << std::endl;
+            //async: 
+            //_simple_kv_client->scan(req, empty_callback);
+            //across all partitions in key order:
+            //simple_kv_scanner scanner(_simple_kv_client.get(), partition_count, req);
+
+        }
     }
 
 private:
@@ -0,0 +1,178 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     offline builder of simple_kv bulk loads, which splits a file of tab separated
+ *     key value lines by simple_kv_key_hash, and writes the pairs of partition i in
+ *     key order into <output_dir>/<i>/checkpoint.1, ready for
+ *     "ddl_client bulk_load -files checkpoint.1"
+ *
+ *     the pairs are sorted in memory, so a very large input should be split and
+ *     built for a subset of the partitions at a time
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+# include "simple_kv.checkpoint.h"
+# include "simple_kv.code.definition.h"
+# include <dsn/cpp/utils.h>
+# include <thread>
+# include <map>
+# include <fstream>
+# include <sstream>
+
+namespace dsn { namespace replication { namespace application {
+
+class simple_kv_bulk_load_builder_app : public ::dsn::service_app
+{
+public:
+    simple_kv_bulk_load_builder_app(dsn_gpid gpid) : ::dsn::service_app(gpid) {}
+
+    ~simple_kv_bulk_load_builder_app()
+    {
+        stop();
+    }
+
+    virtual ::dsn::error_code start(int argc, char** argv) override
+    {
+        _input_file = dsn_config_get_value_string("apps.bulk_load.builder", "input_file", "",
+            "file of key<TAB>value lines, the last value of a duplicated key wins");
+        _output_dir = dsn_config_get_value_string("apps.bulk_load.builder", "output_dir", "./bulk_load",
+            "where the checkpoint files of each partition are written");
+        _partition_count = (int)dsn_config_get_value_uint64("apps.bulk_load.builder", "partition_count", 8,
+            "partition count of the target app");
+        _exit_after_build = dsn_config_get_value_bool("apps.bulk_load.builder", "exit_after_build", true,
+            "exit the process after the files are built");
+
+        if (_input_file.empty() || _partition_count <= 0)
+        {
+            derror("bulk load builder: input_file and partition_count must be given");
+            return ::dsn::ERR_INVALID_PARAMETERS;
+        }
+
+        _runner = std::thread([this]() { run(); });
+        return ::dsn::ERR_OK;
+    }
+
+    virtual ::dsn::error_code stop(bool cleanup = false) override
+    {
+        if (_runner.joinable())
+            _runner.join();
+        return ::dsn::ERR_OK;
+    }
+
+private:
+    ::dsn::error_code build()
+    {
+        std::ifstream is(_input_file.c_str());
+        if (!is.is_open())
+        {
+            derror("bulk load builder: open %s failed", _input_file.c_str());
+            return ::dsn::ERR_FILE_OPERATION_FAILED;
+        }
+
+        std::vector<std::map<std::string, std::string>> partitions(_partition_count);
+        std::string line;
+        uint64_t lines = 0;
+        while (std::getline(is, line))
+        {
+            size_t pos = line.find('\t');
+            if (pos == std::string::npos)
+            {
+                dwarn("bulk load builder: skip line %" PRIu64 " without a tab", lines + 1);
+                lines++;
+                continue;
+            }
+
+            std::string key = line.substr(0, pos);
+            int pidx = static_cast<int>(simple_kv_key_hash(key) % static_cast<uint64_t>(_partition_count));
+            partitions[pidx][key] = line.substr(pos + 1);
+            lines++;
+        }
+        is.close();
+
+        for (int i = 0; i < _partition_count; i++)
+        {
+            std::string dir = ::dsn::utils::filesystem::path_combine(_output_dir, std::to_string(i));
+            if (!::dsn::utils::filesystem::create_directory(dir))
+            {
+                derror("bulk load builder: create dir %s failed", dir.c_str());
+                return ::dsn::ERR_FILE_OPERATION_FAILED;
+            }
+
+            // the decree in the file is a placeholder, the file is renamed to the
+            // decree of the bulk load mutation when it is ingested
+            std::string path = ::dsn::utils::filesystem::path_combine(dir, "checkpoint.1");
+            kv_checkpoint_writer writer(path);
+            auto err = writer.open();
+            if (err != ::dsn::ERR_OK)
+                return err;
+
+            for (auto& kv : partitions[i])
+            {
+                writer.add(kv.first, kv.second);
+            }
+
+            err = writer.finish(1);
+            if (err != ::dsn::ERR_OK)
+                return err;
+
+            ddebug("bulk load builder: %s written, %" PRIu64 " pairs", path.c_str(), writer.record_count());
+            partitions[i].clear();
+        }
+
+        dwarn("bulk load builder: %" PRIu64 " lines of %s are built into %d partitions in %s",
+            lines, _input_file.c_str(), _partition_count, _output_dir.c_str());
+        return ::dsn::ERR_OK;
+    }
+
+    void run()
+    {
+        auto err = build();
+        if (err != ::dsn::ERR_OK)
+        {
+            derror("bulk load builder: build failed, err = %s", err.to_string());
+        }
+
+        if (_exit_after_build)
+        {
+            dsn_exit(err == ::dsn::ERR_OK ? 0 : 1);
+        }
+    }
+
+private:
+    std::string _input_file;
+    std::string _output_dir;
+    int         _partition_count;
+    bool        _exit_after_build;
+    std::thread _runner;
+};
+
+} } }
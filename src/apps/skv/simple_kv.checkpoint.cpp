@@ -0,0 +1,436 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     sorted, block indexed checkpoint file of simple_kv, which is served by mmap
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "simple_kv.checkpoint.h"
+
+# ifdef _WIN32
+# include <Windows.h>
+# else
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# endif
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "simple.kv.checkpoint"
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            //------------------------------ kv_mapped_file ------------------------------
+            class kv_mapped_file
+            {
+            public:
+                kv_mapped_file() : _data(nullptr), _size(0)
+                {
+# ifdef _WIN32
+                    _file = INVALID_HANDLE_VALUE;
+                    _mapping = nullptr;
+# endif
+                }
+
+                ~kv_mapped_file()
+                {
+# ifdef _WIN32
+                    if (_data) ::UnmapViewOfFile(_data);
+                    if (_mapping) ::CloseHandle(_mapping);
+                    if (_file != INVALID_HANDLE_VALUE) ::CloseHandle(_file);
+# else
+                    if (_data) ::munmap((void*)_data, _size);
+# endif
+                }
+
+                bool open(const std::string& path)
+                {
+# ifdef _WIN32
+                    _file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                    if (_file == INVALID_HANDLE_VALUE)
+                        return false;
+
+                    LARGE_INTEGER sz;
+                    if (!::GetFileSizeEx(_file, &sz))
+                        return false;
+                    _size = (size_t)sz.QuadPart;
+                    if (_size == 0)
+                        return true;
+
+                    _mapping = ::CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (_mapping == nullptr)
+                        return false;
+
+                    _data = (const char*)::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+                    return _data != nullptr;
+# else
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    if (fd < 0)
+                        return false;
+
+                    struct stat st;
+                    if (::fstat(fd, &st) != 0)
+                    {
+                        ::close(fd);
+                        return false;
+                    }
+
+                    _size = (size_t)st.st_size;
+                    if (_size > 0)
+                    {
+                        void* p = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+                        if (p != MAP_FAILED)
+                            _data = (const char*)p;
+                    }
+
+                    // the mapping holds its own reference to the file
+                    ::close(fd);
+                    return _size == 0 || _data != nullptr;
+# endif
+                }
+
+                const char* data() const { return _data; }
+                size_t size() const { return _size; }
+
+            private:
+                const char* _data;
+                size_t      _size;
+# ifdef _WIN32
+                HANDLE      _file;
+                HANDLE      _mapping;
+# endif
+            };
+
+            static void put_u32(std::string& buf, uint32_t v) { buf.append((const char*)&v, sizeof(v)); }
+            static void put_u64(std::string& buf, uint64_t v) { buf.append((const char*)&v, sizeof(v)); }
+
+            template<typename T> static T get_fixed(const char* p)
+            {
+                T v;
+                memcpy(&v, p, sizeof(T));
+                return v;
+            }
+
+            //------------------------------ kv_checkpoint_writer ------------------------------
+            kv_checkpoint_writer::kv_checkpoint_writer(const std::string& path, uint32_t block_bytes)
+                : _path(path), _block_bytes(block_bytes), _offset(0), _block_records(0), _block_count(0), _record_count(0)
+            {
+            }
+
+            kv_checkpoint_writer::~kv_checkpoint_writer()
+            {
+                if (_os.is_open())
+                    _os.close();
+            }
+
+            ::dsn::error_code kv_checkpoint_writer::open()
+            {
+                _os.open(_path.c_str(), std::ios::binary | std::ios::trunc);
+                if (!_os.is_open())
+                {
+                    derror("open %s failed", _path.c_str());
+                    return ERR_FILE_OPERATION_FAILED;
+                }
+                return ERR_OK;
+            }
+
+            void kv_checkpoint_writer::add(const kv_slice& key, const kv_slice& value)
+            {
+                if (_block_records == 0)
+                    _block_first_key.assign(key.data, key.size);
+
+                put_u32(_block, key.size);
+                _block.append(key.data, key.size);
+                put_u32(_block, value.size);
+                _block.append(value.data, value.size);
+
+                _block_records++;
+                _record_count++;
+
+                if (_block.size() >= _block_bytes)
+                    flush_block();
+            }
+
+            void kv_checkpoint_writer::flush_block()
+            {
+                if (_block_records == 0)
+                    return;
+
+                uint32_t crc = dsn_crc32_compute(_block.data(), _block.size(), 0);
+                _os.write(_block.data(), _block.size());
+
+                put_u64(_index, _offset);
+                put_u32(_index, (uint32_t)_block.size());
+                put_u32(_index, crc);
+                put_u32(_index, _block_records);
+                put_u32(_index, (uint32_t)_block_first_key.size());
+                _index.append(_block_first_key);
+
+                _offset += _block.size();
+                _block_count++;
+                _block.clear();
+                _block_records = 0;
+            }
+
+            ::dsn::error_code kv_checkpoint_writer::finish(int64_t decree)
+            {
+                flush_block();
+
+                kv_checkpoint_footer footer;
+                memset(&footer, 0, sizeof(footer));
+                footer.index_offset = _offset;
+                footer.index_size = (uint32_t)_index.size();
+                footer.index_crc = dsn_crc32_compute(_index.data(), _index.size(), 0);
+                footer.block_count = _block_count;
+                footer.record_count = _record_count;
+                footer.decree = decree;
+                footer.version = KV_CHECKPOINT_VERSION;
+                footer.footer_crc = dsn_crc32_compute(&footer, offsetof(kv_checkpoint_footer, footer_crc), 0);
+                footer.magic = KV_CHECKPOINT_MAGIC;
+
+                _os.write(_index.data(), _index.size());
+                _os.write((const char*)&footer, sizeof(footer));
+                _os.close();
+
+                if (_os.fail())
+                {
+                    derror("write %s failed", _path.c_str());
+                    return ERR_FILE_OPERATION_FAILED;
+                }
+                return ERR_OK;
+            }
+
+            //------------------------------ kv_checkpoint_reader ------------------------------
+            ::dsn::error_code kv_checkpoint_reader::open(const std::string& path, /*out*/ std::shared_ptr<kv_checkpoint_reader>& reader)
+            {
+                std::shared_ptr<kv_checkpoint_reader> r(new kv_checkpoint_reader());
+                r->_path = path;
+                r->_file.reset(new kv_mapped_file());
+                if (!r->_file->open(path))
+                {
+                    derror("map checkpoint %s failed", path.c_str());
+                    return ERR_FILE_OPERATION_FAILED;
+                }
+
+                const char* base = r->_file->data();
+                size_t size = r->_file->size();
+                if (size < sizeof(kv_checkpoint_footer))
+                    return ERR_INVALID_DATA;
+
+                memcpy(&r->_footer, base + size - sizeof(kv_checkpoint_footer), sizeof(kv_checkpoint_footer));
+                kv_checkpoint_footer& f = r->_footer;
+                if (f.magic != KV_CHECKPOINT_MAGIC)
+                    return ERR_INVALID_DATA;
+
+                if (f.footer_crc != dsn_crc32_compute(&f, offsetof(kv_checkpoint_footer, footer_crc), 0)
+                    || f.version != KV_CHECKPOINT_VERSION
+                    || f.index_offset + f.index_size + sizeof(kv_checkpoint_footer) != size)
+                {
+                    derror("checkpoint %s has a bad footer", path.c_str());
+                    return ERR_CORRUPTION;
+                }
+
+                const char* p = base + f.index_offset;
+                const char* end = p + f.index_size;
+                if (f.index_crc != dsn_crc32_compute(p, f.index_size, 0))
+                {
+                    derror("checkpoint %s has a bad index", path.c_str());
+                    return ERR_CORRUPTION;
+                }
+
+                const size_t handle_bytes = sizeof(uint64_t) + sizeof(uint32_t) * 4;
+                r->_blocks.reserve((size_t)f.block_count);
+                for (uint64_t i = 0; i < f.block_count; i++)
+                {
+                    if (p + handle_bytes > end)
+                        return ERR_CORRUPTION;
+
+                    block_handle h;
+                    h.offset = get_fixed<uint64_t>(p); p += sizeof(uint64_t);
+                    h.size = get_fixed<uint32_t>(p); p += sizeof(uint32_t);
+                    h.crc = get_fixed<uint32_t>(p); p += sizeof(uint32_t);
+                    h.count = get_fixed<uint32_t>(p); p += sizeof(uint32_t);
+                    uint32_t klen = get_fixed<uint32_t>(p); p += sizeof(uint32_t);
+                    if (p + klen > end || h.offset + h.size > f.index_offset)
+                        return ERR_CORRUPTION;
+
+                    h.first_key = kv_slice(p, klen);
+                    p += klen;
+                    r->_blocks.push_back(h);
+                }
+
+                r->_verified.reset(new std::atomic<uint8_t>[r->_blocks.size() + 1]);
+                for (size_t i = 0; i < r->_blocks.size(); i++)
+                    r->_verified[i].store(0);
+
+                reader = std::move(r);
+                return ERR_OK;
+            }
+
+            kv_checkpoint_reader::kv_checkpoint_reader() : _corrupted(false)
+            {
+                memset(&_footer, 0, sizeof(_footer));
+            }
+
+            kv_checkpoint_reader::~kv_checkpoint_reader()
+            {
+            }
+
+            const char* kv_checkpoint_reader::block_data(size_t block) const
+            {
+                const block_handle& h = _blocks[block];
+                const char* data = _file->data() + h.offset;
+
+                if (_verified[block].load(std::memory_order_acquire) == 0)
+                {
+                    uint32_t crc = dsn_crc32_compute(data, h.size, 0);
+                    if (crc != h.crc)
+                    {
+                        derror("checkpoint %s is corrupted at block %d (offset %" PRIu64 ")",
+                            _path.c_str(), (int)block, h.offset);
+                        _corrupted = true;
+                        return nullptr;
+                    }
+                    _verified[block].store(1, std::memory_order_release);
+                }
+                return data;
+            }
+
+            ::dsn::error_code kv_checkpoint_reader::verify() const
+            {
+                for (size_t i = 0; i < _blocks.size(); i++)
+                {
+                    if (block_data(i) == nullptr)
+                        return ERR_CORRUPTION;
+                }
+                return ERR_OK;
+            }
+
+            size_t kv_checkpoint_reader::find_block(const kv_slice& key) const
+            {
+                // last block whose first key <= key
+                size_t lo = 0, hi = _blocks.size();
+                while (lo < hi)
+                {
+                    size_t mid = lo + (hi - lo) / 2;
+                    if (key < _blocks[mid].first_key)
+                        hi = mid;
+                    else
+                        lo = mid + 1;
+                }
+                return lo == 0 ? 0 : lo - 1;
+            }
+
+            bool kv_checkpoint_reader::get(const kv_slice& key, /*out*/ kv_slice& value) const
+            {
+                if (_blocks.empty() || key < _blocks[0].first_key)
+                    return false;
+
+                size_t b = find_block(key);
+                iterator it = block_begin(b);
+                for (; it.valid() && it.block() == b; it.next())
+                {
+                    int c = it.key().compare(key);
+                    if (c == 0)
+                    {
+                        value = it.value();
+                        return true;
+                    }
+                    else if (c > 0)
+                        break;
+                }
+                return false;
+            }
+
+            kv_checkpoint_reader::iterator kv_checkpoint_reader::begin() const
+            {
+                return block_begin(0);
+            }
+
+            kv_checkpoint_reader::iterator kv_checkpoint_reader::block_begin(size_t block) const
+            {
+                iterator it(this);
+                it.load_block(block);
+                return it;
+            }
+
+            kv_checkpoint_reader::iterator kv_checkpoint_reader::seek(const kv_slice& key) const
+            {
+                iterator it = block_begin(_blocks.empty() ? 0 : find_block(key));
+                while (it.valid() && it.key() < key)
+                    it.next();
+                return it;
+            }
+
+            void kv_checkpoint_reader::iterator::load_block(size_t block)
+            {
+                _block = block;
+                if (!valid())
+                    return;
+
+                _pos = _reader->block_data(block);
+                if (_pos == nullptr)
+                {
+                    // the rest cannot be trusted, see corrupted()
+                    _block = _reader->_blocks.size();
+                    return;
+                }
+                _end = _pos + _reader->_blocks[block].size;
+                decode();
+            }
+
+            void kv_checkpoint_reader::iterator::decode()
+            {
+                // the block is checksum verified, so the lengths are trusted
+                uint32_t klen = get_fixed<uint32_t>(_pos);
+                _key = kv_slice(_pos + sizeof(uint32_t), klen);
+                const char* v = _pos + sizeof(uint32_t) + klen;
+                uint32_t vlen = get_fixed<uint32_t>(v);
+                _value = kv_slice(v + sizeof(uint32_t), vlen);
+                _pos = v + sizeof(uint32_t) + vlen;
+            }
+
+            void kv_checkpoint_reader::iterator::next()
+            {
+                if (_pos < _end)
+                    decode();
+                else
+                    load_block(_block + 1);
+            }
+        }
+    }
+}
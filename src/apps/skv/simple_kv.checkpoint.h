@@ -0,0 +1,186 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     sorted, block indexed checkpoint file of simple_kv, which is served by mmap
+ *
+ *     +-------------+-----+-------------+-------+--------+
+ *     | data block0 | ... | data blockN | index | footer |
+ *     +-------------+-----+-------------+-------+--------+
+ *
+ *     data block: sorted records of [u32 key_len][key][u32 value_len][value],
+ *                 about block_bytes each
+ *     index:      per block [u64 offset][u32 size][u32 crc][u32 count][u32 key_len][first key]
+ *     footer:     fixed size, see kv_checkpoint_footer, the crc of the index is
+ *                 checked on open while that of a data block is checked on first touch
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include "simple_kv.store.h"
+# include <memory>
+# include <fstream>
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            # pragma pack(push, 4)
+            struct kv_checkpoint_footer
+            {
+                uint64_t index_offset;
+                uint32_t index_size;
+                uint32_t index_crc;
+                uint64_t block_count;
+                uint64_t record_count;
+                int64_t  decree;
+                uint32_t version;
+                uint32_t footer_crc; // of all fields above
+                uint64_t magic;
+            };
+            # pragma pack(pop)
+
+            const uint64_t KV_CHECKPOINT_MAGIC = 0x54504b43564b53ULL; // "SKVCKPT"
+            const uint32_t KV_CHECKPOINT_VERSION = 1;
+
+            class kv_checkpoint_writer
+            {
+            public:
+                explicit kv_checkpoint_writer(const std::string& path, uint32_t block_bytes = 64 * 1024);
+                ~kv_checkpoint_writer();
+
+                ::dsn::error_code open();
+
+                // keys must be added in strictly increasing order
+                void add(const kv_slice& key, const kv_slice& value);
+
+                ::dsn::error_code finish(int64_t decree);
+
+                uint64_t record_count() const { return _record_count; }
+
+            private:
+                void flush_block();
+
+            private:
+                std::string   _path;
+                uint32_t      _block_bytes;
+                std::ofstream _os;
+                uint64_t      _offset;
+
+                std::string   _block;
+                uint32_t      _block_records;
+                std::string   _block_first_key;
+                std::string   _index;
+                uint64_t      _block_count;
+                uint64_t      _record_count;
+            };
+
+            class kv_mapped_file;
+
+            class kv_checkpoint_reader
+            {
+            public:
+                // ERR_INVALID_DATA when it is not a checkpoint of this format (e.g., the old
+                // record stream), ERR_CORRUPTION when the footer or the index is damaged
+                static ::dsn::error_code open(const std::string& path, /*out*/ std::shared_ptr<kv_checkpoint_reader>& reader);
+
+                ~kv_checkpoint_reader();
+
+                const std::string& path() const { return _path; }
+                int64_t  decree() const { return _footer.decree; }
+                uint64_t record_count() const { return _footer.record_count; }
+                size_t   block_count() const { return _blocks.size(); }
+
+                // the value points into the mapped file and lives as long as the reader
+                bool get(const kv_slice& key, /*out*/ kv_slice& value) const;
+
+                //
+                // a data block whose checksum mismatches is seen as the end of the
+                // records, which marks the reader corrupted; verify() checks all the
+                // blocks up front and returns ERR_CORRUPTION when any is damaged
+                //
+                bool corrupted() const { return _corrupted.load(); }
+                ::dsn::error_code verify() const;
+
+                class iterator
+                {
+                public:
+                    bool valid() const { return _block < _reader->_blocks.size(); }
+                    const kv_slice& key() const { return _key; }
+                    const kv_slice& value() const { return _value; }
+                    size_t block() const { return _block; }
+                    void next();
+
+                private:
+                    friend class kv_checkpoint_reader;
+                    iterator(const kv_checkpoint_reader* reader) : _reader(reader), _block(0), _pos(nullptr), _end(nullptr) {}
+                    void load_block(size_t block);
+                    void decode();
+
+                    const kv_checkpoint_reader* _reader;
+                    size_t      _block;
+                    const char* _pos;
+                    const char* _end;
+                    kv_slice    _key;
+                    kv_slice    _value;
+                };
+
+                iterator begin() const;
+                iterator block_begin(size_t block) const;
+                // first record whose key is not less than the given one
+                iterator seek(const kv_slice& key) const;
+
+            private:
+                struct block_handle
+                {
+                    uint64_t offset;
+                    uint32_t size;
+                    uint32_t crc;
+                    uint32_t count;
+                    kv_slice first_key;
+                };
+
+                kv_checkpoint_reader();
+                size_t find_block(const kv_slice& key) const; // block that may contain key
+                const char* block_data(size_t block) const;   // checksum verified, nullptr when it mismatches
+
+            private:
+                std::string                     _path;
+                std::unique_ptr<kv_mapped_file> _file;
+                kv_checkpoint_footer            _footer;
+                std::vector<block_handle>       _blocks;
+                // 0: not verified yet, 1: verified
+                std::unique_ptr<std::atomic<uint8_t>[]> _verified;
+                mutable std::atomic<bool>       _corrupted;
+            };
+        }
+    }
+}
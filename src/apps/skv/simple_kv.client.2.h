@@ -22,7 +22,6 @@ public:
     std::pair< ::dsn::error_code, std::string> read_sync(
         const std::string& key, 
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
-        int hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -33,7 +32,7 @@ public:
                 key,
                 nullptr,
                 empty_callback,
-                hash,
+                simple_kv_key_hash(key),
                 timeout,
                 0
                 )
@@ -47,7 +46,6 @@ public:
         TCallback&& callback,
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
         int reply_thread_hash = 0,
-        uint64_t hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -57,7 +55,7 @@ public:
                     key, 
                     this,
                     std::forward<TCallback>(callback),
-                    hash, 
+                    simple_kv_key_hash(key),
                     timeout, 
                     reply_thread_hash
                     );
@@ -68,7 +66,6 @@ public:
     std::pair< ::dsn::error_code, int32_t> write_sync(
         const kv_pair& pr, 
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
-        int hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -79,7 +76,7 @@ public:
                 pr,
                 nullptr,
                 empty_callback,
-                hash,
+                simple_kv_key_hash(pr.key),
                 timeout,
                 0
                 )
@@ -93,7 +90,6 @@ public:
         TCallback&& callback,
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
         int reply_thread_hash = 0,
-        uint64_t hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -103,7 +99,7 @@ public:
                     pr, 
                     this,
                     std::forward<TCallback>(callback),
-                    hash, 
+                    simple_kv_key_hash(pr.key),
                     timeout, 
                     reply_thread_hash
                     );
@@ -114,7 +110,6 @@ public:
     std::pair< ::dsn::error_code, int32_t> append_sync(
         const kv_pair& pr, 
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
-        int hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -125,7 +120,7 @@ public:
                 pr,
                 nullptr,
                 empty_callback,
-                hash,
+                simple_kv_key_hash(pr.key),
                 timeout,
                 0
                 )
@@ -139,7 +134,6 @@ public:
         TCallback&& callback,
         std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
         int reply_thread_hash = 0,
-        uint64_t hash = 0,
         dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
         )
     {
@@ -149,6 +143,52 @@ public:
                     pr, 
                     this,
                     std::forward<TCallback>(callback),
+                    simple_kv_key_hash(pr.key),
+                    timeout, 
+                    reply_thread_hash
+                    );
+    }
+
+    // ---------- call RPC_SIMPLE_KV_SIMPLE_KV_SCAN ------------
+    // - synchronous 
+    std::pair< ::dsn::error_code, scan_response> scan_sync(
+        const scan_request& req, 
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0), 
+        int hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::wait_and_unwrap<scan_response>(
+            ::dsn::rpc::call(
+                server_addr.unwrap_or(_server),
+                RPC_SIMPLE_KV_SIMPLE_KV_SCAN,
+                req,
+                nullptr,
+                empty_callback,
+                hash,
+                timeout,
+                0
+                )
+            );
+    }
+    
+    // - asynchronous with on-stack scan_request and scan_response  
+    template<typename TCallback>
+    ::dsn::task_ptr scan(
+        const scan_request& req, 
+        TCallback&& callback,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+        int reply_thread_hash = 0,
+        uint64_t hash = 0,
+        dsn::optional< ::dsn::rpc_address> server_addr = dsn::none
+        )
+    {
+        return ::dsn::rpc::call(
+                    server_addr.unwrap_or(_server), 
+                    RPC_SIMPLE_KV_SIMPLE_KV_SCAN, 
+                    req, 
+                    this,
+                    std::forward<TCallback>(callback),
                     hash, 
                     timeout, 
                     reply_thread_hash
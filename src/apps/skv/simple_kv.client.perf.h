@@ -78,7 +78,7 @@ public:
             {
                 end_send_one(context, err);
             },
-            _timeout, 0, rs
+            _timeout
             );
     }
 
@@ -96,7 +96,7 @@ public:
             {
                 end_send_one(context, err);
             },
-            _timeout, 0, rs
+            _timeout
             );
     }
 
@@ -113,7 +113,7 @@ public:
             {
                 end_send_one(context, err);
             },
-            _timeout, 0, rs
+            _timeout
             );
     }
 
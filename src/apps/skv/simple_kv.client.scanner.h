@@ -0,0 +1,192 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/*
+ * Description:
+ *     client side scan over all partitions of a simple_kv app
+ *
+ *     keys are spread over partitions by the partition hash the writer chooses, so
+ *     every partition holds an ordered subset of the range; the scanner pages through
+ *     all partitions in parallel, prefetches the next page of a partition while the
+ *     current one is consumed, and merges the pages into one stream in key order
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+# include "simple_kv.client.2.h"
+# include <queue>
+# include <functional>
+
+namespace dsn { namespace replication { namespace application {
+
+class simple_kv_scanner
+{
+public:
+    // partition i is reached with partition hash i, and returns only the keys whose
+    // hash % partition_count is i, also when a split child not ready yet is served by
+    // its parent
+    simple_kv_scanner(
+        simple_kv_client2* client,
+        int partition_count,
+        const scan_request& req,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0)
+        )
+        : _client(client), _timeout(timeout), _partitions(partition_count), _started(false)
+    {
+        for (int i = 0; i < partition_count; i++)
+        {
+            partition& p = _partitions[i];
+            p.index = i;
+            p.req = req;
+            p.req.context.clear();
+            p.req.partition_count = partition_count;
+            p.pos = 0;
+            fetch(p);
+        }
+    }
+
+    ~simple_kv_scanner()
+    {
+        for (auto& p : _partitions)
+        {
+            if (p.pending != nullptr)
+                p.pending->cancel(true);
+        }
+    }
+
+    //
+    // the next pair in key order, false when all partitions are done or any page
+    // fails (see error()); it waits for the pages, so never call it in the threads
+    // where the replies are handled
+    //
+    bool next(/*out*/ kv_pair& pr)
+    {
+        if (!_started)
+        {
+            _started = true;
+            for (auto& p : _partitions)
+            {
+                if (ready(p))
+                    _heap.push(&p);
+            }
+        }
+
+        if (_error != ERR_OK || _heap.empty())
+            return false;
+
+        partition* p = _heap.top();
+        _heap.pop();
+        pr = std::move(p->page.kvs[p->pos++]);
+
+        if (ready(*p))
+            _heap.push(p);
+        return true;
+    }
+
+    ::dsn::error_code error() const { return _error; }
+
+private:
+    struct partition
+    {
+        int               index;
+        scan_request      req;          // context is of the page fetched last
+        scan_response     page;         // being consumed
+        size_t            pos;
+        ::dsn::task_ptr   pending;      // fetching the next page
+        ::dsn::error_code pending_err;
+        scan_response     pending_page;
+    };
+
+    struct key_greater
+    {
+        bool operator()(const partition* l, const partition* r) const
+        {
+            return r->page.kvs[r->pos].key < l->page.kvs[l->pos].key;
+        }
+    };
+
+    void fetch(partition& p)
+    {
+        partition* pp = &p;
+        p.pending = _client->scan(
+            p.req,
+            [pp](::dsn::error_code err, scan_response&& resp)
+            {
+                pp->pending_err = err;
+                if (err == ERR_OK)
+                    pp->pending_page = std::move(resp);
+            },
+            _timeout,
+            0,
+            static_cast<uint64_t>(p.index)
+            );
+    }
+
+    // make sure there is a pair at pos of the partition's page, false when it is done
+    bool ready(partition& p)
+    {
+        while (p.pos >= p.page.kvs.size())
+        {
+            if (p.pending == nullptr)
+                return false;
+
+            p.pending->wait();
+            p.pending = nullptr;
+
+            if (p.pending_err == ERR_OK && p.pending_page.error != 0)
+                p.pending_err = ERR_INVALID_STATE;
+            if (p.pending_err != ERR_OK)
+            {
+                derror("scan partition %d failed, err = %s", p.index, p.pending_err.to_string());
+                _error = p.pending_err;
+                return false;
+            }
+
+            p.page = std::move(p.pending_page);
+            p.pos = 0;
+            if (!p.page.complete)
+            {
+                p.req.context = p.page.context;
+                fetch(p);
+            }
+        }
+        return true;
+    }
+
+private:
+    simple_kv_client2*        _client;
+    std::chrono::milliseconds _timeout;
+    std::vector<partition>    _partitions;
+    bool                      _started;
+    ::dsn::error_code         _error;
+    std::priority_queue<partition*, std::vector<partition*>, key_greater> _heap;
+};
+
+} } }
@@ -43,6 +43,26 @@ namespace dsn { namespace replication { namespace application {
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_READ, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    DEFINE_TASK_CODE_RPC(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
     // test timer task code
     DEFINE_TASK_CODE(LPC_SIMPLE_KV_TEST_TIMER, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+    // background checkpoint, runs in the long task pool of the replication layer
+    DEFINE_THREAD_POOL_CODE(THREAD_POOL_REPLICATION_LONG)
+    DEFINE_TASK_CODE(LPC_SIMPLE_KV_CHECKPOINT, TASK_PRIORITY_LOW, THREAD_POOL_REPLICATION_LONG)
+    DEFINE_TASK_CODE(LPC_SIMPLE_KV_LOAD_CHECKPOINT, TASK_PRIORITY_LOW, THREAD_POOL_REPLICATION_LONG)
+    DEFINE_TASK_CODE(LPC_SIMPLE_KV_PURGE, TASK_PRIORITY_LOW, THREAD_POOL_REPLICATION_LONG)
+
+    //
+    // the partition hash of a key, requests on a key are always routed with it, so that
+    // a split can tell which half each pair goes to from the key alone
+    //
+    inline uint64_t simple_kv_key_hash(const char* key, size_t size)
+    {
+        return dsn_crc64_compute(key, size, 0);
+    }
+
+    inline uint64_t simple_kv_key_hash(const std::string& key)
+    {
+        return simple_kv_key_hash(key.c_str(), key.length());
+    }
 } } } 
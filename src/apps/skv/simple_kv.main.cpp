@@ -36,6 +36,8 @@
 // apps
 # include "simple_kv.app.example.h"
 # include "simple_kv.server.impl.h"
+# include "simple_kv.store.bench.h"
+# include "simple_kv.bulk_load.builder.h"
 
 // framework specific tools
 # include <dsn/dist/replication/replication.global_check.h>
@@ -47,6 +49,8 @@ static void dsn_app_registration_simple_kv()
     
     dsn::register_app< ::dsn::replication::application::simple_kv_client_app>("client");
     dsn::register_app< ::dsn::replication::application::simple_kv_perf_test_client_app>("client.perf.test");
+    dsn::register_app< ::dsn::replication::application::simple_kv_store_bench_app>("store.bench");
+    dsn::register_app< ::dsn::replication::application::simple_kv_bulk_load_builder_app>("bulk_load.builder");
 
     //dsn::replication::install_checkers();
 }
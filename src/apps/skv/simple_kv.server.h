@@ -75,6 +75,16 @@ protected:
         int32_t resp;
         reply(resp);
     }
+    // RPC_SIMPLE_KV_SIMPLE_KV_SCAN
+    // the handler marshalls the scan_response itself, so that a page can be
+    // written straight from the storage
+    virtual void on_scan(dsn_message_t request)
+    {
+        std::cout << "... exec RPC_SIMPLE_KV_SIMPLE_KV_SCAN ... (not implemented) " << std::endl;
+        scan_response resp;
+        resp.complete = true;
+        reply(request, resp);
+    }
     
 public:
     void open_service(dsn_gpid gpid)
@@ -82,6 +92,7 @@ public:
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_READ, "read", &simple_kv_service::on_read, gpid);
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, "write", &simple_kv_service::on_write, gpid);
         this->register_async_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, "append", &simple_kv_service::on_append, gpid);
+        this->register_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, "scan", &simple_kv_service::on_scan, gpid);
     }
 
     void close_service(dsn_gpid gpid)
@@ -89,6 +100,7 @@ public:
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_READ, gpid);
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_WRITE, gpid);
         this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_APPEND, gpid);
+        this->unregister_rpc_handler(RPC_SIMPLE_KV_SIMPLE_KV_SCAN, gpid);
     }
 };
 
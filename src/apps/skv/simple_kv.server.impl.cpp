@@ -34,8 +34,10 @@
  */
 
 #include "simple_kv.server.impl.h"
+#include "simple_kv.checkpoint.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -53,33 +55,175 @@ namespace dsn {
             {
                 _test_file_learning = false;
                 _last_durable_decree = 0;
+                _checkpoint_running = false;
+                _checkpoint_min_decree_gap = 0;
+                _checkpoint_reserve_count = 2;
+                _delta_checkpoint_enabled = true;
+                _delta_max_count = 8;
+                _last_checkpoint_seq = 0;
+                _delta_count = 0;
+                _force_full_checkpoint = false;
+                _scan_max_page_count = 1000;
+                _scan_max_page_bytes = 1024 * 1024;
+                _load_stopped = false;
+                _partition_count = 0;
+                _purge_pending = false;
             }
 
             // RPC_SIMPLE_KV_READ
             void simple_kv_service_impl::on_read(const std::string& key, ::dsn::rpc_replier<std::string>& reply)
             {
                 std::string r;
+                _store.get(key, r);
+
+                dinfo("read %s", r.c_str());
+                reply(r);
+            }
+
+            //
+            // a scan_response whose pairs point into the store, it is marshalled exactly
+            // as scan_response so that keys and values are copied only once, into the message
+            //
+            struct kv_scan_page
+            {
+                std::vector<std::pair<kv_slice, kv_slice>> kvs;
+                kv_slice context;
+                bool     complete;
+
+                kv_scan_page() : complete(false) {}
+
+                uint32_t read(::apache::thrift::protocol::TProtocol* iprot)
                 {
-                    zauto_lock l(_lock);
+                    dassert(false, "kv_scan_page is never read, read it as scan_response");
+                    return 0;
+                }
+
+                uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+            };
+
+            GENERATED_TYPE_SERIALIZATION(kv_scan_page, THRIFT)
+
+            static uint32_t write_slice(
+                ::apache::thrift::protocol::TProtocol* oprot,
+                ::apache::thrift::protocol::TBinaryProtocol* binary_proto,
+                const kv_slice& s)
+            {
+                if (binary_proto != nullptr)
+                    return binary_proto->writeString< ::dsn::char_ptr>(::dsn::char_ptr(s.data, static_cast<int>(s.size)));
+                else
+                    return oprot->writeString(s.to_string());
+            }
+
+            uint32_t kv_scan_page::write(::apache::thrift::protocol::TProtocol* oprot) const
+            {
+                using namespace ::apache::thrift::protocol;
+                TBinaryProtocol* binary_proto = dynamic_cast<TBinaryProtocol*>(oprot);
+
+                uint32_t xfer = 0;
+                xfer += oprot->writeStructBegin("scan_response");
+
+                xfer += oprot->writeFieldBegin("error", T_I32, 1);
+                xfer += oprot->writeI32(0);
+                xfer += oprot->writeFieldEnd();
+
+                xfer += oprot->writeFieldBegin("kvs", T_LIST, 2);
+                xfer += oprot->writeListBegin(T_STRUCT, static_cast<uint32_t>(kvs.size()));
+                for (auto& kv : kvs)
+                {
+                    xfer += oprot->writeStructBegin("kv_pair");
+                    xfer += oprot->writeFieldBegin("key", T_STRING, 1);
+                    xfer += write_slice(oprot, binary_proto, kv.first);
+                    xfer += oprot->writeFieldEnd();
+                    xfer += oprot->writeFieldBegin("value", T_STRING, 2);
+                    xfer += write_slice(oprot, binary_proto, kv.second);
+                    xfer += oprot->writeFieldEnd();
+                    xfer += oprot->writeFieldStop();
+                    xfer += oprot->writeStructEnd();
+                }
+                xfer += oprot->writeListEnd();
+                xfer += oprot->writeFieldEnd();
+
+                xfer += oprot->writeFieldBegin("context", T_STRING, 3);
+                xfer += write_slice(oprot, binary_proto, context);
+                xfer += oprot->writeFieldEnd();
+
+                xfer += oprot->writeFieldBegin("complete", T_BOOL, 4);
+                xfer += oprot->writeBool(complete);
+                xfer += oprot->writeFieldEnd();
+
+                xfer += oprot->writeFieldStop();
+                xfer += oprot->writeStructEnd();
+                return xfer;
+            }
+
+            // RPC_SIMPLE_KV_SCAN
+            void simple_kv_service_impl::on_scan(dsn_message_t request)
+            {
+                scan_request req;
+                ::dsn::unmarshall(request, req);
+
+                int limit = (req.limit > 0 && req.limit < _scan_max_page_count) ? req.limit : _scan_max_page_count;
+
+                // a page resumes right after the last key of the former one,
+                // keys with the prefix are all in [prefix, ...)
+                bool inclusive = req.context.empty();
+                const std::string* start = inclusive ? &req.start_key : &req.context;
+                if (inclusive && !req.prefix.empty() && *start < req.prefix)
+                    start = &req.prefix;
+
+                // while a split is going on, the parent also serves the scan of the hidden
+                // child, which must only see the child's half
+                uint64_t scan_count = req.partition_count > 0 ? static_cast<uint64_t>(req.partition_count) : 0;
+                uint64_t scan_index = scan_count > 0 ? dsn_msg_get_partition_hash(request) % scan_count : 0;
+
+                kv_slice stop_key(req.stop_key);
+                kv_slice prefix(req.prefix);
+                kv_scan_page page;
+                int bytes = 0;
+                bool more = false;
+                dsn_message_t resp = dsn_msg_create_response(request);
+
+                _store.scan_range(
+                    *start,
+                    inclusive,
+                    [&](const kv_slice& k, const kv_slice& v)
+                    {
+                        if (stop_key.size > 0 && !(k < stop_key))
+                            return false;
+                        if (prefix.size > 0 && (k.size < prefix.size || memcmp(k.data, prefix.data, prefix.size) != 0))
+                            return false;
+                        if (scan_count > 0 && simple_kv_key_hash(k.data, k.size) % scan_count != scan_index)
+                            return true;
+
+                        if ((int)page.kvs.size() >= limit || bytes >= _scan_max_page_bytes)
+                        {
+                            more = true;
+                            return false;
+                        }
 
-                    auto it = _store.find(key);
-                    if (it != _store.end())
+                        page.kvs.push_back(std::make_pair(k, v));
+                        bytes += (int)(k.size + v.size);
+                        return true;
+                    },
+                    [&]()
                     {
-                        r = it->second;
+                        // values are only valid till the store is unlocked
+                        page.complete = !more;
+                        if (!page.kvs.empty())
+                            page.context = page.kvs.back().first;
+                        ::dsn::marshall(resp, page);
                     }
-                }
-             
-                dinfo("read %s", r.c_str());
-                reply(r);
+                    );
+
+                dinfo("scan from %s returns %d pairs, %d bytes, complete = %s",
+                    start->c_str(), (int)page.kvs.size(), bytes, page.complete ? "true" : "false");
+                dsn_rpc_reply(resp);
             }
 
             // RPC_SIMPLE_KV_WRITE
             void simple_kv_service_impl::on_write(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply)
             {
-                {
-                    zauto_lock l(_lock);
-                    _store[pr.key] = pr.value;
-                }                
+                _store.put(pr.key, pr.value);
 
                 dinfo("write %s", pr.key.c_str());
                 reply(0);
@@ -88,27 +232,99 @@ namespace dsn {
             // RPC_SIMPLE_KV_APPEND
             void simple_kv_service_impl::on_append(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply)
             {
+                _store.append(pr.key, pr.value);
+
+                dinfo("append %s", pr.key.c_str());
+                reply(0);
+            }
+
+            // all writes of one mutation, decoded together and applied as one store batch
+            void simple_kv_service_impl::on_batched_write_requests(int64_t decree, dsn_message_t* requests, int count)
+            {
+                if (count == 0)
+                    return;
+
+                std::vector<kv_pair> pairs(count);
+                std::vector<kv_update> updates(count);
+                for (int i = 0; i < count; i++)
                 {
-                    zauto_lock l(_lock);
-                    auto it = _store.find(pr.key);
-                    if (it != _store.end())
-                        it->second.append(pr.value);
+                    dsn_task_code_t code = dsn_msg_task_code(requests[i]);
+                    ::dsn::unmarshall(requests[i], pairs[i]);
+
+                    if (code == RPC_SIMPLE_KV_SIMPLE_KV_WRITE)
+                        updates[i].type = kv_update::PUT;
                     else
-                        _store[pr.key] = pr.value;
+                    {
+                        dassert(code == RPC_SIMPLE_KV_SIMPLE_KV_APPEND,
+                            "invalid write request %s", dsn_task_code_to_string(code));
+                        updates[i].type = kv_update::APPEND;
+                    }
+                    updates[i].key = pairs[i].key;
+                    updates[i].value = pairs[i].value;
                 }
 
-                dinfo("append %s", pr.key.c_str());
-                reply(0);
+                _store.write_batch(&updates[0], count);
+
+                for (int i = 0; i < count; i++)
+                {
+                    ::dsn::rpc_replier<int32_t> reply(dsn_msg_create_response(requests[i]));
+                    reply(0);
+                }
+
+                dinfo("batched write %d requests at decree %" PRId64, count, decree);
             }
             
             ::dsn::error_code simple_kv_service_impl::start(int argc, char** argv)
             {
                 _data_dir = dsn_get_app_data_dir(get_gpid());
 
+                _checkpoint_min_decree_gap = (int64_t)dsn_config_get_value_uint64(
+                    "replication",
+                    "checkpoint_min_decree_gap",
+                    10000,
+                    "minimum decree gap that triggers checkpoint"
+                    );
+                _checkpoint_reserve_count = (int)dsn_config_get_value_uint64(
+                    "replication",
+                    "simple_kv_checkpoint_reserve_count",
+                    2,
+                    "how many latest checkpoints simple_kv keeps in its data dir, older ones are removed"
+                    );
+                if (_checkpoint_reserve_count < 1)
+                    _checkpoint_reserve_count = 1;
+                _scan_max_page_count = (int)dsn_config_get_value_uint64(
+                    "replication",
+                    "simple_kv_scan_max_page_count",
+                    1000,
+                    "max pairs in a page of simple_kv scan"
+                    );
+                _scan_max_page_bytes = (int)dsn_config_get_value_uint64(
+                    "replication",
+                    "simple_kv_scan_max_page_bytes",
+                    1024 * 1024,
+                    "max bytes of keys and values in a page of simple_kv scan"
+                    );
+                if (_scan_max_page_count < 1)
+                    _scan_max_page_count = 1;
+                _delta_checkpoint_enabled = dsn_config_get_value_bool(
+                    "replication",
+                    "simple_kv_delta_checkpoint_enabled",
+                    true,
+                    "whether simple_kv writes only the pairs changed since the last checkpoint"
+                    );
+                _delta_max_count = (int)dsn_config_get_value_uint64(
+                    "replication",
+                    "simple_kv_delta_max_count",
+                    8,
+                    "how many deltas simple_kv chains on a full checkpoint before writing a new full one"
+                    );
+
                 {
                     zauto_lock l(_lock);
                     set_last_durable_decree(0);
-                    recover();
+                    auto err = recover();
+                    if (err != ERR_OK)
+                        return err;
                 }
 
                 open_service(get_gpid());
@@ -119,6 +335,8 @@ namespace dsn {
             {
                 close_service(get_gpid());
 
+                wait_background_tasks();
+
                 {
                     zauto_lock l(_lock);
                     if (clear_state)
@@ -136,59 +354,202 @@ namespace dsn {
             }
 
             // checkpoint related
-            void simple_kv_service_impl::recover()
+
+            //
+            // checkpoints in the data dir are either full ones named checkpoint.<decree>, or
+            // deltas named delta.<from>.<to> with the latest values of the keys written in
+            // (from, to], which are chained on a full checkpoint of decree <from> or on the
+            // delta ending at <from>
+            //
+            struct kv_checkpoint_file
             {
-                zauto_lock l(_lock);
+                bool        full;
+                int64_t     from; // 0 for full checkpoints
+                int64_t     to;
+                std::string path;
+            };
 
-                _store.clear();
+            static bool parse_checkpoint_file(const std::string& path, /*out*/ kv_checkpoint_file& f)
+            {
+                auto&& s = utils::filesystem::get_file_name(path);
+                if (s.substr(0, strlen("checkpoint.")) == std::string("checkpoint."))
+                {
+                    f.full = true;
+                    f.from = 0;
+                    f.to = static_cast<int64_t>(atoll(s.substr(strlen("checkpoint.")).c_str()));
+                }
+                else if (s.substr(0, strlen("delta.")) == std::string("delta."))
+                {
+                    f.full = false;
+                    if (2 != sscanf(s.c_str() + strlen("delta."), "%" SCNd64 ".%" SCNd64, &f.from, &f.to))
+                        return false;
+                }
+                else
+                    return false;
 
-                int64_t maxVersion = 0;
-                std::string name;
+                f.path = path;
+                return f.to > 0 && f.from >= 0 && f.from < f.to;
+            }
 
+            static void list_checkpoint_files(const char* dir, /*out*/ std::vector<kv_checkpoint_file>& files)
+            {
                 std::vector<std::string> sub_list;
-                std::string path = data_dir();
-                if (!dsn::utils::filesystem::get_subfiles(path, sub_list, false))
+                if (!dsn::utils::filesystem::get_subfiles(dir, sub_list, false))
                 {
-                    dassert(false, "Fail to get subfiles in %s.", path.c_str());
+                    dassert(false, "Fail to get subfiles in %s.", dir);
                 }
+
                 for (auto& fpath : sub_list)
                 {
-                    auto&& s = dsn::utils::filesystem::get_file_name(fpath);
-                    if (s.substr(0, strlen("checkpoint.")) != std::string("checkpoint."))
+                    kv_checkpoint_file f;
+                    if (parse_checkpoint_file(utils::filesystem::path_combine(dir, utils::filesystem::get_file_name(fpath)), f))
+                        files.push_back(f);
+                }
+            }
+
+            //
+            // the longest checkpoint chain not beyond max_decree, i.e., a full checkpoint
+            // followed by the deltas chained on it, empty when there is no full checkpoint
+            //
+            static void get_checkpoint_chain(
+                const std::vector<kv_checkpoint_file>& files,
+                int64_t max_decree,
+                /*out*/ std::vector<kv_checkpoint_file>& chain
+                )
+            {
+                chain.clear();
+                for (auto& f : files)
+                {
+                    if (!f.full || f.to > max_decree)
                         continue;
 
-                    int64_t version = static_cast<int64_t>(atoll(s.substr(strlen("checkpoint.")).c_str()));
-                    if (version > maxVersion)
+                    std::vector<kv_checkpoint_file> c;
+                    c.push_back(f);
+                    while (true)
                     {
-                        maxVersion = version;
-                        name = std::string(data_dir()) + "/" + s;
+                        const kv_checkpoint_file* next = nullptr;
+                        for (auto& d : files)
+                        {
+                            if (!d.full && d.from == c.back().to && d.to <= max_decree
+                                && (next == nullptr || d.to > next->to))
+                                next = &d;
+                        }
+                        if (next == nullptr)
+                            break;
+                        c.push_back(*next);
                     }
+
+                    if (chain.empty() || c.back().to > chain.back().to
+                        || (c.back().to == chain.back().to && c.size() < chain.size()))
+                        chain.swap(c);
                 }
-                sub_list.clear();
+            }
 
-                if (maxVersion > 0)
+            ::dsn::error_code simple_kv_service_impl::recover()
+            {
+                wait_background_tasks();
+
+                zauto_lock l(_lock);
+
+                _store.clear();
+                _last_checkpoint_seq = 0;
+                _delta_count = 0;
+                _force_full_checkpoint = false;
+
+                std::vector<kv_checkpoint_file> files, chain;
+                list_checkpoint_files(data_dir(), files);
+                get_checkpoint_chain(files, INT64_MAX, chain);
+                if (chain.empty())
+                    return ERR_OK;
+
+                auto err = recover(chain[0].path, chain[0].to);
+                if (err != ERR_OK)
+                    return err;
+                set_last_durable_decree(chain[0].to);
+
+                for (size_t i = 1; i < chain.size(); i++)
                 {
-                    recover(name, maxVersion);
-                    set_last_durable_decree(maxVersion);
+                    err = apply_delta(chain[i].path, true);
+                    if (err != ERR_OK)
+                    {
+                        // the state is still consistent at the end of the former one,
+                        // the rest is learned from others
+                        derror("%s: apply delta checkpoint %s failed, err = %s, stop at decree %" PRId64,
+                            data_dir(), chain[i].path.c_str(), err.to_string(), last_durable_decree());
+                        _force_full_checkpoint = true;
+                        break;
+                    }
+
+                    set_last_durable_decree(chain[i].to);
+                    _delta_count++;
                 }
+
+                ddebug("%s: recovered from %s and %d deltas, durable decree = %" PRId64,
+                    data_dir(), chain[0].path.c_str(), _delta_count, last_durable_decree());
+                return ERR_OK;
             }
 
-            void simple_kv_service_impl::recover(const std::string& name, int64_t version)
+            ::dsn::error_code simple_kv_service_impl::recover(const std::string& name, int64_t version)
             {
+                wait_background_tasks();
+
                 zauto_lock l(_lock);
 
+                std::shared_ptr<kv_checkpoint_reader> reader;
+                auto err = kv_checkpoint_reader::open(name, reader);
+                if (err == ERR_OK)
+                {
+                    // serve from the mapped file right away and load it into memory lazily
+                    _store.clear();
+                    _store.set_base(reader);
+                    _last_checkpoint_seq = 0;
+
+                    _load_stopped = false;
+                    _load_task = tasking::enqueue(
+                        LPC_SIMPLE_KV_LOAD_CHECKPOINT,
+                        this,
+                        [this]()
+                        {
+                            _store.load_base(_load_stopped);
+                        }
+                        );
+
+                    ddebug("%s: checkpoint %s opened, decree = %" PRId64 ", records = %" PRIu64 ", blocks = %d",
+                        data_dir(), name.c_str(), reader->decree(), reader->record_count(), (int)reader->block_count());
+                    return ERR_OK;
+                }
+
+                if (err != ERR_INVALID_DATA && err != ERR_FILE_OPERATION_FAILED)
+                {
+                    // the state is learned from others then
+                    derror("%s: checkpoint %s is corrupted, err = %s", data_dir(), name.c_str(), err.to_string());
+                    return err;
+                }
+
+                // checkpoints written by former versions are a plain record stream
                 std::ifstream is(name.c_str(), std::ios::binary);
                 if (!is.is_open())
-                    return;
+                {
+                    derror("%s: open checkpoint %s failed", data_dir(), name.c_str());
+                    return ERR_FILE_OPERATION_FAILED;
+                }
                 
                 _store.clear();
 
+                // pairs loaded with put() are seen as new writes, so no delta can follow
+                _last_checkpoint_seq = 0;
+                _force_full_checkpoint = true;
+
                 uint64_t count;
                 int magic;
                 
                 is.read((char*)&count, sizeof(count));
                 is.read((char*)&magic, sizeof(magic)); 
-                dassert(magic == 0xdeadbeef, "invalid checkpoint");
+                if (!is || magic != 0xdeadbeef)
+                {
+                    derror("%s: invalid checkpoint %s", data_dir(), name.c_str());
+                    return ERR_INVALID_DATA;
+                }
 
                 for (uint64_t i = 0; i < count; i++)
                 {
@@ -206,58 +567,351 @@ namespace dsn {
 
                     is.read((char*)&value[0], sz);
 
-                    _store[key] = value;
+                    if (_store.owns(key))
+                        _store.put(key, value);
                 }
                 is.close();
+                return ERR_OK;
+            }
+
+
+            //
+            // apply the pairs of a delta checkpoint, as part of the durable state when
+            // recovering, or as ordinary writes (to be covered by the next delta) when learning
+            //
+            ::dsn::error_code simple_kv_service_impl::apply_delta(const std::string& name, bool durable)
+            {
+                std::shared_ptr<kv_checkpoint_reader> reader;
+                auto err = kv_checkpoint_reader::open(name, reader);
+                if (err != ERR_OK)
+                    return err;
+
+                // checked up front so that a damaged delta is never applied in part
+                err = reader->verify();
+                if (err != ERR_OK)
+                    return err;
+
+                std::vector<kv_update> batch;
+                for (auto it = reader->begin(); it.valid(); it.next())
+                {
+                    if (!_store.owns(it.key()))
+                        continue;
+
+                    if (durable)
+                    {
+                        _store.put_durable(it.key(), it.value());
+                        continue;
+                    }
+
+                    kv_update u = { kv_update::PUT, it.key(), it.value() };
+                    batch.push_back(u);
+                    if (batch.size() >= 1024)
+                    {
+                        _store.write_batch(&batch[0], static_cast<int>(batch.size()));
+                        batch.clear();
+                    }
+                }
+
+                if (!batch.empty())
+                    _store.write_batch(&batch[0], static_cast<int>(batch.size()));
+
+                dinfo("%s: delta checkpoint %s applied, records = %" PRIu64,
+                    data_dir(), name.c_str(), reader->record_count());
+                return ERR_OK;
+            }
+
+            // under _lock
+            bool simple_kv_service_impl::need_full_checkpoint() const
+            {
+                return !_delta_checkpoint_enabled
+                    || _force_full_checkpoint
+                    || last_durable_decree() == 0
+                    || _delta_count >= _delta_max_count;
+            }
+
+            // under _lock
+            void simple_kv_service_impl::on_checkpoint_written(int64_t from, int64_t decree, uint64_t snapshot_seq)
+            {
+                set_last_durable_decree(decree);
+                _last_checkpoint_seq = snapshot_seq;
+
+                if (from == 0)
+                {
+                    _delta_count = 0;
+                    _force_full_checkpoint = false;
+                }
+                else
+                {
+                    _delta_count++;
+                }
+
+                gc_checkpoints();
             }
 
             ::dsn::error_code simple_kv_service_impl::sync_checkpoint(int64_t last_commit)
             {
-                char name[256];
-                sprintf(name, "%s/checkpoint.%" PRId64, data_dir(), last_commit);
+                wait_background_tasks();
 
                 zauto_lock l(_lock);
 
                 if (last_commit == last_durable_decree())
-                {
-                    dassert(utils::filesystem::file_exists(name), 
-                        "checkpoint file %s is missing!",
-                        name
-                        );
                     return ERR_OK;
+
+                int64_t from = need_full_checkpoint() ? 0 : last_durable_decree();
+
+                // readers still go on while the snapshot is dumped
+                bool ok = _store.take_snapshot();
+                dassert(ok, "snapshot is still held by a background checkpoint");
+                uint64_t seq = _store.snapshot_seq();
+
+                auto err = write_checkpoint(from, last_commit, _last_checkpoint_seq);
+                _store.release_snapshot();
+                try_purge();
+
+                if (err == ERR_OK)
+                {
+                    on_checkpoint_written(from, last_commit, seq);
                 }
+                return err;
+            }
 
-                std::ofstream os(name, std::ios::binary);
+            ::dsn::error_code simple_kv_service_impl::async_checkpoint(int64_t last_commit)
+            {
+                if (last_commit - last_durable_decree() < _checkpoint_min_decree_gap
+                    || last_commit <= last_durable_decree())
+                    return ERR_NO_NEED_OPERATE;
 
-                uint64_t count = (uint64_t)_store.size();
-                int magic = 0xdeadbeef;
-                
-                os.write((const char*)&count, (uint32_t)sizeof(count));
-                os.write((const char*)&magic, (uint32_t)sizeof(magic));
+                if (_checkpoint_running.exchange(true))
+                    return ERR_WRONG_TIMING;
+
+                int64_t from;
+                uint64_t since_seq;
+                {
+                    zauto_lock l(_lock);
+                    from = need_full_checkpoint() ? 0 : last_durable_decree();
+                    since_seq = _last_checkpoint_seq;
+                }
+
+                // the store is at last_commit now as writes are applied in this
+                // same replica thread, so the snapshot is exactly that decree
+                bool ok = _store.take_snapshot();
+                dassert(ok, "snapshot is held while no checkpoint is running");
+                uint64_t seq = _store.snapshot_seq();
+
+                _checkpoint_task = tasking::enqueue(
+                    LPC_SIMPLE_KV_CHECKPOINT,
+                    this,
+                    [this, from, last_commit, since_seq, seq]()
+                    {
+                        auto err = write_checkpoint(from, last_commit, since_seq);
+                        _store.release_snapshot();
+                        try_purge();
+
+                        if (err == ERR_OK)
+                        {
+                            zauto_lock l(_lock);
 
-                for (auto it = _store.begin(); it != _store.end(); ++it)
+                            // a delta is useless once the durable state is replaced (e.g., by copying)
+                            if (last_commit > last_durable_decree()
+                                && (from == 0 || from == last_durable_decree()))
+                            {
+                                on_checkpoint_written(from, last_commit, seq);
+                            }
+                        }
+
+                        ddebug("%s: async %s checkpoint at decree %" PRId64 " done, err = %s",
+                            data_dir(), from == 0 ? "full" : "delta", last_commit, err.to_string());
+                        _checkpoint_running = false;
+                    }
+                    );
+                return ERR_OK;
+            }
+
+            void simple_kv_service_impl::wait_background_tasks()
+            {
+                auto purger = _purge_task;
+                if (purger != nullptr)
                 {
-                    const std::string& k = it->first;
-                    uint32_t sz = (uint32_t)k.length();
+                    purger->cancel(true);
+                    _purge_task = nullptr;
+                }
 
-                    os.write((const char*)&sz, (uint32_t)sizeof(sz));
-                    os.write((const char*)&k[0], sz);
+                auto loader = _load_task;
+                if (loader != nullptr)
+                {
+                    _load_stopped = true;
+                    loader->cancel(true);
+                    _load_task = nullptr;
+                }
 
-                    const std::string& v = it->second;
-                    sz = (uint32_t)v.length();
+                auto tsk = _checkpoint_task;
+                if (tsk == nullptr)
+                    return;
 
-                    os.write((const char*)&sz, (uint32_t)sizeof(sz));
-                    os.write((const char*)&v[0], sz);
+                if (tsk->cancel(true))
+                {
+                    // never ran
+                    _store.release_snapshot();
+                    _checkpoint_running = false;
                 }
-                
-                os.close();
+                _checkpoint_task = nullptr;
+            }
+
+            // on the replica thread
+            void simple_kv_service_impl::set_partition_count(int partition_count)
+            {
+                _store.set_partition(get_gpid().u.partition_index, partition_count);
+                if (partition_count == _partition_count)
+                    return;
+
+                ddebug("%s: partition count is changed from %d to %d",
+                    data_dir(), _partition_count, partition_count);
+                _partition_count = partition_count;
+                if (partition_count == 0)
+                    return;
 
-                // TODO: gc checkpoints
-                set_last_durable_decree(last_commit);
+                {
+                    zauto_lock l(_lock);
+
+                    // the durable chain may still have the pairs of the other half
+                    _force_full_checkpoint = true;
+                }
+
+                _purge_pending = true;
+                _purge_task = tasking::enqueue(
+                    LPC_SIMPLE_KV_PURGE,
+                    this,
+                    [this]()
+                    {
+                        try_purge();
+                    }
+                    );
+            }
+
+            void simple_kv_service_impl::try_purge()
+            {
+                if (_purge_pending.load() && _store.purge_unowned())
+                    _purge_pending = false;
+            }
+
+            //
+            // dump the alive store snapshot as a full checkpoint of the given decree when
+            // from is 0, or else as a delta with the pairs written after the snapshot since_seq
+            //
+            ::dsn::error_code simple_kv_service_impl::write_checkpoint(int64_t from, int64_t decree, uint64_t since_seq)
+            {
+                char name[256], tmp_name[256];
+                if (from == 0)
+                {
+                    sprintf(name, "%s/checkpoint.%" PRId64, data_dir(), decree);
+                    sprintf(tmp_name, "%s/tmp.checkpoint.%" PRId64, data_dir(), decree);
+                }
+                else
+                {
+                    sprintf(name, "%s/delta.%" PRId64 ".%" PRId64, data_dir(), from, decree);
+                    sprintf(tmp_name, "%s/tmp.delta.%" PRId64 ".%" PRId64, data_dir(), from, decree);
+                }
+                // a partial file is never picked up as tmp.* is not a checkpoint name
+
+                kv_checkpoint_writer writer(tmp_name);
+                auto err = writer.open();
+                if (err != ERR_OK)
+                    return err;
+
+                auto v = [&writer](const kv_slice& k, const kv_slice& v)
+                {
+                    writer.add(k, v);
+                };
+                if (from == 0)
+                    _store.scan_snapshot(v);
+                else
+                    _store.scan_snapshot_delta(v, since_seq);
+
+                err = writer.finish(decree);
+                if (err == ERR_OK && _store.corrupted())
+                {
+                    // pairs in the damaged blocks of the base are missing from the snapshot
+                    derror("%s: the store is corrupted, checkpoint %s is dropped", data_dir(), name);
+                    err = ERR_CORRUPTION;
+                }
+                if (err != ERR_OK)
+                {
+                    utils::filesystem::remove_path(tmp_name);
+                    return err;
+                }
+
+                if (utils::filesystem::file_exists(name))
+                    utils::filesystem::remove_path(name);
+                if (!utils::filesystem::rename_path(tmp_name, name))
+                {
+                    derror("rename %s to %s failed", tmp_name, name);
+                    return ERR_FILE_OPERATION_FAILED;
+                }
+
+                dinfo("%s: checkpoint %s written, records = %" PRIu64, data_dir(), name, writer.record_count());
                 return ERR_OK;
             }
 
+            //
+            // keep the latest few full checkpoints and the chain the durable state is on,
+            // remove older full checkpoints and the deltas chained on them, under _lock
+            //
+            void simple_kv_service_impl::gc_checkpoints()
+            {
+                std::vector<std::string> sub_list;
+                if (!dsn::utils::filesystem::get_subfiles(data_dir(), sub_list, false))
+                {
+                    dwarn("get subfiles in %s failed", data_dir());
+                    return;
+                }
+
+                std::vector<kv_checkpoint_file> files, chain;
+                for (auto& fpath : sub_list)
+                {
+                    kv_checkpoint_file f;
+                    if (parse_checkpoint_file(utils::filesystem::path_combine(data_dir(), utils::filesystem::get_file_name(fpath)), f))
+                        files.push_back(f);
+                }
+                get_checkpoint_chain(files, last_durable_decree(), chain);
+
+                std::vector<int64_t> versions;
+                for (auto& f : files)
+                {
+                    if (f.full && f.to <= last_durable_decree())
+                        versions.push_back(f.to);
+                }
+
+                if ((int)versions.size() <= _checkpoint_reserve_count)
+                    return;
+
+                std::sort(versions.begin(), versions.end());
+                int64_t oldest = versions[versions.size() - _checkpoint_reserve_count];
+                if (!chain.empty() && chain[0].to < oldest)
+                    oldest = chain[0].to;
+
+                for (auto& f : files)
+                {
+                    if (f.full ? f.to >= oldest : f.from >= oldest)
+                        continue;
+
+                    if (!utils::filesystem::remove_path(f.path))
+                    {
+                        dwarn("remove old checkpoint %s failed", f.path.c_str());
+                    }
+                    else
+                    {
+                        ddebug("old checkpoint %s removed", f.path.c_str());
+                    }
+                }
+            }
+
+            //
             // helper routines to accelerate learning
+            //
+            // when the learner already has all the writes before some delta on the chain
+            // (learn_start - 1 >= its from), only the deltas from there are returned,
+            // otherwise it is the full checkpoint followed by all the deltas
+            //
             ::dsn::error_code simple_kv_service_impl::get_checkpoint(
                 int64_t learn_start,
                 int64_t local_commit,
@@ -265,25 +919,42 @@ namespace dsn {
                 int     learn_request_size,
                 app_learn_state& state)
             {
+                zauto_lock l(_lock);
+
+                std::vector<kv_checkpoint_file> files, chain;
                 if (last_durable_decree() > 0)
                 {
-                    char name[256];
-                    sprintf(name, "%s/checkpoint.%" PRId64,
-                        data_dir(),
-                        last_durable_decree()
-                        );
-                    
-                    state.from_decree_excluded = 0;
-                    state.to_decree_included = last_durable_decree();
-                    state.files.push_back(std::string(name));
-                    return ERR_OK;
+                    list_checkpoint_files(data_dir(), files);
+                    get_checkpoint_chain(files, last_durable_decree(), chain);
                 }
-                else
+
+                if (chain.empty())
                 {
                     state.from_decree_excluded = 0;
                     state.to_decree_included = 0;
                     return ERR_OBJECT_NOT_FOUND;
                 }
+
+                size_t first = 0;
+                for (size_t i = chain.size() - 1; i > 0; i--)
+                {
+                    if (chain[i].from <= learn_start - 1)
+                    {
+                        first = i;
+                        break;
+                    }
+                }
+
+                state.from_decree_excluded = chain[first].from;
+                state.to_decree_included = chain.back().to;
+                for (size_t i = first; i < chain.size(); i++)
+                {
+                    state.files.push_back(chain[i].path);
+                }
+
+                ddebug("%s: get checkpoint for learn_start = %" PRId64 ", (%" PRId64 ", %" PRId64 "] with %d files",
+                    data_dir(), learn_start, state.from_decree_excluded, state.to_decree_included, (int)state.files.size());
+                return ERR_OK;
             }
 
             ::dsn::error_code simple_kv_service_impl::apply_checkpoint(
@@ -291,9 +962,86 @@ namespace dsn {
                 int64_t commit,
                 const dsn_app_learn_state& state)
             {
+                std::vector<kv_checkpoint_file> files;
+                for (int i = 0; i < state.file_state_count; i++)
+                {
+                    kv_checkpoint_file f;
+                    if (!parse_checkpoint_file(state.files[i], f))
+                    {
+                        derror("%s: unknown learned checkpoint file %s", data_dir(), state.files[i]);
+                        return ERR_INVALID_DATA;
+                    }
+                    files.push_back(f);
+                }
+
+                // the full one first, then deltas along the chain
+                std::sort(files.begin(), files.end(), [](const kv_checkpoint_file& l, const kv_checkpoint_file& r)
+                {
+                    return l.from < r.from;
+                });
+
+                if (files.empty() || (state.from_decree_excluded == 0) != files[0].full)
+                {
+                    derror("%s: learned checkpoints do not match the state (%" PRId64 ", %" PRId64 "]",
+                        data_dir(), state.from_decree_excluded, state.to_decree_included);
+                    return ERR_INVALID_DATA;
+                }
+
                 if (mode == DSN_CHKPT_LEARN)
                 {
-                    recover(state.files[0], state.to_decree_included);
+                    size_t i = 0;
+                    if (files.size() == 1 && files[0].full && state.to_decree_included > last_durable_decree())
+                    {
+                        // a sole full checkpoint (e.g., ingested by a bulk load) is adopted as the
+                        // local checkpoint of the learned decree, so it is durable right away
+                        char lname[256];
+                        sprintf(lname, "%s/checkpoint.%" PRId64, data_dir(), state.to_decree_included);
+                        if (utils::filesystem::file_exists(lname))
+                            utils::filesystem::remove_path(lname);
+                        if (!utils::filesystem::rename_path(files[0].path, lname))
+                            return ERR_CHECKPOINT_FAILED;
+
+                        auto err = recover(lname, state.to_decree_included);
+                        if (err != ERR_OK)
+                        {
+                            // not to be picked up as the local state on restart
+                            utils::filesystem::remove_path(lname);
+                            return err;
+                        }
+
+                        zauto_lock l(_lock);
+                        set_last_durable_decree(state.to_decree_included);
+                        _delta_count = 0;
+                        return ERR_OK;
+                    }
+                    else if (files[0].full)
+                    {
+                        auto err = recover(files[0].path, files[0].to);
+                        if (err != ERR_OK)
+                            return err;
+
+                        // the memory state is no longer on the local checkpoint chain
+                        zauto_lock l(_lock);
+                        _force_full_checkpoint = true;
+                        i = 1;
+                    }
+                    else if (state.from_decree_excluded > commit)
+                    {
+                        derror("%s: learned deltas start from %" PRId64 ", beyond local commit %" PRId64,
+                            data_dir(), state.from_decree_excluded, commit);
+                        return ERR_INVALID_STATE;
+                    }
+
+                    for (; i < files.size(); i++)
+                    {
+                        auto err = apply_delta(files[i].path, false);
+                        if (err != ERR_OK)
+                        {
+                            derror("%s: apply learned delta %s failed, err = %s",
+                                data_dir(), files[i].path.c_str(), err.to_string());
+                            return err;
+                        }
+                    }
                     return ERR_OK;
                 }
                 else
@@ -301,20 +1049,21 @@ namespace dsn {
                     dassert(DSN_CHKPT_COPY == mode, "invalid mode %d", (int)mode);
                     dassert(state.to_decree_included > last_durable_decree(), "checkpoint's decree is smaller than current");
 
-                    char name[256];
-                    sprintf(name, "%s/checkpoint.%" PRId64,
-                        data_dir(),
-                        state.to_decree_included
-                        );
-                    std::string lname(name);
-
-                    if (!utils::filesystem::rename_path(state.files[0], lname))
-                        return ERR_CHECKPOINT_FAILED;
-                    else
+                    for (auto& f : files)
                     {
-                        set_last_durable_decree(state.to_decree_included);
-                        return ERR_OK;
+                        std::string lname = utils::filesystem::path_combine(data_dir(), utils::filesystem::get_file_name(f.path));
+                        if (utils::filesystem::file_exists(lname))
+                            utils::filesystem::remove_path(lname);
+                        if (!utils::filesystem::rename_path(f.path, lname))
+                            return ERR_CHECKPOINT_FAILED;
                     }
+
+                    zauto_lock l(_lock);
+                    set_last_durable_decree(state.to_decree_included);
+
+                    // the copied files are not taken from the memory state
+                    _force_full_checkpoint = true;
+                    return ERR_OK;
                 }
             }
 
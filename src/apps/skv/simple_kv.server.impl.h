@@ -36,6 +36,7 @@
 #pragma once
 
 # include "simple_kv.server.h"
+# include "simple_kv.store.h"
 # include <dsn/cpp/replicated_service_app.h>
 
 namespace dsn {
@@ -54,6 +55,10 @@ namespace dsn {
                 virtual void on_write(const kv_pair& pr, ::dsn::rpc_replier<int32_t> &reply);
                 // RPC_SIMPLE_KV_APPEND
                 virtual void on_append(const kv_pair& pr, ::dsn::rpc_replier<int32_t>& reply);
+                // RPC_SIMPLE_KV_SCAN
+                virtual void on_scan(dsn_message_t request) override;
+
+                virtual void on_batched_write_requests(int64_t decree, dsn_message_t* requests, int count) override;
 
                 virtual ::dsn::error_code start(int argc, char** argv) override;
 
@@ -61,6 +66,8 @@ namespace dsn {
 
                 virtual ::dsn::error_code sync_checkpoint(int64_t last_commit) override;
 
+                virtual ::dsn::error_code async_checkpoint(int64_t last_commit) override;
+
                 virtual int64_t get_last_checkpoint_decree() override { return last_durable_decree(); }
 
                 virtual ::dsn::error_code get_checkpoint(
@@ -77,21 +84,58 @@ namespace dsn {
                     const dsn_app_learn_state& state
                     ) override;
 
+                virtual void set_partition_count(int partition_count) override;
+
+                // a damaged block of the checkpoint served from is found, so writes fail
+                // and the replica learns the state from others
+                virtual int get_physical_error() override { return _store.corrupted() ? ERR_CORRUPTION.get() : 0; }
+
             private:
-                void recover();
-                void recover(const std::string& name, int64_t version);
+                ::dsn::error_code recover();
+                ::dsn::error_code recover(const std::string& name, int64_t version);
                 const char* data_dir() const { return _data_dir.c_str(); }
                 int64_t last_durable_decree() const { return _last_durable_decree; }
                 void set_last_durable_decree(int64_t d) { _last_durable_decree = d; }
 
+                ::dsn::error_code apply_delta(const std::string& name, bool durable);
+                ::dsn::error_code write_checkpoint(int64_t from, int64_t decree, uint64_t since_seq);
+                bool need_full_checkpoint() const;
+                void on_checkpoint_written(int64_t from, int64_t decree, uint64_t snapshot_seq);
+                void gc_checkpoints();
+                void try_purge();
+                void wait_background_tasks();
+
             private:
-                typedef std::map<std::string, std::string> simple_kv;
-                simple_kv _store;
-                ::dsn::service::zlock _lock;
+                simple_kv_store _store;
+                ::dsn::service::zlock _lock; // serialize checkpoint and recovery
                 bool      _test_file_learning;
 
                 std::string _data_dir;
-                int64_t     _last_durable_decree;
+                std::atomic<int64_t> _last_durable_decree;
+
+                ::dsn::task_ptr   _checkpoint_task;
+                std::atomic<bool> _checkpoint_running;
+                int64_t           _checkpoint_min_decree_gap;
+                int               _checkpoint_reserve_count;
+
+                // delta checkpoints, all under _lock
+                bool              _delta_checkpoint_enabled;
+                int               _delta_max_count;
+                uint64_t          _last_checkpoint_seq; // store snapshot of the durable checkpoint, 0 when it is what is recovered
+                int               _delta_count;         // deltas on the latest full checkpoint
+                bool              _force_full_checkpoint;
+
+                int               _scan_max_page_count;
+                int               _scan_max_page_bytes;
+
+                ::dsn::task_ptr   _load_task;
+                std::atomic<bool> _load_stopped;
+
+                // pairs left to the other half of a split are dropped from memory once
+                // no snapshot is alive, retried when a checkpoint releases its snapshot
+                int               _partition_count;
+                ::dsn::task_ptr   _purge_task;
+                std::atomic<bool> _purge_pending;
             };
 
         }
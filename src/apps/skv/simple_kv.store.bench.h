@@ -0,0 +1,443 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     microbenchmark of simple_kv_store against the std::map + zlock it replaces,
+ *     with several readers and one writer running concurrently; it also checks
+ *     that the readers find every pair of a base checkpoint while it is loaded, and
+ *     that the two halves of a split see each pair exactly once
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+# include "simple_kv.store.h"
+# include "simple_kv.checkpoint.h"
+# include "simple_kv.code.definition.h"
+# include <dsn/cpp/utils.h>
+# include <algorithm>
+# include <atomic>
+# include <thread>
+# include <random>
+# include <sstream>
+# include <fstream>
+
+namespace dsn { namespace replication { namespace application {
+
+class simple_kv_store_bench_app : public ::dsn::service_app
+{
+public:
+    simple_kv_store_bench_app(dsn_gpid gpid) : ::dsn::service_app(gpid) {}
+
+    ~simple_kv_store_bench_app()
+    {
+        stop();
+    }
+
+    virtual ::dsn::error_code start(int argc, char** argv) override
+    {
+        _key_count = (int)dsn_config_get_value_uint64("apps.store.bench", "key_count", 100000,
+            "how many keys are loaded before the test");
+        _payload_bytes = (int)dsn_config_get_value_uint64("apps.store.bench", "payload_bytes", 128,
+            "value size in bytes");
+        _reader_count = (int)dsn_config_get_value_uint64("apps.store.bench", "reader_count", 4,
+            "how many reader threads run besides the single writer thread");
+        _duration_seconds = (int)dsn_config_get_value_uint64("apps.store.bench", "duration_seconds", 5,
+            "how long each round runs");
+        _exit_after_test = dsn_config_get_value_bool("apps.store.bench", "exit_after_test", false,
+            "dump the result and exit the process after the test is finished");
+
+        _runner = std::thread([this]() { run(); });
+        return ::dsn::ERR_OK;
+    }
+
+    virtual ::dsn::error_code stop(bool cleanup = false) override
+    {
+        if (_runner.joinable())
+            _runner.join();
+        return ::dsn::ERR_OK;
+    }
+
+private:
+    struct result
+    {
+        uint64_t reads;
+        uint64_t writes;
+    };
+
+    // the baseline is what simple_kv_service_impl used before the store was introduced
+    class map_engine
+    {
+    public:
+        map_engine() : _lock(true) {}
+        bool get(const std::string& key, std::string& value)
+        {
+            ::dsn::service::zauto_lock l(_lock);
+            auto it = _map.find(key);
+            if (it == _map.end())
+                return false;
+            value = it->second;
+            return true;
+        }
+        void put(const std::string& key, const std::string& value)
+        {
+            ::dsn::service::zauto_lock l(_lock);
+            _map[key] = value;
+        }
+    private:
+        std::map<std::string, std::string> _map;
+        ::dsn::service::zlock _lock;
+    };
+
+    class store_engine
+    {
+    public:
+        bool get(const std::string& key, std::string& value) { return _store.get(key, value); }
+        void put(const std::string& key, const std::string& value) { _store.put(key, value); }
+    private:
+        simple_kv_store _store;
+    };
+
+    static std::string make_key(uint64_t i)
+    {
+        std::stringstream ss;
+        ss << "key." << i;
+        return ss.str();
+    }
+
+    template<typename TEngine>
+    result run_one(TEngine& engine)
+    {
+        std::string value(_payload_bytes, 'x');
+        for (int i = 0; i < _key_count; i++)
+            engine.put(make_key(i), value);
+
+        std::atomic<bool> stopped(false);
+        std::atomic<uint64_t> reads(0);
+        std::atomic<uint64_t> writes(0);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < _reader_count; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                std::minstd_rand rnd(t + 1);
+                std::string v;
+                uint64_t n = 0;
+                while (!stopped.load(std::memory_order_relaxed))
+                {
+                    engine.get(make_key(rnd() % _key_count), v);
+                    n++;
+                }
+                reads += n;
+            });
+        }
+
+        threads.emplace_back([&]()
+        {
+            std::minstd_rand rnd(0);
+            uint64_t n = 0;
+            while (!stopped.load(std::memory_order_relaxed))
+            {
+                engine.put(make_key(rnd() % _key_count), value);
+                n++;
+            }
+            writes += n;
+        });
+
+        std::this_thread::sleep_for(std::chrono::seconds(_duration_seconds));
+        stopped = true;
+        for (auto& th : threads)
+            th.join();
+
+        result r;
+        r.reads = reads.load();
+        r.writes = writes.load();
+        return r;
+    }
+
+    // returns how many reads miss a pair of the base while load_base() runs
+    uint64_t check_base_load()
+    {
+        std::string path = ::dsn::utils::filesystem::path_combine(
+            dsn_get_app_data_dir(get_gpid()), "store-bench-base.1");
+        std::string value(_payload_bytes, 'x');
+        std::vector<std::string> keys;
+        for (int i = 0; i < _key_count; i++)
+            keys.push_back(make_key(i));
+        std::sort(keys.begin(), keys.end());
+
+        kv_checkpoint_writer writer(path);
+        auto err = writer.open();
+        dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+        for (auto& k : keys)
+            writer.add(k, value);
+        err = writer.finish(1);
+        dassert(err == ::dsn::ERR_OK, "write %s failed, err = %s", path.c_str(), err.to_string());
+
+        std::shared_ptr<kv_checkpoint_reader> reader;
+        err = kv_checkpoint_reader::open(path, reader);
+        dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+
+        std::unique_ptr<simple_kv_store> store(new simple_kv_store());
+        store->set_base(reader);
+        reader.reset();
+
+        std::atomic<bool> loaded(false);
+        std::atomic<uint64_t> misses(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < _reader_count; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                std::minstd_rand rnd(t + 1);
+                std::string v;
+                while (!loaded.load())
+                {
+                    if (!store->get(keys[rnd() % keys.size()], v))
+                        misses++;
+                }
+            });
+        }
+
+        std::atomic<bool> stopped(false);
+        store->load_base(stopped);
+        loaded = true;
+        for (auto& th : threads)
+            th.join();
+
+        store.reset();
+        ::dsn::utils::filesystem::remove_path(path);
+        return misses.load();
+    }
+
+    //
+    // the parent and the child of a split start with the same pairs, half in the base
+    // checkpoint and half written since, and each pair must be seen by the scans and
+    // the checkpoints of exactly the half its key hash is routed to, also after the
+    // other half is purged from memory; returns how many pairs are seen wrongly
+    //
+    uint64_t check_split_filter()
+    {
+        std::string path = ::dsn::utils::filesystem::path_combine(
+            dsn_get_app_data_dir(get_gpid()), "store-bench-split.1");
+        std::string value(_payload_bytes, 'x');
+        std::vector<std::string> keys;
+        for (int i = 0; i < _key_count; i++)
+            keys.push_back(make_key(i));
+        std::sort(keys.begin(), keys.end());
+
+        kv_checkpoint_writer writer(path);
+        auto err = writer.open();
+        dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+        for (size_t i = 0; i < keys.size(); i += 2)
+            writer.add(keys[i], value);
+        err = writer.finish(1);
+        dassert(err == ::dsn::ERR_OK, "write %s failed, err = %s", path.c_str(), err.to_string());
+
+        std::vector<int> seen(keys.size(), 0);
+        uint64_t wrong = 0;
+        auto record = [&](int index, const kv_slice& k)
+        {
+            auto it = std::lower_bound(keys.begin(), keys.end(), k.to_string());
+            if (it == keys.end() || *it != k.to_string()
+                || simple_kv_key_hash(k.data, k.size) % 2 != static_cast<uint64_t>(index))
+                wrong++;
+            else
+                seen[it - keys.begin()]++;
+        };
+
+        std::atomic<bool> stopped(false);
+        for (int index = 0; index < 2; index++)
+        {
+            std::shared_ptr<kv_checkpoint_reader> reader;
+            err = kv_checkpoint_reader::open(path, reader);
+            dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+
+            std::unique_ptr<simple_kv_store> store(new simple_kv_store());
+            store->set_base(reader);
+            for (size_t i = 1; i < keys.size(); i += 2)
+                store->put(keys[i], value);
+            store->set_partition(index, 2);
+
+            // what on_scan returns, with pairs from both the base and the memory
+            store->scan_range(kv_slice(), true,
+                [&](const kv_slice& k, const kv_slice& v) { record(index, k); return true; },
+                []() {});
+
+            // what a full checkpoint keeps, after the other half is dropped
+            store->load_base(stopped);
+            bool purged = store->purge_unowned();
+            dassert(purged, "no snapshot is alive");
+            bool ok = store->take_snapshot();
+            dassert(ok, "no snapshot is alive");
+            store->scan_snapshot([&](const kv_slice& k, const kv_slice& v) { record(index, k); });
+            store->release_snapshot();
+
+            uint64_t owned = 0;
+            for (auto& k : keys)
+            {
+                if (simple_kv_key_hash(k) % 2 == static_cast<uint64_t>(index))
+                    owned++;
+            }
+            if (store->count() != owned)
+                wrong++;
+        }
+
+        for (auto c : seen)
+        {
+            if (c != 2)
+                wrong++;
+        }
+
+        ::dsn::utils::filesystem::remove_path(path);
+        return wrong;
+    }
+
+    //
+    // a damaged block of the base is only found when it is first read, after the
+    // checkpoint is opened, and must be reported by corrupted() both when the base
+    // is loaded and when a snapshot on it is scanned; returns whether it is
+    //
+    bool check_corrupted_base()
+    {
+        std::string path = ::dsn::utils::filesystem::path_combine(
+            dsn_get_app_data_dir(get_gpid()), "store-bench-corrupted.1");
+        std::string value(_payload_bytes, 'x');
+        std::vector<std::string> keys;
+        for (int i = 0; i < _key_count; i++)
+            keys.push_back(make_key(i));
+        std::sort(keys.begin(), keys.end());
+
+        kv_checkpoint_writer writer(path);
+        auto err = writer.open();
+        dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+        for (auto& k : keys)
+            writer.add(k, value);
+        err = writer.finish(1);
+        dassert(err == ::dsn::ERR_OK, "write %s failed, err = %s", path.c_str(), err.to_string());
+
+        // flip a byte in the blocks, which are ahead of the index and the footer
+        {
+            std::fstream fs(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+            fs.seekg(0, std::ios::end);
+            std::streamoff offset = fs.tellg() / 4;
+            char c;
+            fs.seekg(offset);
+            fs.read(&c, 1);
+            c = ~c;
+            fs.seekp(offset);
+            fs.write(&c, 1);
+        }
+
+        bool ok = true;
+        std::atomic<bool> stopped(false);
+        for (int round = 0; round < 2; round++)
+        {
+            std::shared_ptr<kv_checkpoint_reader> reader;
+            err = kv_checkpoint_reader::open(path, reader);
+            dassert(err == ::dsn::ERR_OK, "open %s failed, err = %s", path.c_str(), err.to_string());
+
+            std::unique_ptr<simple_kv_store> store(new simple_kv_store());
+            store->set_base(reader);
+            reader.reset();
+            ok = ok && !store->corrupted();
+
+            if (round == 0)
+            {
+                ok = ok && !store->load_base(stopped);
+            }
+            else
+            {
+                bool taken = store->take_snapshot();
+                dassert(taken, "no snapshot is alive");
+                store->scan_snapshot([](const kv_slice& k, const kv_slice& v) {});
+                store->release_snapshot();
+            }
+            ok = ok && store->corrupted();
+        }
+
+        ::dsn::utils::filesystem::remove_path(path);
+        return ok;
+    }
+
+    void run()
+    {
+        uint64_t misses = check_base_load();
+        dassert(misses == 0, "%" PRIu64 " reads miss a pair while the base is loaded", misses);
+
+        uint64_t wrong = check_split_filter();
+        dassert(wrong == 0, "%" PRIu64 " pairs are seen by the wrong half of a split", wrong);
+
+        bool reported = check_corrupted_base();
+        dassert(reported, "a damaged block of the base is not reported");
+
+        std::unique_ptr<map_engine> m(new map_engine());
+        result rm = run_one(*m);
+        m.reset();
+
+        std::unique_ptr<store_engine> s(new store_engine());
+        result rs = run_one(*s);
+        s.reset();
+
+        std::stringstream ss;
+        ss << "store bench: keys = " << _key_count
+            << ", payload(byte): " << _payload_bytes
+            << ", readers: " << _reader_count
+            << ", writers: 1"
+            << ", duration(s): " << _duration_seconds << std::endl;
+        ss << "  std::map + zlock: read qps: " << rm.reads / _duration_seconds << "#/s"
+            << ", write qps: " << rm.writes / _duration_seconds << "#/s" << std::endl;
+        ss << "  simple_kv_store:  read qps: " << rs.reads / _duration_seconds << "#/s"
+            << ", write qps: " << rs.writes / _duration_seconds << "#/s" << std::endl;
+
+        dwarn(ss.str().c_str());
+
+        if (_exit_after_test)
+        {
+            std::string report = ::dsn::utils::filesystem::path_combine(
+                dsn_get_app_data_dir(get_gpid()), "store-bench-result.txt");
+            std::ofstream result_f(report.c_str(), std::ios::out);
+            result_f << ss.str() << std::endl;
+            result_f.close();
+
+            dsn_exit(0);
+        }
+    }
+
+private:
+    int  _key_count;
+    int  _payload_bytes;
+    int  _reader_count;
+    int  _duration_seconds;
+    bool _exit_after_test;
+    std::thread _runner;
+};
+
+} } }
@@ -0,0 +1,776 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     in-memory storage engine for simple_kv
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "simple_kv.store.h"
+# include "simple_kv.checkpoint.h"
+# include "simple_kv.code.definition.h"
+# include <algorithm>
+# include <new>
+# include <queue>
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "simple.kv.store"
+
+using namespace ::dsn::service;
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            //------------------------------ kv_arena ------------------------------
+            kv_arena::kv_arena(size_t slab_bytes)
+                : _slab_bytes(slab_bytes), _current(nullptr), _left(0), _allocated_bytes(0)
+            {
+            }
+
+            kv_arena::~kv_arena()
+            {
+                clear();
+            }
+
+            char* kv_arena::allocate(size_t bytes)
+            {
+                // keep entries pointer aligned
+                bytes = (bytes + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+                if (bytes > _left)
+                {
+                    // large blobs get their own slab so that the current one is not wasted
+                    if (bytes > _slab_bytes / 4)
+                    {
+                        char* blob = new char[bytes];
+                        _slabs.push_back(blob);
+                        _allocated_bytes += bytes;
+                        return blob;
+                    }
+
+                    _current = new char[_slab_bytes];
+                    _left = _slab_bytes;
+                    _slabs.push_back(_current);
+                }
+
+                char* p = _current;
+                _current += bytes;
+                _left -= bytes;
+                _allocated_bytes += bytes;
+                return p;
+            }
+
+            void kv_arena::clear()
+            {
+                for (auto& s : _slabs)
+                    delete[] s;
+                _slabs.clear();
+                _current = nullptr;
+                _left = 0;
+                _allocated_bytes = 0;
+            }
+
+            void kv_arena::swap(kv_arena& other)
+            {
+                std::swap(_slab_bytes, other._slab_bytes);
+                _slabs.swap(other._slabs);
+                std::swap(_current, other._current);
+                std::swap(_left, other._left);
+                std::swap(_allocated_bytes, other._allocated_bytes);
+            }
+
+            //------------------------------ kv_slice ------------------------------
+            int kv_slice::compare(const kv_slice& o) const
+            {
+                uint32_t n = std::min(size, o.size);
+                int r = (n == 0 ? 0 : memcmp(data, o.data, n));
+                if (r != 0)
+                    return r;
+                return size < o.size ? -1 : (size > o.size ? 1 : 0);
+            }
+
+            static uint64_t kv_hash(const char* data, uint32_t size)
+            {
+                // FNV-1a
+                uint64_t h = 14695981039346656037ULL;
+                for (uint32_t i = 0; i < size; i++)
+                {
+                    h ^= (uint8_t)data[i];
+                    h *= 1099511628211ULL;
+                }
+                return h;
+            }
+
+            size_t kv_slice_hash::operator()(const kv_slice& s) const
+            {
+                return static_cast<size_t>(kv_hash(s.data, s.size));
+            }
+
+            //------------------------------ simple_kv_store ------------------------------
+            simple_kv_store::simple_kv_store(int shard_count)
+                : _write_seq(0), _snapshot_seq(0), _base_attached(false), _base_corrupted(false), _partition_index(0), _partition_count(0)
+            {
+                dassert(shard_count > 0, "invalid shard count %d", shard_count);
+                _shards.resize(shard_count);
+                for (auto& s : _shards)
+                    s = new shard();
+            }
+
+            simple_kv_store::~simple_kv_store()
+            {
+                for (auto& s : _shards)
+                    delete s;
+                _shards.clear();
+            }
+
+            size_t simple_kv_store::shard_index(const kv_slice& key) const
+            {
+                // use the high bits so that the shard choice is independent of the
+                // bucket choice inside the shard's hash index
+                uint64_t h = kv_hash(key.data, key.size);
+                return static_cast<size_t>((h >> 32) % _shards.size());
+            }
+
+            simple_kv_store::shard& simple_kv_store::shard_of(const kv_slice& key) const
+            {
+                return *_shards[shard_index(key)];
+            }
+
+            bool simple_kv_store::get(const kv_slice& key, /*out*/ std::string& value) const
+            {
+                // taken first, as load_base() may move the key into the shard and
+                // release the base between the probe of the shard and the fallback
+                auto base = current_base();
+                {
+                    shard& s = shard_of(key);
+                    zauto_read_lock l(s.lock);
+
+                    auto it = s.index.find(key);
+                    if (it != s.index.end())
+                    {
+                        value.assign(it->second->value.data, it->second->value.size);
+                        return true;
+                    }
+                }
+
+                // not loaded into memory yet, served from the mapped checkpoint
+                kv_slice v;
+                if (base && base->get(key, v))
+                {
+                    value.assign(v.data, v.size);
+                    return true;
+                }
+                return false;
+            }
+
+            uint64_t simple_kv_store::count() const
+            {
+                uint64_t c = 0;
+                for (auto& s : _shards)
+                {
+                    zauto_read_lock l(s->lock);
+                    c += s->index.size();
+                }
+                return c;
+            }
+
+            simple_kv_store::entry* simple_kv_store::new_entry(shard& s, const kv_slice& key, const kv_slice& value)
+            {
+                char* p = s.arena.allocate(sizeof(entry) + key.size + value.size);
+                entry* e = new (p) entry();
+                e->version = 0;
+                e->snapshot_version = 0;
+                e->snapshot_seq = 0;
+                char* k = p + sizeof(entry);
+                if (key.size > 0)
+                    memcpy(k, key.data, key.size);
+                e->key = kv_slice(k, key.size);
+                if (value.size > 0)
+                    memcpy(k + key.size, value.data, value.size);
+                e->value = kv_slice(k + key.size, value.size);
+                return e;
+            }
+
+            void simple_kv_store::set_value(shard& s, entry* e, const kv_slice& value, const kv_slice& tail)
+            {
+                uint32_t sz = value.size + tail.size;
+                char* v = s.arena.allocate(sz);
+                if (value.size > 0)
+                    memcpy(v, value.data, value.size);
+                if (tail.size > 0)
+                    memcpy(v + value.size, tail.data, tail.size);
+
+                // the old value bytes (possibly inline with the entry) become garbage
+                s.garbage_bytes += e->value.size;
+                e->value = kv_slice(v, sz);
+            }
+
+            void simple_kv_store::apply(shard& s, const kv_update& u)
+            {
+                uint64_t seq = ++_write_seq;
+
+                auto it = s.index.find(u.key);
+                if (it != s.index.end())
+                {
+                    entry* e = it->second;
+
+                    // first overwrite since the snapshot, keep what the snapshot sees;
+                    // the old bytes stay valid as compaction is off meanwhile
+                    if (_snapshot_seq != 0 && e->version < _snapshot_seq && e->snapshot_seq != _snapshot_seq)
+                    {
+                        e->snapshot_value = e->value;
+                        e->snapshot_version = e->version;
+                        e->snapshot_seq = _snapshot_seq;
+                    }
+
+                    if (u.type == kv_update::APPEND)
+                        set_value(s, e, e->value, u.value);
+                    else
+                        set_value(s, e, u.value, kv_slice());
+                    e->version = seq;
+                    compact_if_necessary(s);
+                }
+                else
+                {
+                    entry* e;
+                    kv_slice old_value;
+                    auto base = current_base();
+                    if (u.type == kv_update::APPEND && base && base->get(u.key, old_value))
+                    {
+                        e = new_entry(s, u.key, kv_slice());
+                        set_value(s, e, old_value, u.value);
+                    }
+                    else
+                        e = new_entry(s, u.key, u.value);
+
+                    e->version = seq;
+                    s.index.emplace(e->key, e);
+                    s.ordered.emplace(e->key, e);
+                }
+            }
+
+            void simple_kv_store::put(const kv_slice& key, const kv_slice& value)
+            {
+                kv_update u = { kv_update::PUT, key, value };
+                shard& s = shard_of(key);
+                zauto_write_lock l(s.lock);
+                apply(s, u);
+            }
+
+            void simple_kv_store::append(const kv_slice& key, const kv_slice& value)
+            {
+                kv_update u = { kv_update::APPEND, key, value };
+                shard& s = shard_of(key);
+                zauto_write_lock l(s.lock);
+                apply(s, u);
+            }
+
+            void simple_kv_store::put_durable(const kv_slice& key, const kv_slice& value)
+            {
+                shard& s = shard_of(key);
+                zauto_write_lock l(s.lock);
+
+                auto it = s.index.find(key);
+                if (it != s.index.end())
+                {
+                    set_value(s, it->second, value, kv_slice());
+                    it->second->version = 0;
+                    compact_if_necessary(s);
+                }
+                else
+                {
+                    entry* e = new_entry(s, key, value);
+                    s.index.emplace(e->key, e);
+                    s.ordered.emplace(e->key, e);
+                }
+            }
+
+            void simple_kv_store::write_batch(const kv_update* updates, int count)
+            {
+                if (count == 0)
+                    return;
+
+                if (count == 1)
+                {
+                    shard& s = shard_of(updates[0].key);
+                    zauto_write_lock l(s.lock);
+                    apply(s, updates[0]);
+                    return;
+                }
+
+                // group by shard, updates on the same key always land in the same
+                // group so keeping the order inside each group is enough
+                std::vector<std::vector<int>> groups(_shards.size());
+                for (int i = 0; i < count; i++)
+                    groups[shard_index(updates[i].key)].push_back(i);
+
+                for (size_t i = 0; i < groups.size(); i++)
+                {
+                    if (groups[i].empty())
+                        continue;
+
+                    shard& s = *_shards[i];
+                    zauto_write_lock l(s.lock);
+                    for (auto idx : groups[i])
+                        apply(s, updates[idx]);
+                }
+            }
+
+            void simple_kv_store::clear()
+            {
+                dassert(_snapshot_seq == 0, "cannot clear the store while a snapshot is alive");
+                set_base(nullptr);
+                _base_corrupted = false;
+                for (auto& s : _shards)
+                {
+                    zauto_write_lock l(s->lock);
+                    s->index.clear();
+                    s->ordered.clear();
+                    s->arena.clear();
+                    s->garbage_bytes = 0;
+                }
+            }
+
+            void simple_kv_store::compact_if_necessary(shard& s)
+            {
+                // repeated overwrites and appends leave dead values behind, rebuild
+                // the shard into a fresh arena once they dominate
+                if (s.garbage_bytes < 4 * 1024 * 1024 || s.garbage_bytes * 2 < s.arena.allocated_bytes())
+                    return;
+
+                // the alive snapshot still points into the current arena
+                if (_snapshot_seq != 0)
+                    return;
+
+                kv_arena old;
+                old.swap(s.arena);
+
+                std::map<kv_slice, entry*> ordered;
+                std::unordered_map<kv_slice, entry*, kv_slice_hash> index;
+                index.reserve(s.index.size());
+
+                for (auto& kv : s.ordered)
+                {
+                    entry* e = new_entry(s, kv.second->key, kv.second->value);
+                    e->version = kv.second->version;
+                    index.emplace(e->key, e);
+                    ordered.emplace_hint(ordered.end(), e->key, e);
+                }
+
+                s.index.swap(index);
+                s.ordered.swap(ordered);
+
+                dinfo("compact shard, %" PRIu64 " garbage bytes reclaimed, %" PRIu64 " bytes in use",
+                    (uint64_t)s.garbage_bytes,
+                    (uint64_t)s.arena.allocated_bytes()
+                    );
+                s.garbage_bytes = 0;
+            }
+
+            bool simple_kv_store::take_snapshot()
+            {
+                for (auto& s : _shards)
+                    s->lock.lock_write();
+
+                bool ok = (_snapshot_seq == 0);
+                if (ok)
+                {
+                    // no write is in flight now, so this sequence cuts the history cleanly
+                    _snapshot_seq = ++_write_seq;
+                    _snapshot_base = current_base();
+                }
+
+                for (auto& s : _shards)
+                    s->lock.unlock_write();
+                return ok;
+            }
+
+            void simple_kv_store::release_snapshot()
+            {
+                for (auto& s : _shards)
+                    s->lock.lock_write();
+
+                _snapshot_seq = 0;
+                _snapshot_base = nullptr;
+
+                for (auto& s : _shards)
+                    s->lock.unlock_write();
+            }
+
+            void simple_kv_store::scan_snapshot(const visitor& v) const
+            {
+                scan(v, false, 0);
+            }
+
+            void simple_kv_store::scan_snapshot_delta(const visitor& v, uint64_t since_snapshot_seq) const
+            {
+                scan(v, true, since_snapshot_seq);
+            }
+
+            void simple_kv_store::scan(const visitor& v, bool delta, uint64_t since) const
+            {
+                const int batch_size = 256;
+                const uint64_t seq = _snapshot_seq;
+                dassert(seq != 0, "no snapshot is alive");
+
+                typedef std::map<kv_slice, entry*>::const_iterator iter;
+                typedef std::pair<kv_slice, kv_slice> kv;
+
+                // entries and their iterators stay valid as there is neither delete
+                // nor compaction while the snapshot is alive, but the tree itself
+                // may be changed by the writer, so it is only walked under the shard
+                // lock, a batch of pairs at a time
+                struct cursor
+                {
+                    shard*          s;
+                    iter            next;
+                    std::vector<kv> pairs;
+                    size_t          pos;
+                };
+
+                std::vector<cursor> cursors(_shards.size());
+                auto fill = [this, seq, batch_size, delta, since](cursor& c)
+                {
+                    c.pairs.clear();
+                    c.pos = 0;
+
+                    zauto_read_lock l(c.s->lock);
+                    while (c.next != c.s->ordered.end() && (int)c.pairs.size() < batch_size)
+                    {
+                        entry* e = c.next->second;
+                        ++c.next;
+
+                        // left to the other half of a split
+                        if (!owns(e->key))
+                            continue;
+
+                        if (e->version < seq)
+                        {
+                            if (!delta || e->version > since)
+                                c.pairs.push_back(kv(e->key, e->value));
+                        }
+                        else if (e->snapshot_seq == seq)
+                        {
+                            if (!delta || e->snapshot_version > since)
+                                c.pairs.push_back(kv(e->key, e->snapshot_value));
+                        }
+                        // else created after the snapshot
+                    }
+                    return !c.pairs.empty();
+                };
+
+                auto greater = [&cursors](int l, int r)
+                {
+                    return cursors[r].pairs[cursors[r].pos].first < cursors[l].pairs[cursors[l].pos].first;
+                };
+                std::priority_queue<int, std::vector<int>, decltype(greater)> heap(greater);
+
+                for (size_t i = 0; i < _shards.size(); i++)
+                {
+                    cursor& c = cursors[i];
+                    c.s = _shards[i];
+                    {
+                        zauto_read_lock l(c.s->lock);
+                        c.next = c.s->ordered.begin();
+                    }
+                    if (fill(c))
+                        heap.push((int)i);
+                }
+
+                // pairs not loaded from the base checkpoint yet come from the base, and
+                // the in-memory ones win on the same key
+                kv_checkpoint_reader* base = delta ? nullptr : _snapshot_base.get();
+                std::unique_ptr<kv_checkpoint_reader::iterator> bit;
+                if (base)
+                    bit.reset(new kv_checkpoint_reader::iterator(base->begin()));
+
+                while (!heap.empty())
+                {
+                    int i = heap.top();
+                    cursor& c = cursors[i];
+                    const kv& top = c.pairs[c.pos];
+
+                    if (bit && bit->valid())
+                    {
+                        int r = bit->key().compare(top.first);
+                        if (r < 0)
+                        {
+                            if (owns(bit->key()))
+                                v(bit->key(), bit->value());
+                            bit->next();
+                            continue;
+                        }
+                        else if (r == 0)
+                            bit->next();
+                    }
+
+                    heap.pop();
+                    v(top.first, top.second);
+
+                    if (++c.pos < c.pairs.size() || fill(c))
+                        heap.push(i);
+                }
+
+                for (; bit && bit->valid(); bit->next())
+                {
+                    if (owns(bit->key()))
+                        v(bit->key(), bit->value());
+                }
+
+                // the pairs after a damaged block are missing
+                if (base && base->corrupted())
+                    _base_corrupted = true;
+            }
+
+            void simple_kv_store::scan_range(
+                const kv_slice& start,
+                bool start_inclusive,
+                const range_visitor& visit,
+                const std::function<void()>& done
+                ) const
+            {
+                typedef std::map<kv_slice, entry*>::const_iterator iter;
+
+                // all shards are read locked so that the page is consistent, and the
+                // slices are valid until done() as no shard can be changed or compacted
+                for (auto& s : _shards)
+                    s->lock.lock_read();
+
+                std::vector<iter> cursors(_shards.size());
+                auto greater = [&cursors](int l, int r)
+                {
+                    return cursors[r]->first < cursors[l]->first;
+                };
+                std::priority_queue<int, std::vector<int>, decltype(greater)> heap(greater);
+
+                for (size_t i = 0; i < _shards.size(); i++)
+                {
+                    auto& ordered = _shards[i]->ordered;
+                    cursors[i] = start_inclusive ? ordered.lower_bound(start) : ordered.upper_bound(start);
+                    if (cursors[i] != ordered.end())
+                        heap.push((int)i);
+                }
+
+                // the base is only dropped after all its pairs are loaded, which cannot
+                // happen halfway with the locks held, and the in-memory ones win on the same key
+                auto base = current_base();
+                std::unique_ptr<kv_checkpoint_reader::iterator> bit;
+                if (base)
+                {
+                    bit.reset(new kv_checkpoint_reader::iterator(base->seek(start)));
+                    if (!start_inclusive && bit->valid() && bit->key() == start)
+                        bit->next();
+                }
+
+                bool more = true;
+                while (more && !heap.empty())
+                {
+                    int i = heap.top();
+                    const entry* e = cursors[i]->second;
+
+                    if (bit && bit->valid())
+                    {
+                        int r = bit->key().compare(e->key);
+                        if (r < 0)
+                        {
+                            if (owns(bit->key()))
+                                more = visit(bit->key(), bit->value());
+                            bit->next();
+                            continue;
+                        }
+                        else if (r == 0)
+                            bit->next();
+                    }
+
+                    heap.pop();
+                    if (owns(e->key))
+                        more = visit(e->key, e->value);
+
+                    if (++cursors[i] != _shards[i]->ordered.end())
+                        heap.push(i);
+                }
+
+                for (; more && bit && bit->valid(); bit->next())
+                {
+                    if (owns(bit->key()))
+                        more = visit(bit->key(), bit->value());
+                }
+
+                done();
+
+                for (auto& s : _shards)
+                    s->lock.unlock_read();
+            }
+
+            //
+            // std::atomic_load on a shared_ptr takes one of a few global mutexes, so
+            // it is skipped by the flag once the base is fully loaded, which is the
+            // common case; the flag is cleared only after all the pairs are in memory
+            //
+            std::shared_ptr<kv_checkpoint_reader> simple_kv_store::current_base() const
+            {
+                if (!_base_attached.load(std::memory_order_acquire))
+                    return nullptr;
+                return std::atomic_load(&_base);
+            }
+
+            void simple_kv_store::set_base(std::shared_ptr<kv_checkpoint_reader> base)
+            {
+                bool attached = (base != nullptr);
+                if (!attached)
+                    _base_attached.store(false, std::memory_order_release);
+                std::atomic_store(&_base, base);
+                if (attached)
+                    _base_attached.store(true, std::memory_order_release);
+            }
+
+            bool simple_kv_store::corrupted() const
+            {
+                if (_base_corrupted.load())
+                    return true;
+
+                auto base = current_base();
+                return base != nullptr && base->corrupted();
+            }
+
+            bool simple_kv_store::load_base(const std::atomic<bool>& stopped)
+            {
+                auto base = current_base();
+                if (base == nullptr)
+                    return true;
+
+                std::vector<std::vector<kv_update>> groups(_shards.size());
+                for (size_t b = 0; b < base->block_count(); b++)
+                {
+                    if (stopped.load())
+                        return false;
+
+                    for (auto it = base->block_begin(b); it.valid() && it.block() == b; it.next())
+                    {
+                        if (!owns(it.key()))
+                            continue;
+
+                        kv_update u = { kv_update::PUT, it.key(), it.value() };
+                        groups[shard_index(it.key())].push_back(u);
+                    }
+
+                    for (size_t i = 0; i < groups.size(); i++)
+                    {
+                        if (groups[i].empty())
+                            continue;
+
+                        shard& s = *_shards[i];
+                        zauto_write_lock l(s.lock);
+                        for (auto& u : groups[i])
+                        {
+                            // the key is written since the base is opened, which is newer
+                            if (s.index.find(u.key) != s.index.end())
+                                continue;
+
+                            // version 0 as the value is as old as the base
+                            entry* e = new_entry(s, u.key, u.value);
+                            s.index.emplace(e->key, e);
+                            s.ordered.emplace(e->key, e);
+                        }
+                        groups[i].clear();
+                    }
+                }
+
+                if (base->corrupted())
+                {
+                    // the base is kept, as the pairs before the damaged block are still
+                    // served from it, and the replica is to fail on corrupted()
+                    _base_corrupted = true;
+                    return false;
+                }
+
+                // everything is in memory now, the mapped file is released once the
+                // readers and the snapshot still using it are gone
+                set_base(nullptr);
+                ddebug("checkpoint %s is fully loaded, %" PRIu64 " records",
+                    base->path().c_str(), base->record_count());
+                return true;
+            }
+
+            void simple_kv_store::set_partition(int index, int count)
+            {
+                _partition_index.store(index);
+                _partition_count.store(count);
+            }
+
+            bool simple_kv_store::owns(const kv_slice& key) const
+            {
+                int count = _partition_count.load(std::memory_order_relaxed);
+                return count <= 0 ||
+                    simple_kv_key_hash(key.data, key.size) % static_cast<uint64_t>(count)
+                    == static_cast<uint64_t>(_partition_index.load(std::memory_order_relaxed));
+            }
+
+            bool simple_kv_store::purge_unowned()
+            {
+                if (_partition_count.load() <= 0)
+                    return true;
+
+                uint64_t purged = 0;
+                for (auto& s : _shards)
+                {
+                    zauto_write_lock l(s->lock);
+
+                    // the snapshot scan relies on that no entry is deleted
+                    if (_snapshot_seq != 0)
+                        return false;
+
+                    for (auto it = s->ordered.begin(); it != s->ordered.end();)
+                    {
+                        entry* e = it->second;
+                        if (owns(e->key))
+                        {
+                            ++it;
+                            continue;
+                        }
+
+                        s->garbage_bytes += sizeof(entry) + e->key.size + e->value.size;
+                        s->index.erase(e->key);
+                        it = s->ordered.erase(it);
+                        purged++;
+                    }
+                    compact_if_necessary(*s);
+                }
+
+                ddebug("%" PRIu64 " pairs not owned by partition %d of %d are purged",
+                    purged, _partition_index.load(), _partition_count.load());
+                return true;
+            }
+        }
+    }
+}
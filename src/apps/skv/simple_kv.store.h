@@ -0,0 +1,242 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     in-memory storage engine for simple_kv, with concurrent readers and a single writer
+ *
+ *     keys are spread over shards by hash, each shard has a hash index for point
+ *     lookups and an ordered index for ordered iteration, both pointing to entries
+ *     whose keys and values are allocated from the shard's slab arena
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include <dsn/service_api_cpp.h>
+# include <cstring>
+# include <map>
+# include <unordered_map>
+# include <vector>
+# include <functional>
+# include <atomic>
+# include <memory>
+
+namespace dsn {
+    namespace replication {
+        namespace application {
+
+            // bump allocator on large slabs, memory is only returned as a whole
+            class kv_arena
+            {
+            public:
+                explicit kv_arena(size_t slab_bytes = 1024 * 1024);
+                ~kv_arena();
+
+                char* allocate(size_t bytes);
+                void  clear();
+                size_t allocated_bytes() const { return _allocated_bytes; }
+
+                void swap(kv_arena& other);
+
+            private:
+                kv_arena(const kv_arena&) = delete;
+                kv_arena& operator=(const kv_arena&) = delete;
+
+            private:
+                size_t             _slab_bytes;
+                std::vector<char*> _slabs;
+                char*              _current;
+                size_t             _left;
+                size_t             _allocated_bytes;
+            };
+
+            struct kv_slice
+            {
+                const char* data;
+                uint32_t    size;
+
+                kv_slice() : data(nullptr), size(0) {}
+                kv_slice(const char* d, uint32_t sz) : data(d), size(sz) {}
+                kv_slice(const std::string& s) : data(s.c_str()), size(static_cast<uint32_t>(s.length())) {}
+
+                std::string to_string() const { return std::string(data, size); }
+                int compare(const kv_slice& o) const;
+                bool operator == (const kv_slice& o) const { return size == o.size && (size == 0 || memcmp(data, o.data, size) == 0); }
+                bool operator < (const kv_slice& o) const { return compare(o) < 0; }
+            };
+
+            struct kv_slice_hash
+            {
+                size_t operator()(const kv_slice& s) const;
+            };
+
+            struct kv_update
+            {
+                enum kind { PUT, APPEND };
+                kind     type;
+                kv_slice key;
+                kv_slice value;
+            };
+
+            class kv_checkpoint_reader;
+
+            class simple_kv_store
+            {
+            public:
+                typedef std::function<void(const kv_slice& key, const kv_slice& value)> visitor;
+                typedef std::function<bool(const kv_slice& key, const kv_slice& value)> range_visitor;
+
+                explicit simple_kv_store(int shard_count = 16);
+                ~simple_kv_store();
+
+                //
+                // a checkpoint file may be attached as the read-only base, pairs not in
+                // memory are then served from it, and load_base() moves them into memory
+                // in the background; returns false when it is stopped halfway
+                //
+                void set_base(std::shared_ptr<kv_checkpoint_reader> base);
+                bool load_base(const std::atomic<bool>& stopped);
+
+                // a damaged block of the base is found, so the pairs in it are lost
+                bool corrupted() const;
+
+                //
+                // reads may run concurrently with each other and with the writer
+                //
+                bool get(const kv_slice& key, /*out*/ std::string& value) const;
+                uint64_t count() const; // pairs in memory
+
+                //
+                // visit the latest pairs in key order from the start key until the visitor
+                // returns false, and then call done; the writer is blocked till done returns,
+                // so the visited slices are valid until then, and the caller should keep
+                // the range short
+                //
+                void scan_range(
+                    const kv_slice& start,
+                    bool start_inclusive,
+                    const range_visitor& visit,
+                    const std::function<void()>& done
+                    ) const;
+
+                //
+                // writes must come from one thread at a time (the replication layer
+                // applies mutations one by one)
+                //
+                void put(const kv_slice& key, const kv_slice& value);
+                void append(const kv_slice& key, const kv_slice& value);
+
+                // apply updates in order, taking each touched shard's lock only once
+                void write_batch(const kv_update* updates, int count);
+
+                // must not be called while a snapshot is alive
+                void clear();
+
+                //
+                // copy-on-write snapshot of the whole store, at most one is alive at a time.
+                // the writer keeps going while the snapshot is scanned, and preserves the
+                // old value of an entry on its first overwrite after the snapshot is taken
+                //
+                bool take_snapshot();
+                void release_snapshot();
+
+                // visit all pairs of the alive snapshot in key order
+                void scan_snapshot(const visitor& v) const;
+
+                // visit in key order only the pairs of the alive snapshot that are written
+                // after the snapshot of the given sequence (the base is left out)
+                void scan_snapshot_delta(const visitor& v, uint64_t since_snapshot_seq) const;
+
+                uint64_t snapshot_seq() const { return _snapshot_seq; }
+
+                // overwrite as part of the durable state, i.e., not seen by scan_snapshot_delta
+                void put_durable(const kv_slice& key, const kv_slice& value);
+
+                //
+                // after a split, the pairs whose simple_kv_key_hash h has h % count != index
+                // belong to the other half, they are skipped by the scans and the base loading
+                // (so checkpoints leave them out), and purge_unowned() drops them from memory;
+                // count is 0 when all pairs are owned
+                //
+                void set_partition(int index, int count);
+                bool owns(const kv_slice& key) const;
+
+                // false when it stops halfway for an alive snapshot, retry after it is released
+                bool purge_unowned();
+
+            private:
+                struct entry
+                {
+                    kv_slice key;
+                    kv_slice value;
+                    uint64_t version;          // write sequence of the current value
+                    kv_slice snapshot_value;   // value seen by snapshot_seq
+                    uint64_t snapshot_version;
+                    uint64_t snapshot_seq;
+                };
+
+                struct shard
+                {
+                    mutable ::dsn::service::zrwlock_nr lock;
+                    kv_arena arena;
+                    std::unordered_map<kv_slice, entry*, kv_slice_hash> index;
+                    std::map<kv_slice, entry*> ordered;
+                    size_t garbage_bytes; // bytes in arena not referenced any more
+
+                    shard() : garbage_bytes(0) {}
+                };
+
+                size_t shard_index(const kv_slice& key) const;
+                shard& shard_of(const kv_slice& key) const;
+                entry* new_entry(shard& s, const kv_slice& key, const kv_slice& value);
+                void set_value(shard& s, entry* e, const kv_slice& value, const kv_slice& tail);
+                void apply(shard& s, const kv_update& u);
+                void compact_if_necessary(shard& s);
+                std::shared_ptr<kv_checkpoint_reader> current_base() const;
+                void scan(const visitor& v, bool delta, uint64_t since_snapshot_seq) const;
+
+            private:
+                std::vector<shard*> _shards;
+
+                std::atomic<uint64_t> _write_seq;
+                uint64_t              _snapshot_seq; // 0 when no snapshot is alive, set under all shard locks
+                std::shared_ptr<kv_checkpoint_reader> _snapshot_base;
+
+                std::shared_ptr<kv_checkpoint_reader> _base; // by std::atomic_load/store
+                std::atomic<bool>     _base_attached;         // false once the base is fully loaded
+                mutable std::atomic<bool> _base_corrupted;    // till clear()
+
+                std::atomic<int>      _partition_index;
+                std::atomic<int>      _partition_count;
+            };
+
+        }
+    }
+}
@@ -6,9 +6,28 @@ struct kv_pair
     2:string value;
 }
 
+struct scan_request
+{
+    1:string start_key; // inclusive
+    2:string stop_key;  // exclusive, empty for no upper bound
+    3:string prefix;    // only keys with this prefix when not empty
+    4:i32    limit;     // max pairs in a page, server default when <= 0
+    5:string context;   // from the former page, empty for the first one
+    6:i32    partition_count; // only keys whose hash % it is the request's partition hash % it, all when <= 0
+}
+
+struct scan_response
+{
+    1:i32           error;
+    2:list<kv_pair> kvs;
+    3:string        context; // to get the next page
+    4:bool          complete;
+}
+
 service simple_kv
 {
     string read(1:string key);
     i32    write(2:kv_pair pr);
     i32    append(2:kv_pair pr);
+    scan_response scan(1:scan_request req);
 }
@@ -8,6 +8,8 @@ namespace dsn {
     namespace replication {
         namespace application {
             GENERATED_TYPE_SERIALIZATION(kv_pair, THRIFT)
+            GENERATED_TYPE_SERIALIZATION(scan_request, THRIFT)
+            GENERATED_TYPE_SERIALIZATION(scan_response, THRIFT)
         }
     }
 }
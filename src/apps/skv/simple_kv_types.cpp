@@ -131,5 +131,390 @@ void kv_pair::printTo(std::ostream& out) const {
   out << ")";
 }
 
+scan_request::~scan_request() throw() {
+}
+
+
+void scan_request::__set_start_key(const std::string& val) {
+  this->start_key = val;
+}
+
+void scan_request::__set_stop_key(const std::string& val) {
+  this->stop_key = val;
+}
+
+void scan_request::__set_prefix(const std::string& val) {
+  this->prefix = val;
+}
+
+void scan_request::__set_limit(const int32_t val) {
+  this->limit = val;
+}
+
+void scan_request::__set_context(const std::string& val) {
+  this->context = val;
+}
+
+void scan_request::__set_partition_count(const int32_t val) {
+  this->partition_count = val;
+}
+
+uint32_t scan_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->start_key);
+          this->__isset.start_key = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->stop_key);
+          this->__isset.stop_key = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->prefix);
+          this->__isset.prefix = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->limit);
+          this->__isset.limit = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->context);
+          this->__isset.context = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 6:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->partition_count);
+          this->__isset.partition_count = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t scan_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("scan_request");
+
+  xfer += oprot->writeFieldBegin("start_key", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeString(this->start_key);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("stop_key", ::apache::thrift::protocol::T_STRING, 2);
+  xfer += oprot->writeString(this->stop_key);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("prefix", ::apache::thrift::protocol::T_STRING, 3);
+  xfer += oprot->writeString(this->prefix);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("limit", ::apache::thrift::protocol::T_I32, 4);
+  xfer += oprot->writeI32(this->limit);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("context", ::apache::thrift::protocol::T_STRING, 5);
+  xfer += oprot->writeString(this->context);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("partition_count", ::apache::thrift::protocol::T_I32, 6);
+  xfer += oprot->writeI32(this->partition_count);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(scan_request &a, scan_request &b) {
+  using ::std::swap;
+  swap(a.start_key, b.start_key);
+  swap(a.stop_key, b.stop_key);
+  swap(a.prefix, b.prefix);
+  swap(a.limit, b.limit);
+  swap(a.context, b.context);
+  swap(a.partition_count, b.partition_count);
+  swap(a.__isset, b.__isset);
+}
+
+scan_request::scan_request(const scan_request& other4) {
+  start_key = other4.start_key;
+  stop_key = other4.stop_key;
+  prefix = other4.prefix;
+  limit = other4.limit;
+  context = other4.context;
+  partition_count = other4.partition_count;
+  __isset = other4.__isset;
+}
+scan_request::scan_request( scan_request&& other5) {
+  start_key = std::move(other5.start_key);
+  stop_key = std::move(other5.stop_key);
+  prefix = std::move(other5.prefix);
+  limit = std::move(other5.limit);
+  context = std::move(other5.context);
+  partition_count = std::move(other5.partition_count);
+  __isset = std::move(other5.__isset);
+}
+scan_request& scan_request::operator=(const scan_request& other6) {
+  start_key = other6.start_key;
+  stop_key = other6.stop_key;
+  prefix = other6.prefix;
+  limit = other6.limit;
+  context = other6.context;
+  partition_count = other6.partition_count;
+  __isset = other6.__isset;
+  return *this;
+}
+scan_request& scan_request::operator=(scan_request&& other7) {
+  start_key = std::move(other7.start_key);
+  stop_key = std::move(other7.stop_key);
+  prefix = std::move(other7.prefix);
+  limit = std::move(other7.limit);
+  context = std::move(other7.context);
+  partition_count = std::move(other7.partition_count);
+  __isset = std::move(other7.__isset);
+  return *this;
+}
+void scan_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "scan_request(";
+  out << "start_key=" << to_string(start_key);
+  out << ", " << "stop_key=" << to_string(stop_key);
+  out << ", " << "prefix=" << to_string(prefix);
+  out << ", " << "limit=" << to_string(limit);
+  out << ", " << "context=" << to_string(context);
+  out << ", " << "partition_count=" << to_string(partition_count);
+  out << ")";
+}
+
+
+scan_response::~scan_response() throw() {
+}
+
+
+void scan_response::__set_error(const int32_t val) {
+  this->error = val;
+}
+
+void scan_response::__set_kvs(const std::vector<kv_pair> & val) {
+  this->kvs = val;
+}
+
+void scan_response::__set_context(const std::string& val) {
+  this->context = val;
+}
+
+void scan_response::__set_complete(const bool val) {
+  this->complete = val;
+}
+
+uint32_t scan_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->error);
+          this->__isset.error = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->kvs.clear();
+            uint32_t _size8;
+            ::apache::thrift::protocol::TType _etype9;
+            xfer += iprot->readListBegin(_etype9, _size8);
+            this->kvs.resize(_size8);
+            uint32_t _i10;
+            for (_i10 = 0; _i10 < _size8; ++_i10)
+            {
+              xfer += this->kvs[_i10].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.kvs = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->context);
+          this->__isset.context = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->complete);
+          this->__isset.complete = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t scan_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("scan_response");
+
+  xfer += oprot->writeFieldBegin("error", ::apache::thrift::protocol::T_I32, 1);
+  xfer += oprot->writeI32(this->error);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("kvs", ::apache::thrift::protocol::T_LIST, 2);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->kvs.size()));
+    std::vector<kv_pair> ::const_iterator _iter11;
+    for (_iter11 = this->kvs.begin(); _iter11 != this->kvs.end(); ++_iter11)
+    {
+      xfer += (*_iter11).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("context", ::apache::thrift::protocol::T_STRING, 3);
+  xfer += oprot->writeString(this->context);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("complete", ::apache::thrift::protocol::T_BOOL, 4);
+  xfer += oprot->writeBool(this->complete);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(scan_response &a, scan_response &b) {
+  using ::std::swap;
+  swap(a.error, b.error);
+  swap(a.kvs, b.kvs);
+  swap(a.context, b.context);
+  swap(a.complete, b.complete);
+  swap(a.__isset, b.__isset);
+}
+
+scan_response::scan_response(const scan_response& other12) {
+  error = other12.error;
+  kvs = other12.kvs;
+  context = other12.context;
+  complete = other12.complete;
+  __isset = other12.__isset;
+}
+scan_response::scan_response( scan_response&& other13) {
+  error = std::move(other13.error);
+  kvs = std::move(other13.kvs);
+  context = std::move(other13.context);
+  complete = std::move(other13.complete);
+  __isset = std::move(other13.__isset);
+}
+scan_response& scan_response::operator=(const scan_response& other14) {
+  error = other14.error;
+  kvs = other14.kvs;
+  context = other14.context;
+  complete = other14.complete;
+  __isset = other14.__isset;
+  return *this;
+}
+scan_response& scan_response::operator=(scan_response&& other15) {
+  error = std::move(other15.error);
+  kvs = std::move(other15.kvs);
+  context = std::move(other15.context);
+  complete = std::move(other15.complete);
+  __isset = std::move(other15.__isset);
+  return *this;
+}
+void scan_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "scan_response(";
+  out << "error=" << to_string(error);
+  out << ", " << "kvs=" << to_string(kvs);
+  out << ", " << "context=" << to_string(context);
+  out << ", " << "complete=" << to_string(complete);
+  out << ")";
+}
+
 }}} // namespace
 #endif
@@ -21,6 +21,10 @@ namespace dsn { namespace replication { namespace application {
 
 class kv_pair;
 
+class scan_request;
+
+class scan_response;
+
 typedef struct _kv_pair__isset {
   _kv_pair__isset() : key(false), value(false) {}
   bool key :1;
@@ -76,6 +80,148 @@ inline std::ostream& operator<<(std::ostream& out, const kv_pair& obj)
   return out;
 }
 
+typedef struct _scan_request__isset {
+  _scan_request__isset() : start_key(false), stop_key(false), prefix(false), limit(false), context(false), partition_count(false) {}
+  bool start_key :1;
+  bool stop_key :1;
+  bool prefix :1;
+  bool limit :1;
+  bool context :1;
+  bool partition_count :1;
+} _scan_request__isset;
+
+class scan_request {
+ public:
+
+  scan_request(const scan_request&);
+  scan_request(scan_request&&);
+  scan_request& operator=(const scan_request&);
+  scan_request& operator=(scan_request&&);
+  scan_request() : start_key(), stop_key(), prefix(), limit(0), context(), partition_count(0) {
+  }
+
+  virtual ~scan_request() throw();
+  std::string start_key;
+  std::string stop_key;
+  std::string prefix;
+  int32_t limit;
+  std::string context;
+  int32_t partition_count;
+
+  _scan_request__isset __isset;
+
+  void __set_start_key(const std::string& val);
+
+  void __set_stop_key(const std::string& val);
+
+  void __set_prefix(const std::string& val);
+
+  void __set_limit(const int32_t val);
+
+  void __set_context(const std::string& val);
+
+  void __set_partition_count(const int32_t val);
+
+  bool operator == (const scan_request & rhs) const
+  {
+    if (!(start_key == rhs.start_key))
+      return false;
+    if (!(stop_key == rhs.stop_key))
+      return false;
+    if (!(prefix == rhs.prefix))
+      return false;
+    if (!(limit == rhs.limit))
+      return false;
+    if (!(context == rhs.context))
+      return false;
+    if (!(partition_count == rhs.partition_count))
+      return false;
+    return true;
+  }
+  bool operator != (const scan_request &rhs) const {
+    return !(*this == rhs);
+  }
+
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(scan_request &a, scan_request &b);
+
+inline std::ostream& operator<<(std::ostream& out, const scan_request& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
+typedef struct _scan_response__isset {
+  _scan_response__isset() : error(false), kvs(false), context(false), complete(false) {}
+  bool error :1;
+  bool kvs :1;
+  bool context :1;
+  bool complete :1;
+} _scan_response__isset;
+
+class scan_response {
+ public:
+
+  scan_response(const scan_response&);
+  scan_response(scan_response&&);
+  scan_response& operator=(const scan_response&);
+  scan_response& operator=(scan_response&&);
+  scan_response() : error(0), context(), complete(0) {
+  }
+
+  virtual ~scan_response() throw();
+  int32_t error;
+  std::vector<kv_pair>  kvs;
+  std::string context;
+  bool complete;
+
+  _scan_response__isset __isset;
+
+  void __set_error(const int32_t val);
+
+  void __set_kvs(const std::vector<kv_pair> & val);
+
+  void __set_context(const std::string& val);
+
+  void __set_complete(const bool val);
+
+  bool operator == (const scan_response & rhs) const
+  {
+    if (!(error == rhs.error))
+      return false;
+    if (!(kvs == rhs.kvs))
+      return false;
+    if (!(context == rhs.context))
+      return false;
+    if (!(complete == rhs.complete))
+      return false;
+    return true;
+  }
+  bool operator != (const scan_response &rhs) const {
+    return !(*this == rhs);
+  }
+
+
+  uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  virtual void printTo(std::ostream& out) const;
+};
+
+void swap(scan_response &a, scan_response &b);
+
+inline std::ostream& operator<<(std::ostream& out, const scan_response& obj)
+{
+  obj.printTo(out);
+  return out;
+}
+
 }}} // namespace
 
 #endif
@@ -100,4 +100,14 @@ namespace dsn {
             return nullptr;
     }
 
+    void message_parser_manager::register_http_bodiless_rpc(const char* rpc_name)
+    {
+        dassert(strlen(rpc_name) < DSN_MAX_TASK_CODE_NAME_LENGTH, "too long rpc name %s", rpc_name);
+        _http_bodiless_rpcs.insert(rpc_name);
+    }
+
+    bool message_parser_manager::is_http_bodiless_rpc(const char* rpc_name) const
+    {
+        return _http_bodiless_rpcs.find(rpc_name) != _http_bodiless_rpcs.end();
+    }
 }
@@ -38,6 +38,9 @@
 # include <dsn/internal/command.h>
 # include <dsn/internal/task.h>
 # include <dsn/cpp/json_helper.h>
+# include <dsn/cpp/auto_codes.h>
+# include <iomanip>
+# include <chrono>
 # include "service_engine.h"
 
 DSN_API dsn_handle_t dsn_perf_counter_create(const char* section, const char* name, dsn_perf_counter_type_t type, const char* description)
@@ -151,10 +154,39 @@ perf_counters::perf_counters(void)
         &perf_counters::get_counter_index
         );
 
+    _history_seconds = 60 * (int)dsn_config_get_value_uint64(
+        "core",
+        "perf_counter_history_minutes",
+        5,
+        "how long (minutes) the values of all counters are kept at 1 second resolution, 0 to disable"
+        );
+    _history_last_sample_ms = 0;
+    _history_stopped = false;
+
+    ::dsn::register_command("counter.history",
+        "counter.history - get the values of a specific counter in the recent seconds, one per second",
+        "counter.history app-name*section-name*counter-name [seconds]",
+        &perf_counters::get_counter_history
+        );
+
+    if (_history_seconds > 0)
+    {
+        _history_thread = std::thread([this]() { history_sampler(); });
+    }
 }
 
 perf_counters::~perf_counters(void)
 {
+    if (_history_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> l(_history_lock);
+            _history_stopped = true;
+        }
+        _history_stop_cond.notify_all();
+        _history_thread.join();
+    }
+
     delete[] _quick_counters;
 }
 
@@ -256,6 +288,11 @@ bool perf_counters::remove_counter(const char* full_name)
         }
     }
     
+    {
+        std::lock_guard<std::mutex> l(_history_lock);
+        _histories.erase(full_name);
+    }
+
     dinfo("performance counter %s is removed", full_name);
     return true;
 }
@@ -468,5 +505,228 @@ std::string perf_counters::get_counter_index(const std::vector<std::string>& arg
     return ss.str();
 }
 
+void perf_counters::history_sampler()
+{
+    std::unique_lock<std::mutex> l(_history_lock);
+    auto next = std::chrono::steady_clock::now();
+    while (true)
+    {
+        next += std::chrono::seconds(1);
+        auto now = std::chrono::steady_clock::now();
+        if (next < now)
+            next = now; // the samples missed are not made up
+
+        if (_history_stop_cond.wait_until(l, next, [this]() { return _history_stopped; }))
+            break;
+
+        l.unlock();
+        sample_history();
+        l.lock();
+    }
+}
+
+void perf_counters::sample_history()
+{
+    std::vector<perf_counter_ptr> counters;
+    {
+        utils::auto_read_lock l(_lock);
+        counters.reserve(_counters.size());
+        for (auto& c : _counters)
+        {
+            counters.push_back(c.second);
+        }
+    }
+
+    // the counters are read without the locks, as some of them take a while
+    std::vector<double> values(counters.size());
+    for (size_t i = 0; i < counters.size(); i++)
+    {
+        if (counters[i]->type() == COUNTER_TYPE_NUMBER_PERCENTILES)
+            values[i] = counters[i]->get_percentile(COUNTER_PERCENTILE_99);
+        else
+            values[i] = counters[i]->get_value();
+    }
+
+    utils::auto_read_lock l(_lock);
+    std::lock_guard<std::mutex> l2(_history_lock);
+    for (size_t i = 0; i < counters.size(); i++)
+    {
+        // removed in the meantime
+        if (_quick_counters[counters[i]->index() >> 32] != counters[i].get())
+            continue;
+
+        counter_history& h = _histories[counters[i]->full_name()];
+        if (h.values.empty())
+        {
+            h.values.resize(_history_seconds, 0);
+            h.next = 0;
+            h.count = 0;
+        }
+
+        h.values[h.next] = values[i];
+        h.next = (h.next + 1) % _history_seconds;
+        if (h.count < _history_seconds)
+            h.count++;
+    }
+    _history_last_sample_ms = utils::get_current_physical_time_ns() / 1000000;
+}
+
+struct history_resp {
+    std::string counter_name;
+    uint64_t end_time_ms; // of the last value
+    uint32_t interval_ms;
+    std::vector<double> values;
+    DEFINE_JSON_SERIALIZATION(counter_name, end_time_ms, interval_ms, values)
+};
+
+std::string perf_counters::get_counter_history(const std::vector<std::string>& args)
+{
+    std::stringstream ss;
+    history_resp resp{ std::string(), 0, 1000, std::vector<double>() };
+
+    if (args.size() < 1)
+    {
+        resp.encode_json_state(ss);
+        return ss.str();
+    }
+
+    resp.counter_name = args[0];
+    int seconds = args.size() >= 2 ? atoi(args[1].c_str()) : 0;
+
+    perf_counters& c = perf_counters::instance();
+    {
+        std::lock_guard<std::mutex> l(c._history_lock);
+        auto it = c._histories.find(args[0]);
+        if (it != c._histories.end())
+        {
+            const counter_history& h = it->second;
+            int count = (seconds > 0 && seconds < h.count) ? seconds : h.count;
+            int size = static_cast<int>(h.values.size());
+            resp.values.reserve(count);
+            for (int i = count; i > 0; i--)
+            {
+                resp.values.push_back(h.values[(h.next - i + size) % size]);
+            }
+            resp.end_time_ms = c._history_last_sample_ms;
+        }
+    }
+
+    resp.encode_json_state(ss);
+    return ss.str();
+}
+
+// metric names are [a-zA-Z_:][a-zA-Z0-9_:]*
+static std::string prometheus_name(const char* name)
+{
+    std::string r = "dsn_";
+    for (const char* p = name; *p; p++)
+    {
+        char ch = *p;
+        if (isalnum(ch) || ch == '_' || ch == ':')
+            r.push_back(ch);
+        else if (r.back() != '_')
+            r.push_back('_');
+    }
+    while (r.back() == '_')
+        r.pop_back();
+    return r;
+}
+
+static std::string prometheus_label_value(const char* value)
+{
+    std::string r;
+    for (const char* p = value; *p; p++)
+    {
+        if (*p == '\\' || *p == '"')
+        {
+            r.push_back('\\');
+            r.push_back(*p);
+        }
+        else if (*p == '\n')
+        {
+            r.append("\\n");
+        }
+        else
+        {
+            r.push_back(*p);
+        }
+    }
+    return r;
+}
+
+std::string perf_counters::get_prometheus_text()
+{
+    // the counters of the same name but of different apps or sections are
+    // one metric with different labels, and must be listed together
+    std::map<std::string, std::vector<perf_counter_ptr> > metrics;
+    {
+        utils::auto_read_lock l(_lock);
+        for (auto& c : _counters)
+        {
+            metrics[prometheus_name(c.second->name())].push_back(c.second);
+        }
+    }
+
+    static const char* quantiles[COUNTER_PERCENTILE_COUNT] = { "0.5", "0.9", "0.95", "0.99", "0.999" };
+
+    // the percentiles are of a sliding window, so a percentile counter has no
+    // cumulative sum or count to export as a summary; its quantiles are gauges
+    std::stringstream ss;
+    ss << std::setprecision(15);
+    for (auto& m : metrics)
+    {
+        ss << "# HELP " << m.first << " " << m.second[0]->dsptr() << "\n";
+        ss << "# TYPE " << m.first << " gauge\n";
+
+        // a metric is either all percentiles or all plain values, as mixing
+        // the two under one name would give series with different labels
+        bool is_percentile = (m.second[0]->type() == COUNTER_TYPE_NUMBER_PERCENTILES);
+        for (auto& c : m.second)
+        {
+            if ((c->type() == COUNTER_TYPE_NUMBER_PERCENTILES) != is_percentile)
+                continue;
+
+            std::string labels = std::string("app=\"") + prometheus_label_value(c->app())
+                + "\",section=\"" + prometheus_label_value(c->section()) + "\"";
+
+            if (!is_percentile)
+            {
+                ss << m.first << "{" << labels << "} " << c->get_value() << "\n";
+                continue;
+            }
+
+            for (int i = 0; i < COUNTER_PERCENTILE_COUNT; i++)
+            {
+                ss << m.first << "{" << labels << ",quantile=\"" << quantiles[i] << "\"} "
+                    << c->get_percentile((dsn_perf_counter_percentile_type_t)i) << "\n";
+            }
+        }
+    }
+    return ss.str();
+}
+
+DEFINE_TASK_CODE_RPC(RPC_PERF_COUNTER_METRICS, TASK_PRIORITY_COMMON, ::dsn::THREAD_POOL_DEFAULT)
+
+static void on_http_metrics(dsn_message_t req, void*)
+{
+    std::string text = perf_counters::instance().get_prometheus_text();
+
+    // the body is the raw text, as the http response has no serialization
+    dsn_message_t resp = dsn_msg_create_response(req);
+    void* ptr;
+    size_t size;
+    dsn_msg_write_next(resp, &ptr, &size, text.size());
+    memcpy(ptr, text.data(), text.size());
+    dsn_msg_write_commit(resp, text.size());
+    dsn_rpc_reply(resp);
+}
+
+/*static*/ void perf_counters::register_http_metrics()
+{
+    // the handler name is the url path, see http_message_parser
+    ::dsn::service_engine::fast_instance().register_system_rpc_handler(RPC_PERF_COUNTER_METRICS, "metrics", on_http_metrics, nullptr);
+    message_parser_manager::instance().register_http_bodiless_rpc("metrics");
+}
+
 } // end namespace
 
@@ -863,12 +863,14 @@ namespace dsn {
                 {
                     if (result.err == ERR_OK)
                     {
-                        // update gpid when necessary
+                        // update gpid when necessary, client.hash is kept so that
+                        // retries are resolved by the key again
                         auto& hdr2 = request->header;
-                        if (*(uint64_t*)&hdr2->gpid != *(uint64_t*)&result.pid)
+                        if (*(uint64_t*)&hdr2->gpid != *(uint64_t*)&result.pid
+                            || (hdr2->client.flags & MSG_CLIENT_FLAG_KEY_HASH) == 0)
                         {
                             hdr2->gpid = result.pid;
-                            hdr2->client.hash = dsn_gpid_to_hash(result.pid);
+                            hdr2->client.flags |= MSG_CLIENT_FLAG_KEY_HASH;
                             request->seal(task_spec::get(request->local_rpc_code)->rpc_message_crc_required);
                         }
 
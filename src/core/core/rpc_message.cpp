@@ -199,6 +199,16 @@ DSN_API void dsn_msg_get_options(
     opts->gpid = hdr->gpid;
 }
 
+DSN_API uint64_t dsn_msg_get_partition_hash(dsn_message_t msg)
+{
+    return ((::dsn::message_ex*)msg)->header->client.hash;
+}
+
+DSN_API bool dsn_msg_has_key_hash(dsn_message_t msg)
+{
+    return (((::dsn::message_ex*)msg)->header->client.flags & MSG_CLIENT_FLAG_KEY_HASH) != 0;
+}
+
 DSN_API dsn_msg_header_type dsn_msg_get_header_type(
     dsn_message_t msg
     )
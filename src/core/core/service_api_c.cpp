@@ -1353,6 +1353,12 @@ bool run(const char* config_file, const char* config_arguments, bool sleep_after
         ::dsn::command_manager::instance().start_remote_cli();
     }
 
+    if (dsn_all.config->get_value<bool>("core", "perf_counter_http_enabled", true,
+        "whether to serve all perf counters in the prometheus text format at http://<rpc address>/metrics"))
+    {
+        ::dsn::perf_counters::register_http_metrics();
+    }
+
     // register local cli commands
     ::dsn::register_command("config-dump",
         "config-dump - dump configuration",
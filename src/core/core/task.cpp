@@ -531,7 +531,12 @@ rpc_request_task::rpc_request_task(message_ex* request, rpc_handler_info* h, ser
     : task(dsn_task_code_t(h->code),  // it is possible that request->local_rpc_code != h->code when it is handled in frameworks
         nullptr, 
         [](void*) { dassert(false, "rpc request task cannot be cancelled"); },
-        static_cast<int>(request->header->client.hash), node),
+        // requests resolved to a partition are dispatched by the partition, as
+        // client.hash keeps the key hash for the server to see
+        request->header->gpid.value != 0
+            ? static_cast<int>(dsn_gpid_to_hash(request->header->gpid))
+            : static_cast<int>(request->header->client.hash),
+        node),
     _request(request),
     _handler(h),
     _enqueue_ts_ns(0)
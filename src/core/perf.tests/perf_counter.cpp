@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     throughput of the number counters when all threads update the same counter
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include <gtest/gtest.h>
+# include <dsn/tool_api.h>
+
+# include "../tools/common/simple_perf_counter_v2_atomic.h"
+# include "../tools/common/simple_perf_counter_v2_fast.h"
+# include "../tools/common/simple_perf_counter_v2_tls.h"
+
+# include <thread>
+# include <vector>
+# include <chrono>
+# include <iostream>
+
+using namespace ::dsn;
+using namespace ::dsn::tools;
+
+static uint64_t run_increments(perf_counter_ptr pc, int thread_count, int times)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back([pc, times]() {
+            for (int j = 0; j < times; ++j)
+                pc->increment();
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+TEST(perf_counter, number_contended_increments)
+{
+    int thread_count = std::max(2, std::min(16, (int)std::thread::hardware_concurrency()));
+    const int times = 1000000;
+
+    std::vector<std::pair<const char*, perf_counter::factory> > factories{
+        {"v2_atomic", simple_perf_counter_v2_atomic_factory},
+        {"v2_fast", simple_perf_counter_v2_fast_factory},
+        {"v2_tls", simple_perf_counter_v2_tls_factory}
+    };
+
+    for (auto& f : factories)
+    {
+        perf_counter_ptr counter = f.second("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER, "");
+        uint64_t ns = run_increments(counter, thread_count, times);
+        uint64_t expected = (uint64_t)thread_count * times;
+        uint64_t value = counter->get_integer_value();
+
+        std::cout << "perf_counter_" << f.first << ": " << thread_count << " threads, "
+                  << (double)expected * 1000.0 / ns << " M increments/s, "
+                  << expected - value << " of " << expected << " increments lost" << std::endl;
+
+        // v2_fast trades exactness for speed
+        if (f.second != simple_perf_counter_v2_fast_factory)
+            ASSERT_EQ(expected, value);
+    }
+}
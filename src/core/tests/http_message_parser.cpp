@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Unit-test for http_message_parser.
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "../tools/common/http_message_parser.h"
+# include <gtest/gtest.h>
+# include <cstring>
+
+using namespace ::dsn;
+
+static message_ex* parse_http(const char* request, /*out*/ int& read_next)
+{
+    http_message_parser parser;
+    message_reader reader(4096);
+    size_t length = strlen(request);
+    memcpy(reader.read_buffer_ptr(static_cast<unsigned int>(length)), request, length);
+    reader.mark_read(static_cast<unsigned int>(length));
+    return parser.get_message_on_receive(&reader, read_next);
+}
+
+TEST(core, http_message_parser_bodiless_request)
+{
+    // "metrics" is registered by perf_counters::register_http_metrics on start
+    ASSERT_TRUE(message_parser_manager::instance().is_http_bodiless_rpc("metrics"));
+
+    int read_next;
+    message_ex* msg = parse_http("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n", read_next);
+    ASSERT_NE(nullptr, msg);
+    ASSERT_STREQ("metrics", msg->header->rpc_name);
+    ASSERT_EQ(0u, msg->header->body_length);
+    ASSERT_EQ(1, msg->header->context.u.is_request);
+    msg->add_ref();
+    msg->release_ref();
+
+    // the other rpcs expect a marshalled body, so they are refused without one
+    msg = parse_http("GET /RPC_CM_QUERY_NODE_PARTITIONS HTTP/1.1\r\nHost: localhost\r\n\r\n", read_next);
+    ASSERT_EQ(nullptr, msg);
+    ASSERT_EQ(-1, read_next);
+
+    msg = parse_http("GET /DSF_THRIFT_JSON/0/RPC_CM_QUERY_NODE_PARTITIONS HTTP/1.1\r\nHost: localhost\r\n\r\n", read_next);
+    ASSERT_EQ(nullptr, msg);
+    ASSERT_EQ(-1, read_next);
+}
@@ -36,12 +36,16 @@
 #include "../tools/common/simple_perf_counter.h"
 #include "../tools/common/simple_perf_counter_v2_atomic.h"
 #include "../tools/common/simple_perf_counter_v2_fast.h"
+#include "../tools/common/simple_perf_counter_v2_tls.h"
 
 #include <dsn/tool_api.h>
 #include <gtest/gtest.h>
 #include <thread>
 #include <cmath>
 #include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 using namespace dsn;
 using namespace dsn::tools;
@@ -127,3 +131,182 @@ TEST(tools_common, simple_perf_counter_v2_fast)
     test_perf_counter(simple_perf_counter_v2_fast_factory);
 }
 
+TEST(tools_common, simple_perf_counter_v2_tls)
+{
+    test_perf_counter(simple_perf_counter_v2_tls_factory);
+}
+
+static uint64_t run_increments(perf_counter_ptr pc, int thread_count, int times)
+{
+    std::vector< thread_ptr > threads;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i=0; i<thread_count; ++i) {
+        thread_ptr t( new std::thread([pc, times]() {
+            for (int j=0; j<times; ++j)
+                pc->increment();
+        }) );
+        threads.push_back(t);
+    }
+    for (unsigned int i=0; i!=threads.size(); ++i)
+        threads[i]->join();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+TEST(tools_common, simple_perf_counter_v2_tls_exact)
+{
+    perf_counter_ptr counter = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER, "");
+
+    // the updates of the exited threads still count
+    run_increments(counter, 8, count_times);
+    ASSERT_EQ((uint64_t)8 * count_times, counter->get_integer_value());
+
+    perf_counter_inc_dec(counter);
+    ASSERT_EQ((uint64_t)8 * count_times, counter->get_integer_value());
+
+    counter->set(5);
+    ASSERT_EQ(5u, counter->get_integer_value());
+    counter->increment();
+    ASSERT_EQ(6u, counter->get_integer_value());
+
+    // a new counter on the index of a released one starts from 0
+    counter = nullptr;
+    counter = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER, "");
+    counter->increment();
+    ASSERT_EQ(1u, counter->get_integer_value());
+}
+
+TEST(tools_common, simple_perf_counter_v2_tls_thread_exit)
+{
+    perf_counter_ptr c1 = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER, "");
+    perf_counter_ptr c2 = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_RATE, "");
+
+    // many short-lived threads, whose slots are folded into the counter when they exit
+    for (int i = 0; i < 100; ++i) {
+        std::thread t([c1, c2]() {
+            c1->add(3);
+            c2->increment();
+        });
+        t.join();
+    }
+    ASSERT_EQ(300u, c1->get_integer_value());
+
+    c1->set(7);
+    run_increments(c1, 4, 100);
+    ASSERT_EQ(407u, c1->get_integer_value());
+
+    // a thread exiting after the counter it updated is destroyed
+    std::mutex lock;
+    std::condition_variable cv;
+    bool updated = false, released = false;
+    std::thread t([&]() {
+        perf_counter_ptr c3 = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER, "");
+        c3->increment();
+        c1->increment();
+        c3 = nullptr;
+
+        std::unique_lock<std::mutex> l(lock);
+        updated = true;
+        cv.notify_all();
+        cv.wait(l, [&]() { return released; });
+    });
+    {
+        std::unique_lock<std::mutex> l(lock);
+        cv.wait(l, [&]() { return updated; });
+        c2 = nullptr;
+        released = true;
+        cv.notify_all();
+    }
+    t.join();
+    ASSERT_EQ(408u, c1->get_integer_value());
+}
+
+TEST(tools_common, log_linear_histogram_boundaries)
+{
+    ASSERT_EQ(0, histogram_snapshot::bucket_index(0));
+    ASSERT_EQ(1, histogram_snapshot::bucket_index(1));
+    ASSERT_EQ(0, histogram_snapshot::most_significant_bit(1));
+
+    // every power of two from the linear limit on starts a new group of sub buckets
+    const int linear_bits = histogram_snapshot::sub_bucket_bits + 1;
+    for (int k = 1; k < 64; ++k) {
+        uint64_t v = 1ULL << k;
+        ASSERT_EQ(k, histogram_snapshot::most_significant_bit(v));
+        ASSERT_EQ(k - 1, histogram_snapshot::most_significant_bit(v - 1));
+        ASSERT_EQ(k, histogram_snapshot::most_significant_bit(v | (v - 1)));
+
+        int index = histogram_snapshot::bucket_index(v);
+        if (k < linear_bits) {
+            ASSERT_EQ((int)v, index);
+        } else {
+            ASSERT_EQ(histogram_snapshot::linear_limit + (k - linear_bits) * histogram_snapshot::sub_bucket_count, index);
+            ASSERT_EQ(v, histogram_snapshot::bucket_value(index) - (v >> (histogram_snapshot::sub_bucket_bits + 1)));
+        }
+        ASSERT_EQ(index - 1, histogram_snapshot::bucket_index(v - 1));
+    }
+    ASSERT_EQ(histogram_snapshot::bucket_count - histogram_snapshot::sub_bucket_count,
+        histogram_snapshot::bucket_index(1ULL << 63));
+}
+
+TEST(tools_common, log_linear_histogram)
+{
+    // exact below the linear limit, and within the sub bucket precision above
+    for (uint64_t v = 0; v < 1000000; v += 7) {
+        uint64_t b = histogram_snapshot::bucket_value(histogram_snapshot::bucket_index(v));
+        ASSERT_LE(std::abs((double)b - (double)v), v / (double)histogram_snapshot::sub_bucket_count + 0.5);
+    }
+    ASSERT_EQ(histogram_snapshot::bucket_count - 1, histogram_snapshot::bucket_index(~0ULL));
+
+    log_linear_histogram h1, h2;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h1.record(v);
+        h2.record(v + 1000);
+    }
+
+    histogram_snapshot s1, s2;
+    h1.snapshot(s1);
+    h2.snapshot(s2);
+    ASSERT_EQ(1000u, s1.count);
+    ASSERT_NEAR(500, (double)s1.value_at_percentile(50), 500 * 0.04);
+    ASSERT_NEAR(999, (double)s1.value_at_percentile(99.9), 999 * 0.04);
+
+    // the merged percentiles are the ones of all the samples
+    s1.merge(s2);
+    ASSERT_EQ(2000u, s1.count);
+    ASSERT_NEAR(1000, (double)s1.value_at_percentile(50), 1000 * 0.04);
+    ASSERT_NEAR(1998, (double)s1.value_at_percentile(99.9), 1998 * 0.04);
+
+    // a window is the difference of two snapshots
+    histogram_snapshot start;
+    h1.snapshot(start);
+    for (int i = 0; i < 100; ++i)
+        h1.record(5000);
+    histogram_snapshot window;
+    h1.snapshot(window);
+    window.subtract(start);
+    ASSERT_EQ(100u, window.count);
+    ASSERT_NEAR(5000, (double)window.value_at_percentile(50), 5000 * 0.04);
+}
+
+TEST(tools_common, simple_perf_counter_v2_tls_percentile)
+{
+    perf_counter_ptr counter = simple_perf_counter_v2_tls_factory("", "", "", dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER_PERCENTILES, "");
+    ASSERT_EQ(-1.0, counter->get_percentile(COUNTER_PERCENTILE_50));
+
+    std::vector< thread_ptr > threads;
+    for (int i=0; i<4; ++i) {
+        thread_ptr t( new std::thread([counter]() {
+            for (uint64_t v=1; v<=10000; ++v)
+                counter->set(v);
+        }) );
+        threads.push_back(t);
+    }
+    for (unsigned int i=0; i!=threads.size(); ++i)
+        threads[i]->join();
+
+    histogram_snapshot h;
+    ASSERT_TRUE(counter->get_histogram(h));
+    ASSERT_EQ(40000u, h.count);
+    ASSERT_NEAR(9990, counter->get_percentile(COUNTER_PERCENTILE_999), 9990 * 0.04);
+    ASSERT_NEAR(5000, counter->get_percentile(COUNTER_PERCENTILE_50), 5000 * 0.04);
+}
@@ -72,3 +72,30 @@ TEST(core, perf_counters)
     ASSERT_EQ(nullptr, p);
     ASSERT_FALSE(c.remove_counter("app*test*unexist_counter"));
 }
+
+TEST(core, perf_counters_prometheus_text)
+{
+    perf_counters& c = perf_counters::instance();
+    perf_counter_ptr p = c.get_counter("app", "test", "prom.counter#1", COUNTER_TYPE_NUMBER, "", true);
+    ASSERT_NE(nullptr, p);
+    p->set(42);
+
+    std::string text = c.get_prometheus_text();
+    ASSERT_NE(std::string::npos, text.find("# TYPE dsn_prom_counter_1 gauge\n"));
+    ASSERT_NE(std::string::npos, text.find("dsn_prom_counter_1{app=\"app\",section=\"test\"} 42\n"));
+
+    // the percentiles are of a sliding window, so they are gauges with no _sum or _count
+    perf_counter_ptr pp = c.get_counter("app", "test", "prom.latency", COUNTER_TYPE_NUMBER_PERCENTILES, "", true);
+    ASSERT_NE(nullptr, pp);
+    text = c.get_prometheus_text();
+    ASSERT_NE(std::string::npos, text.find("# TYPE dsn_prom_latency gauge\n"));
+    ASSERT_NE(std::string::npos, text.find("dsn_prom_latency{app=\"app\",section=\"test\",quantile=\"0.99\"} "));
+    ASSERT_EQ(std::string::npos, text.find("dsn_prom_latency_sum"));
+    ASSERT_EQ(std::string::npos, text.find("dsn_prom_latency_count"));
+
+    ASSERT_TRUE(c.remove_counter("app*test*prom.counter#1"));
+    ASSERT_TRUE(c.remove_counter("app*test*prom.latency"));
+    text = c.get_prometheus_text();
+    ASSERT_EQ(std::string::npos, text.find("dsn_prom_counter_1"));
+    ASSERT_EQ(std::string::npos, text.find("dsn_prom_latency"));
+}
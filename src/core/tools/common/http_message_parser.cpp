@@ -80,6 +80,22 @@ http_message_parser::http_message_parser()
 
         dinfo("http call %s", url.c_str());
 
+        // url = "/" + rpc_name, e.g., /metrics for a scraper's GET, where the
+        // handler is registered with the name, see perf_counters::register_http_metrics;
+        // only for the rpcs taking no body, the others would fail to unmarshall
+        if (args.size() == 1)
+        {
+            std::string name = args[0].substr(0, args[0].find('?'));
+            if (!message_parser_manager::instance().is_http_bodiless_rpc(name.c_str()))
+            {
+                derror("rpc %s in url %s is not callable without body", name.c_str(), url.c_str());
+                return 1;
+            }
+            auto owner = static_cast<http_message_parser*>(parser->data);
+            strcpy(owner->_current_message->header->rpc_name, name.c_str());
+            return 0;
+        }
+
         if (args.size() != 3)
         {
             dinfo("skip url parse for %s, could be done in headers if not cross-domain", url.c_str());
@@ -349,7 +365,24 @@ http_message_parser::http_message_parser()
         owner->_current_message->header->body_length = length;
         owner->_received_messages.emplace(std::move(owner->_current_message));
         return 0;
-    };    
+    };
+    _parser_setting.on_message_complete = [](http_parser* parser)->int
+    {
+        // a message without body, e.g., a GET, is not taken in on_body,
+        // and is delivered only to the rpcs taking no body
+        auto owner = static_cast<http_message_parser*>(parser->data);
+        if (owner->_current_message != nullptr)
+        {
+            if (!message_parser_manager::instance().is_http_bodiless_rpc(owner->_current_message->header->rpc_name))
+            {
+                derror("rpc %s is not callable without body", owner->_current_message->header->rpc_name);
+                return 1;
+            }
+            owner->_current_message->header->body_length = 0;
+            owner->_received_messages.emplace(std::move(owner->_current_message));
+        }
+        return 0;
+    };
     http_parser_init(&_parser, HTTP_BOTH);
 }
 
@@ -374,6 +407,13 @@ message_ex* http_message_parser::get_message_on_receive(message_reader* reader,
         return nullptr;
     }
 
+    if (HTTP_PARSER_ERRNO(&_parser) != HPE_OK)
+    {
+        derror("invalid http message: %s", http_errno_name(HTTP_PARSER_ERRNO(&_parser)));
+        read_next = -1;
+        return nullptr;
+    }
+
     if (!_received_messages.empty())
     {
         auto msg = std::move(_received_messages.front());
@@ -43,6 +43,7 @@
 # include "simple_perf_counter.h"
 # include "simple_perf_counter_v2_atomic.h"
 # include "simple_perf_counter_v2_fast.h"
+# include "simple_perf_counter_v2_tls.h"
 # include "simple_task_queue.h"
 # include "network.sim.h"
 # include "simple_logger.h"
@@ -98,6 +99,11 @@ namespace dsn {
                 simple_perf_counter_v2_fast_factory,
                 PROVIDER_TYPE_MAIN
                 );
+            ::dsn::tools::internal_use_only::register_component_provider(
+                "dsn::tools::simple_perf_counter_v2_tls",
+                simple_perf_counter_v2_tls_factory,
+                PROVIDER_TYPE_MAIN
+                );
         }
     }
 }
@@ -0,0 +1,486 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ * 
+ * -=- Robust Distributed System Nucleus (rDSN) -=- 
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     Performance counter ver.tls
+ *     Each thread updates its own slot of a Number or Rate counter, which is padded
+ *     to a cache line of its own and found through a thread local table, and the
+ *     slots are summed up on read; so the updates neither contend nor falsely share
+ *     cache lines as in ver.faster, and none is lost as each slot has one writer
+ *     Percentiles are computed from a log-linear histogram with atomic buckets (see
+ *     log_linear_histogram.h) over fixed time windows aligned to the wall clock, so
+ *     they are exact up to the bucket precision for all the samples of a window, and
+ *     the windows of many nodes are mergeable
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# include "simple_perf_counter_v2_tls.h"
+# include "shared_io_service.h"
+# include <atomic>
+# include <mutex>
+# include <vector>
+
+namespace dsn {
+    namespace tools {
+
+# define CACHELINE_SIZE 64
+
+        // the value is padded on both sides, so the cache line it is on belongs to
+        // this slot only, whatever the alignment of the allocation is
+        struct tls_counter_slot
+        {
+            char                 padding_before[CACHELINE_SIZE];
+            std::atomic<int64_t> value;
+            char                 padding_after[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+            tls_counter_slot() : value(0) {}
+        };
+
+        // thread local table from the index of a counter to the slot of this thread,
+        // an entry is valid only when its generation matches the counter's, so the
+        // entries of destroyed counters are never used even when the index is reused
+        struct tls_counter_entry
+        {
+            uint64_t          generation;
+            tls_counter_slot* slot;
+        };
+
+        struct tls_counter_table
+        {
+            tls_counter_entry* entries;
+            uint32_t           capacity;
+        };
+
+        static __thread tls_counter_table s_tls_counter_table;
+
+        class perf_counter_tls_base;
+
+        // dense indices of the live counters, and unique generations;
+        // the index of a destroyed counter is reused by the next new counter
+        class tls_counter_index_allocator
+        {
+        public:
+            static tls_counter_index_allocator& instance()
+            {
+                // never destroyed, as counters may be released after the static destructors
+                static tls_counter_index_allocator* inst = new tls_counter_index_allocator();
+                return *inst;
+            }
+
+            void allocate(perf_counter_tls_base* counter, /*out*/ uint32_t& index, /*out*/ uint64_t& generation)
+            {
+                std::lock_guard<std::mutex> l(_lock);
+                if (_free_indices.empty())
+                {
+                    index = _next_index++;
+                    _generations.push_back(0);
+                    _owners.push_back(nullptr);
+                }
+                else
+                {
+                    index = _free_indices.back();
+                    _free_indices.pop_back();
+                }
+                generation = ++_next_generation;
+                _generations[index] = generation;
+                _owners[index] = counter;
+            }
+
+            // after this, no exiting thread touches the counter any more
+            void release(uint32_t index)
+            {
+                std::lock_guard<std::mutex> l(_lock);
+                _generations[index] = 0;
+                _owners[index] = nullptr;
+                _free_indices.push_back(index);
+            }
+
+            // the slots of an exiting thread are folded into their live counters
+            void on_thread_exit(tls_counter_table& table);
+
+        private:
+            tls_counter_index_allocator() : _next_index(0), _next_generation(0) {}
+
+            std::mutex            _lock;
+            std::vector<uint32_t> _free_indices;
+            uint32_t              _next_index;
+            uint64_t              _next_generation;
+            std::vector<uint64_t>               _generations; // of the live counters by index, 0 when free
+            std::vector<perf_counter_tls_base*> _owners;
+        };
+
+        // releases the slots of this thread when it exits, see register_slot
+        struct tls_counter_thread_guard
+        {
+            ~tls_counter_thread_guard()
+            {
+                tls_counter_index_allocator::instance().on_thread_exit(s_tls_counter_table);
+            }
+        };
+
+        class perf_counter_tls_base : public perf_counter
+        {
+        public:
+            perf_counter_tls_base(const char* app, const char *section, const char *name, dsn_perf_counter_type_t type, const char *dsptr)
+                : perf_counter(app, section, name, type, dsptr), _base(0)
+            {
+                tls_counter_index_allocator::instance().allocate(this, _tls_index, _generation);
+            }
+
+            ~perf_counter_tls_base(void)
+            {
+                tls_counter_index_allocator::instance().release(_tls_index);
+                for (auto& s : _slots)
+                {
+                    delete s;
+                }
+            }
+
+            // called when the thread owning the slot exits, the value of the slot is
+            // kept in _base so the updates of the exited threads still count
+            void retire_slot(tls_counter_slot* slot)
+            {
+                std::lock_guard<std::mutex> l(_slots_lock);
+                for (auto it = _slots.begin(); it != _slots.end(); ++it)
+                {
+                    if (*it == slot)
+                    {
+                        _base.fetch_add(slot->value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        *it = _slots.back();
+                        _slots.pop_back();
+                        delete slot;
+                        return;
+                    }
+                }
+            }
+
+        protected:
+            // only this thread writes its slot, so a plain load and store is exact
+            void local_add(int64_t val)
+            {
+                tls_counter_slot* slot = get_slot();
+                slot->value.store(slot->value.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+            }
+
+            int64_t sum()
+            {
+                std::lock_guard<std::mutex> l(_slots_lock);
+                int64_t val = _base.load(std::memory_order_relaxed);
+                for (auto& s : _slots)
+                {
+                    val += s->value.load(std::memory_order_relaxed);
+                }
+                return val;
+            }
+
+            void reset_to(int64_t val)
+            {
+                std::lock_guard<std::mutex> l(_slots_lock);
+                int64_t slots_val = 0;
+                for (auto& s : _slots)
+                {
+                    slots_val += s->value.load(std::memory_order_relaxed);
+                }
+                _base.store(val - slots_val, std::memory_order_relaxed);
+            }
+
+        private:
+            tls_counter_slot* get_slot()
+            {
+                tls_counter_table& table = s_tls_counter_table;
+                if (_tls_index < table.capacity && table.entries[_tls_index].generation == _generation)
+                    return table.entries[_tls_index].slot;
+                else
+                    return register_slot();
+            }
+
+            tls_counter_slot* register_slot()
+            {
+                // constructed on the first registration of this thread
+                static thread_local tls_counter_thread_guard s_guard;
+                (void)s_guard;
+
+                tls_counter_table& table = s_tls_counter_table;
+                if (_tls_index >= table.capacity)
+                {
+                    uint32_t capacity = table.capacity == 0 ? 64 : table.capacity;
+                    while (capacity <= _tls_index)
+                        capacity *= 2;
+
+                    tls_counter_entry* entries = new tls_counter_entry[capacity];
+                    for (uint32_t i = 0; i < capacity; i++)
+                    {
+                        entries[i] = i < table.capacity ? table.entries[i] : tls_counter_entry{ 0, nullptr };
+                    }
+                    delete[] table.entries;
+                    table.entries = entries;
+                    table.capacity = capacity;
+                }
+
+                tls_counter_slot* slot = new tls_counter_slot();
+                {
+                    std::lock_guard<std::mutex> l(_slots_lock);
+                    _slots.push_back(slot);
+                }
+                table.entries[_tls_index] = tls_counter_entry{ _generation, slot };
+                return slot;
+            }
+
+        private:
+            uint32_t                        _tls_index;
+            uint64_t                        _generation;
+            std::mutex                      _slots_lock;
+            std::vector<tls_counter_slot*>  _slots;
+            std::atomic<int64_t>            _base; // makes set() exact, and keeps the values of the exited threads
+        };
+
+        void tls_counter_index_allocator::on_thread_exit(tls_counter_table& table)
+        {
+            {
+                std::lock_guard<std::mutex> l(_lock);
+                for (uint32_t i = 0; i < table.capacity && i < _generations.size(); i++)
+                {
+                    tls_counter_entry& e = table.entries[i];
+                    if (e.slot != nullptr && e.generation == _generations[i])
+                    {
+                        _owners[i]->retire_slot(e.slot);
+                    }
+                }
+            }
+
+            // a counter updated later by this thread registers a new slot
+            delete[] table.entries;
+            table.entries = nullptr;
+            table.capacity = 0;
+        }
+
+        // -----------   NUMBER perf counter ---------------------------------
+
+        class perf_counter_number_v2_tls : public perf_counter_tls_base
+        {
+        public:
+            perf_counter_number_v2_tls(const char* app, const char *section, const char *name, dsn_perf_counter_type_t type, const char *dsptr)
+                : perf_counter_tls_base(app, section, name, type, dsptr)
+            {
+            }
+            ~perf_counter_number_v2_tls(void) {}
+
+            virtual void   increment() { local_add(1); }
+            virtual void   decrement() { local_add(-1); }
+            virtual void   add(uint64_t val) { local_add(static_cast<int64_t>(val)); }
+            virtual void   set(uint64_t val) { reset_to(static_cast<int64_t>(val)); }
+            virtual double get_value() { return static_cast<double>(sum()); }
+            virtual uint64_t get_integer_value() { return static_cast<uint64_t>(sum()); }
+            virtual double get_percentile(dsn_perf_counter_percentile_type_t type) { dassert(false, "invalid execution flow"); return 0.0; }
+        };
+
+        // -----------   RATE perf counter ---------------------------------
+
+        class perf_counter_rate_v2_tls : public perf_counter_tls_base
+        {
+        public:
+            perf_counter_rate_v2_tls(const char* app, const char *section, const char *name, dsn_perf_counter_type_t type, const char *dsptr)
+                : perf_counter_tls_base(app, section, name, type, dsptr), _last_sum(0), _rate(0)
+            {
+                _last_time = ::dsn::utils::get_current_physical_time_ns();
+            }
+            ~perf_counter_rate_v2_tls(void) {}
+
+            virtual void   increment() { local_add(1); }
+            virtual void   decrement() { local_add(-1); }
+            virtual void   add(uint64_t val) { local_add(static_cast<int64_t>(val)); }
+            virtual void   set(uint64_t val) { dassert(false, "invalid execution flow"); }
+
+            // the slots are never reset, the rate is the delta of the sum since the last read
+            virtual double get_value()
+            {
+                std::lock_guard<std::mutex> l(_rate_lock);
+                uint64_t now = ::dsn::utils::get_current_physical_time_ns();
+                double interval = (now - _last_time) / 1e9;
+                if (interval <= 0.1)
+                    return _rate;
+
+                int64_t val = sum();
+                _rate = (val - _last_sum) / interval;
+                _last_sum = val;
+                _last_time = now;
+                return _rate;
+            }
+            virtual uint64_t get_integer_value() { return (uint64_t)get_value(); }
+            virtual double get_percentile(dsn_perf_counter_percentile_type_t type) { dassert(false, "invalid execution flow"); return 0.0; }
+
+        private:
+            std::mutex _rate_lock;
+            int64_t    _last_sum;
+            uint64_t   _last_time;
+            double     _rate;
+        };
+
+        // -----------   NUMBER_PERCENTILE perf counter ---------------------------------
+
+        class perf_counter_number_percentile_v2_tls : public perf_counter
+        {
+        public:
+            perf_counter_number_percentile_v2_tls(const char* app, const char *section, const char *name, dsn_perf_counter_type_t type, const char *dsptr)
+                : perf_counter(app, section, name, type, dsptr), _last_sample(0), _has_window(false)
+            {
+                _window_seconds = config()->get_value<int>(
+                    "components.simple_perf_counter_v2_tls",
+                    "percentile_window_seconds",
+                    60,
+                    "the percentiles are of the samples in the last complete window of this many seconds");
+                if (_window_seconds <= 0)
+                    _window_seconds = 60;
+
+                _timer.reset(new boost::asio::deadline_timer(shared_io_service::instance().ios));
+                _timer->expires_from_now(boost::posix_time::milliseconds(ms_to_next_window()));
+                this->add_ref();
+                _timer->async_wait(std::bind(&perf_counter_number_percentile_v2_tls::on_timer, this, _timer, std::placeholders::_1));
+            }
+
+            ~perf_counter_number_percentile_v2_tls(void)
+            {
+                _timer->cancel();
+            }
+
+            virtual void   increment() { dassert(false, "invalid execution flow"); }
+            virtual void   decrement() { dassert(false, "invalid execution flow"); }
+            virtual void   add(uint64_t val) { dassert(false, "invalid execution flow"); }
+            virtual void   set(uint64_t val)
+            {
+                _histogram.record(val);
+                _last_sample.store(val, std::memory_order_relaxed);
+            }
+
+            virtual double get_value() { dassert(false, "invalid execution flow");  return 0.0; }
+            virtual uint64_t get_integer_value() { return (uint64_t)get_value(); }
+
+            virtual double get_percentile(dsn_perf_counter_percentile_type_t type)
+            {
+                static const double percentiles[COUNTER_PERCENTILE_COUNT] = { 50, 90, 95, 99, 99.9 };
+                if ((type < 0) || (type >= COUNTER_PERCENTILE_COUNT))
+                {
+                    dassert(false, "send a wrong counter percentile type");
+                    return -1;
+                }
+
+                std::lock_guard<std::mutex> l(_window_lock);
+                if (_has_window)
+                    return (double)_window.value_at_percentile(percentiles[type]);
+
+                // no window is complete yet, so the samples so far are used
+                histogram_snapshot current;
+                _histogram.snapshot(current);
+                if (current.count == 0)
+                    return -1.0;
+                return (double)current.value_at_percentile(percentiles[type]);
+            }
+
+            virtual bool get_histogram(/*out*/ histogram_snapshot& window) override
+            {
+                std::lock_guard<std::mutex> l(_window_lock);
+                if (_has_window)
+                    window = _window;
+                else
+                    _histogram.snapshot(window);
+                return true;
+            }
+
+            virtual uint64_t get_latest_sample() const override
+            {
+                return _last_sample.load(std::memory_order_relaxed);
+            }
+
+        private:
+            // the windows are aligned to the wall clock, so that the windows of different nodes match
+            uint64_t ms_to_next_window() const
+            {
+                uint64_t now_ms = ::dsn::utils::get_current_physical_time_ns() / 1000000;
+                uint64_t window_ms = static_cast<uint64_t>(_window_seconds) * 1000;
+                return window_ms - now_ms % window_ms;
+            }
+
+            void on_timer(std::shared_ptr<boost::asio::deadline_timer> timer, const boost::system::error_code& ec)
+            {
+                //as the callback is not in tls context, so the log system calls like ddebug, dassert will cause a lock
+                if (!ec)
+                {
+                    // only when others also hold the reference
+                    if (this->get_count() > 1)
+                    {
+                        histogram_snapshot now;
+                        _histogram.snapshot(now);
+                        histogram_snapshot window = now;
+                        window.subtract(_window_start);
+
+                        {
+                            std::lock_guard<std::mutex> l(_window_lock);
+                            _window = std::move(window);
+                            _has_window = true;
+                        }
+                        _window_start = std::move(now);
+
+                        timer->expires_from_now(boost::posix_time::milliseconds(ms_to_next_window()));
+                        this->add_ref();
+                        timer->async_wait(std::bind(&perf_counter_number_percentile_v2_tls::on_timer, this, timer, std::placeholders::_1));
+                    }
+                }
+                else if (boost::system::errc::operation_canceled != ec)
+                {
+                    dassert(false, "on_timer error!!!");
+                }
+                this->release_ref();
+            }
+
+            std::shared_ptr<boost::asio::deadline_timer> _timer;
+            int                   _window_seconds;
+            log_linear_histogram  _histogram;
+            std::atomic<uint64_t> _last_sample;
+
+            histogram_snapshot    _window_start; // only touched by on_timer
+            std::mutex            _window_lock;
+            histogram_snapshot    _window;
+            bool                  _has_window;
+        };
+
+        // ---------------------- perf counter dispatcher ---------------------
+
+        perf_counter* simple_perf_counter_v2_tls_factory(const char* app, const char *section, const char *name, dsn_perf_counter_type_t type, const char *dsptr)
+        {
+            if (type == dsn_perf_counter_type_t::COUNTER_TYPE_NUMBER)
+                return new perf_counter_number_v2_tls(app, section, name, type, dsptr);
+            else if (type == dsn_perf_counter_type_t::COUNTER_TYPE_RATE)
+                return new perf_counter_rate_v2_tls(app, section, name, type, dsptr);
+            else
+                return new perf_counter_number_percentile_v2_tls(app, section, name, type, dsptr);
+        }
+
+    }
+}
@@ -68,6 +68,9 @@
 
 # else
 
+# include <fcntl.h>
+# include <unistd.h>
+
 # if defined(__FreeBSD__)
 # include <sys/types.h>
 # include <sys/user.h>
@@ -1012,6 +1015,43 @@ out_error:
                 return true;
             }
 
+            bool sync_file(FILE* fp)
+            {
+                if (fflush(fp) != 0)
+                {
+                    return false;
+                }
+
+# if defined(_WIN32)
+                return ::_commit(::_fileno(fp)) == 0;
+# else
+                return ::fsync(::fileno(fp)) == 0;
+# endif
+            }
+
+            bool sync_directory(const std::string& path)
+            {
+# if defined(_WIN32)
+                // the entries are flushed with the file system metadata
+                return true;
+# else
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    dwarn("open directory '%s' failed, err = %s", path.c_str(), strerror(errno));
+                    return false;
+                }
+
+                bool ret = (::fsync(fd) == 0);
+                if (!ret)
+                {
+                    dwarn("sync directory '%s' failed, err = %s", path.c_str(), strerror(errno));
+                }
+                ::close(fd);
+                return ret;
+# endif
+            }
+
             error_code get_process_image_path(int pid, std::string& path)
             {
                 if (pid < -1)
@@ -66,7 +66,7 @@ namespace dsn
             int idx = -1;
             if (_app_partition_count != -1)
             {
-                idx = get_partition_index(_app_partition_count, partition_hash);
+                idx = get_serving_index(get_partition_index(_app_partition_count, partition_hash));
                 rpc_address target;
                 if (ERR_OK == get_address(idx, target))
                 {
@@ -93,7 +93,16 @@ namespace dsn
 
         void partition_resolver_simple::on_access_failure(int partition_index, error_code err)
         {
-            if (-1 != partition_index)
+            // the partition count is doubled and the keys are moved to the new partitions
+            if (err == ERR_PARENT_PARTITION_MISUSED)
+            {
+                ddebug("clear all partition configuration cache of %d due to access failure %s",
+                    _app_id, err.to_string());
+
+                zauto_write_lock l(_config_lock);
+                _config_cache.clear();
+            }
+            else if (-1 != partition_index)
             {
                 ddebug("clear partition configuration cache %d.%d due to access failure %s",
                     _app_id, partition_index, err.to_string());
@@ -290,11 +299,18 @@ namespace dsn
                         dassert(false, "app id is changed (mostly the app was removed and created with the same name), local Vs remote: %u vs %u ",
                             _app_id, resp.app_id);
                     }
-                    if (_app_partition_count != -1 && _app_partition_count != resp.partition_count)
+                    if (_app_partition_count != -1 && _app_partition_count > resp.partition_count)
                     {
-                        dassert(false, "partition count is changed (mostly the app was removed and created with the same name), local Vs remote: %u vs %u ",
+                        dassert(false, "partition count is decreased (mostly the app was removed and created with the same name), local Vs remote: %u vs %u ",
                             _app_partition_count, resp.partition_count);
                     }
+                    if (_app_partition_count != -1 && _app_partition_count < resp.partition_count)
+                    {
+                        // the app is split, so all the cached partitions serve fewer keys
+                        ddebug("%s.client: partition count is changed from %d to %d",
+                            _app_path.c_str(), _app_partition_count, resp.partition_count);
+                        _config_cache.clear();
+                    }
                     _app_id = resp.app_id;
                     _app_partition_count = resp.partition_count;
                     _app_is_stateful = resp.is_stateful;
@@ -398,7 +414,6 @@ namespace dsn
                     for (auto& req : reqs2)
                     {
                         dassert(-1 == req->partition_index, "");
-                        req->partition_index = get_partition_index(_app_partition_count, req->partition_hash);
                     }
                     handle_pending_requests(reqs2, client_err);
                 }
@@ -421,6 +436,9 @@ namespace dsn
             {
                 if (err == ERR_OK)
                 {
+                    // the partition count or the split state may be changed by the reply
+                    req->partition_index = get_serving_index(get_partition_index(_app_partition_count, req->partition_hash));
+
                     rpc_address addr;
                     err = get_address(req->partition_index, addr);
                     if (err == ERR_OK)
@@ -514,6 +532,21 @@ namespace dsn
             }
         }
 
+        // a new partition of an ongoing split is reported with an invalid ballot (-1) until
+        // it catches up with its parent, and its keys are served by the parent till then
+        int partition_resolver_simple::get_serving_index(int partition_index) const
+        {
+            zauto_read_lock l(_config_lock);
+            int parent_count = _app_partition_count / 2;
+            if (partition_index >= parent_count)
+            {
+                auto it = _config_cache.find(partition_index);
+                if (it != _config_cache.end() && it->second->config.ballot == -1)
+                    return partition_index - parent_count;
+            }
+            return partition_index;
+        }
+
         int partition_resolver_simple::get_partition_index(int partition_count, uint64_t partition_hash)
         {
             return partition_hash % static_cast<uint64_t>(partition_count);
@@ -111,6 +111,7 @@ namespace dsn
             // local routines
             rpc_address get_address(const partition_configuration& config) const;
             error_code get_address(int partition_index, /*out*/ rpc_address& addr);
+            int get_serving_index(int partition_index) const;
             void handle_pending_requests(std::list<request_context_ptr>& reqs, error_code err);
             void clear_all_pending_requests();
 
@@ -37,6 +37,7 @@
 # include <dsn/dist/failure_detector.h>
 # include <chrono>
 # include <ctime>
+# include <cmath>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -56,6 +57,47 @@ failure_detector::failure_detector()
     dsn_task_code_set_threadpool(RPC_FD_FAILURE_DETECTOR_PING_ACK, pool);
 
     _is_started = false;
+    _phi_threshold = 0;
+    _phi_safety_margin_milliseconds = 0;
+}
+
+void phi_accrual_window::add(uint32_t interval_ms)
+{
+    if (_count == max_samples)
+    {
+        uint64_t oldest = _samples[_next];
+        _sum -= oldest;
+        _sum_squares -= oldest * oldest;
+    }
+    else
+    {
+        _count++;
+    }
+
+    _samples[_next] = interval_ms;
+    _next = (_next + 1) % max_samples;
+    _sum += interval_ms;
+    _sum_squares += static_cast<uint64_t>(interval_ms) * interval_ms;
+}
+
+double phi_accrual_window::phi(uint64_t elapsed_ms, double min_std_ms) const
+{
+    if (_count == 0)
+        return 0;
+
+    double mean = static_cast<double>(_sum) / _count;
+    double variance = static_cast<double>(_sum_squares) / _count - mean * mean;
+    double sd = variance > 0 ? sqrt(variance) : 0;
+    if (sd < min_std_ms)
+        sd = min_std_ms;
+
+    // logistic approximation of the normal cdf
+    double y = (static_cast<double>(elapsed_ms) - mean) / sd;
+    double e = exp(-y * (1.5976 + 0.070566 * y * y));
+    if (elapsed_ms > mean)
+        return -log10(e / (1.0 + e));
+    else
+        return -log10(1.0 - 1.0 / (1.0 + e));
 }
 
 error_code failure_detector::start(
@@ -65,13 +107,35 @@ error_code failure_detector::start(
     uint32_t grace_seconds, 
     bool use_allow_list)
 {
-    _check_interval_milliseconds = check_interval_seconds * 1000;
-    _beacon_interval_milliseconds = beacon_interval_seconds * 1000;
-    _lease_milliseconds = lease_seconds * 1000;
-    _grace_milliseconds = grace_seconds * 1000;
+    return start_ms(
+        check_interval_seconds * 1000,
+        beacon_interval_seconds * 1000,
+        lease_seconds * 1000,
+        grace_seconds * 1000,
+        use_allow_list
+        );
+}
+
+error_code failure_detector::start_ms(
+    uint32_t check_interval_milliseconds,
+    uint32_t beacon_interval_milliseconds,
+    uint32_t lease_milliseconds,
+    uint32_t grace_milliseconds,
+    bool use_allow_list)
+{
+    set_intervals_ms(check_interval_milliseconds, beacon_interval_milliseconds, lease_milliseconds, grace_milliseconds);
 
     _use_allow_list   = use_allow_list;
 
+    if (_phi_threshold > 0
+        && _grace_milliseconds <= _lease_milliseconds + _check_interval_milliseconds
+            + std::max(_check_interval_milliseconds, _phi_safety_margin_milliseconds))
+    {
+        dwarn("phi accrual suspicion takes no effect as grace(%u ms) <= lease(%u ms) + check interval(%u ms) "
+            "+ max(check interval, safety margin(%u ms))",
+            _grace_milliseconds, _lease_milliseconds, _check_interval_milliseconds, _phi_safety_margin_milliseconds);
+    }
+
     open_service();
 
     // start periodically check job
@@ -83,6 +147,13 @@ error_code failure_detector::start(
         -1,
         std::chrono::milliseconds(_check_interval_milliseconds));
 
+    // beacons to all masters are sent by one timer, and at most one is in flight per master
+    _send_beacon_task = tasking::enqueue_timer(
+        LPC_BEACON_SEND,
+        this,
+        [this] {send_beacons();},
+        std::chrono::milliseconds(_beacon_interval_milliseconds));
+
     _is_started = true;
     return ERR_OK;
 }
@@ -100,11 +171,6 @@ error_code failure_detector::stop()
 
     {
         zauto_lock l(_lock);
-        for (auto& m : _masters)
-        {
-            m.second.send_beacon_timer->cancel(true);
-        }
-
         _masters.clear();
         _workers.clear();
     }
@@ -115,12 +181,18 @@ error_code failure_detector::stop()
         _check_task = nullptr;
     }
 
+    if (_send_beacon_task != nullptr)
+    {
+        _send_beacon_task->cancel(true);
+        _send_beacon_task = nullptr;
+    }
+
     return ERR_OK;
 }
 
 void failure_detector::register_master(::dsn::rpc_address target)
 {
-    bool setup_timer = false;
+    bool send_now = false;
     uint64_t now = now_ms();
 
     zauto_lock l(_lock);
@@ -131,7 +203,7 @@ void failure_detector::register_master(::dsn::rpc_address target)
     if (ret.second)
     {
         dinfo("register master[%s] successfully", target.to_string());
-        setup_timer = true;
+        send_now = true;
     }
     else
     {
@@ -139,20 +211,46 @@ void failure_detector::register_master(::dsn::rpc_address target)
         if (ret.first->second.rejected)
         {
             ret.first->second.rejected = false;
-            setup_timer = true;            
+            ret.first->second.next_beacon_time = now;
+            send_now = true;
         }
         dinfo("master[%s] already registered", target.to_string());
     }
 
-    if (setup_timer)
+    // don't wait for the next tick of the beacon timer
+    if (send_now)
     {
-        ret.first->second.send_beacon_timer = tasking::enqueue_timer(LPC_BEACON_SEND, this,
-            [this, target]() 
-            {
-                this->send_beacon(target, now_ms());
-            },
-            std::chrono::milliseconds(_beacon_interval_milliseconds)
-            );
+        tasking::enqueue(LPC_BEACON_SEND, this, [this]() { send_beacons(); });
+    }
+}
+
+void failure_detector::send_beacons()
+{
+    std::vector< ::dsn::rpc_address> targets;
+    uint64_t now = now_ms();
+
+    {
+        zauto_lock l(_lock);
+        for (auto& m : _masters)
+        {
+            master_record& record = m.second;
+            if (record.rejected || now < record.next_beacon_time)
+                continue;
+
+            // a beacon is in flight till it is acked or its rpc times out
+            if (record.beacon_in_flight_time != 0
+                && now - record.beacon_in_flight_time < _check_interval_milliseconds)
+                continue;
+
+            record.beacon_in_flight_time = now;
+            record.next_beacon_time = now + _beacon_interval_milliseconds;
+            targets.push_back(record.node);
+        }
+    }
+
+    for (auto& target : targets)
+    {
+        send_beacon(target, now);
     }
 }
 
@@ -172,20 +270,17 @@ bool failure_detector::switch_master(::dsn::rpc_address from, ::dsn::rpc_address
 
         it->second.node = to;
         it->second.rejected = false;
-        it->second.send_beacon_timer->cancel(true);
-        it->second.send_beacon_timer = tasking::enqueue_timer(LPC_BEACON_SEND, this,
-            [this, to]()
-            {
-                this->send_beacon(to, now_ms());
-            },
-            std::chrono::milliseconds(_beacon_interval_milliseconds),
-            0,
-            std::chrono::milliseconds(delay_milliseconds)
-            );
+        it->second.next_beacon_time = now_ms() + delay_milliseconds;
+        it->second.beacon_in_flight_time = 0;
 
         _masters.insert(std::make_pair(to, it->second));
         _masters.erase(from);
 
+        if (delay_milliseconds == 0)
+        {
+            tasking::enqueue(LPC_BEACON_SEND, this, [this]() { send_beacons(); });
+        }
+
         dinfo("switch master successfully, from[%s], to[%s]",
               from.to_string(), to.to_string());
     }
@@ -282,8 +377,7 @@ void failure_detector::check_all_records()
         {
             worker_record& record = itq->second;
 
-            if (record.is_alive != false
-                && now - record.last_beacon_recv_time > _grace_milliseconds)
+            if (record.is_alive != false && is_worker_expired(record, now))
             {
                 expire.push_back(record.node);
                 record.is_alive = false;
@@ -301,6 +395,50 @@ void failure_detector::check_all_records()
     }
 }
 
+void failure_detector::set_intervals_ms(
+    uint32_t check_interval_milliseconds,
+    uint32_t beacon_interval_milliseconds,
+    uint32_t lease_milliseconds,
+    uint32_t grace_milliseconds)
+{
+    _check_interval_milliseconds = check_interval_milliseconds;
+    _beacon_interval_milliseconds = beacon_interval_milliseconds;
+    _lease_milliseconds = lease_milliseconds;
+    _grace_milliseconds = grace_milliseconds;
+}
+
+bool failure_detector::is_worker_expired(const worker_record& record, uint64_t now) const
+{
+    uint64_t elapsed = now - record.last_beacon_recv_time;
+    if (!is_worker_expired(elapsed, record.intervals))
+        return false;
+
+    if (elapsed <= _grace_milliseconds)
+    {
+        dwarn("worker[%s] is suspected, phi = %.2f, no beacon for %" PRIu64 " ms",
+            record.node.to_string(), record.intervals.phi(elapsed, _beacon_interval_milliseconds / 4.0), elapsed);
+    }
+    return true;
+}
+
+bool failure_detector::is_worker_expired(uint64_t elapsed_ms, const phi_accrual_window& intervals) const
+{
+    if (elapsed_ms > _grace_milliseconds)
+        return true;
+
+    // the worker must have stopped serving before it is declared dead, i.e., found its
+    // lease expired on its own check tick, and finished what it does on that, with some
+    // more time for the clock rate drift, as grace - lease ensures without phi
+    uint64_t safe_ms = static_cast<uint64_t>(_lease_milliseconds) + _check_interval_milliseconds
+        + std::max(_check_interval_milliseconds, _phi_safety_margin_milliseconds);
+    if (_phi_threshold <= 0
+        || intervals.count() < phi_accrual_window::min_samples
+        || elapsed_ms <= safe_ms)
+        return false;
+
+    return intervals.phi(elapsed_ms, _beacon_interval_milliseconds / 4.0) > _phi_threshold;
+}
+
 void failure_detector::add_allow_list( ::dsn::rpc_address node)
 {
     zauto_lock l(_lock);
@@ -347,6 +485,12 @@ void failure_detector::on_ping_internal(const beacon_msg& beacon, /*out*/ beacon
     }
     else if (is_time_greater_than(now, itr->second.last_beacon_recv_time))
     {
+        // the gap of a disconnection is not a sample of the normal intervals
+        if (itr->second.is_alive)
+            itr->second.intervals.add(static_cast<uint32_t>(now - itr->second.last_beacon_recv_time));
+        else
+            itr->second.intervals.clear();
+
         // update last_beacon_recv_time
         itr->second.last_beacon_recv_time = now;
 
@@ -393,13 +537,17 @@ bool failure_detector::end_ping_internal(::dsn::error_code err, const beacon_ack
     }
 
     master_record& record = itr->second;
+    if (record.beacon_in_flight_time == beacon_send_time)
+    {
+        record.beacon_in_flight_time = 0;
+    }
+
     if (!ack.allowed)
     {
         dwarn("worker rejected, stop sending beacon message, "
             "remote_master[%s], local_worker[%s]",
             node.to_string(), primary_address().to_string());
         record.rejected = true;
-        record.send_beacon_timer->cancel(true);
         err.end_tracking();
         return false;
     }
@@ -442,7 +590,6 @@ bool failure_detector::unregister_master(::dsn::rpc_address node)
 
     if (it != _masters.end())
     {
-        it->second.send_beacon_timer->cancel(true);
         _masters.erase(it);
         dinfo("unregister master[%s] successfully", node.to_string());
         return true;
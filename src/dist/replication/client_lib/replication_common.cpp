@@ -55,12 +55,30 @@ replication_options::replication_options()
 
     group_check_disabled = false;
     group_check_interval_ms = 10000;
+    group_check_batch_enabled = false;
+    group_check_batch_window_ms = 100;
+
+    learn_log_pipeline_disabled = false;
+    learn_max_concurrent_count = 8;
 
     checkpoint_disabled = false;
     checkpoint_interval_seconds = 100;
     checkpoint_min_decree_gap = 10000;
     checkpoint_max_interval_hours = 24; // at least one checkpoint per day
 
+    bulk_load_stage_timeout_seconds = 3600;
+
+    split_forward_batch_count = 256;
+    split_fence_pending_count = 64;
+    split_fence_timeout_ms = 5000;
+
+    primary_handoff_timeout_ms = 1000;
+
+    hotkey_detection_disabled = false;
+    hotkey_sample_interval = 64;
+    hotkey_top_count = 8;
+    hotkey_window_sample_count = 10000;
+
     gc_disabled = false;
     gc_interval_ms = 30 * 1000; // 30000 milliseconds
     gc_memory_replica_interval_ms = 5 * 60 * 1000; // 5 minutes
@@ -71,7 +89,14 @@ replication_options::replication_options()
     fd_beacon_interval_seconds = 3;
     fd_lease_seconds = 10;
     fd_grace_seconds = 15;
-
+    fd_check_interval_ms = 0;
+    fd_beacon_interval_ms = 0;
+    fd_lease_ms = 0;
+    fd_grace_ms = 0;
+    fd_phi_threshold = 0;
+    fd_phi_safety_margin_ms = 2000;
+
+    log_private_disabled = false;
     log_private_file_size_mb = 32;
     log_private_batch_buffer_kb = 512;
     log_private_force_flush = true;
@@ -82,6 +107,7 @@ replication_options::replication_options()
 
     config_sync_disabled = false;
     config_sync_interval_ms = 30000;
+    config_sync_full_interval_ms = 300000;
 
     lb_interval_ms = 10000;
     write_empty_enabled = true;
@@ -185,6 +211,33 @@ void replication_options::initialize()
         group_check_interval_ms,
         "every what period (ms) we check the replica healthness"
         );
+    group_check_batch_enabled =
+        dsn_config_get_value_bool("replication",
+        "group_check_batch_enabled",
+        group_check_batch_enabled,
+        "whether group checks of all primaries on this node are aligned and sent to the same node in one batch"
+        );
+    group_check_batch_window_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "group_check_batch_window_ms",
+        group_check_batch_window_ms,
+        "how long (ms) group checks to the same node are collected before the batch is sent"
+        );
+
+    learn_log_pipeline_disabled =
+        dsn_config_get_value_bool("replication",
+        "learn_log_pipeline_disabled",
+        learn_log_pipeline_disabled,
+        "whether to disable pipelined log learning, where learned log files are copied one by one "
+        "and each is applied while the next one is being copied"
+        );
+    learn_max_concurrent_count =
+        (int)dsn_config_get_value_uint64("replication",
+        "learn_max_concurrent_count",
+        learn_max_concurrent_count,
+        "maximum number of replicas learning concurrently on one node, 0 for unlimited; "
+        "replicas with larger lag are scheduled first"
+        );
 
     checkpoint_disabled =
         dsn_config_get_value_bool("replication",
@@ -211,6 +264,64 @@ void replication_options::initialize()
         "maximum time interval (hours) where a new checkpoint must be created"
         );
 
+    bulk_load_stage_timeout_seconds =
+        (int)dsn_config_get_value_uint64("replication",
+        "bulk_load_stage_timeout_seconds",
+        bulk_load_stage_timeout_seconds,
+        "how long (seconds) the primary waits for a member to copy the files of a bulk load"
+        );
+
+    split_forward_batch_count =
+        (int)dsn_config_get_value_uint64("replication",
+        "split_forward_batch_count",
+        split_forward_batch_count,
+        "at most how many writes a parent partition forwards to its child in one batch during a split"
+        );
+    split_fence_pending_count =
+        (int)dsn_config_get_value_uint64("replication",
+        "split_fence_pending_count",
+        split_fence_pending_count,
+        "the parent stops taking the writes of its child's keys once no more than so many are left to forward"
+        );
+    split_fence_timeout_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "split_fence_timeout_ms",
+        split_fence_timeout_ms,
+        "how long (ms) the writes of the child's keys may be rejected before the split is aborted and retried"
+        );
+
+    primary_handoff_timeout_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "primary_handoff_timeout_ms",
+        primary_handoff_timeout_ms,
+        "how long (ms) a primary being downgraded waits for its in-flight writes to commit before it hands off anyway"
+        );
+
+    hotkey_detection_disabled =
+        dsn_config_get_value_bool("replication",
+        "hotkey_detection_disabled",
+        hotkey_detection_disabled,
+        "whether to disable sampling the request keys of each partition for hot key detection"
+        );
+    hotkey_sample_interval =
+        (int)dsn_config_get_value_uint64("replication",
+        "hotkey_sample_interval",
+        hotkey_sample_interval,
+        "one in how many client requests is sampled for hot key detection"
+        );
+    hotkey_top_count =
+        (int)dsn_config_get_value_uint64("replication",
+        "hotkey_top_count",
+        hotkey_top_count,
+        "how many hottest keys are tracked for each partition"
+        );
+    hotkey_window_sample_count =
+        (int)dsn_config_get_value_uint64("replication",
+        "hotkey_window_sample_count",
+        hotkey_window_sample_count,
+        "the sampled counts are halved after every so many samples of a partition"
+        );
+
     gc_disabled =
         dsn_config_get_value_bool("replication",
         "gc_disabled",
@@ -266,7 +377,52 @@ void replication_options::initialize()
         fd_grace_seconds,
         "grace (seconds) assigned to remote FD slaves (grace > lease)"
         );
+    fd_check_interval_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "fd_check_interval_ms",
+        fd_check_interval_ms,
+        "overrides fd_check_interval_seconds when not 0, for sub-second checks"
+        );
+    fd_beacon_interval_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "fd_beacon_interval_ms",
+        fd_beacon_interval_ms,
+        "overrides fd_beacon_interval_seconds when not 0, for sub-second beacons"
+        );
+    fd_lease_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "fd_lease_ms",
+        fd_lease_ms,
+        "overrides fd_lease_seconds when not 0, for sub-second leases"
+        );
+    fd_grace_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "fd_grace_ms",
+        fd_grace_ms,
+        "overrides fd_grace_seconds when not 0, for sub-second grace periods"
+        );
+    fd_phi_threshold =
+        dsn_config_get_value_double("replication",
+        "fd_phi_threshold",
+        fd_phi_threshold,
+        "when not 0, a slave is declared dead after its lease once the phi suspicion level "
+        "of its beacon inter-arrival times exceeds this, and after the grace at the latest, e.g., 8"
+        );
+    fd_phi_safety_margin_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "fd_phi_safety_margin_ms",
+        fd_phi_safety_margin_ms,
+        "a slave is not declared dead by phi until lease + check interval + max(check interval, this) "
+        "after its last beacon, so that it has surely stopped serving"
+        );
 
+    log_private_disabled =
+        dsn_config_get_value_bool("replication",
+        "log_private_disabled",
+        log_private_disabled,
+        "whether to disable the private log, so that mutations are only written to the shared log, "
+        "and learning and gc use the shared log instead"
+        );
     log_private_file_size_mb =
         (int)dsn_config_get_value_uint64("replication",
         "log_private_file_size_mb",
@@ -317,6 +473,12 @@ void replication_options::initialize()
         config_sync_interval_ms,
         "every this period(ms) the replica syncs replica configuration with the meta server"
         );
+    config_sync_full_interval_ms =
+        (int)dsn_config_get_value_uint64("replication",
+        "config_sync_full_interval_ms",
+        config_sync_full_interval_ms,
+        "every this period(ms) the replica server queries all its partitions instead of only the changed ones"
+        );
 
     lb_interval_ms =
         (int)dsn_config_get_value_uint64("replication",
@@ -399,4 +561,70 @@ void replica_helper::load_meta_servers(/*out*/ std::vector<dsn::rpc_address>& se
     dassert(servers.size() > 0, "no meta server specified in config [%s].%s", section, key);
 }
 
+/*static*/ const char* replica_helper::split_parent_count_env = "replica.split.parent_count";
+/*static*/ const char* replica_helper::split_ready_children_env = "replica.split.ready_children";
+/*static*/ const char* replica_helper::split_original_count_env = "replica.split.original_count";
+
+/*static*/ int replica_helper::get_split_parent_count(const ::dsn::app_info& info)
+{
+    auto it = info.envs.find(split_parent_count_env);
+    return it == info.envs.end() ? 0 : atoi(it->second.c_str());
+}
+
+/*static*/ bool replica_helper::is_split_child_ready(const ::dsn::app_info& info, int child_index)
+{
+    auto it = info.envs.find(split_ready_children_env);
+    if (it == info.envs.end())
+        return false;
+
+    std::vector<std::string> children;
+    ::dsn::utils::split_args(it->second.c_str(), children, ',');
+    for (auto& c : children)
+    {
+        if (atoi(c.c_str()) == child_index)
+            return true;
+    }
+    return false;
+}
+
+/*static*/ bool replica_helper::mark_split_child_ready(/*inout*/ ::dsn::app_info& info, int child_index)
+{
+    int parent_count = get_split_parent_count(info);
+    if (parent_count == 0 || is_split_child_ready(info, child_index))
+        return false;
+
+    std::string& ready = info.envs[split_ready_children_env];
+    if (!ready.empty())
+        ready.append(",");
+    ready.append(std::to_string(child_index));
+
+    for (int i = parent_count; i < 2 * parent_count; i++)
+    {
+        if (!is_split_child_ready(info, i))
+            return true;
+    }
+
+    info.envs.erase(split_parent_count_env);
+    info.envs.erase(split_ready_children_env);
+    return true;
+}
+
+/*static*/ int replica_helper::get_serving_partition_count(const ::dsn::app_info& info, int partition_index)
+{
+    int parent_count = get_split_parent_count(info);
+    if (parent_count == 0)
+        return info.partition_count;
+
+    if (partition_index < parent_count)
+        return is_split_child_ready(info, partition_index + parent_count) ? 2 * parent_count : parent_count;
+    else
+        return is_split_child_ready(info, partition_index) ? 2 * parent_count : 0;
+}
+
+/*static*/ bool replica_helper::is_app_ever_split(const ::dsn::app_info& info)
+{
+    return info.envs.find(split_original_count_env) != info.envs.end()
+        || get_split_parent_count(info) != 0;
+}
+
 }} // end namespace
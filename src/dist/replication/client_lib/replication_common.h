@@ -67,12 +67,30 @@ public:
     
     bool    group_check_disabled;
     int32_t group_check_interval_ms;
+    bool    group_check_batch_enabled;
+    int32_t group_check_batch_window_ms;
+
+    bool    learn_log_pipeline_disabled;
+    int32_t learn_max_concurrent_count;
 
     bool    checkpoint_disabled;
     int32_t checkpoint_interval_seconds;
     int64_t checkpoint_min_decree_gap;
     int32_t checkpoint_max_interval_hours;
 
+    int32_t bulk_load_stage_timeout_seconds;
+
+    int32_t split_forward_batch_count;
+    int32_t split_fence_pending_count;
+    int32_t split_fence_timeout_ms;
+
+    int32_t primary_handoff_timeout_ms;
+
+    bool    hotkey_detection_disabled;
+    int32_t hotkey_sample_interval;
+    int32_t hotkey_top_count;
+    int32_t hotkey_window_sample_count;
+
     bool    gc_disabled;
     int32_t gc_interval_ms;
     int32_t gc_memory_replica_interval_ms;
@@ -83,7 +101,14 @@ public:
     int32_t fd_beacon_interval_seconds;
     int32_t fd_lease_seconds;
     int32_t fd_grace_seconds;
-
+    int32_t fd_check_interval_ms;
+    int32_t fd_beacon_interval_ms;
+    int32_t fd_lease_ms;
+    int32_t fd_grace_ms;
+    double  fd_phi_threshold;
+    int32_t fd_phi_safety_margin_ms;
+
+    bool    log_private_disabled;
     int32_t log_private_file_size_mb;
     int32_t log_private_batch_buffer_kb;
     bool    log_private_force_flush;
@@ -94,6 +119,7 @@ public:
 
     bool    config_sync_disabled;
     int32_t config_sync_interval_ms;
+    int32_t config_sync_full_interval_ms;
 
     int32_t lb_interval_ms;
     bool    write_empty_enabled;
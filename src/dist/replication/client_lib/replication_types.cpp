@@ -2289,6 +2289,238 @@ void group_check_response::printTo(std::ostream& out) const {
   out << ")";
 }
 
+group_check_batch_request::~group_check_batch_request() throw() {
+}
+
+
+void group_check_batch_request::__set_node(const  ::dsn::rpc_address& val) {
+  this->node = val;
+}
+
+void group_check_batch_request::__set_requests(const std::vector<group_check_request> & val) {
+  this->requests = val;
+}
+
+uint32_t group_check_batch_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->node.read(iprot);
+          this->__isset.node = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->requests.clear();
+            uint32_t _size173;
+            ::apache::thrift::protocol::TType _etype174;
+            xfer += iprot->readListBegin(_etype174, _size173);
+            this->requests.resize(_size173);
+            uint32_t _i175;
+            for (_i175 = 0; _i175 < _size173; ++_i175)
+            {
+              xfer += this->requests[_i175].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.requests = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t group_check_batch_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("group_check_batch_request");
+
+  xfer += oprot->writeFieldBegin("node", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->node.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("requests", ::apache::thrift::protocol::T_LIST, 2);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->requests.size()));
+    std::vector<group_check_request> ::const_iterator _iter176;
+    for (_iter176 = this->requests.begin(); _iter176 != this->requests.end(); ++_iter176)
+    {
+      xfer += (*_iter176).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(group_check_batch_request &a, group_check_batch_request &b) {
+  using ::std::swap;
+  swap(a.node, b.node);
+  swap(a.requests, b.requests);
+  swap(a.__isset, b.__isset);
+}
+
+group_check_batch_request::group_check_batch_request(const group_check_batch_request& other177) {
+  node = other177.node;
+  requests = other177.requests;
+  __isset = other177.__isset;
+}
+group_check_batch_request& group_check_batch_request::operator=(const group_check_batch_request& other178) {
+  node = other178.node;
+  requests = other178.requests;
+  __isset = other178.__isset;
+  return *this;
+}
+void group_check_batch_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "group_check_batch_request(";
+  out << "node=" << to_string(node);
+  out << ", " << "requests=" << to_string(requests);
+  out << ")";
+}
+
+
+group_check_batch_response::~group_check_batch_response() throw() {
+}
+
+
+void group_check_batch_response::__set_responses(const std::vector<group_check_response> & val) {
+  this->responses = val;
+}
+
+uint32_t group_check_batch_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->responses.clear();
+            uint32_t _size179;
+            ::apache::thrift::protocol::TType _etype180;
+            xfer += iprot->readListBegin(_etype180, _size179);
+            this->responses.resize(_size179);
+            uint32_t _i181;
+            for (_i181 = 0; _i181 < _size179; ++_i181)
+            {
+              xfer += this->responses[_i181].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.responses = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t group_check_batch_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("group_check_batch_response");
+
+  xfer += oprot->writeFieldBegin("responses", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->responses.size()));
+    std::vector<group_check_response> ::const_iterator _iter182;
+    for (_iter182 = this->responses.begin(); _iter182 != this->responses.end(); ++_iter182)
+    {
+      xfer += (*_iter182).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(group_check_batch_response &a, group_check_batch_response &b) {
+  using ::std::swap;
+  swap(a.responses, b.responses);
+  swap(a.__isset, b.__isset);
+}
+
+group_check_batch_response::group_check_batch_response(const group_check_batch_response& other183) {
+  responses = other183.responses;
+  __isset = other183.__isset;
+}
+group_check_batch_response& group_check_batch_response::operator=(const group_check_batch_response& other184) {
+  responses = other184.responses;
+  __isset = other184.__isset;
+  return *this;
+}
+void group_check_batch_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "group_check_batch_response(";
+  out << "responses=" << to_string(responses);
+  out << ")";
+}
+
+
 
 node_info::~node_info() throw() {
 }
@@ -2778,15 +3010,27 @@ void configuration_update_response::printTo(std::ostream& out) const {
 }
 
 
-configuration_query_by_node_request::~configuration_query_by_node_request() throw() {
+replica_load::~replica_load() throw() {
 }
 
 
-void configuration_query_by_node_request::__set_node(const  ::dsn::rpc_address& val) {
-  this->node = val;
+void replica_load::__set_pid(const  ::dsn::gpid& val) {
+  this->pid = val;
 }
 
-uint32_t configuration_query_by_node_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+void replica_load::__set_qps(const double val) {
+  this->qps = val;
+}
+
+void replica_load::__set_bytes_per_second(const double val) {
+  this->bytes_per_second = val;
+}
+
+void replica_load::__set_disk_usage_mb(const int64_t val) {
+  this->disk_usage_mb = val;
+}
+
+uint32_t replica_load::read(::apache::thrift::protocol::TProtocol* iprot) {
 
   apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
   uint32_t xfer = 0;
@@ -2809,8 +3053,32 @@ uint32_t configuration_query_by_node_request::read(::apache::thrift::protocol::T
     {
       case 1:
         if (ftype == ::apache::thrift::protocol::T_STRUCT) {
-          xfer += this->node.read(iprot);
-          this->__isset.node = true;
+          xfer += this->pid.read(iprot);
+          this->__isset.pid = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_DOUBLE) {
+          xfer += iprot->readDouble(this->qps);
+          this->__isset.qps = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_DOUBLE) {
+          xfer += iprot->readDouble(this->bytes_per_second);
+          this->__isset.bytes_per_second = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->disk_usage_mb);
+          this->__isset.disk_usage_mb = true;
         } else {
           xfer += iprot->skip(ftype);
         }
@@ -2827,13 +3095,25 @@ uint32_t configuration_query_by_node_request::read(::apache::thrift::protocol::T
   return xfer;
 }
 
-uint32_t configuration_query_by_node_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+uint32_t replica_load::write(::apache::thrift::protocol::TProtocol* oprot) const {
   uint32_t xfer = 0;
   apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
-  xfer += oprot->writeStructBegin("configuration_query_by_node_request");
+  xfer += oprot->writeStructBegin("replica_load");
 
-  xfer += oprot->writeFieldBegin("node", ::apache::thrift::protocol::T_STRUCT, 1);
-  xfer += this->node.write(oprot);
+  xfer += oprot->writeFieldBegin("pid", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->pid.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("qps", ::apache::thrift::protocol::T_DOUBLE, 2);
+  xfer += oprot->writeDouble(this->qps);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("bytes_per_second", ::apache::thrift::protocol::T_DOUBLE, 3);
+  xfer += oprot->writeDouble(this->bytes_per_second);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("disk_usage_mb", ::apache::thrift::protocol::T_I64, 4);
+  xfer += oprot->writeI64(this->disk_usage_mb);
   xfer += oprot->writeFieldEnd();
 
   xfer += oprot->writeFieldStop();
@@ -2841,42 +3121,62 @@ uint32_t configuration_query_by_node_request::write(::apache::thrift::protocol::
   return xfer;
 }
 
-void swap(configuration_query_by_node_request &a, configuration_query_by_node_request &b) {
+void swap(replica_load &a, replica_load &b) {
   using ::std::swap;
-  swap(a.node, b.node);
+  swap(a.pid, b.pid);
+  swap(a.qps, b.qps);
+  swap(a.bytes_per_second, b.bytes_per_second);
+  swap(a.disk_usage_mb, b.disk_usage_mb);
   swap(a.__isset, b.__isset);
 }
 
-configuration_query_by_node_request::configuration_query_by_node_request(const configuration_query_by_node_request& other54) {
-  node = other54.node;
-  __isset = other54.__isset;
+replica_load::replica_load(const replica_load& other207) {
+  pid = other207.pid;
+  qps = other207.qps;
+  bytes_per_second = other207.bytes_per_second;
+  disk_usage_mb = other207.disk_usage_mb;
+  __isset = other207.__isset;
 }
-configuration_query_by_node_request& configuration_query_by_node_request::operator=(const configuration_query_by_node_request& other55) {
-  node = other55.node;
-  __isset = other55.__isset;
+replica_load& replica_load::operator=(const replica_load& other208) {
+  pid = other208.pid;
+  qps = other208.qps;
+  bytes_per_second = other208.bytes_per_second;
+  disk_usage_mb = other208.disk_usage_mb;
+  __isset = other208.__isset;
   return *this;
 }
-void configuration_query_by_node_request::printTo(std::ostream& out) const {
+void replica_load::printTo(std::ostream& out) const {
   using ::apache::thrift::to_string;
-  out << "configuration_query_by_node_request(";
-  out << "node=" << to_string(node);
+  out << "replica_load(";
+  out << "pid=" << to_string(pid);
+  out << ", " << "qps=" << to_string(qps);
+  out << ", " << "bytes_per_second=" << to_string(bytes_per_second);
+  out << ", " << "disk_usage_mb=" << to_string(disk_usage_mb);
   out << ")";
 }
 
 
-configuration_query_by_node_response::~configuration_query_by_node_response() throw() {
+configuration_query_by_node_request::~configuration_query_by_node_request() throw() {
 }
 
 
-void configuration_query_by_node_response::__set_err(const  ::dsn::error_code& val) {
-  this->err = val;
+void configuration_query_by_node_request::__set_node(const  ::dsn::rpc_address& val) {
+  this->node = val;
 }
 
-void configuration_query_by_node_response::__set_partitions(const std::vector<configuration_update_request> & val) {
-  this->partitions = val;
+void configuration_query_by_node_request::__set_config_epoch(const int64_t val) {
+  this->config_epoch = val;
 }
 
-uint32_t configuration_query_by_node_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+void configuration_query_by_node_request::__set_config_version(const int64_t val) {
+  this->config_version = val;
+}
+
+void configuration_query_by_node_request::__set_loads(const std::vector<replica_load> & val) {
+  this->loads = val;
+}
+
+uint32_t configuration_query_by_node_request::read(::apache::thrift::protocol::TProtocol* iprot) {
 
   apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
   uint32_t xfer = 0;
@@ -2899,28 +3199,44 @@ uint32_t configuration_query_by_node_response::read(::apache::thrift::protocol::
     {
       case 1:
         if (ftype == ::apache::thrift::protocol::T_STRUCT) {
-          xfer += this->err.read(iprot);
-          this->__isset.err = true;
+          xfer += this->node.read(iprot);
+          this->__isset.node = true;
         } else {
           xfer += iprot->skip(ftype);
         }
         break;
       case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_epoch);
+          this->__isset.config_epoch = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_version);
+          this->__isset.config_version = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
         if (ftype == ::apache::thrift::protocol::T_LIST) {
           {
-            this->partitions.clear();
-            uint32_t _size56;
-            ::apache::thrift::protocol::TType _etype59;
-            xfer += iprot->readListBegin(_etype59, _size56);
-            this->partitions.resize(_size56);
-            uint32_t _i60;
-            for (_i60 = 0; _i60 < _size56; ++_i60)
+            this->loads.clear();
+            uint32_t _size209;
+            ::apache::thrift::protocol::TType _etype210;
+            xfer += iprot->readListBegin(_etype210, _size209);
+            this->loads.resize(_size209);
+            uint32_t _i211;
+            for (_i211 = 0; _i211 < _size209; ++_i211)
             {
-              xfer += this->partitions[_i60].read(iprot);
+              xfer += this->loads[_i211].read(iprot);
             }
             xfer += iprot->readListEnd();
           }
-          this->__isset.partitions = true;
+          this->__isset.loads = true;
         } else {
           xfer += iprot->skip(ftype);
         }
@@ -2937,27 +3253,253 @@ uint32_t configuration_query_by_node_response::read(::apache::thrift::protocol::
   return xfer;
 }
 
-uint32_t configuration_query_by_node_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+uint32_t configuration_query_by_node_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
   uint32_t xfer = 0;
   apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
-  xfer += oprot->writeStructBegin("configuration_query_by_node_response");
+  xfer += oprot->writeStructBegin("configuration_query_by_node_request");
 
-  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
-  xfer += this->err.write(oprot);
-  xfer += oprot->writeFieldEnd();
+  xfer += oprot->writeFieldBegin("node", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->node.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("config_epoch", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->config_epoch);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("config_version", ::apache::thrift::protocol::T_I64, 3);
+  xfer += oprot->writeI64(this->config_version);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("loads", ::apache::thrift::protocol::T_LIST, 4);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->loads.size()));
+    std::vector<replica_load> ::const_iterator _iter212;
+    for (_iter212 = this->loads.begin(); _iter212 != this->loads.end(); ++_iter212)
+    {
+      xfer += (*_iter212).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(configuration_query_by_node_request &a, configuration_query_by_node_request &b) {
+  using ::std::swap;
+  swap(a.node, b.node);
+  swap(a.config_epoch, b.config_epoch);
+  swap(a.config_version, b.config_version);
+  swap(a.loads, b.loads);
+  swap(a.__isset, b.__isset);
+}
+
+configuration_query_by_node_request::configuration_query_by_node_request(const configuration_query_by_node_request& other213) {
+  node = other213.node;
+  config_epoch = other213.config_epoch;
+  config_version = other213.config_version;
+  loads = other213.loads;
+  __isset = other213.__isset;
+}
+configuration_query_by_node_request& configuration_query_by_node_request::operator=(const configuration_query_by_node_request& other214) {
+  node = other214.node;
+  config_epoch = other214.config_epoch;
+  config_version = other214.config_version;
+  loads = other214.loads;
+  __isset = other214.__isset;
+  return *this;
+}
+void configuration_query_by_node_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "configuration_query_by_node_request(";
+  out << "node=" << to_string(node);
+  out << ", " << "config_epoch=" << to_string(config_epoch);
+  out << ", " << "config_version=" << to_string(config_version);
+  out << ", " << "loads=" << to_string(loads);
+  out << ")";
+}
+
+
+configuration_query_by_node_response::~configuration_query_by_node_response() throw() {
+}
+
+
+void configuration_query_by_node_response::__set_err(const  ::dsn::error_code& val) {
+  this->err = val;
+}
+
+void configuration_query_by_node_response::__set_partitions(const std::vector<configuration_update_request> & val) {
+  this->partitions = val;
+}
+
+void configuration_query_by_node_response::__set_is_incremental(const bool val) {
+  this->is_incremental = val;
+}
+
+void configuration_query_by_node_response::__set_gone_partitions(const std::vector< ::dsn::gpid> & val) {
+  this->gone_partitions = val;
+}
+
+void configuration_query_by_node_response::__set_config_epoch(const int64_t val) {
+  this->config_epoch = val;
+}
+
+void configuration_query_by_node_response::__set_config_version(const int64_t val) {
+  this->config_version = val;
+}
+
+uint32_t configuration_query_by_node_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->err.read(iprot);
+          this->__isset.err = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->partitions.clear();
+            uint32_t _size195;
+            ::apache::thrift::protocol::TType _etype196;
+            xfer += iprot->readListBegin(_etype196, _size195);
+            this->partitions.resize(_size195);
+            uint32_t _i197;
+            for (_i197 = 0; _i197 < _size195; ++_i197)
+            {
+              xfer += this->partitions[_i197].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.partitions = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->is_incremental);
+          this->__isset.is_incremental = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->gone_partitions.clear();
+            uint32_t _size198;
+            ::apache::thrift::protocol::TType _etype199;
+            xfer += iprot->readListBegin(_etype199, _size198);
+            this->gone_partitions.resize(_size198);
+            uint32_t _i200;
+            for (_i200 = 0; _i200 < _size198; ++_i200)
+            {
+              xfer += this->gone_partitions[_i200].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.gone_partitions = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_epoch);
+          this->__isset.config_epoch = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 6:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_version);
+          this->__isset.config_version = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t configuration_query_by_node_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("configuration_query_by_node_response");
+
+  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->err.write(oprot);
+  xfer += oprot->writeFieldEnd();
 
   xfer += oprot->writeFieldBegin("partitions", ::apache::thrift::protocol::T_LIST, 2);
   {
     xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->partitions.size()));
-    std::vector<configuration_update_request> ::const_iterator _iter61;
-    for (_iter61 = this->partitions.begin(); _iter61 != this->partitions.end(); ++_iter61)
+    std::vector<configuration_update_request> ::const_iterator _iter201;
+    for (_iter201 = this->partitions.begin(); _iter201 != this->partitions.end(); ++_iter201)
+    {
+      xfer += (*_iter201).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("is_incremental", ::apache::thrift::protocol::T_BOOL, 3);
+  xfer += oprot->writeBool(this->is_incremental);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("gone_partitions", ::apache::thrift::protocol::T_LIST, 4);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->gone_partitions.size()));
+    std::vector< ::dsn::gpid> ::const_iterator _iter202;
+    for (_iter202 = this->gone_partitions.begin(); _iter202 != this->gone_partitions.end(); ++_iter202)
     {
-      xfer += (*_iter61).write(oprot);
+      xfer += (*_iter202).write(oprot);
     }
     xfer += oprot->writeListEnd();
   }
   xfer += oprot->writeFieldEnd();
 
+  xfer += oprot->writeFieldBegin("config_epoch", ::apache::thrift::protocol::T_I64, 5);
+  xfer += oprot->writeI64(this->config_epoch);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("config_version", ::apache::thrift::protocol::T_I64, 6);
+  xfer += oprot->writeI64(this->config_version);
+  xfer += oprot->writeFieldEnd();
+
   xfer += oprot->writeFieldStop();
   xfer += oprot->writeStructEnd();
   return xfer;
@@ -2967,18 +3509,30 @@ void swap(configuration_query_by_node_response &a, configuration_query_by_node_r
   using ::std::swap;
   swap(a.err, b.err);
   swap(a.partitions, b.partitions);
+  swap(a.is_incremental, b.is_incremental);
+  swap(a.gone_partitions, b.gone_partitions);
+  swap(a.config_epoch, b.config_epoch);
+  swap(a.config_version, b.config_version);
   swap(a.__isset, b.__isset);
 }
 
-configuration_query_by_node_response::configuration_query_by_node_response(const configuration_query_by_node_response& other62) {
-  err = other62.err;
-  partitions = other62.partitions;
-  __isset = other62.__isset;
-}
-configuration_query_by_node_response& configuration_query_by_node_response::operator=(const configuration_query_by_node_response& other63) {
-  err = other63.err;
-  partitions = other63.partitions;
-  __isset = other63.__isset;
+configuration_query_by_node_response::configuration_query_by_node_response(const configuration_query_by_node_response& other203) {
+  err = other203.err;
+  partitions = other203.partitions;
+  is_incremental = other203.is_incremental;
+  gone_partitions = other203.gone_partitions;
+  config_epoch = other203.config_epoch;
+  config_version = other203.config_version;
+  __isset = other203.__isset;
+}
+configuration_query_by_node_response& configuration_query_by_node_response::operator=(const configuration_query_by_node_response& other204) {
+  err = other204.err;
+  partitions = other204.partitions;
+  is_incremental = other204.is_incremental;
+  gone_partitions = other204.gone_partitions;
+  config_epoch = other204.config_epoch;
+  config_version = other204.config_version;
+  __isset = other204.__isset;
   return *this;
 }
 void configuration_query_by_node_response::printTo(std::ostream& out) const {
@@ -2986,6 +3540,116 @@ void configuration_query_by_node_response::printTo(std::ostream& out) const {
   out << "configuration_query_by_node_response(";
   out << "err=" << to_string(err);
   out << ", " << "partitions=" << to_string(partitions);
+  out << ", " << "is_incremental=" << to_string(is_incremental);
+  out << ", " << "gone_partitions=" << to_string(gone_partitions);
+  out << ", " << "config_epoch=" << to_string(config_epoch);
+  out << ", " << "config_version=" << to_string(config_version);
+  out << ")";
+}
+
+
+config_change_notification::~config_change_notification() throw() {
+}
+
+
+void config_change_notification::__set_config_epoch(const int64_t val) {
+  this->config_epoch = val;
+}
+
+void config_change_notification::__set_config_version(const int64_t val) {
+  this->config_version = val;
+}
+
+uint32_t config_change_notification::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_epoch);
+          this->__isset.config_epoch = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->config_version);
+          this->__isset.config_version = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t config_change_notification::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("config_change_notification");
+
+  xfer += oprot->writeFieldBegin("config_epoch", ::apache::thrift::protocol::T_I64, 1);
+  xfer += oprot->writeI64(this->config_epoch);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("config_version", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->config_version);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(config_change_notification &a, config_change_notification &b) {
+  using ::std::swap;
+  swap(a.config_epoch, b.config_epoch);
+  swap(a.config_version, b.config_version);
+  swap(a.__isset, b.__isset);
+}
+
+config_change_notification::config_change_notification(const config_change_notification& other205) {
+  config_epoch = other205.config_epoch;
+  config_version = other205.config_version;
+  __isset = other205.__isset;
+}
+config_change_notification& config_change_notification::operator=(const config_change_notification& other206) {
+  config_epoch = other206.config_epoch;
+  config_version = other206.config_version;
+  __isset = other206.__isset;
+  return *this;
+}
+void config_change_notification::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "config_change_notification(";
+  out << "config_epoch=" << to_string(config_epoch);
+  out << ", " << "config_version=" << to_string(config_version);
   out << ")";
 }
 
@@ -5701,4 +6365,1117 @@ void node_state::printTo(std::ostream& out) const {
   out << ")";
 }
 
+bulk_load_request::~bulk_load_request() throw() {
+}
+
+
+void bulk_load_request::__set_pid(const  ::dsn::gpid& val) {
+  this->pid = val;
+}
+
+void bulk_load_request::__set_source(const  ::dsn::rpc_address& val) {
+  this->source = val;
+}
+
+void bulk_load_request::__set_source_dir(const std::string& val) {
+  this->source_dir = val;
+}
+
+void bulk_load_request::__set_files(const std::vector<std::string> & val) {
+  this->files = val;
+}
+
+void bulk_load_request::__set_ballot(const int64_t val) {
+  this->ballot = val;
+}
+
+void bulk_load_request::__set_signature(const int64_t val) {
+  this->signature = val;
+}
+
+uint32_t bulk_load_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->pid.read(iprot);
+          this->__isset.pid = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->source.read(iprot);
+          this->__isset.source = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->source_dir);
+          this->__isset.source_dir = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->files.clear();
+            uint32_t _size185;
+            ::apache::thrift::protocol::TType _etype186;
+            xfer += iprot->readListBegin(_etype186, _size185);
+            this->files.resize(_size185);
+            uint32_t _i187;
+            for (_i187 = 0; _i187 < _size185; ++_i187)
+            {
+              xfer += iprot->readString(this->files[_i187]);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.files = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->ballot);
+          this->__isset.ballot = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 6:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->signature);
+          this->__isset.signature = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t bulk_load_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("bulk_load_request");
+
+  xfer += oprot->writeFieldBegin("pid", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->pid.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("source", ::apache::thrift::protocol::T_STRUCT, 2);
+  xfer += this->source.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("source_dir", ::apache::thrift::protocol::T_STRING, 3);
+  xfer += oprot->writeString(this->source_dir);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("files", ::apache::thrift::protocol::T_LIST, 4);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRING, static_cast<uint32_t>(this->files.size()));
+    std::vector<std::string> ::const_iterator _iter188;
+    for (_iter188 = this->files.begin(); _iter188 != this->files.end(); ++_iter188)
+    {
+      xfer += oprot->writeString((*_iter188));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("ballot", ::apache::thrift::protocol::T_I64, 5);
+  xfer += oprot->writeI64(this->ballot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("signature", ::apache::thrift::protocol::T_I64, 6);
+  xfer += oprot->writeI64(this->signature);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(bulk_load_request &a, bulk_load_request &b) {
+  using ::std::swap;
+  swap(a.pid, b.pid);
+  swap(a.source, b.source);
+  swap(a.source_dir, b.source_dir);
+  swap(a.files, b.files);
+  swap(a.ballot, b.ballot);
+  swap(a.signature, b.signature);
+  swap(a.__isset, b.__isset);
+}
+
+bulk_load_request::bulk_load_request(const bulk_load_request& other189) {
+  pid = other189.pid;
+  source = other189.source;
+  source_dir = other189.source_dir;
+  files = other189.files;
+  ballot = other189.ballot;
+  signature = other189.signature;
+  __isset = other189.__isset;
+}
+bulk_load_request& bulk_load_request::operator=(const bulk_load_request& other190) {
+  pid = other190.pid;
+  source = other190.source;
+  source_dir = other190.source_dir;
+  files = other190.files;
+  ballot = other190.ballot;
+  signature = other190.signature;
+  __isset = other190.__isset;
+  return *this;
+}
+void bulk_load_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "bulk_load_request(";
+  out << "pid=" << to_string(pid);
+  out << ", " << "source=" << to_string(source);
+  out << ", " << "source_dir=" << to_string(source_dir);
+  out << ", " << "files=" << to_string(files);
+  out << ", " << "ballot=" << to_string(ballot);
+  out << ", " << "signature=" << to_string(signature);
+  out << ")";
+}
+
+
+bulk_load_response::~bulk_load_response() throw() {
+}
+
+
+void bulk_load_response::__set_err(const  ::dsn::error_code& val) {
+  this->err = val;
+}
+
+void bulk_load_response::__set_decree(const int64_t val) {
+  this->decree = val;
+}
+
+uint32_t bulk_load_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->err.read(iprot);
+          this->__isset.err = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->decree);
+          this->__isset.decree = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t bulk_load_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("bulk_load_response");
+
+  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->err.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("decree", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->decree);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(bulk_load_response &a, bulk_load_response &b) {
+  using ::std::swap;
+  swap(a.err, b.err);
+  swap(a.decree, b.decree);
+  swap(a.__isset, b.__isset);
+}
+
+bulk_load_response::bulk_load_response(const bulk_load_response& other191) {
+  err = other191.err;
+  decree = other191.decree;
+  __isset = other191.__isset;
+}
+bulk_load_response& bulk_load_response::operator=(const bulk_load_response& other192) {
+  err = other192.err;
+  decree = other192.decree;
+  __isset = other192.__isset;
+  return *this;
+}
+void bulk_load_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "bulk_load_response(";
+  out << "err=" << to_string(err);
+  out << ", " << "decree=" << to_string(decree);
+  out << ")";
+}
+
+
+split_partition_request::~split_partition_request() throw() {
+}
+
+
+void split_partition_request::__set_parent(const  ::dsn::gpid& val) {
+  this->parent = val;
+}
+
+void split_partition_request::__set_parent_ballot(const int64_t val) {
+  this->parent_ballot = val;
+}
+
+void split_partition_request::__set_child(const  ::dsn::gpid& val) {
+  this->child = val;
+}
+
+void split_partition_request::__set_child_primary(const  ::dsn::rpc_address& val) {
+  this->child_primary = val;
+}
+
+void split_partition_request::__set_partition_count(const int32_t val) {
+  this->partition_count = val;
+}
+
+uint32_t split_partition_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->parent.read(iprot);
+          this->__isset.parent = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->parent_ballot);
+          this->__isset.parent_ballot = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->child.read(iprot);
+          this->__isset.child = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->child_primary.read(iprot);
+          this->__isset.child_primary = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->partition_count);
+          this->__isset.partition_count = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t split_partition_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("split_partition_request");
+
+  xfer += oprot->writeFieldBegin("parent", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->parent.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("parent_ballot", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->parent_ballot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("child", ::apache::thrift::protocol::T_STRUCT, 3);
+  xfer += this->child.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("child_primary", ::apache::thrift::protocol::T_STRUCT, 4);
+  xfer += this->child_primary.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("partition_count", ::apache::thrift::protocol::T_I32, 5);
+  xfer += oprot->writeI32(this->partition_count);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(split_partition_request &a, split_partition_request &b) {
+  using ::std::swap;
+  swap(a.parent, b.parent);
+  swap(a.parent_ballot, b.parent_ballot);
+  swap(a.child, b.child);
+  swap(a.child_primary, b.child_primary);
+  swap(a.partition_count, b.partition_count);
+  swap(a.__isset, b.__isset);
+}
+
+split_partition_request::split_partition_request(const split_partition_request& other215) {
+  parent = other215.parent;
+  parent_ballot = other215.parent_ballot;
+  child = other215.child;
+  child_primary = other215.child_primary;
+  partition_count = other215.partition_count;
+  __isset = other215.__isset;
+}
+split_partition_request& split_partition_request::operator=(const split_partition_request& other216) {
+  parent = other216.parent;
+  parent_ballot = other216.parent_ballot;
+  child = other216.child;
+  child_primary = other216.child_primary;
+  partition_count = other216.partition_count;
+  __isset = other216.__isset;
+  return *this;
+}
+void split_partition_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "split_partition_request(";
+  out << "parent=" << to_string(parent);
+  out << ", " << "parent_ballot=" << to_string(parent_ballot);
+  out << ", " << "child=" << to_string(child);
+  out << ", " << "child_primary=" << to_string(child_primary);
+  out << ", " << "partition_count=" << to_string(partition_count);
+  out << ")";
+}
+
+
+split_forward_request::~split_forward_request() throw() {
+}
+
+
+void split_forward_request::__set_child(const  ::dsn::gpid& val) {
+  this->child = val;
+}
+
+void split_forward_request::__set_bulk_load_decree(const int64_t val) {
+  this->bulk_load_decree = val;
+}
+
+void split_forward_request::__set_updates(const std::vector<mutation_update> & val) {
+  this->updates = val;
+}
+
+uint32_t split_forward_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->child.read(iprot);
+          this->__isset.child = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->bulk_load_decree);
+          this->__isset.bulk_load_decree = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->updates.clear();
+            uint32_t _size217;
+            ::apache::thrift::protocol::TType _etype218;
+            xfer += iprot->readListBegin(_etype218, _size217);
+            this->updates.resize(_size217);
+            uint32_t _i219;
+            for (_i219 = 0; _i219 < _size217; ++_i219)
+            {
+              xfer += this->updates[_i219].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.updates = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t split_forward_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("split_forward_request");
+
+  xfer += oprot->writeFieldBegin("child", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->child.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("bulk_load_decree", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->bulk_load_decree);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("updates", ::apache::thrift::protocol::T_LIST, 3);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->updates.size()));
+    std::vector<mutation_update> ::const_iterator _iter220;
+    for (_iter220 = this->updates.begin(); _iter220 != this->updates.end(); ++_iter220)
+    {
+      xfer += (*_iter220).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(split_forward_request &a, split_forward_request &b) {
+  using ::std::swap;
+  swap(a.child, b.child);
+  swap(a.bulk_load_decree, b.bulk_load_decree);
+  swap(a.updates, b.updates);
+  swap(a.__isset, b.__isset);
+}
+
+split_forward_request::split_forward_request(const split_forward_request& other221) {
+  child = other221.child;
+  bulk_load_decree = other221.bulk_load_decree;
+  updates = other221.updates;
+  __isset = other221.__isset;
+}
+split_forward_request& split_forward_request::operator=(const split_forward_request& other222) {
+  child = other222.child;
+  bulk_load_decree = other222.bulk_load_decree;
+  updates = other222.updates;
+  __isset = other222.__isset;
+  return *this;
+}
+void split_forward_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "split_forward_request(";
+  out << "child=" << to_string(child);
+  out << ", " << "bulk_load_decree=" << to_string(bulk_load_decree);
+  out << ", " << "updates=" << to_string(updates);
+  out << ")";
+}
+
+
+split_forward_response::~split_forward_response() throw() {
+}
+
+
+void split_forward_response::__set_err(const  ::dsn::error_code& val) {
+  this->err = val;
+}
+
+uint32_t split_forward_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->err.read(iprot);
+          this->__isset.err = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t split_forward_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("split_forward_response");
+
+  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->err.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(split_forward_response &a, split_forward_response &b) {
+  using ::std::swap;
+  swap(a.err, b.err);
+  swap(a.__isset, b.__isset);
+}
+
+split_forward_response::split_forward_response(const split_forward_response& other223) {
+  err = other223.err;
+  __isset = other223.__isset;
+}
+split_forward_response& split_forward_response::operator=(const split_forward_response& other224) {
+  err = other224.err;
+  __isset = other224.__isset;
+  return *this;
+}
+void split_forward_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "split_forward_response(";
+  out << "err=" << to_string(err);
+  out << ")";
+}
+
+
+notify_split_ready_request::~notify_split_ready_request() throw() {
+}
+
+
+void notify_split_ready_request::__set_parent(const  ::dsn::gpid& val) {
+  this->parent = val;
+}
+
+void notify_split_ready_request::__set_parent_ballot(const int64_t val) {
+  this->parent_ballot = val;
+}
+
+void notify_split_ready_request::__set_child(const  ::dsn::gpid& val) {
+  this->child = val;
+}
+
+uint32_t notify_split_ready_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->parent.read(iprot);
+          this->__isset.parent = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->parent_ballot);
+          this->__isset.parent_ballot = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->child.read(iprot);
+          this->__isset.child = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t notify_split_ready_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("notify_split_ready_request");
+
+  xfer += oprot->writeFieldBegin("parent", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->parent.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("parent_ballot", ::apache::thrift::protocol::T_I64, 2);
+  xfer += oprot->writeI64(this->parent_ballot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("child", ::apache::thrift::protocol::T_STRUCT, 3);
+  xfer += this->child.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(notify_split_ready_request &a, notify_split_ready_request &b) {
+  using ::std::swap;
+  swap(a.parent, b.parent);
+  swap(a.parent_ballot, b.parent_ballot);
+  swap(a.child, b.child);
+  swap(a.__isset, b.__isset);
+}
+
+notify_split_ready_request::notify_split_ready_request(const notify_split_ready_request& other225) {
+  parent = other225.parent;
+  parent_ballot = other225.parent_ballot;
+  child = other225.child;
+  __isset = other225.__isset;
+}
+notify_split_ready_request& notify_split_ready_request::operator=(const notify_split_ready_request& other226) {
+  parent = other226.parent;
+  parent_ballot = other226.parent_ballot;
+  child = other226.child;
+  __isset = other226.__isset;
+  return *this;
+}
+void notify_split_ready_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "notify_split_ready_request(";
+  out << "parent=" << to_string(parent);
+  out << ", " << "parent_ballot=" << to_string(parent_ballot);
+  out << ", " << "child=" << to_string(child);
+  out << ")";
+}
+
+
+notify_split_ready_response::~notify_split_ready_response() throw() {
+}
+
+
+void notify_split_ready_response::__set_err(const  ::dsn::error_code& val) {
+  this->err = val;
+}
+
+uint32_t notify_split_ready_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->err.read(iprot);
+          this->__isset.err = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t notify_split_ready_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("notify_split_ready_response");
+
+  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->err.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(notify_split_ready_response &a, notify_split_ready_response &b) {
+  using ::std::swap;
+  swap(a.err, b.err);
+  swap(a.__isset, b.__isset);
+}
+
+notify_split_ready_response::notify_split_ready_response(const notify_split_ready_response& other227) {
+  err = other227.err;
+  __isset = other227.__isset;
+}
+notify_split_ready_response& notify_split_ready_response::operator=(const notify_split_ready_response& other228) {
+  err = other228.err;
+  __isset = other228.__isset;
+  return *this;
+}
+void notify_split_ready_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "notify_split_ready_response(";
+  out << "err=" << to_string(err);
+  out << ")";
+}
+
+
+configuration_split_app_request::~configuration_split_app_request() throw() {
+}
+
+
+void configuration_split_app_request::__set_app_name(const std::string& val) {
+  this->app_name = val;
+}
+
+uint32_t configuration_split_app_request::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->app_name);
+          this->__isset.app_name = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t configuration_split_app_request::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("configuration_split_app_request");
+
+  xfer += oprot->writeFieldBegin("app_name", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeString(this->app_name);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(configuration_split_app_request &a, configuration_split_app_request &b) {
+  using ::std::swap;
+  swap(a.app_name, b.app_name);
+  swap(a.__isset, b.__isset);
+}
+
+configuration_split_app_request::configuration_split_app_request(const configuration_split_app_request& other229) {
+  app_name = other229.app_name;
+  __isset = other229.__isset;
+}
+configuration_split_app_request& configuration_split_app_request::operator=(const configuration_split_app_request& other230) {
+  app_name = other230.app_name;
+  __isset = other230.__isset;
+  return *this;
+}
+void configuration_split_app_request::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "configuration_split_app_request(";
+  out << "app_name=" << to_string(app_name);
+  out << ")";
+}
+
+
+configuration_split_app_response::~configuration_split_app_response() throw() {
+}
+
+
+void configuration_split_app_response::__set_err(const  ::dsn::error_code& val) {
+  this->err = val;
+}
+
+void configuration_split_app_response::__set_partition_count(const int32_t val) {
+  this->partition_count = val;
+}
+
+uint32_t configuration_split_app_response::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  apache::thrift::protocol::TInputRecursionTracker tracker(*iprot);
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->err.read(iprot);
+          this->__isset.err = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->partition_count);
+          this->__isset.partition_count = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t configuration_split_app_response::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  apache::thrift::protocol::TOutputRecursionTracker tracker(*oprot);
+  xfer += oprot->writeStructBegin("configuration_split_app_response");
+
+  xfer += oprot->writeFieldBegin("err", ::apache::thrift::protocol::T_STRUCT, 1);
+  xfer += this->err.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("partition_count", ::apache::thrift::protocol::T_I32, 2);
+  xfer += oprot->writeI32(this->partition_count);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(configuration_split_app_response &a, configuration_split_app_response &b) {
+  using ::std::swap;
+  swap(a.err, b.err);
+  swap(a.partition_count, b.partition_count);
+  swap(a.__isset, b.__isset);
+}
+
+configuration_split_app_response::configuration_split_app_response(const configuration_split_app_response& other231) {
+  err = other231.err;
+  partition_count = other231.partition_count;
+  __isset = other231.__isset;
+}
+configuration_split_app_response& configuration_split_app_response::operator=(const configuration_split_app_response& other232) {
+  err = other232.err;
+  partition_count = other232.partition_count;
+  __isset = other232.__isset;
+  return *this;
+}
+void configuration_split_app_response::printTo(std::ostream& out) const {
+  using ::apache::thrift::to_string;
+  out << "configuration_split_app_response(";
+  out << "err=" << to_string(err);
+  out << ", " << "partition_count=" << to_string(partition_count);
+  out << ")";
+}
+
 }} // namespace
@@ -10,13 +10,17 @@ void usage(char* exe)
     std::cout << "Usage:" << std::endl;
     std::cout << "\t" << exe << " <config.ini> create_app -name <app_name> -type <app_type> [-pc partition_count] [-rc replication_count] [-env k1=v1;k2=v2;...] [-stateless]" << std::endl;
     std::cout << "\t" << exe << " <config.ini> drop_app -name <app_name>" << std::endl;
+    std::cout << "\t" << exe << " <config.ini> split_app -name <app_name>" << std::endl;
     std::cout << "\t" << exe << " <config.ini> list_apps [-status <all|available|creating|creating_failed|dropping|dropping_failed|dropped>] [-o <out_file>]" << std::endl;
     std::cout << "\t" << exe << " <config.ini> list_nodes [-status <all|alive|unalive>] [-o <out_file>]" << std::endl;
     std::cout << "\t" << exe << " <config.ini> list_app -name <app_name> [-detailed] [-o <out_file>]" << std::endl;
     std::cout << "\t" << exe << " <config.ini> stop_migration" << std::endl;
     std::cout << "\t" << exe << " <config.ini> start_migration" << std::endl;
     std::cout << "\t" << exe << " <config.ini> balancer -gpid <appid.partition_index> -type <move_pri|copy_pri|copy_sec> -from <from_address> -to <to_address>" << std::endl;
+    std::cout << "\t" << exe << " <config.ini> bulk_load -name <app_name> -source <source_address> -dir <source_dir> -files <f1;f2;...>" << std::endl;
     std::cout << "\t\tpartition count must be a power of 2" << std::endl;
+    std::cout << "\t\tsplit_app doubles the partition count, the new partitions serve their keys once they catch up" << std::endl;
+    std::cout << "\t\tbulk_load ingests <source_dir>/<partition_index>/<files> into each partition, replacing its state" << std::endl;
     std::cout << "\t\tapp_name and app_type shoud be composed of a-z, 0-9 and underscore" << std::endl;
     std::cout << "\t\twithout -o option, program will print status on screen" << std::endl;
     std::cout << "\t\twith -detailed option, program will also print partition state" << std::endl;
@@ -74,6 +78,9 @@ int main(int argc, char** argv)
     std::string out_file;
     bool is_stateless = false;
     std::map<std::string, std::string> envs;
+    dsn::rpc_address source;
+    std::string source_dir;
+    std::vector<std::string> files;
 
     for(int index = 3; index < argc; index++)
     {
@@ -124,6 +131,21 @@ int main(int argc, char** argv)
             }
             std::cout << "envs:" << argv[index] << std::endl;
         }
+        else if (strcmp(argv[index], "-source") == 0 && argc > index)
+        {
+            source.from_string_ipv4(argv[++index]);
+            std::cout << "source:" << argv[index] << std::endl;
+        }
+        else if (strcmp(argv[index], "-dir") == 0 && argc > index)
+        {
+            source_dir.assign(argv[++index]);
+            std::cout << "source_dir:" << source_dir << std::endl;
+        }
+        else if (strcmp(argv[index], "-files") == 0 && argc > index)
+        {
+            ::dsn::utils::split_args(argv[++index], files, ';');
+            std::cout << "files:" << argv[index] << std::endl;
+        }
         else if (strcmp(argv[index], "-stateless") == 0)
         {
             is_stateless = true;
@@ -164,6 +186,15 @@ int main(int argc, char** argv)
         else
             std::cout << "drop app:" << app_name << " failed, error=" << dsn_error_to_string(err) << std::endl;
     }
+    else if(command == "split_app") {
+        if(app_name.empty())
+            usage(argv[0]);
+        dsn::error_code err = client.split_app(app_name, partition_count);
+        if(err == dsn::ERR_OK)
+            std::cout << "split app:" << app_name << " into " << partition_count << " partitions ongoing ..." << std::endl;
+        else
+            std::cout << "split app:" << app_name << " failed, error=" << dsn_error_to_string(err) << std::endl;
+    }
     else if(command == "list_apps") {
         dsn::app_status::type s = dsn::app_status::AS_INVALID;
         if (!status.empty() && status != "all") {
@@ -240,6 +271,12 @@ int main(int argc, char** argv)
         dsn::error_code err = client.send_balancer_proposal(request);
         std::cout << "send balancer proposal result: " << err.to_string() << std::endl;
     }
+    else if (command == "bulk_load") {
+        if (app_name.empty() || source.is_invalid() || source_dir.empty() || files.empty())
+            usage(argv[0]);
+        dsn::error_code err = client.bulk_load(app_name, source, source_dir, files);
+        std::cout << "bulk load result: " << err.to_string() << std::endl;
+    }
     else {
         std::cout << "invalid command:" << command << std::endl;
         usage(argv[0]);
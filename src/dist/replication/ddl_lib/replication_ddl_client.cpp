@@ -189,6 +189,30 @@ dsn::error_code replication_ddl_client::drop_app(const std::string& app_name)
     return dsn::ERR_OK;
 }
 
+dsn::error_code replication_ddl_client::split_app(const std::string& app_name, /*out*/ int32_t& partition_count)
+{
+    if(app_name.empty() || !std::all_of(app_name.cbegin(),app_name.cend(),(bool (*)(int)) replication_ddl_client::valid_app_char))
+        return ERR_INVALID_PARAMETERS;
+
+    std::shared_ptr<configuration_split_app_request> req(new configuration_split_app_request());
+    req->app_name = app_name;
+
+    auto resp_task = request_meta<configuration_split_app_request>(
+            RPC_CM_SPLIT_APP,
+            req
+    );
+    resp_task->wait();
+    if (resp_task->error() != dsn::ERR_OK)
+    {
+        return resp_task->error();
+    }
+
+    dsn::replication::configuration_split_app_response resp;
+    ::dsn::unmarshall(resp_task->response(), resp);
+    partition_count = resp.partition_count;
+    return resp.err;
+}
+
 dsn::error_code replication_ddl_client::list_apps(const dsn::app_status::type status, const std::string& file_name)
 {
     std::shared_ptr<configuration_list_apps_request> req(new configuration_list_apps_request());
@@ -509,6 +533,56 @@ dsn::error_code replication_ddl_client::send_balancer_proposal(const configurati
     return resp.err;
 }
 
+dsn::error_code replication_ddl_client::bulk_load(const std::string& app_name, const dsn::rpc_address& source, const std::string& source_dir, const std::vector<std::string>& files, int timeout_seconds)
+{
+    if (files.empty())
+        return ERR_INVALID_PARAMETERS;
+
+    int32_t app_id;
+    int32_t partition_count;
+    std::vector<partition_configuration> partitions;
+    dsn::error_code err = list_app(app_name, app_id, partition_count, partitions);
+    if (err != dsn::ERR_OK)
+    {
+        std::cout << "bulk load " << app_name << " failed: list app error: " << err.to_string() << std::endl;
+        return err;
+    }
+
+    for (const partition_configuration& pc : partitions)
+    {
+        int pidx = pc.pid.get_partition_index();
+        if (pc.primary.is_invalid())
+        {
+            std::cout << "bulk load " << app_name << " failed: partition " << pidx << " has no primary" << std::endl;
+            return ERR_INVALID_STATE;
+        }
+
+        bulk_load_request req;
+        req.pid = pc.pid;
+        req.source = source;
+        req.source_dir = source_dir + "/" + std::to_string(pidx);
+        req.files = files;
+        req.ballot = 0;
+        req.signature = 0;
+
+        auto resp = rpc::call_wait<bulk_load_response>(
+            pc.primary,
+            RPC_BULK_LOAD,
+            req,
+            static_cast<int>(gpid_to_hash(pc.pid)),
+            std::chrono::seconds(timeout_seconds)
+            );
+        err = (resp.first == ERR_OK ? resp.second.err : resp.first);
+        if (err != dsn::ERR_OK)
+        {
+            std::cout << "bulk load " << app_name << " failed: partition " << pidx << " error: " << err.to_string() << std::endl;
+            return err;
+        }
+        std::cout << "bulk load " << app_name << ": partition " << pidx << " loaded at decree " << resp.second.decree << std::endl;
+    }
+    return dsn::ERR_OK;
+}
+
 bool replication_ddl_client::valid_app_char(int c)
 {
     return (bool)std::isalnum(c) || c == '_' || c == '.';
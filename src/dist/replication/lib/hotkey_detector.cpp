@@ -0,0 +1,149 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     sampled hot key detection of one partition
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+#include "hotkey_detector.h"
+#include <algorithm>
+#include <cstring>
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "replica.hotkey"
+
+namespace dsn { namespace replication {
+
+hotkey_detector::hotkey_detector(int sample_interval, int top_count, int window_sample_count)
+    : _sample_interval(sample_interval > 0 ? sample_interval : 1),
+    _top_count(top_count > 0 ? top_count : 1),
+    _window_sample_count(window_sample_count > 0 ? window_sample_count : 1),
+    _calls(0),
+    _window_count(0)
+{
+    memset(_sketch, 0, sizeof(_sketch));
+}
+
+// one independent hash per sketch row, derived from the 64-bit key hash
+uint32_t hotkey_detector::estimate_and_add(uint64_t hash)
+{
+    static const uint64_t seeds[sketch_depth] = {
+        0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL, 0x27d4eb2f165667c5ULL
+    };
+
+    uint32_t estimate = UINT32_MAX;
+    for (int d = 0; d < sketch_depth; d++)
+    {
+        uint64_t h = (hash ^ seeds[d]) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        uint32_t& c = _sketch[d][h % sketch_width];
+        ++c;
+        estimate = std::min(estimate, c);
+    }
+    return estimate;
+}
+
+int hotkey_detector::record(uint64_t hash, bool is_write)
+{
+    ::dsn::service::zauto_lock l(_lock);
+
+    uint32_t estimate = estimate_and_add(hash);
+    ++_window_count;
+
+    auto it = std::find_if(_heavy_hitters.begin(), _heavy_hitters.end(),
+        [hash](const hot_key& k) { return k.hash == hash; });
+    if (it == _heavy_hitters.end())
+    {
+        if (_heavy_hitters.size() < _top_count)
+        {
+            _heavy_hitters.push_back(hot_key{ hash, 0, 0, 0 });
+            it = _heavy_hitters.end() - 1;
+        }
+        else
+        {
+            // replace the coldest one only when this key is estimated hotter
+            it = std::min_element(_heavy_hitters.begin(), _heavy_hitters.end(),
+                [](const hot_key& l, const hot_key& r) { return l.count < r.count; });
+            if (it->count >= estimate)
+                it = _heavy_hitters.end();
+            else
+                *it = hot_key{ hash, 0, 0, 0 };
+        }
+    }
+
+    if (it != _heavy_hitters.end())
+    {
+        it->count = estimate;
+        if (is_write)
+            it->writes++;
+        else
+            it->reads++;
+    }
+
+    uint32_t top = 0;
+    for (auto& k : _heavy_hitters)
+        top = std::max(top, k.count);
+    int share = static_cast<int>(std::min(top, _window_count) * 100 / _window_count);
+
+    if (_window_count >= _window_sample_count)
+        decay();
+
+    return share;
+}
+
+void hotkey_detector::decay()
+{
+    for (int d = 0; d < sketch_depth; d++)
+    {
+        for (int w = 0; w < sketch_width; w++)
+        {
+            _sketch[d][w] >>= 1;
+        }
+    }
+
+    for (auto& k : _heavy_hitters)
+    {
+        k.count >>= 1;
+    }
+    _window_count >>= 1;
+}
+
+uint32_t hotkey_detector::get_hot_keys(/*out*/ std::vector<hot_key>& keys) const
+{
+    ::dsn::service::zauto_lock l(_lock);
+    keys = _heavy_hitters;
+    std::sort(keys.begin(), keys.end(), [](const hot_key& l, const hot_key& r) { return l.count > r.count; });
+    return _window_count;
+}
+
+}} // namespace
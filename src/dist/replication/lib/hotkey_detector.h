@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     sampled hot key detection of one partition
+ *
+ *     keys are identified by the partition hash clients attach to their requests
+ *     (see dsn_msg_get_partition_hash); one in every sample_interval requests is
+ *     counted in a count-min sketch, and the keys with the largest estimates are
+ *     kept in a small heavy-hitter list; all counts are halved once a window of
+ *     samples is full, so the list follows the recent load
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+#pragma once
+
+#include <dsn/service_api_cpp.h>
+#include <atomic>
+#include <vector>
+
+namespace dsn { namespace replication {
+
+class hotkey_detector
+{
+public:
+    struct hot_key
+    {
+        uint64_t hash;
+        uint32_t count;  // estimated samples in the current window
+        uint32_t reads;  // samples since the key entered the list
+        uint32_t writes;
+    };
+
+    hotkey_detector(int sample_interval, int top_count, int window_sample_count);
+
+    // called on every request, true when this one is to be recorded
+    bool sample()
+    {
+        return _calls.fetch_add(1, std::memory_order_relaxed) % _sample_interval == 0;
+    }
+
+    // returns the share (%) of the hottest key in the current window
+    int record(uint64_t hash, bool is_write);
+
+    // returns the samples in the current window, keys are in descending order of count
+    uint32_t get_hot_keys(/*out*/ std::vector<hot_key>& keys) const;
+
+    int sample_interval() const { return _sample_interval; }
+
+private:
+    uint32_t estimate_and_add(uint64_t hash);
+    void decay();
+
+private:
+    enum { sketch_depth = 4, sketch_width = 1024 };
+
+    const uint64_t        _sample_interval;
+    const size_t          _top_count;
+    const uint32_t        _window_sample_count;
+    std::atomic<uint64_t> _calls;
+
+    mutable ::dsn::service::zlock _lock;
+    uint32_t              _sketch[sketch_depth][sketch_width];
+    std::vector<hot_key>  _heavy_hitters; // at most _top_count
+    uint32_t              _window_count;
+};
+
+}} // namespace
@@ -136,6 +136,18 @@ void mutation::add_client_request(task_code code, dsn_message_t request)
     dassert(client_requests.size() == data.updates.size(), "size must be equal");
 }
 
+void mutation::add_replica_update(task_code code, const blob& payload)
+{
+    data.updates.push_back(mutation_update());
+    mutation_update& update = data.updates.back();
+    update.code = code;
+    update.serialization_type = DSF_THRIFT_BINARY;
+    update.data = payload;
+    _appro_data_bytes += 32 + sizeof(int) + payload.length();
+
+    client_requests.push_back(nullptr);
+}
+
 void mutation::write_to(binary_writer& writer) const
 {
     marshall(writer, data, DSF_THRIFT_BINARY);
@@ -385,6 +397,16 @@ mutation_ptr mutation_queue::check_possible_work(int current_running_count)
     }
 }
 
+uint64_t mutation_queue::oldest_tid() const
+{
+    if (!_hdr.is_empty())
+        return _hdr._first->tid();
+    else if (_pending_mutation != nullptr)
+        return _pending_mutation->tid();
+    else
+        return 0;
+}
+
 void mutation_queue::clear()
 {
     if (_pending_mutation != nullptr)
@@ -56,6 +56,8 @@ public:
     // state inquery
     const char* name() const { return _name; }
     const uint64_t tid() const { return _tid; }
+    // tid of the latest created mutation in this process
+    static uint64_t last_tid() { return s_tid.load(); }
     bool is_logged() const { return _not_logged == 0; }
     bool is_ready_for_commit() const { return _private0 == 0; }
     dsn_message_t prepare_msg() { return _prepare_request; }
@@ -69,6 +71,8 @@ public:
     // state change
     void set_id(ballot b, decree c);
     void add_client_request(task_code code, dsn_message_t request);
+    // an update issued by the replica itself, so there is no client request to reply
+    void add_replica_update(task_code code, const blob& payload);
     void copy_from(mutation_ptr& old);
     void set_logged() { dassert (!is_logged(), ""); _not_logged = 0; }
     unsigned int decrease_left_secondary_ack_count() { return --_left_secondary_ack_count; }
@@ -152,6 +156,10 @@ public:
     // which triggers further round of operations as returned
     mutation_ptr check_possible_work(int current_running_count);
 
+    // tid of the oldest mutation not handed out yet, 0 when there is none;
+    // mutations are handed out in the order they are created
+    uint64_t oldest_tid() const;
+
 private:
     mutation_ptr unlink_next_workload()
     {
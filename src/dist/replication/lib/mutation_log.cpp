@@ -1082,12 +1082,12 @@ void mutation_log::get_learn_state(
     /*out*/ ::dsn::replication::learn_state& state
     ) const
 {
-    dassert(_is_private, "this method is only valid for private logs");
-    dassert(_private_gpid == gpid, "replica gpid does not match");
+    dassert(!_is_private || _private_gpid == gpid, "replica gpid does not match");
 
     std::map<int, log_file_ptr> files;
     std::map<int, log_file_ptr>::reverse_iterator itr;
     log_file_ptr cfile = nullptr;
+    replica_log_info log_info;
 
     {
         zauto_lock l(_lock);
@@ -1095,14 +1095,61 @@ void mutation_log::get_learn_state(
         files = _log_files;
         cfile = _current_log_file;
 
+        if (_is_private)
+        {
+            log_info = _private_log_info;
+        }
+        else
+        {
+            auto it = _shared_log_info_map.find(gpid);
+            if (it == _shared_log_info_map.end())
+                return;
+            log_info = it->second;
+        }
+
         binary_writer temp_writer;
         if (!get_learn_state_in_memory(start, temp_writer) &&
-            start > _private_log_info.max_decree)
+            start > log_info.max_decree)
             return;
 
         state.meta = temp_writer.get_buffer();
     }
 
+    if (!_is_private)
+    {
+        // nothing is logged for this replica after start
+        if (start > log_info.max_decree)
+            return;
+
+        // flush last file so learning can learn the on-disk state
+        if (nullptr != cfile) cfile->flush();
+
+        // the previous max decree of each file is the index:
+        // stop at the first file which is started before "start"
+        std::list<std::string> learn_files;
+        for (itr = files.rbegin(); itr != files.rend(); ++itr)
+        {
+            log_file_ptr& log = itr->second;
+            if (log->end_offset() <= log_info.valid_start_offset)
+                break;
+
+            if (log->end_offset() > log->start_offset())
+            {
+                // not empty file
+                learn_files.push_back(log->path());
+            }
+
+            if (log->previous_log_max_decree(gpid) < start)
+                break;
+        }
+
+        for (auto it = learn_files.rbegin(); it != learn_files.rend(); ++it)
+        {
+            state.files.push_back(*it);
+        }
+        return;
+    }
+
     // flush last file so learning can learn the on-disk state
     if (nullptr != cfile) cfile->flush();
 
@@ -1112,7 +1159,7 @@ void mutation_log::get_learn_state(
     for (itr = files.rbegin(); itr != files.rend(); ++itr)
     {
         log_file_ptr& log = itr->second;
-        if (log->end_offset() <= _private_log_info.valid_start_offset)
+        if (log->end_offset() <= log_info.valid_start_offset)
             break;
 
         if (skip_next)
@@ -234,7 +234,9 @@ public:
     int garbage_collection(replica_log_info_map& gc_condition);
 
     //
-    //  when this is a private log, log files are learned by remote replicas
+    //  log files are learned by remote replicas, or used to catch up locally;
+    //  for the shared log, the files are selected with the per-file previous
+    //  max decrees of "gpid", and may contain mutations of other replicas
     //
     void get_learn_state(
         gpid gpid,
@@ -60,6 +60,8 @@ replica::replica(replica_stub* stub, gpid gpid, const app_info& app, const char*
     _options = &stub->options();
     init_state();
     _config.pid = gpid;
+    _partition_count = replica_helper::get_serving_partition_count(_app_info, gpid.get_partition_index());
+    _app_ever_split = replica_helper::is_app_ever_split(_app_info);
 
     std::stringstream ss;
     ss << _name << ".2pc.latency(ns)";
@@ -69,6 +71,31 @@ replica::replica(replica_stub* stub, gpid gpid, const app_info& app, const char*
     ss << _name << ".private_log_size(MB)";
     _counter_private_log_size.init("eon.replication", ss.str().c_str(), COUNTER_TYPE_NUMBER, "private log size(MB)");
 
+    ss.str("");
+    ss << _name << ".request.qps";
+    _counter_request_qps.init("eon.replication", ss.str().c_str(), COUNTER_TYPE_RATE, "client requests per second, estimated by sampling");
+
+    ss.str("");
+    ss << _name << ".request.bytes";
+    _counter_request_bytes.init("eon.replication", ss.str().c_str(), COUNTER_TYPE_RATE, "client request bytes per second, estimated by sampling");
+
+    ss.str("");
+    ss << _name << ".disk_usage(MB)";
+    _counter_disk_usage.init("eon.replication", ss.str().c_str(), COUNTER_TYPE_NUMBER, "disk usage of the replica dir(MB)");
+
+    ss.str("");
+    ss << _name << ".hotkey.share(%)";
+    _counter_hotkey_share.init("eon.replication", ss.str().c_str(), COUNTER_TYPE_NUMBER, "share of the hottest key in the sampled requests");
+
+    if (!_options->hotkey_detection_disabled)
+    {
+        _hotkey_detector.reset(new hotkey_detector(
+            _options->hotkey_sample_interval,
+            _options->hotkey_top_count,
+            _options->hotkey_window_sample_count
+            ));
+    }
+
 }
 
 //void replica::json_state(std::stringstream& out) const
@@ -155,9 +182,41 @@ void replica::on_client_read(task_code code, dsn_message_t request)
 
     dassert (_app != nullptr, "");
 
+    if (!is_key_served(request))
+    {
+        response_client_message(request, ERR_PARENT_PARTITION_MISUSED);
+        return;
+    }
+
+    sample_request_key(request, false);
     dsn_hosted_app_commit_rpc_request(_app->app_context(), request, true);
 }
 
+// clients with a stale partition count send the keys of a split child to its parent
+bool replica::is_key_served(dsn_message_t request) const
+{
+    // the older clients send the hash of the partition id instead of the key, which
+    // can't be checked, but they reach the right partition till the app is split
+    if (!_app_ever_split && !dsn_msg_has_key_hash(request))
+        return true;
+
+    return _partition_count > 0 &&
+        dsn_msg_get_partition_hash(request) % static_cast<uint64_t>(_partition_count)
+            == static_cast<uint64_t>(get_gpid().get_partition_index());
+}
+
+// cheap enough for every request, as only one in hotkey_sample_interval is recorded
+void replica::sample_request_key(dsn_message_t request, bool is_write)
+{
+    if (_hotkey_detector == nullptr || !_hotkey_detector->sample())
+        return;
+
+    int share = _hotkey_detector->record(dsn_msg_get_partition_hash(request), is_write);
+    _counter_request_qps.add(_hotkey_detector->sample_interval());
+    _counter_request_bytes.add(dsn_msg_body_size(request) * _hotkey_detector->sample_interval());
+    _counter_hotkey_share.set(share);
+}
+
 void replica::response_client_message(dsn_message_t request, error_code error)
 {
     if (nullptr == request)
@@ -285,9 +344,9 @@ void replica::execute_mutation(mutation_ptr& mu)
                 _app->last_committed_decree()
                 );
 
-            // make sure private log saves the state
+            // make sure private (or shared when private is disabled) log saves the state
             // catch-up will be done later after checkpoint task is fininished
-            dassert(_private_log != nullptr, "");          
+            dassert(_private_log != nullptr || _options->log_private_disabled, "");          
         }
         break;
     case partition_status::PS_POTENTIAL_SECONDARY:
@@ -328,6 +387,21 @@ void replica::execute_mutation(mutation_ptr& mu)
 
     if (status() == partition_status::PS_PRIMARY)
     {
+        if (_primary_states.split != nullptr)
+        {
+            capture_split_updates(mu);
+        }
+        if (!_primary_states.split_forwards.empty())
+        {
+            on_split_forward_committed(mu);
+        }
+        if (_primary_states.handoff != nullptr)
+        {
+            check_primary_handoff(false);
+            if (status() != partition_status::PS_PRIMARY)
+                return;
+        }
+
         mutation_ptr next = _primary_states.write_queue.check_possible_work(
             static_cast<int>(_prepare_list->max_decree() - d)
             );
@@ -47,6 +47,7 @@
 # include "mutation.h"
 # include "prepare_list.h"
 # include "replica_context.h"
+# include "hotkey_detector.h"
 
 namespace dsn { namespace replication {
 
@@ -78,6 +79,8 @@ public:
     void check_state_completeness();
     //error_code check_and_fix_private_log_completeness();
     void close();
+    // restart learning after the stub grants a learning slot to this replica
+    void on_learning_slot_granted(uint64_t signature);
 
     //
     //    requests from clients
@@ -89,7 +92,7 @@ public:
     //    messages and tools from/for meta server
     //
     void on_config_proposal(configuration_update_request& proposal);
-    void on_config_sync(const partition_configuration& config);
+    void on_config_sync(const app_info& info, const partition_configuration& config);
             
     //
     //    messages from peers (primary or secondary)
@@ -102,6 +105,21 @@ public:
     void on_group_check(const group_check_request& request, /*out*/ group_check_response& response);
     void on_copy_checkpoint(const replica_configuration& request, /*out*/ learn_response& response);
 
+    //
+    //    bulk load, from the admin (primary) or the primary (secondary)
+    //
+    void on_bulk_load(dsn_message_t msg, const bulk_load_request& request);
+    void on_bulk_load_stage(dsn_message_t msg, const bulk_load_request& request);
+    // called by the app when the bulk load mutation is committed or fails
+    void on_bulk_load_ingested(int64_t signature, error_code err, decree d);
+    std::string bulk_load_dir(int64_t signature) const;
+
+    //
+    //    online split, from the meta server (parent primary) or the parent primary (child primary)
+    //
+    void on_split_partition(const split_partition_request& request);
+    void on_split_forward(dsn_message_t msg, const split_forward_request& request);
+
     //
     //    messsages from liveness monitor
     //
@@ -122,6 +140,8 @@ public:
     replication_app_base* get_app() { return _app.get(); }
     const app_info* get_app_info() const { return &_app_info; }
     const dsn_app_callbacks& get_app_callbacks() const { return _app_callbacks; }
+    // the keys are only checked once the app is ever split, 0 means all are served
+    int get_app_partition_count() const { return _app_ever_split ? _partition_count : 0; }
     decree max_prepared_decree() const { return _prepare_list->max_decree(); }
     decree last_committed_decree() const { return _prepare_list->last_committed_decree(); }
     decree last_prepared_decree() const;
@@ -135,11 +155,17 @@ public:
 
     //void json_state(std::stringstream& out) const;
     void update_commit_statistics(int count);
+    // nullptr when hot key detection is disabled
+    const hotkey_detector* get_hotkey_detector() const { return _hotkey_detector.get(); }
+    double get_request_qps() { return _counter_request_qps.get_value(); }
+    double get_request_bytes_per_second() { return _counter_request_bytes.get_value(); }
+    int64_t get_disk_usage_mb() { return static_cast<int64_t>(_counter_disk_usage.get_value()); }
         
 private:
     // common helpers
     void init_state();
     void response_client_message(dsn_message_t request, error_code error);    
+    void sample_request_key(dsn_message_t request, bool is_write);
     void execute_mutation(mutation_ptr& mu);
     mutation_ptr new_mutation(decree decree);    
         
@@ -169,6 +195,20 @@ private:
     void handle_learning_succeeded_on_primary(::dsn::rpc_address node, uint64_t learn_signature);
     void notify_learn_completion();
     error_code apply_learned_state_from_private_log(learn_state& state);
+    error_code replay_learned_log_files(std::vector<std::string>& files, prepare_list& plist);
+    void apply_learned_log_in_memory(const blob& meta, prepare_list& plist);
+    prepare_list* create_learning_prepare_list();
+
+    // pipelined log learning: copy log files one by one, and replay each file
+    // while the next one is being copied; when some files are applied before
+    // a failure, the next learning round resumes from the applied state
+    struct learn_log_pipeline;
+    void start_pipelined_log_learning(learn_request&& req, learn_response&& resp);
+    bool is_learn_log_pipeline_alive(const std::shared_ptr<learn_log_pipeline>& pl);
+    void copy_next_learned_log_file(const std::shared_ptr<learn_log_pipeline>& pl);
+    void on_copy_learned_log_file_completed(const std::shared_ptr<learn_log_pipeline>& pl, size_t index, error_code err, size_t size);
+    void on_learned_log_file_replayed(const std::shared_ptr<learn_log_pipeline>& pl, size_t index, error_code err);
+    void advance_learn_log_pipeline(const std::shared_ptr<learn_log_pipeline>& pl);
         
     /////////////////////////////////////////////////////////////////
     // failure handling    
@@ -181,6 +221,7 @@ private:
     void add_potential_secondary(configuration_update_request& proposal);
     void upgrade_to_secondary_on_primary(::dsn::rpc_address node);
     void downgrade_to_secondary_on_primary(configuration_update_request& proposal);
+    void check_primary_handoff(bool timeout);
     void downgrade_to_inactive_on_primary(configuration_update_request& proposal);
     void remove(configuration_update_request& proposal);
     void update_configuration_on_meta_server(config_type::type type, ::dsn::rpc_address node, partition_configuration& newConfig);
@@ -202,6 +243,7 @@ private:
     // check timer for gc, checkpointing etc.
     void on_checkpoint_timer();
     void garbage_collection();
+    void update_disk_usage();
     void init_checkpoint();
     void background_checkpoint();
     void catch_up_with_private_logs(partition_status::type s);
@@ -209,6 +251,28 @@ private:
     void on_copy_checkpoint_ack(error_code err, const std::shared_ptr<replica_configuration>& req, const std::shared_ptr<learn_response>& resp);
     void on_copy_checkpoint_file_completed(error_code err, size_t sz, std::shared_ptr<learn_response> resp, const std::string &chk_dir);
 
+    /////////////////////////////////////////////////////////////////
+    // bulk load
+    void stage_bulk_load(const bulk_load_request& request, std::function<void(error_code)> callback);
+    void on_bulk_load_staged(int64_t signature, ::dsn::rpc_address node, error_code err);
+
+    /////////////////////////////////////////////////////////////////
+    // split
+    void update_partition_count(const app_info& info);
+    void notify_app_partition_count();
+    bool is_key_served(dsn_message_t request) const;
+    bool is_split_fenced(dsn_message_t request) const;
+    bool is_split_alive(gpid child) const;
+    void on_split_seeded(gpid child, error_code err, decree d);
+    void capture_split_updates(mutation_ptr& mu);
+    void forward_split_updates();
+    void on_split_forwarded(gpid child, error_code err);
+    void check_split_fence();
+    void notify_split_ready();
+    void on_split_ready_notified(gpid child, error_code err);
+    void abort_split(const char* reason, error_code err);
+    void on_split_forward_committed(mutation_ptr& mu);
+
 private:
     friend class ::dsn::replication::replication_checker;
     friend class ::dsn::replication::test::test_checker;
@@ -237,6 +301,8 @@ private:
     char                    _name[256]; // app.index @ host:port
     replication_options     *_options;
     const app_info          _app_info;
+    int                     _partition_count; // modulus of the served key hashes, see get_serving_partition_count
+    bool                    _app_ever_split;
     dsn_app_callbacks       _app_callbacks;
     
     // replica status specific states
@@ -248,6 +314,13 @@ private:
     // perf counters
     perf_counter_               _counter_commit_latency;
     perf_counter_               _counter_private_log_size;
+    perf_counter_               _counter_request_qps;
+    perf_counter_               _counter_request_bytes;
+    perf_counter_               _counter_disk_usage;
+    perf_counter_               _counter_hotkey_share;
+
+    // sampled request keys
+    std::unique_ptr<hotkey_detector> _hotkey_detector;
 
 };
 
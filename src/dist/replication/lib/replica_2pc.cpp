@@ -63,6 +63,28 @@ void replica::on_client_write(task_code code, dsn_message_t request)
         return;
     }
 
+    // the client retries on the new primary
+    if (_primary_states.handoff != nullptr)
+    {
+        response_client_message(request, ERR_INVALID_STATE);
+        return;
+    }
+
+    if (!is_key_served(request))
+    {
+        response_client_message(request, ERR_PARENT_PARTITION_MISUSED);
+        return;
+    }
+
+    // the client retries till the child takes over the key
+    if (_primary_states.split != nullptr && is_split_fenced(request))
+    {
+        response_client_message(request, ERR_BUSY);
+        return;
+    }
+
+    sample_request_key(request, true);
+
     auto mu = _primary_states.write_queue.add_work(code, request, this);
     if (mu)
     {
@@ -386,7 +408,7 @@ void replica::on_append_log_completed(mutation_ptr& mu, error_code err, size_t s
     }
    
     // write local private log if necessary
-    if (err == ERR_OK && status() != partition_status::PS_ERROR)
+    if (err == ERR_OK && status() != partition_status::PS_ERROR && _private_log != nullptr)
     {
         _private_log->append(mu,
             LPC_WRITE_REPLICATION_LOG,
@@ -0,0 +1,266 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     bulk load of checkpoint files built offline
+ *
+ *     the primary first stages the files on all members, i.e., each member copies
+ *     them from the source node into its replica dir, and then proposes one mutation
+ *     carrying the request, whose commit applies the staged files on every member as
+ *     a learned checkpoint of that decree (see replication_app_base::write_bulk_load);
+ *     the data never goes through the mutation log, and the ingestion is ordered with
+ *     the other writes by the decree
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+#include "replica.h"
+#include "mutation.h"
+#include "mutation_log.h"
+#include "replica_stub.h"
+#include "replication_app_base.h"
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "replica.bulk_load"
+
+namespace dsn { namespace replication {
+
+std::string replica::bulk_load_dir(int64_t signature) const
+{
+    char name[64];
+    sprintf(name, "bulk_load.%" PRId64, signature);
+    return utils::filesystem::path_combine(_dir, name);
+}
+
+// @ primary
+void replica::on_bulk_load(dsn_message_t msg, const bulk_load_request& request)
+{
+    check_hashed_access();
+
+    bulk_load_response response;
+    response.decree = invalid_decree;
+
+    if (partition_status::PS_PRIMARY != status())
+    {
+        response.err = ERR_INVALID_STATE;
+    }
+    else if (request.files.empty())
+    {
+        response.err = ERR_INVALID_PARAMETERS;
+    }
+    else if (static_cast<int>(_primary_states.membership.secondaries.size()) + 1 < _options->mutation_2pc_min_replica_count)
+    {
+        response.err = ERR_NOT_ENOUGH_MEMBER;
+    }
+    // learners would miss the staged files, so the load waits for them to finish,
+    // and a split parent must not replace the checkpoint its child is seeded with
+    else if (_primary_states.bulk_load != nullptr || !_primary_states.learners.empty()
+        || _primary_states.split != nullptr)
+    {
+        response.err = ERR_BUSY;
+    }
+    else
+    {
+        response.err = ERR_OK;
+    }
+
+    if (response.err != ERR_OK)
+    {
+        dwarn("%s: reject bulk load from %s, err = %s",
+            name(), request.source_dir.c_str(), response.err.to_string());
+        reply(msg, response);
+        return;
+    }
+
+    std::unique_ptr<bulk_load_context> bl(new bulk_load_context());
+    bl->request = request;
+    bl->request.pid = get_gpid();
+    bl->request.ballot = get_ballot();
+    bl->request.signature = static_cast<int64_t>(++_primary_states.next_learning_version);
+    bl->staging_count = static_cast<int>(_primary_states.membership.secondaries.size()) + 1;
+
+    dsn_msg_add_ref(msg); // released on reply
+    bl->admin_request = msg;
+
+    _primary_states.bulk_load = std::move(bl);
+    const bulk_load_request& req = _primary_states.bulk_load->request;
+
+    ddebug("%s: start bulk load with signature %" PRId64 ", %d files from %s:%s",
+        name(), req.signature, (int)req.files.size(), req.source.to_string(), req.source_dir.c_str());
+
+    int64_t signature = req.signature;
+    ::dsn::rpc_address self = _stub->_primary_address;
+    stage_bulk_load(req, [this, signature, self](error_code err)
+    {
+        on_bulk_load_staged(signature, self, err);
+    });
+
+    for (auto& sec : _primary_states.membership.secondaries)
+    {
+        rpc::call(
+            sec,
+            RPC_BULK_LOAD_STAGE,
+            req,
+            this,
+            [this, signature, sec](error_code err, bulk_load_response&& resp)
+            {
+                on_bulk_load_staged(signature, sec, err == ERR_OK ? resp.err : err);
+            },
+            gpid_to_hash(get_gpid()),
+            std::chrono::seconds(_options->bulk_load_stage_timeout_seconds),
+            gpid_to_hash(get_gpid())
+            );
+    }
+}
+
+// @ secondary
+void replica::on_bulk_load_stage(dsn_message_t msg, const bulk_load_request& request)
+{
+    check_hashed_access();
+
+    if (request.ballot != get_ballot() || partition_status::PS_SECONDARY != status())
+    {
+        bulk_load_response response;
+        response.err = ERR_INVALID_STATE;
+        response.decree = invalid_decree;
+        reply(msg, response);
+        return;
+    }
+
+    dsn_msg_add_ref(msg); // released after reply
+    stage_bulk_load(request, [this, msg](error_code err)
+    {
+        bulk_load_response response;
+        response.err = err;
+        response.decree = invalid_decree;
+        reply(msg, response);
+        dsn_msg_release_ref(msg);
+    });
+}
+
+// copy the files into bulk_load_dir(signature), callback is run in the replica thread
+void replica::stage_bulk_load(const bulk_load_request& request, std::function<void(error_code)> callback)
+{
+    std::string dir = bulk_load_dir(request.signature);
+
+    // only one load is staged at a time, so the former ones are leftovers of failed loads
+    std::vector<std::string> sub_dirs;
+    utils::filesystem::get_subdirectories(_dir, sub_dirs, false);
+    for (auto& d : sub_dirs)
+    {
+        if (utils::filesystem::get_file_name(d).substr(0, strlen("bulk_load.")) == "bulk_load." && d != dir)
+        {
+            dwarn("%s: remove staged bulk load %s", name(), d.c_str());
+            utils::filesystem::remove_path(d);
+        }
+    }
+
+    if (utils::filesystem::path_exists(dir))
+        utils::filesystem::remove_path(dir);
+
+    int64_t signature = request.signature;
+    file::copy_remote_files(
+        request.source,
+        request.source_dir,
+        request.files,
+        dir,
+        true,
+        LPC_BULK_LOAD_STAGE_DONE,
+        this,
+        [this, signature, callback](error_code err, size_t sz)
+        {
+            check_hashed_access();
+            if (err == ERR_OK)
+            {
+                ddebug("%s: bulk load with signature %" PRId64 " staged, size = %" PRIu64,
+                    name(), signature, (uint64_t)sz);
+            }
+            else
+            {
+                derror("%s: stage bulk load with signature %" PRId64 " failed, err = %s",
+                    name(), signature, err.to_string());
+            }
+            callback(err);
+        },
+        gpid_to_hash(get_gpid())
+        );
+}
+
+// @ primary
+void replica::on_bulk_load_staged(int64_t signature, ::dsn::rpc_address node, error_code err)
+{
+    check_hashed_access();
+
+    auto& bl = _primary_states.bulk_load;
+    if (partition_status::PS_PRIMARY != status() || bl == nullptr || bl->request.signature != signature || bl->proposed)
+        return;
+
+    if (err != ERR_OK)
+    {
+        derror("%s: stage bulk load with signature %" PRId64 " on %s failed, err = %s",
+            name(), signature, node.to_string(), err.to_string());
+        bl->reply(err, invalid_decree);
+        bl.reset();
+        return;
+    }
+
+    if (--bl->staging_count > 0)
+        return;
+
+    // all members are staged, so the load is ingested at the decree of this mutation
+    binary_writer writer;
+    marshall(writer, bl->request, DSF_THRIFT_BINARY);
+
+    mutation_ptr mu = new_mutation(invalid_decree);
+    mu->add_replica_update(RPC_BULK_LOAD, writer.get_buffer());
+    bl->proposed = true;
+
+    ddebug("%s: bulk load with signature %" PRId64 " staged on all members, propose mutation %s",
+        name(), signature, mu->name());
+    init_prepare(mu);
+}
+
+// called when the bulk load mutation is committed on this replica
+void replica::on_bulk_load_ingested(int64_t signature, error_code err, decree d)
+{
+    // writes forwarded by a split parent apply upon the loaded state only
+    if (partition_status::PS_PRIMARY == status() && err == ERR_OK)
+        _primary_states.last_bulk_load_decree = d;
+
+    auto& bl = _primary_states.bulk_load;
+    if (partition_status::PS_PRIMARY != status() || bl == nullptr || bl->request.signature != signature)
+        return;
+
+    bl->reply(err, d);
+    bl.reset();
+}
+
+}} // namespace
@@ -55,13 +55,21 @@ void replica::init_group_check()
     if (partition_status::PS_PRIMARY != status() || _options->group_check_disabled)
         return;
 
+    // align the rounds of all primaries on this node so their group checks can be batched
+    int delay_ms = 0;
+    if (_options->group_check_batch_enabled)
+    {
+        delay_ms = _options->group_check_interval_ms - static_cast<int>(now_ms() % _options->group_check_interval_ms);
+    }
+
     dassert (nullptr == _primary_states.group_check_task, "");
     _primary_states.group_check_task = tasking::enqueue_timer(
         LPC_GROUP_CHECK,
         this,
         [this] {broadcast_group_check();},
         std::chrono::milliseconds(_options->group_check_interval_ms),
-        gpid_to_hash(get_gpid())
+        gpid_to_hash(get_gpid()),
+        std::chrono::milliseconds(delay_ms)
         );
 }
 
@@ -112,18 +120,39 @@ void replica::broadcast_group_check()
             enum_to_string(it->second)
         );
 
-        dsn::task_ptr callback_task = rpc::call(
-            addr,
-            RPC_GROUP_CHECK,
-            *request,            
-            this,
-            [=](error_code err, group_check_response&& resp)
-            {
-                auto alloc = std::make_shared<group_check_response>(std::move(resp));
-                on_group_check_reply(err, request, alloc);
-            },
-            gpid_to_hash(get_gpid())
-            );
+        dsn::task_ptr callback_task;
+        if (_options->group_check_batch_enabled)
+        {
+            auto item = std::make_shared<group_check_batch_item>();
+            item->request = request;
+            item->response = std::make_shared<group_check_response>();
+            item->callback = tasking::create_task(
+                LPC_GROUP_CHECK_BATCH_REPLY,
+                this,
+                [this, item]()
+                {
+                    on_group_check_reply(item->err, item->request, item->response);
+                },
+                gpid_to_hash(get_gpid())
+                );
+            callback_task = item->callback;
+            _stub->batch_group_check(addr, item);
+        }
+        else
+        {
+            callback_task = rpc::call(
+                addr,
+                RPC_GROUP_CHECK,
+                *request,            
+                this,
+                [=](error_code err, group_check_response&& resp)
+                {
+                    auto alloc = std::make_shared<group_check_response>(std::move(resp));
+                    on_group_check_reply(err, request, alloc);
+                },
+                gpid_to_hash(get_gpid())
+                );
+        }
 
         _primary_states.group_check_pending_replies[addr] = callback_task;
     }
@@ -180,6 +209,7 @@ void replica::on_group_check(const group_check_request& request, /*out*/ group_c
         }
         break;
     case partition_status::PS_POTENTIAL_SECONDARY:
+        _potential_secondary_states.learnee_committed_decree = request.last_committed_decree;
         init_learn(request.config.learner_signature);
         break;
     case partition_status::PS_ERROR:
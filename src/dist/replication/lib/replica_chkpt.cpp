@@ -52,11 +52,16 @@ namespace dsn {
             check_hashed_access();
             init_checkpoint();
             garbage_collection();
+            update_disk_usage();
         }
 
         // run in replica thread
         void replica::garbage_collection()
         {
+            // the shared log is collected by the replica stub
+            if (_private_log == nullptr)
+                return;
+
             _private_log->garbage_collection(
                 get_gpid(),
                 _app->last_durable_decree(),
@@ -69,6 +74,26 @@ namespace dsn {
             }
         }
 
+        // run in replica thread, the usage is reported to the meta server for load balancing
+        void replica::update_disk_usage()
+        {
+            std::vector<std::string> files;
+            if (!utils::filesystem::get_subfiles(_dir, files, true))
+            {
+                dwarn("%s: list files in %s failed", name(), _dir.c_str());
+                return;
+            }
+
+            int64_t total = 0;
+            for (auto& f : files)
+            {
+                int64_t sz = 0;
+                if (utils::filesystem::file_size(f, sz))
+                    total += sz;
+            }
+            _counter_disk_usage.set(total / 1000000);
+        }
+
         // run in replica thread
         void replica::init_checkpoint()
         {
@@ -309,7 +334,8 @@ namespace dsn {
         void replica::catch_up_with_private_logs(partition_status::type s)
         {
             learn_state state;
-            _private_log->get_learn_state(
+            mutation_log_ptr log = (_private_log != nullptr ? _private_log : _stub->_log);
+            log->get_learn_state(
                 get_gpid(),
                 _app->last_committed_decree() + 1,
                 state
@@ -57,6 +57,8 @@ void replica::on_config_proposal(configuration_update_request& proposal)
         proposal.node.to_string()
         );
 
+    update_partition_count(proposal.info);
+
     if (proposal.config.ballot < get_ballot())
     {
         dwarn(
@@ -234,6 +236,9 @@ void replica::upgrade_to_secondary_on_primary(::dsn::rpc_address node)
     update_configuration_on_meta_server(config_type::CT_UPGRADE_TO_SECONDARY, node, newConfig);
 }
 
+// the primary hands off gracefully: new writes are rejected, and the downgrade is
+// sent to the meta server once the prepared writes are committed, i.e., acked by all
+// secondaries, so the secondary upgraded next has them all and none is lost
 void replica::downgrade_to_secondary_on_primary(configuration_update_request& proposal)
 {
     if (proposal.config.ballot != get_ballot() || status() != partition_status::PS_PRIMARY)
@@ -244,6 +249,54 @@ void replica::downgrade_to_secondary_on_primary(configuration_update_request& pr
     dassert (proposal.config.secondaries == _primary_states.membership.secondaries, "");
     dassert (proposal.node == proposal.config.primary, "");
 
+    // the meta server resends the proposal till the downgrade is done
+    if (_primary_states.handoff != nullptr)
+        return;
+
+    ddebug("%s: start primary handoff, %" PRId64 " prepared writes to commit",
+        name(), _prepare_list->max_decree() - last_committed_decree());
+
+    _primary_states.handoff.reset(new configuration_update_request(proposal));
+    _primary_states.handoff_task = tasking::enqueue(
+        LPC_PRIMARY_HANDOFF_TIMER,
+        this,
+        [this]() { check_primary_handoff(true); },
+        gpid_to_hash(get_gpid()),
+        std::chrono::milliseconds(_options->primary_handoff_timeout_ms)
+        );
+
+    check_primary_handoff(false);
+}
+
+void replica::check_primary_handoff(bool timeout)
+{
+    check_hashed_access();
+
+    auto& handoff = _primary_states.handoff;
+    if (handoff == nullptr || status() != partition_status::PS_PRIMARY || handoff->config.ballot != get_ballot())
+        return;
+
+    bool drained = (_primary_states.write_queue.oldest_tid() == 0
+        && last_committed_decree() == _prepare_list->max_decree());
+    if (!drained && !timeout)
+        return;
+
+    if (!drained)
+    {
+        dwarn("%s: primary handoff timeout, %" PRId64 " prepared writes are not committed yet",
+            name(), _prepare_list->max_decree() - last_committed_decree());
+    }
+    else
+    {
+        ddebug("%s: primary handoff drained at decree %" PRId64, name(), last_committed_decree());
+    }
+
+    configuration_update_request proposal = *handoff;
+    if (!timeout)
+        _primary_states.handoff_task->cancel(false);
+    _primary_states.handoff_task = nullptr;
+    handoff.reset();
+
     proposal.config.primary.set_invalid();
     proposal.config.secondaries.push_back(proposal.node);
 
@@ -672,6 +725,10 @@ bool replica::update_local_configuration(const replica_configuration& config, bo
         }
         break;
     case partition_status::PS_POTENTIAL_SECONDARY:
+        if (config.status != partition_status::PS_POTENTIAL_SECONDARY)
+        {
+            _stub->release_learning_slot(get_gpid());
+        }
         switch (config.status)
         {
         case partition_status::PS_PRIMARY:
@@ -818,10 +875,12 @@ bool replica::update_local_configuration_with_no_ballot_change(partition_status:
     return update_local_configuration(config, true);
 }
 
-void replica::on_config_sync(const partition_configuration& config)
+void replica::on_config_sync(const app_info& info, const partition_configuration& config)
 {
     ddebug("%s: configuration sync", name());
 
+    update_partition_count(info);
+
     // no outdated update
     if (config.ballot < get_ballot())
         return;
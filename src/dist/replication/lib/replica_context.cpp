@@ -89,6 +89,35 @@ void primary_context::cleanup(bool clean_pending_mutations)
     // clean up checkpoint
     CLEANUP_TASK_ALWAYS(checkpoint_task)
 
+    // the pending bulk load is failed, the admin may retry on the new primary
+    if (bulk_load != nullptr)
+    {
+        bulk_load->reply(ERR_INVALID_STATE, invalid_decree);
+        bulk_load.reset();
+    }
+    last_bulk_load_decree = invalid_decree;
+
+    // the meta server triggers the split again on the new primary
+    if (split != nullptr)
+    {
+        CLEANUP_TASK_ALWAYS(split->pending_task)
+        split.reset();
+    }
+
+    for (auto& f : split_forwards)
+    {
+        split_forward_response resp;
+        resp.err = ERR_INVALID_STATE;
+        dsn_message_t msg = dsn_msg_create_response(f.second);
+        ::dsn::marshall(msg, resp);
+        dsn_rpc_reply(msg);
+        dsn_msg_release_ref(f.second);
+    }
+    split_forwards.clear();
+
+    CLEANUP_TASK_ALWAYS(handoff_task)
+    handoff.reset();
+
     membership.ballot = 0;
 }
 
@@ -98,6 +127,11 @@ bool primary_context::is_cleaned()
         nullptr == group_check_task &&
         nullptr == reconfiguration_task &&
         nullptr == checkpoint_task &&
+        nullptr == bulk_load &&
+        nullptr == split &&
+        split_forwards.empty() &&
+        nullptr == handoff &&
+        nullptr == handoff_task &&
         group_check_pending_replies.empty()
         ;
 }
@@ -110,6 +144,23 @@ void primary_context::do_cleanup_pending_mutations(bool clean_pending_mutations)
     }
 }
 
+void bulk_load_context::reply(error_code err, decree d)
+{
+    if (admin_request != nullptr)
+    {
+        bulk_load_response resp;
+        resp.err = err;
+        resp.decree = d;
+
+        dsn_message_t msg = dsn_msg_create_response(admin_request);
+        ::dsn::marshall(msg, resp);
+        dsn_rpc_reply(msg);
+
+        dsn_msg_release_ref(admin_request);
+        admin_request = nullptr;
+    }
+}
+
 void primary_context::reset_membership(const partition_configuration& config, bool clear_learners)
 {
     statuses.clear();
@@ -214,6 +265,8 @@ bool potential_secondary_context::cleanup(bool force)
         
     CLEANUP_TASK(learn_remote_files_task, force)
 
+    CLEANUP_TASK(learn_log_replay_task, force)
+
     CLEANUP_TASK(catchup_with_private_log_task, force)
     
     learning_version = 0;
@@ -231,6 +284,7 @@ bool potential_secondary_context::is_cleaned()
         nullptr == learning_task &&
         nullptr == learn_remote_files_task &&
         nullptr == learn_remote_files_completed_task &&
+        nullptr == learn_log_replay_task &&
         nullptr == catchup_with_private_log_task
         ;
 }
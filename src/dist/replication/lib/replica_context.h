@@ -36,6 +36,7 @@
 # pragma once
 
 # include "mutation.h"
+# include <deque>
 
 namespace dsn { namespace replication {
 
@@ -48,12 +49,47 @@ struct remote_learner_state
 
 typedef std::unordered_map< ::dsn::rpc_address, remote_learner_state> learner_map;
 
+// a bulk load is first staged, i.e., its files are copied to every member,
+// and then ingested by all members through one mutation
+struct bulk_load_context
+{
+    bulk_load_request request;     // with ballot and signature assigned
+    dsn_message_t     admin_request; // replied when the mutation is committed or the load fails
+    int               staging_count; // members not staged yet
+    bool              proposed;
+
+    bulk_load_context() : admin_request(nullptr), staging_count(0), proposed(false) {}
+    void reply(error_code err, decree d);
+};
+
+// a split seeds the child with a checkpoint of the parent, forwards the parent's
+// later writes of the child's keys to it, and at last fences these keys on the
+// parent till the meta server hands them over to the child, see replica_split.cpp
+struct split_context
+{
+    split_partition_request request;
+    decree          checkpoint_decree; // the parent checkpoint the child is seeded with
+    decree          child_decree;      // where the checkpoint is ingested by the child, invalid_decree till then
+    std::deque<mutation_update> pending_updates; // committed after checkpoint_decree, not forwarded yet
+    int             forwarding_count;  // updates of the inflight forward
+    uint64_t        fence_tid;         // the child's keys are rejected after this mutation, 0 before the fence
+    uint64_t        fence_ts_ms;
+    decree          fence_decree;      // writes taken before the fence are all prepared at or before it
+    bool            notifying;
+    dsn::task_ptr   pending_task;      // the inflight rpc or the retry timer
+
+    split_context()
+        : checkpoint_decree(invalid_decree), child_decree(invalid_decree), forwarding_count(0),
+        fence_tid(0), fence_ts_ms(0), fence_decree(invalid_decree), notifying(false)
+    {}
+};
+
 class primary_context
 {
 public:
     primary_context(gpid gpid, int max_concurrent_2pc_count = 1, bool batch_write_disabled = false)
         : next_learning_version(0), write_queue(gpid, max_concurrent_2pc_count, batch_write_disabled)
-        , last_prepare_ts_ms(0)
+        , last_bulk_load_decree(invalid_decree), last_prepare_ts_ms(0)
     {}
 
     void cleanup(bool clean_pending_mutations = true);
@@ -93,7 +129,23 @@ public:
     // copy checkpoint from secondaries ptr
     dsn::task_ptr   checkpoint_task;
 
+    // at most one bulk load at a time
+    std::unique_ptr<bulk_load_context> bulk_load;
+    decree last_bulk_load_decree;
+
+    // split of this partition as the parent
+    std::unique_ptr<split_context> split;
+
+    // writes forwarded by the parent when this partition is a split child,
+    // the parent is replied to when they are committed
+    std::deque<std::pair<mutation_ptr, dsn_message_t>> split_forwards;
+
     uint64_t last_prepare_ts_ms;
+
+    // the downgrade proposal this primary hands off for, new writes are rejected
+    // till the prepared ones are committed or handoff_task times out
+    std::unique_ptr<configuration_update_request> handoff;
+    dsn::task_ptr handoff_task;
 };
 
 class secondary_context
@@ -118,7 +170,8 @@ public:
         learning_start_ts_ns(0),
         learning_status(learner_status::LearningInvalid),
         learning_round_is_running(false),
-        learning_start_prepare_decree(invalid_decree)
+        learning_start_prepare_decree(invalid_decree),
+        learnee_committed_decree(invalid_decree)
     {}
 
     bool cleanup(bool force);
@@ -131,11 +184,13 @@ public:
     learner_status::type  learning_status;
     volatile bool   learning_round_is_running;
     decree          learning_start_prepare_decree;
+    decree          learnee_committed_decree; // latest known, used to prioritize learning on the node
 
     ::dsn::task_ptr       delay_learning_task;
     ::dsn::task_ptr       learning_task;
     ::dsn::task_ptr       learn_remote_files_task;
     ::dsn::task_ptr       learn_remote_files_completed_task;
+    ::dsn::task_ptr       learn_log_replay_task; // of the pipelined log learning
     ::dsn::task_ptr       catchup_with_private_log_task;
 };
 
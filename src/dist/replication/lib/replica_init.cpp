@@ -207,93 +207,104 @@ error_code replica::init_app_and_prepare_list(bool create_new)
             dassert(_app->last_committed_decree() == _app->last_durable_decree(), "");
             _prepare_list->reset(_app->last_committed_decree());
 
-            _private_log = new mutation_log_private(
-                log_dir,
-                _options->log_private_file_size_mb,
-                get_gpid(),
-                this,
-                _options->log_private_batch_buffer_kb * 1024
-                );
-            ddebug("%s: plog_dir = %s", name(), log_dir.c_str());
-
             // sync valid_start_offset between app and logs
             _stub->_log->set_valid_start_offset_on_open(get_gpid(),
                 _app->init_info().init_offset_in_shared_log
                 );
-            _private_log->set_valid_start_offset_on_open(get_gpid(),
-                _app->init_info().init_offset_in_private_log
-                );
-            
-            // replay the logs
+
+            if (_options->log_private_disabled)
+            {
+                // the shared log is replayed later by the replica stub
+                ddebug("%s: private log is disabled, recover from shared log only", name());
+                set_inactive_state_transient(true);
+            }
+            else
             {
-                ddebug("%s: start to replay private log", name());
+                _private_log = new mutation_log_private(
+                    log_dir,
+                    _options->log_private_file_size_mb,
+                    get_gpid(),
+                    this,
+                    _options->log_private_batch_buffer_kb * 1024
+                    );
+                ddebug("%s: plog_dir = %s", name(), log_dir.c_str());
+
+                // sync valid_start_offset between app and logs
+                _private_log->set_valid_start_offset_on_open(get_gpid(),
+                    _app->init_info().init_offset_in_private_log
+                    );
+            
+                // replay the logs
+                {
+                    ddebug("%s: start to replay private log", name());
+
+                    std::map<gpid, decree> replay_condition;
+                    replay_condition[_config.pid] = _app->last_committed_decree();
+
+                    uint64_t start_time = now_ms();
+                    err = _private_log->open(
+                        [this](mutation_ptr& mu)
+                        {
+                            return replay_mutation(mu, true);
+                        },
+                        [this](error_code err)
+                        {
+                            tasking::enqueue(
+                                LPC_REPLICATION_ERROR,
+                                this,
+                                [this, err]() { handle_local_failure(err); },
+                                gpid_to_hash(get_gpid())
+                                );
+                        },
+                        replay_condition
+                        );
 
-                std::map<gpid, decree> replay_condition;
-                replay_condition[_config.pid] = _app->last_committed_decree();
+                    uint64_t finish_time = now_ms();
 
-                uint64_t start_time = now_ms();
-                err = _private_log->open(
-                    [this](mutation_ptr& mu)
+                    if (err == ERR_OK)
                     {
-                        return replay_mutation(mu, true);
-                    },
-                    [this](error_code err)
+                        ddebug(
+                            "%s: replay private log succeed, durable = %" PRId64 ", committed = %" PRId64 ", "
+                            "max_prepared = %" PRId64 ", ballot = %" PRId64 ", valid_offset_in_plog = %" PRId64 ", "
+                            "max_decree_in_plog = %" PRId64 ", max_commit_on_disk_in_plog = %" PRId64 ", "
+                            "time_used = %" PRIu64 " ms",
+                            name(),
+                            _app->last_durable_decree(),
+                            _app->last_committed_decree(),
+                            max_prepared_decree(),
+                            get_ballot(),
+                            _app->init_info().init_offset_in_private_log,
+                            _private_log->max_decree(get_gpid()),
+                            _private_log->max_commit_on_disk(),
+                            finish_time - start_time
+                            );
+                        _private_log->check_valid_start_offset(get_gpid(), _app->init_info().init_offset_in_private_log);
+                        set_inactive_state_transient(true);
+                    }
+                    /* in the beginning the prepare_list is reset to the durable_decree */
+                    else
                     {
-                        tasking::enqueue(
-                            LPC_REPLICATION_ERROR,
-                            this,
-                            [this, err]() { handle_local_failure(err); },
-                            gpid_to_hash(get_gpid())
+                        derror(
+                            "%s: replay private log failed, err = %s, durable = %" PRId64 ", committed = %" PRId64 ", "
+                            "maxpd = %" PRId64 ", ballot = %" PRId64 ", valid_offset_in_plog = %" PRId64 ", "
+                            "time_used = %" PRIu64 " ms",
+                            name(),
+                            err.to_string(),
+                            _app->last_durable_decree(),
+                            _app->last_committed_decree(),
+                            max_prepared_decree(),
+                            get_ballot(),
+                            _app->init_info().init_offset_in_private_log,
+                            finish_time - start_time
                             );
-                    },
-                    replay_condition
-                    );
-
-                uint64_t finish_time = now_ms();
-
-                if (err == ERR_OK)
-                {
-                    ddebug(
-                        "%s: replay private log succeed, durable = %" PRId64 ", committed = %" PRId64 ", "
-                        "max_prepared = %" PRId64 ", ballot = %" PRId64 ", valid_offset_in_plog = %" PRId64 ", "
-                        "max_decree_in_plog = %" PRId64 ", max_commit_on_disk_in_plog = %" PRId64 ", "
-                        "time_used = %" PRIu64 " ms",
-                        name(),
-                        _app->last_durable_decree(),
-                        _app->last_committed_decree(),
-                        max_prepared_decree(),
-                        get_ballot(),
-                        _app->init_info().init_offset_in_private_log,
-                        _private_log->max_decree(get_gpid()),
-                        _private_log->max_commit_on_disk(),
-                        finish_time - start_time
-                        );
-                    _private_log->check_valid_start_offset(get_gpid(), _app->init_info().init_offset_in_private_log);
-                    set_inactive_state_transient(true);
-                }
-                /* in the beginning the prepare_list is reset to the durable_decree */
-                else
-                {
-                    derror(
-                        "%s: replay private log failed, err = %s, durable = %" PRId64 ", committed = %" PRId64 ", "
-                        "maxpd = %" PRId64 ", ballot = %" PRId64 ", valid_offset_in_plog = %" PRId64 ", "
-                        "time_used = %" PRIu64 " ms",
-                        name(),
-                        err.to_string(),
-                        _app->last_durable_decree(),
-                        _app->last_committed_decree(),
-                        max_prepared_decree(),
-                        get_ballot(),
-                        _app->init_info().init_offset_in_private_log,
-                        finish_time - start_time
-                        );
 
-                    set_inactive_state_transient(false);
+                        set_inactive_state_transient(false);
 
-                    _private_log->close();
-                    _private_log = nullptr;
+                        _private_log->close();
+                        _private_log = nullptr;
 
-                    _stub->_log->on_partition_removed(get_gpid());
+                        _stub->_log->on_partition_removed(get_gpid());
+                    }
                 }
             }
         }
@@ -323,7 +334,7 @@ error_code replica::init_app_and_prepare_list(bool create_new)
     }
     else
     {
-        if (nullptr == _private_log)
+        if (nullptr == _private_log && !_options->log_private_disabled)
         {
             ::dsn::utils::filesystem::remove_path(log_dir);
             ::dsn::utils::filesystem::create_directory(log_dir);
@@ -398,7 +409,7 @@ bool replica::replay_mutation(mutation_ptr& mu, bool is_private)
     }
 
     // fix private log completeness when it is from shared
-    if (!is_private && d > _private_log->max_commit_on_disk())
+    if (!is_private && _private_log != nullptr && d > _private_log->max_commit_on_disk())
     {
         _private_log->append(mu,
             LPC_WRITE_REPLICATION_LOG,
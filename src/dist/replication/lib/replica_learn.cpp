@@ -167,6 +167,7 @@ void replica::init_learn(uint64_t signature)
         case learner_status::LearningSucceeded:
             {
                 check_state_completeness();
+                _stub->release_learning_slot(get_gpid());
                 notify_learn_completion();
                 return;
             }
@@ -178,6 +179,16 @@ void replica::init_learn(uint64_t signature)
         }
     }
         
+    // wait for a learning slot on this node, the stub restarts learning when it is granted
+    decree lag = _potential_secondary_states.learnee_committed_decree - _app->last_committed_decree();
+    if (!_stub->acquire_learning_slot(this, lag > 0 ? lag : 0, _potential_secondary_states.learning_version))
+    {
+        dinfo("%s: init_learn[%016llx]: too many replicas are learning on this node, wait for a slot, lag = %" PRId64,
+            name(), _potential_secondary_states.learning_version, lag
+            );
+        return;
+    }
+
     _potential_secondary_states.learning_round_is_running = true;
 
     learn_request request;
@@ -386,16 +397,19 @@ void replica::on_learn(dsn_message_t msg, const learn_request& request)
         }
     }
 
-    // learn private replication logs
+    // learn private replication logs, or the shared log when private log is disabled,
+    // in which case the learner filters out the mutations of other replicas
     // in this case, the state on the PS is still incomplete
     else
     {
-        _private_log->get_learn_state(get_gpid(), learn_start_decree, response.state);
+        mutation_log_ptr log = (_private_log != nullptr ? _private_log : _stub->_log);
+        log->get_learn_state(get_gpid(), learn_start_decree, response.state);
         response.type = learn_type::LT_LOG;
-        response.base_local_dir = _private_log->dir();
+        response.base_local_dir = log->dir();
         ddebug(
-            "%s: on_learn[%016llx]: learner = %s, learn private logs succeed, base_local_dir = %s, learn_file_count = %u",
+            "%s: on_learn[%016llx]: learner = %s, learn %s logs succeed, base_local_dir = %s, learn_file_count = %u",
             name(), request.signature, request.learner.to_string(),
+            _private_log != nullptr ? "private" : "shared",
             response.base_local_dir.c_str(), static_cast<uint32_t>(response.state.files.size())
             );
     }
@@ -444,6 +458,8 @@ void replica::on_learn_reply(
         enum_to_string(_potential_secondary_states.learning_status)
         );
 
+    _potential_secondary_states.learnee_committed_decree = resp.last_committed_decree;
+
     if (resp.err != ERR_OK)
     {
         if (resp.err == ERR_INACTIVE_STATE)
@@ -515,7 +531,7 @@ void replica::on_learn_reply(
             err = _app->open_new_internal(
                 this,
                 _stub->_log->on_partition_reset(get_gpid(), 0),
-                _private_log->on_partition_reset(get_gpid(), 0)
+                _private_log != nullptr ? _private_log->on_partition_reset(get_gpid(), 0) : 0
                 );
 
             if (err != ERR_OK)
@@ -568,7 +584,7 @@ void replica::on_learn_reply(
         err = _app->update_init_info(
             this,
             _stub->_log->on_partition_reset(get_gpid(), _app->last_committed_decree()),
-            _private_log->on_partition_reset(get_gpid(), _app->last_committed_decree()),
+            _private_log != nullptr ? _private_log->on_partition_reset(get_gpid(), _app->last_committed_decree()) : 0,
             _app->last_committed_decree()
             );
 
@@ -597,7 +613,10 @@ void replica::on_learn_reply(
                 // because shared log are written without callback, need to manully
                 // set flag and write mutations to private log
                 mu->set_logged();
-                _private_log->append(mu, LPC_WRITE_REPLICATION_LOG, this, nullptr);                
+                if (_private_log != nullptr)
+                {
+                    _private_log->append(mu, LPC_WRITE_REPLICATION_LOG, this, nullptr);
+                }
 
                 // then we prepare
                 _prepare_list->prepare(mu, partition_status::PS_POTENTIAL_SECONDARY);
@@ -631,6 +650,14 @@ void replica::on_learn_reply(
         utils::filesystem::remove_path(_app->learn_dir());
         utils::filesystem::create_directory(_app->learn_dir());
 
+        if (resp.type == learn_type::LT_LOG
+            && resp.state.files.size() > 1
+            && !_options->learn_log_pipeline_disabled)
+        {
+            start_pipelined_log_learning(std::move(req), std::move(resp));
+            return;
+        }
+
         ddebug(
             "%s: on_learn_reply[%016llx]: learnee = %s, learn_duration = %" PRIu64 " ms, start to copy remote files, learn_file_count = %d",
             name(), req.signature, resp.config.primary.to_string(),
@@ -866,6 +893,20 @@ void replica::on_learn_remote_state_completed(error_code err)
     }
 }
 
+void replica::on_learning_slot_granted(uint64_t signature)
+{
+    check_hashed_access();
+
+    if (status() != partition_status::PS_POTENTIAL_SECONDARY)
+    {
+        // the slot is granted after we left learning
+        _stub->release_learning_slot(get_gpid());
+        return;
+    }
+
+    init_learn(signature);
+}
+
 void replica::handle_learning_error(error_code err, bool is_local_error)
 {
     check_hashed_access();
@@ -954,21 +995,19 @@ void replica::on_add_learner(const group_check_request& request)
             return;
 
         dassert(partition_status::PS_POTENTIAL_SECONDARY == status(), "");
+        _potential_secondary_states.learnee_committed_decree = request.last_committed_decree;
         init_learn(request.config.learner_signature);
     }
 }
 
 // in non-replication thread
-error_code replica::apply_learned_state_from_private_log(learn_state& state)
+prepare_list* replica::create_learning_prepare_list()
 {
-    int64_t offset;
-    error_code err;
-
     // temp prepare list for learning purpose
-    prepare_list plist(
+    return new prepare_list(
         _app->last_committed_decree(),
         _options->max_mutation_count_in_prepare_list,
-        [this, &err](mutation_ptr& mu)
+        [this](mutation_ptr& mu)
         {
             if (mu->data.header.decree == _app->last_committed_decree() + 1)
             {
@@ -976,11 +1015,20 @@ error_code replica::apply_learned_state_from_private_log(learn_state& state)
             }   
         }
         );
+}
 
-    err = mutation_log::replay(
-        state.files,
+// in non-replication thread
+error_code replica::replay_learned_log_files(std::vector<std::string>& files, prepare_list& plist)
+{
+    int64_t offset;
+    return mutation_log::replay(
+        files,
         [this, &plist](mutation_ptr& mu)
         {
+            // shared log files contain mutations of other replicas
+            if (mu->data.header.pid != get_gpid())
+                return false;
+
             auto d = mu->data.header.decree;
             if (d <= plist.last_committed_decree())
                 return false;
@@ -994,28 +1042,252 @@ error_code replica::apply_learned_state_from_private_log(learn_state& state)
         },
         offset
         );
+}
+
+// in non-replication thread
+void replica::apply_learned_log_in_memory(const blob& meta, prepare_list& plist)
+{
+    binary_reader reader(meta);
+    while (!reader.is_eof())
+    {
+        auto mu = mutation::read_from_log_file(reader, nullptr);
+        auto d = mu->data.header.decree;
+        if (d <= plist.last_committed_decree())
+            continue;
+
+        auto old = plist.get_mutation_by_decree(d);
+        if (old != nullptr && old->data.header.ballot >= mu->data.header.ballot)
+            continue;
+        
+        mu->set_logged();
+        plist.prepare(mu, partition_status::PS_SECONDARY);
+    }
+}
+
+// in non-replication thread
+error_code replica::apply_learned_state_from_private_log(learn_state& state)
+{
+    std::unique_ptr<prepare_list> plist(create_learning_prepare_list());
+
+    error_code err = replay_learned_log_files(state.files, *plist);
 
     // apply in-buffer private logs
     if (err == ERR_OK)
     {
-        binary_reader reader(state.meta);
-        while (!reader.is_eof())
-        {
-            auto mu = mutation::read_from_log_file(reader, nullptr);
-            auto d = mu->data.header.decree;
-            if (d <= plist.last_committed_decree())
-                continue;
+        apply_learned_log_in_memory(state.meta, *plist);
+    }
 
-            auto old = plist.get_mutation_by_decree(d);
-            if (old != nullptr && old->data.header.ballot >= mu->data.header.ballot)
-                continue;
-            
-            mu->set_logged();
-            plist.prepare(mu, partition_status::PS_SECONDARY);
+    return err;
+}
+
+// all but plist are only touched in the replication thread, and plist only
+// by the one replay task running at a time
+struct replica::learn_log_pipeline
+{
+    learn_request  req;
+    learn_response resp;
+    size_t         next_copy;     // index of the next file to be copied
+    size_t         copied_count;  // files are copied in order
+    size_t         next_replay;   // index of the next file to be replayed, i.e., count of files replayed
+    bool           replaying;
+    bool           finished;
+    size_t         copied_size;
+    error_code     err;           // of the first failed copy or replay
+    std::unique_ptr<prepare_list> plist;
+
+    learn_log_pipeline()
+        : next_copy(0), copied_count(0), next_replay(0), replaying(false), finished(false),
+        copied_size(0), err(ERR_OK)
+    {}
+};
+
+void replica::start_pipelined_log_learning(learn_request&& req, learn_response&& resp)
+{
+    std::shared_ptr<learn_log_pipeline> pl(new learn_log_pipeline());
+    pl->req = std::move(req);
+    pl->resp = std::move(resp);
+    pl->plist.reset(create_learning_prepare_list());
+
+    ddebug(
+        "%s: start_pipelined_log_learning[%016llx]: learnee = %s, learn_duration = %" PRIu64 " ms, learn_file_count = %d",
+        name(), pl->req.signature, pl->resp.config.primary.to_string(),
+        _potential_secondary_states.duration_ms(),
+        static_cast<int>(pl->resp.state.files.size())
+        );
+
+    copy_next_learned_log_file(pl);
+}
+
+// the pipeline is dropped once the learning round is cleaned up or restarted,
+// where the tasks in flight are cancelled or waited for by cleanup()
+bool replica::is_learn_log_pipeline_alive(const std::shared_ptr<learn_log_pipeline>& pl)
+{
+    return !pl->finished
+        && partition_status::PS_POTENTIAL_SECONDARY == status()
+        && _potential_secondary_states.learning_version == static_cast<uint64_t>(pl->req.signature);
+}
+
+void replica::copy_next_learned_log_file(const std::shared_ptr<learn_log_pipeline>& pl)
+{
+    size_t index = pl->next_copy++;
+    std::vector<std::string> files;
+    files.push_back(pl->resp.state.files[index]);
+
+    _potential_secondary_states.learn_remote_files_task =
+        file::copy_remote_files(pl->resp.config.primary,
+            pl->resp.base_local_dir,
+            files,
+            _app->learn_dir(),
+            true,
+            LPC_LEARN_LOG_FILE_COPIED,
+            this,
+            [this, pl, index](error_code err, size_t sz)
+            {
+                on_copy_learned_log_file_completed(pl, index, err, sz);
+            },
+            gpid_to_hash(get_gpid())
+            );
+}
+
+void replica::on_copy_learned_log_file_completed(
+    const std::shared_ptr<learn_log_pipeline>& pl,
+    size_t index,
+    error_code err,
+    size_t size
+    )
+{
+    check_hashed_access();
+
+    if (!is_learn_log_pipeline_alive(pl))
+        return;
+
+    _potential_secondary_states.learn_remote_files_task = nullptr;
+
+    if (err != ERR_OK)
+    {
+        pl->err = err;
+    }
+    else
+    {
+        pl->copied_size += size;
+        pl->copied_count = index + 1;
+
+        // prefetch the next file while replaying the copied ones
+        if (pl->next_copy < pl->resp.state.files.size())
+        {
+            copy_next_learned_log_file(pl);
         }
     }
 
-    return err;
+    advance_learn_log_pipeline(pl);
+}
+
+void replica::on_learned_log_file_replayed(const std::shared_ptr<learn_log_pipeline>& pl, size_t index, error_code err)
+{
+    check_hashed_access();
+
+    if (!is_learn_log_pipeline_alive(pl))
+        return;
+
+    _potential_secondary_states.learn_log_replay_task = nullptr;
+    pl->replaying = false;
+
+    if (err == ERR_OK)
+        pl->next_replay = index + 1;
+    else if (pl->err == ERR_OK)
+        pl->err = err;
+
+    advance_learn_log_pipeline(pl);
+}
+
+// replay the next copied file, or finish the pipeline when nothing is left to do
+void replica::advance_learn_log_pipeline(const std::shared_ptr<learn_log_pipeline>& pl)
+{
+    if (pl->replaying)
+        return;
+
+    if (pl->err == ERR_OK && pl->next_replay < pl->copied_count)
+    {
+        size_t index = pl->next_replay;
+        pl->replaying = true;
+
+        // the replay is done out of the replication thread, as it is with the
+        // other learning types, and the result is posted back
+        _potential_secondary_states.learn_log_replay_task = tasking::enqueue(
+            LPC_LEARN_REMOTE_DELTA_FILES,
+            this,
+            [this, pl, index]()
+            {
+                std::vector<std::string> files;
+                files.push_back(utils::filesystem::path_combine(_app->learn_dir(), pl->resp.state.files[index]));
+                error_code err = replay_learned_log_files(files, *pl->plist);
+
+                dinfo(
+                    "%s: on_copy_learned_log_file_completed[%016llx]: learnee = %s, replay file %s done, err = %s, "
+                    "app_committed_decree = %" PRId64,
+                    name(), pl->req.signature, pl->resp.config.primary.to_string(),
+                    files[0].c_str(), err.to_string(),
+                    _app->last_committed_decree()
+                    );
+
+                tasking::enqueue(
+                    LPC_LEARN_LOG_FILE_REPLAYED,
+                    this,
+                    [this, pl, index, err]() { on_learned_log_file_replayed(pl, index, err); },
+                    gpid_to_hash(get_gpid())
+                    );
+            }
+            );
+        return;
+    }
+
+    // waiting for the next file
+    if (pl->err == ERR_OK && pl->next_replay < pl->resp.state.files.size())
+        return;
+
+    pl->finished = true;
+
+    // a copy may still be in flight after a failed replay
+    if (_potential_secondary_states.learn_remote_files_task != nullptr)
+    {
+        _potential_secondary_states.learn_remote_files_task->cancel(false);
+        _potential_secondary_states.learn_remote_files_task = nullptr;
+    }
+
+    error_code err = pl->err;
+    bool all_replayed = (err == ERR_OK);
+    if (err != ERR_OK && pl->next_replay > 0)
+    {
+        // the replayed files are already applied to the app, so we can
+        // resume from there in the next learning round
+        dwarn(
+            "%s: advance_learn_log_pipeline[%016llx]: learnee = %s, stop at file %d of %d, err = %s, "
+            "resume from the applied state in next round",
+            name(), pl->req.signature, pl->resp.config.primary.to_string(),
+            static_cast<int>(pl->next_replay), static_cast<int>(pl->resp.state.files.size()),
+            err.to_string()
+            );
+        err = ERR_OK;
+    }
+
+    _potential_secondary_states.learn_remote_files_task = tasking::create_task(
+        LPC_LEARN_REMOTE_DELTA_FILES,
+        this,
+        [this, pl, err, all_replayed]()
+        {
+            if (all_replayed)
+            {
+                // all files are replayed, apply in-buffer private logs
+                apply_learned_log_in_memory(pl->resp.state.meta, *pl->plist);
+            }
+
+            // the learned state is already applied
+            pl->resp.state.files.clear();
+            pl->resp.state.meta = blob();
+            on_copy_remote_state_completed(err, pl->copied_size, std::move(pl->req), std::move(pl->resp));
+        }
+        );
+    _potential_secondary_states.learn_remote_files_task->enqueue();
 }
 
 }} // namespace
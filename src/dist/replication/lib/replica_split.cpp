@@ -0,0 +1,531 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     online partition split, where partition i of an app with N partitions is
+ *     split into i and its child i + N
+ *
+ *     the meta server creates the child on the members of the parent, and asks the
+ *     parent primary to split; the parent then
+ *       - seeds the child with its latest checkpoint as a bulk load, while capturing
+ *         its later commits of the child's keys,
+ *       - forwards the captured writes in batches to the child primary, which
+ *         replicates them as its own mutations,
+ *       - fences the child's keys when few are left, i.e., rejects their new writes
+ *         with ERR_BUSY, and waits till the writes taken before are all forwarded,
+ *       - asks the meta server to mark the child ready, so that both partitions
+ *         serve keys by hash % 2N from then on
+ *     any failure resets the split on the parent, and the meta server triggers it
+ *     again, whose bulk load resets the child as well
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+#include "replica.h"
+#include "mutation.h"
+#include "mutation_log.h"
+#include "replica_stub.h"
+#include "replication_app_base.h"
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "replica.split"
+
+namespace dsn { namespace replication {
+
+void replica::update_partition_count(const app_info& info)
+{
+    int app_count = get_app_partition_count();
+    if (!_app_ever_split && replica_helper::is_app_ever_split(info))
+    {
+        ddebug("%s: the app is split, the key of every request is checked from now on", name());
+        _app_ever_split = true;
+    }
+
+    int count = replica_helper::get_serving_partition_count(info, get_gpid().get_partition_index());
+    if (count > _partition_count)
+    {
+        ddebug("%s: serving partition count is changed from %d to %d", name(), _partition_count, count);
+        _partition_count = count;
+    }
+
+    if (get_app_partition_count() != app_count)
+        notify_app_partition_count();
+}
+
+void replica::notify_app_partition_count()
+{
+    // so that the app drops the pairs left to the other half of the split
+    if (_app != nullptr)
+        _app->set_partition_count(get_app_partition_count());
+}
+
+bool replica::is_split_fenced(dsn_message_t request) const
+{
+    auto& sp = _primary_states.split;
+    return sp->fence_tid != 0 &&
+        dsn_msg_get_partition_hash(request) % static_cast<uint64_t>(sp->request.partition_count)
+        == static_cast<uint64_t>(sp->request.child.get_partition_index());
+}
+
+bool replica::is_split_alive(gpid child) const
+{
+    return partition_status::PS_PRIMARY == status()
+        && _primary_states.split != nullptr
+        && _primary_states.split->request.child == child;
+}
+
+// @ parent primary
+void replica::on_split_partition(const split_partition_request& request)
+{
+    check_hashed_access();
+
+    if (partition_status::PS_PRIMARY != status() || request.parent_ballot != get_ballot())
+    {
+        dwarn("%s: ignore split to %d.%d with ballot %" PRId64 ", local ballot = %" PRId64 ", status = %s",
+            name(), request.child.get_app_id(), request.child.get_partition_index(),
+            request.parent_ballot, get_ballot(), enum_to_string(status()));
+        return;
+    }
+
+    if (_partition_count >= request.partition_count)
+    {
+        dwarn("%s: ignore split to %d.%d as the child is already ready",
+            name(), request.child.get_app_id(), request.child.get_partition_index());
+        return;
+    }
+
+    auto& sp = _primary_states.split;
+    if (sp != nullptr)
+    {
+        // the meta server triggers the split periodically till the child is ready
+        if (sp->request.child == request.child && sp->request.child_primary == request.child_primary)
+            return;
+
+        abort_split("the child primary is changed", ERR_INVALID_STATE);
+    }
+
+    if (_primary_states.bulk_load != nullptr)
+    {
+        dwarn("%s: delay split as a bulk load is in progress", name());
+        return;
+    }
+
+    // there is no checkpoint to seed the child with before anything is committed
+    if (last_committed_decree() == 0)
+    {
+        ddebug("%s: propose an empty mutation before split", name());
+        mutation_ptr mu = new_mutation(invalid_decree);
+        mu->add_client_request(RPC_REPLICATION_WRITE_EMPTY, nullptr);
+        init_prepare(mu);
+        return;
+    }
+
+    error_code err = _app->sync_checkpoint();
+    learn_state state;
+    if (err == ERR_OK)
+    {
+        err = _app->get_checkpoint(0, blob(), state);
+    }
+    if (err != ERR_OK)
+    {
+        derror("%s: get checkpoint for split failed, err = %s", name(), err.to_string());
+        return;
+    }
+
+    sp.reset(new split_context());
+    sp->request = request;
+    sp->checkpoint_decree = state.to_decree_included;
+
+    bulk_load_request seed;
+    seed.pid = request.child;
+    seed.source = _stub->_primary_address;
+    seed.source_dir = _app->data_dir();
+    for (auto& f : state.files)
+    {
+        seed.files.push_back(utils::filesystem::get_file_name(f));
+    }
+
+    ddebug("%s: start split to %d.%d @ %s, seed it with checkpoint at decree %" PRId64 ", %d files",
+        name(), request.child.get_app_id(), request.child.get_partition_index(),
+        request.child_primary.to_string(), sp->checkpoint_decree, (int)seed.files.size());
+
+    gpid child = request.child;
+    sp->pending_task = rpc::call(
+        request.child_primary,
+        RPC_BULK_LOAD,
+        seed,
+        this,
+        [this, child](error_code err, bulk_load_response&& resp)
+        {
+            on_split_seeded(child, err == ERR_OK ? resp.err : err, resp.decree);
+        },
+        gpid_to_hash(child),
+        std::chrono::seconds(_options->bulk_load_stage_timeout_seconds),
+        gpid_to_hash(get_gpid())
+        );
+}
+
+// @ parent primary
+void replica::on_split_seeded(gpid child, error_code err, decree d)
+{
+    check_hashed_access();
+
+    if (!is_split_alive(child))
+        return;
+
+    auto& sp = _primary_states.split;
+    sp->pending_task = nullptr;
+    if (err != ERR_OK)
+    {
+        abort_split("seed the child failed", err);
+        return;
+    }
+
+    ddebug("%s: child %d.%d is seeded at its decree %" PRId64 ", %d writes to forward",
+        name(), child.get_app_id(), child.get_partition_index(), d, (int)sp->pending_updates.size());
+
+    sp->child_decree = d;
+    forward_split_updates();
+}
+
+// @ parent primary, called when mu is committed
+void replica::capture_split_updates(mutation_ptr& mu)
+{
+    auto& sp = _primary_states.split;
+    if (mu->data.header.decree > sp->checkpoint_decree)
+    {
+        for (size_t i = 0; i < mu->data.updates.size(); i++)
+        {
+            const mutation_update& update = mu->data.updates[i];
+            if (update.code == RPC_REPLICATION_WRITE_EMPTY)
+                continue;
+
+            // the keys of the writes prepared by former primaries are unknown, so they
+            // are forwarded as well, where the other keys are garbage to the child
+            dsn_message_t req = mu->client_requests[i];
+            if (req != nullptr &&
+                dsn_msg_get_partition_hash(req) % static_cast<uint64_t>(sp->request.partition_count)
+                != static_cast<uint64_t>(sp->request.child.get_partition_index()))
+                continue;
+
+            sp->pending_updates.push_back(update);
+        }
+    }
+
+    forward_split_updates();
+}
+
+// @ parent primary
+void replica::forward_split_updates()
+{
+    auto& sp = _primary_states.split;
+    if (sp->child_decree == invalid_decree || sp->forwarding_count > 0 || sp->pending_task != nullptr)
+        return;
+
+    if (sp->pending_updates.empty())
+    {
+        check_split_fence();
+        return;
+    }
+
+    split_forward_request request;
+    request.child = sp->request.child;
+    request.bulk_load_decree = sp->child_decree;
+
+    int count = std::min(static_cast<int>(sp->pending_updates.size()), _options->split_forward_batch_count);
+    request.updates.assign(sp->pending_updates.begin(), sp->pending_updates.begin() + count);
+    sp->forwarding_count = count;
+
+    dinfo("%s: forward %d writes to child %d.%d, %d left",
+        name(), count, request.child.get_app_id(), request.child.get_partition_index(),
+        (int)sp->pending_updates.size() - count);
+
+    gpid child = request.child;
+    sp->pending_task = rpc::call(
+        sp->request.child_primary,
+        RPC_SPLIT_FORWARD,
+        request,
+        this,
+        [this, child](error_code err, split_forward_response&& resp)
+        {
+            on_split_forwarded(child, err == ERR_OK ? resp.err : err);
+        },
+        gpid_to_hash(child),
+        std::chrono::milliseconds(0),
+        gpid_to_hash(get_gpid())
+        );
+
+    check_split_fence();
+}
+
+// @ parent primary
+void replica::on_split_forwarded(gpid child, error_code err)
+{
+    check_hashed_access();
+
+    if (!is_split_alive(child))
+        return;
+
+    auto& sp = _primary_states.split;
+    sp->pending_task = nullptr;
+
+    if (err == ERR_BUSY)
+    {
+        // the child is too far behind on committing, try again later
+        sp->forwarding_count = 0;
+        sp->pending_task = tasking::enqueue(
+            LPC_SPLIT_PARTITION_TIMER,
+            this,
+            [this, child]()
+            {
+                if (!is_split_alive(child))
+                    return;
+                _primary_states.split->pending_task = nullptr;
+                forward_split_updates();
+            },
+            gpid_to_hash(get_gpid()),
+            std::chrono::milliseconds(100)
+            );
+        return;
+    }
+
+    if (err != ERR_OK)
+    {
+        abort_split("forward writes to the child failed", err);
+        return;
+    }
+
+    sp->pending_updates.erase(sp->pending_updates.begin(), sp->pending_updates.begin() + sp->forwarding_count);
+    sp->forwarding_count = 0;
+    forward_split_updates();
+}
+
+// @ parent primary
+void replica::check_split_fence()
+{
+    auto& sp = _primary_states.split;
+    if (sp->child_decree == invalid_decree || sp->notifying)
+        return;
+
+    int left = static_cast<int>(sp->pending_updates.size());
+    if (sp->fence_tid == 0)
+    {
+        if (left > _options->split_fence_pending_count)
+            return;
+
+        // the writes of the child's keys taken from now on are rejected
+        sp->fence_tid = mutation::last_tid();
+        sp->fence_ts_ms = dsn_now_ms();
+        ddebug("%s: fence the keys of child %d.%d, %d writes left to forward",
+            name(), sp->request.child.get_app_id(), sp->request.child.get_partition_index(), left);
+    }
+
+    if (dsn_now_ms() > sp->fence_ts_ms + static_cast<uint64_t>(_options->split_fence_timeout_ms))
+    {
+        abort_split("the fenced writes are not drained in time", ERR_TIMEOUT);
+        return;
+    }
+
+    // the writes taken before the fence are all in the prepare list once the write
+    // queue has handed out the mutations created before it
+    if (sp->fence_decree == invalid_decree)
+    {
+        uint64_t oldest = _primary_states.write_queue.oldest_tid();
+        if (oldest != 0 && oldest <= sp->fence_tid)
+            return;
+        sp->fence_decree = _prepare_list->max_decree();
+    }
+
+    if (last_committed_decree() < sp->fence_decree || left > 0 || sp->forwarding_count > 0)
+        return;
+
+    ddebug("%s: child %d.%d has caught up at decree %" PRId64 ", notify the meta server",
+        name(), sp->request.child.get_app_id(), sp->request.child.get_partition_index(), sp->fence_decree);
+
+    // from now on the fence is kept till the meta server replies, as the child may
+    // have taken over the keys even when the reply is lost
+    sp->notifying = true;
+    notify_split_ready();
+}
+
+// @ parent primary
+void replica::notify_split_ready()
+{
+    auto& sp = _primary_states.split;
+    notify_split_ready_request request;
+    request.parent = get_gpid();
+    request.parent_ballot = get_ballot();
+    request.child = sp->request.child;
+
+    gpid child = request.child;
+    rpc_address target(_stub->_failure_detector->get_servers());
+    sp->pending_task = rpc::call(
+        target,
+        RPC_CM_NOTIFY_SPLIT_READY,
+        request,
+        this,
+        [this, child](error_code err, notify_split_ready_response&& resp)
+        {
+            on_split_ready_notified(child, err == ERR_OK ? resp.err : err);
+        },
+        0,
+        std::chrono::milliseconds(0),
+        gpid_to_hash(get_gpid())
+        );
+}
+
+// @ parent primary
+void replica::on_split_ready_notified(gpid child, error_code err)
+{
+    check_hashed_access();
+
+    if (!is_split_alive(child))
+        return;
+
+    auto& sp = _primary_states.split;
+    sp->pending_task = nullptr;
+
+    if (err == ERR_OK)
+    {
+        ddebug("%s: split to %d.%d is done, serving partition count is changed from %d to %d",
+            name(), child.get_app_id(), child.get_partition_index(), _partition_count, sp->request.partition_count);
+        _partition_count = sp->request.partition_count;
+        _primary_states.split.reset();
+        notify_app_partition_count();
+        return;
+    }
+
+    if (err == ERR_TIMEOUT || err == ERR_BUSY || err == ERR_FORWARD_TO_OTHERS)
+    {
+        dwarn("%s: notify split ready of %d.%d failed, err = %s, retry later",
+            name(), child.get_app_id(), child.get_partition_index(), err.to_string());
+        sp->pending_task = tasking::enqueue(
+            LPC_SPLIT_PARTITION_TIMER,
+            this,
+            [this, child]()
+            {
+                if (!is_split_alive(child))
+                    return;
+                _primary_states.split->pending_task = nullptr;
+                notify_split_ready();
+            },
+            gpid_to_hash(get_gpid()),
+            std::chrono::seconds(1)
+            );
+        return;
+    }
+
+    // the meta server refuses to mark the child, so the keys are safe to take back
+    abort_split("the meta server refuses the child", err);
+}
+
+// @ parent primary
+void replica::abort_split(const char* reason, error_code err)
+{
+    auto& sp = _primary_states.split;
+    derror("%s: abort split to %d.%d as %s, err = %s",
+        name(), sp->request.child.get_app_id(), sp->request.child.get_partition_index(), reason, err.to_string());
+
+    if (sp->pending_task != nullptr)
+    {
+        sp->pending_task->cancel(false);
+        sp->pending_task = nullptr;
+    }
+    sp.reset();
+}
+
+// @ child primary
+void replica::on_split_forward(dsn_message_t msg, const split_forward_request& request)
+{
+    check_hashed_access();
+
+    split_forward_response response;
+    if (partition_status::PS_PRIMARY != status()
+        || request.bulk_load_decree == invalid_decree
+        || request.bulk_load_decree != _primary_states.last_bulk_load_decree)
+    {
+        response.err = ERR_INVALID_STATE;
+    }
+    else if (request.updates.empty())
+    {
+        response.err = ERR_INVALID_PARAMETERS;
+    }
+    else if (static_cast<int>(_primary_states.membership.secondaries.size()) + 1 < _options->mutation_2pc_min_replica_count)
+    {
+        response.err = ERR_NOT_ENOUGH_MEMBER;
+    }
+    else if (_prepare_list->max_decree() + 1 > last_committed_decree() + _options->staleness_for_commit)
+    {
+        response.err = ERR_BUSY;
+    }
+    else
+    {
+        response.err = ERR_OK;
+    }
+
+    if (response.err != ERR_OK)
+    {
+        if (response.err != ERR_BUSY)
+        {
+            dwarn("%s: reject split forward with %d writes, bulk load decree = %" PRId64 ", err = %s",
+                name(), (int)request.updates.size(), request.bulk_load_decree, response.err.to_string());
+        }
+        reply(msg, response);
+        return;
+    }
+
+    mutation_ptr mu = new_mutation(invalid_decree);
+    for (auto& update : request.updates)
+    {
+        mu->add_replica_update(update.code, update.data);
+        mu->data.updates.back().serialization_type = update.serialization_type;
+    }
+
+    dsn_msg_add_ref(msg); // released on reply
+    _primary_states.split_forwards.emplace_back(mu, msg);
+    init_prepare(mu);
+}
+
+// @ child primary, called when mu is committed
+void replica::on_split_forward_committed(mutation_ptr& mu)
+{
+    auto& forwards = _primary_states.split_forwards;
+    while (!forwards.empty() && forwards.front().first->data.header.decree <= mu->data.header.decree)
+    {
+        split_forward_response response;
+        response.err = (forwards.front().first == mu ? ERR_OK : ERR_INVALID_STATE);
+        reply(forwards.front().second, response);
+        dsn_msg_release_ref(forwards.front().second);
+        forwards.pop_front();
+    }
+}
+
+}} // namespace
@@ -53,19 +53,37 @@ using namespace dsn::service;
 bool replica_stub::s_not_exit_on_log_failure = false;
 
 replica_stub::replica_stub(replica_state_subscriber subscriber /*= nullptr*/, bool is_long_subscriber/* = true*/)
-    : serverlet("replica_stub"), _replicas_lock(true), /*_cli_replica_stub_json_state_handle(nullptr), */_cli_kill_partition(nullptr)
+    : serverlet("replica_stub"), _replicas_lock(true), /*_cli_replica_stub_json_state_handle(nullptr), */_cli_kill_partition(nullptr), _cli_learn_throttle(nullptr), _cli_hotkey(nullptr)
 {    
     _replica_state_subscriber = subscriber;
     _is_long_subscriber = is_long_subscriber;
     _failure_detector = nullptr;
     _state = NS_Disconnected;
     _log = nullptr;
+    _learning_max_concurrent_count = 0;
+    _config_epoch = 0;
+    _config_version = 0;
+    _last_full_config_sync_ms = 0;
+    _replica_directory.store(nullptr);
+    _replica_directory_epoch.store(1);
+    for (auto& reader : _replica_directory_readers)
+    {
+        reader.epoch.store(0);
+    }
     install_perf_counters();
 }
 
 replica_stub::~replica_stub(void)
 {
     close();
+
+    // no reader is left now
+    delete _replica_directory.exchange(nullptr);
+    for (auto& d : _retired_replica_directories)
+    {
+        delete d.first;
+    }
+    _retired_replica_directories.clear();
 }
 
 void replica_stub::install_perf_counters()
@@ -78,6 +96,8 @@ void replica_stub::install_perf_counters()
     _counter_replicas_learning_failed_latency.init("eon.replication", "replicas.learning.failed(ns)", COUNTER_TYPE_NUMBER_PERCENTILES, "learning time (failed)");
     _counter_replicas_learning_success_latency.init("eon.replication", "replicas.learning.success(ns)", COUNTER_TYPE_NUMBER_PERCENTILES, "learning time (success)");
     _counter_replicas_learning_count.init("eon.replication", "replicas.learnig(#)", COUNTER_TYPE_NUMBER, "total learning count");
+    _counter_replicas_learning_running_count.init("eon.replication", "replicas.learning.running(#)", COUNTER_TYPE_NUMBER, "# of replicas holding a learning slot");
+    _counter_replicas_learning_waiting_count.init("eon.replication", "replicas.learning.waiting(#)", COUNTER_TYPE_NUMBER, "# of replicas waiting for a learning slot");
 
     std::stringstream ss;
     ss << primary_address().to_std_string() << ".replica_stub.shared_log_size";
@@ -97,6 +117,7 @@ void replica_stub::initialize(const replication_options& opts, bool clear/* = fa
     ddebug("primary_address = %s", _primary_address.to_string());
 
     set_options(opts);
+    _learning_max_concurrent_count = _options.learn_max_concurrent_count;
     std::ostringstream oss;
     for (int i = 0; i < _options.meta_servers.size(); ++i)
     {
@@ -325,7 +346,7 @@ void replica_stub::initialize(const replication_options& opts, bool clear/* = fa
 
         if (err == ERR_OK)
         {
-            dassert(smax == pmax, "incomplete private log state");
+            dassert(smax == pmax || it->second->private_log() == nullptr, "incomplete private log state");
             it->second->set_inactive_state_transient(true);
         }
         else
@@ -348,7 +369,11 @@ void replica_stub::initialize(const replication_options& opts, bool clear/* = fa
     }
     
     // attach rps
-    _replicas = std::move(rps);
+    {
+        zauto_lock l(_replicas_lock);
+        _replicas = std::move(rps);
+        publish_replica_directory();
+    }
     _counter_replicas_count.add((uint64_t)_replicas.size());
 
     // start timer for configuration sync
@@ -374,11 +399,12 @@ void replica_stub::initialize(const replication_options& opts, bool clear/* = fa
             [=]() {this->on_meta_server_connected(); }
             );
 
-        err = _failure_detector->start(
-            _options.fd_check_interval_seconds,
-            _options.fd_beacon_interval_seconds,
-            _options.fd_lease_seconds,
-            _options.fd_grace_seconds
+        _failure_detector->set_phi_threshold(_options.fd_phi_threshold, _options.fd_phi_safety_margin_ms);
+        err = _failure_detector->start_ms(
+            _options.fd_check_interval_ms > 0 ? _options.fd_check_interval_ms : _options.fd_check_interval_seconds * 1000,
+            _options.fd_beacon_interval_ms > 0 ? _options.fd_beacon_interval_ms : _options.fd_beacon_interval_seconds * 1000,
+            _options.fd_lease_ms > 0 ? _options.fd_lease_ms : _options.fd_lease_seconds * 1000,
+            _options.fd_grace_ms > 0 ? _options.fd_grace_ms : _options.fd_grace_seconds * 1000
             );
         dassert(err == ERR_OK, "FD start failed, err = %s", err.to_string());
 
@@ -419,8 +445,250 @@ void replica_stub::on_kill_app_cli(void *context, int argc, const char **argv, d
     return;
 }
 
+void replica_stub::on_learn_throttle_cli(void *context, int argc, const char **argv, dsn_cli_reply *reply)
+{
+    std::stringstream ss;
+    if (argc >= 1)
+    {
+        int count = atoi(argv[0]);
+        if (count < 0)
+        {
+            ss << "invalid max concurrent learning count " << argv[0] << std::endl;
+        }
+        else
+        {
+            {
+                zauto_lock l(_learning_lock);
+                _learning_max_concurrent_count = count;
+            }
+            ddebug("max concurrent learning count is set to %d", count);
+            schedule_waiting_learners();
+        }
+    }
+
+    {
+        zauto_lock l(_learning_lock);
+        ss << "max_concurrent_count = " << _learning_max_concurrent_count
+           << ", running = " << _learning_replicas.size()
+           << ", waiting = " << _learning_waiters.size() << std::endl;
+        for (auto& w : _learning_waiters)
+        {
+            ss << "  waiting " << w.first.get_app_id() << "." << w.first.get_partition_index()
+               << ", lag = " << w.second.lag << std::endl;
+        }
+    }
+
+    std::string* resp = new std::string(ss.str());
+    reply->context = resp;
+    reply->message = (const char*)resp->c_str();
+    reply->size = resp->size();
+}
+
+void replica_stub::on_hotkey_cli(void *context, int argc, const char **argv, dsn_cli_reply *reply)
+{
+    std::stringstream ss;
+    int app_id = 0, partition_index = 0;
+    if (argc >= 1 && 2 != sscanf(argv[0], "%d.%d", &app_id, &partition_index))
+    {
+        app_id = -1;
+    }
+
+    std::vector<replica_ptr> reps;
+    {
+        zauto_lock l(_replicas_lock);
+        for (auto& kv : _replicas)
+        {
+            if (argc == 0 || (kv.first.get_app_id() == app_id && kv.first.get_partition_index() == partition_index))
+                reps.push_back(kv.second);
+        }
+    }
+
+    if (reps.empty())
+    {
+        ss << (argc == 0 ? "no replica on this node" : "partition not found") << std::endl;
+    }
+    else if (reps.front()->get_hotkey_detector() == nullptr)
+    {
+        ss << "hot key detection is disabled" << std::endl;
+    }
+    else if (argc == 0)
+    {
+        std::vector<std::pair<double, replica_ptr>> qps;
+        for (auto& r : reps)
+            qps.emplace_back(r->get_request_qps(), r);
+        std::sort(qps.begin(), qps.end(), [](const std::pair<double, replica_ptr>& l, const std::pair<double, replica_ptr>& r)
+        {
+            return l.first > r.first;
+        });
+
+        for (auto& q : qps)
+        {
+            std::vector<hotkey_detector::hot_key> keys;
+            uint32_t samples = q.second->get_hotkey_detector()->get_hot_keys(keys);
+            ss << q.second->name() << ": qps = " << (uint64_t)q.first;
+            if (!keys.empty() && samples > 0)
+            {
+                char hash[32];
+                sprintf(hash, "%016" PRIx64, keys[0].hash);
+                ss << ", hottest key = " << hash << ", share = " << keys[0].count * 100 / samples << "%";
+            }
+            ss << std::endl;
+        }
+    }
+    else
+    {
+        std::vector<hotkey_detector::hot_key> keys;
+        uint32_t samples = reps.front()->get_hotkey_detector()->get_hot_keys(keys);
+        ss << reps.front()->name() << ": " << samples << " samples in the window" << std::endl;
+        for (auto& k : keys)
+        {
+            char hash[32];
+            sprintf(hash, "%016" PRIx64, k.hash);
+            ss << "  key = " << hash
+               << ", share = " << (samples > 0 ? k.count * 100 / samples : 0) << "%"
+               << ", sampled reads = " << k.reads
+               << ", sampled writes = " << k.writes << std::endl;
+        }
+    }
+
+    std::string* resp = new std::string(ss.str());
+    reply->context = resp;
+    reply->message = (const char*)resp->c_str();
+    reply->size = resp->size();
+}
+
+bool replica_stub::acquire_learning_slot(replica* r, decree lag, uint64_t signature)
+{
+    gpid pid = r->get_gpid();
+
+    zauto_lock l(_learning_lock);
+    if (_learning_replicas.find(pid) != _learning_replicas.end())
+        return true;
+
+    if (_learning_max_concurrent_count == 0
+        || (int)_learning_replicas.size() < _learning_max_concurrent_count)
+    {
+        _learning_waiters.erase(pid);
+        _learning_replicas.insert(pid);
+        _counter_replicas_learning_running_count.set(_learning_replicas.size());
+        _counter_replicas_learning_waiting_count.set(_learning_waiters.size());
+        return true;
+    }
+
+    // refresh lag and signature when already waiting
+    auto& w = _learning_waiters[pid];
+    w.lag = lag;
+    w.signature = signature;
+    _counter_replicas_learning_waiting_count.set(_learning_waiters.size());
+    return false;
+}
+
+void replica_stub::release_learning_slot(gpid pid)
+{
+    {
+        zauto_lock l(_learning_lock);
+        bool running = (_learning_replicas.erase(pid) > 0);
+        bool waiting = (_learning_waiters.erase(pid) > 0);
+        if (!running && !waiting)
+            return;
+
+        _counter_replicas_learning_running_count.set(_learning_replicas.size());
+        _counter_replicas_learning_waiting_count.set(_learning_waiters.size());
+    }
+
+    schedule_waiting_learners();
+}
+
+void replica_stub::schedule_waiting_learners()
+{
+    std::vector<std::pair<gpid, uint64_t>> granted;
+    {
+        zauto_lock l(_learning_lock);
+        while (!_learning_waiters.empty()
+            && (_learning_max_concurrent_count == 0
+                || (int)_learning_replicas.size() < _learning_max_concurrent_count))
+        {
+            // the replica lagging most behind goes first
+            auto it = _learning_waiters.begin();
+            for (auto it2 = _learning_waiters.begin(); it2 != _learning_waiters.end(); ++it2)
+            {
+                if (it2->second.lag > it->second.lag)
+                    it = it2;
+            }
+
+            granted.emplace_back(it->first, it->second.signature);
+            _learning_replicas.insert(it->first);
+            _learning_waiters.erase(it);
+        }
+
+        if (granted.empty())
+            return;
+
+        _counter_replicas_learning_running_count.set(_learning_replicas.size());
+        _counter_replicas_learning_waiting_count.set(_learning_waiters.size());
+    }
+
+    for (auto& g : granted)
+    {
+        replica_ptr r = get_replica(g.first);
+        if (r == nullptr)
+        {
+            release_learning_slot(g.first);
+            continue;
+        }
+
+        uint64_t signature = g.second;
+        tasking::enqueue(
+            LPC_DELAY_LEARN,
+            r.get(),
+            [r, signature]() { r->on_learning_slot_granted(signature); },
+            gpid_to_hash(g.first)
+            );
+    }
+}
+
+// the slot of this thread in replica_stub::_replica_directory_readers, the same
+// for all the stubs in the process, or -1 when the slots are used up
+static int replica_directory_reader_slot()
+{
+    static std::atomic<int> s_next_slot(0);
+    static __thread int s_slot = 0; // slot + 1, 0 when not assigned yet
+
+    if (s_slot == 0)
+    {
+        int slot = s_next_slot++;
+        s_slot = (slot < MAX_REPLICA_DIRECTORY_READERS ? slot + 1 : -1);
+    }
+    return s_slot > 0 ? s_slot - 1 : -1;
+}
+
 replica_ptr replica_stub::get_replica(gpid gpid, bool new_when_possible, const app_info* app)
 {
+    // fast path without lock:
+    // the reader announces the epoch it enters before loading the directory, and
+    // a directory retired at epoch E is deleted only when every reader is either
+    // out or has entered at E or later, in which case it loaded a newer directory
+    int slot = new_when_possible ? -1 : replica_directory_reader_slot();
+    if (slot >= 0)
+    {
+        auto& reader = _replica_directory_readers[slot];
+        reader.epoch.store(_replica_directory_epoch.load());
+
+        replica_ptr r;
+        replica_directory* dir = _replica_directory.load();
+        int32_t app_id = gpid.get_app_id();
+        int32_t pidx = gpid.get_partition_index();
+        if (dir != nullptr
+            && app_id >= 0 && app_id < (int32_t)dir->size()
+            && pidx >= 0 && pidx < (int32_t)(*dir)[app_id].size())
+        {
+            r = (*dir)[app_id][pidx];
+        }
+
+        reader.epoch.store(0, std::memory_order_release);
+        return r;
+    }
+
     zauto_lock l(_replicas_lock);
     auto it = _replicas.find(gpid);
     if (it != _replicas.end())
@@ -521,6 +789,20 @@ void replica_stub::on_config_proposal(const configuration_update_request& propos
     }
 }
 
+void replica_stub::on_config_change_notify(const config_change_notification& notification)
+{
+    if (!is_connected() || _options.config_sync_disabled)
+        return;
+
+    // _config_query_task and the config version are guarded by _replicas_lock
+    zauto_lock l(_replicas_lock);
+    if (notification.config_epoch == _config_epoch && notification.config_version <= _config_version)
+        return;
+
+    ddebug("config changes notified by meta server, config version = %" PRId64, notification.config_version);
+    query_configuration_by_node();
+}
+
 void replica_stub::on_query_decree(const query_replica_decree_request& req, /*out*/ query_replica_decree_response& resp)
 {
     replica_ptr rep = get_replica(req.pid);
@@ -622,6 +904,136 @@ void replica_stub::on_group_check(const group_check_request& request, /*out*/ gr
     }
 }
 
+void replica_stub::on_group_check_batch(const group_check_batch_request& request, /*out*/ rpc_replier<group_check_batch_response>& reply)
+{
+    ddebug("%s: received batched group check with %u requests",
+        _primary_address.to_string(), static_cast<uint32_t>(request.requests.size())
+        );
+
+    struct batch_context
+    {
+        rpc_replier<group_check_batch_response> replier;
+        group_check_batch_response              response;
+        std::atomic<int>                        pending;
+
+        batch_context(const rpc_replier<group_check_batch_response>& r) : replier(r), pending(0) {}
+    };
+
+    auto ctx = std::make_shared<batch_context>(reply);
+    ctx->response.responses.resize(request.requests.size());
+    ctx->pending = static_cast<int>(request.requests.size());
+    if (ctx->pending == 0)
+    {
+        ctx->replier(ctx->response);
+        return;
+    }
+
+    // each group check runs in the thread of its replica, as if it came in alone
+    for (size_t i = 0; i < request.requests.size(); ++i)
+    {
+        auto& req = request.requests[i];
+        tasking::enqueue(
+            LPC_GROUP_CHECK_BATCH_DISPATCH,
+            this,
+            [this, ctx, i, req]()
+            {
+                on_group_check(req, ctx->response.responses[i]);
+                if (--ctx->pending == 0)
+                {
+                    ctx->replier(ctx->response);
+                }
+            },
+            gpid_to_hash(req.config.pid)
+            );
+    }
+}
+
+void replica_stub::batch_group_check(::dsn::rpc_address node, const group_check_batch_item_ptr& item)
+{
+    bool first;
+    {
+        zauto_lock l(_group_check_batch_lock);
+        auto& items = _group_check_batches[node];
+        first = items.empty();
+        items.push_back(item);
+    }
+
+    // the first group check to a node opens a window for the others
+    if (first)
+    {
+        tasking::enqueue(
+            LPC_GROUP_CHECK_BATCH_FLUSH,
+            this,
+            [this, node]() { flush_group_check_batch(node); },
+            0,
+            std::chrono::milliseconds(_options.group_check_batch_window_ms)
+            );
+    }
+}
+
+void replica_stub::flush_group_check_batch(::dsn::rpc_address node)
+{
+    std::vector<group_check_batch_item_ptr> items;
+    {
+        zauto_lock l(_group_check_batch_lock);
+        auto it = _group_check_batches.find(node);
+        if (it == _group_check_batches.end())
+            return;
+        items = std::move(it->second);
+        _group_check_batches.erase(it);
+    }
+
+    group_check_batch_request request;
+    request.node = node;
+    request.requests.reserve(items.size());
+    for (auto& item : items)
+    {
+        request.requests.push_back(*item->request);
+    }
+
+    dinfo("%s: send batched group check with %u requests to %s",
+        _primary_address.to_string(), static_cast<uint32_t>(items.size()), node.to_string()
+        );
+
+    rpc::call(
+        node,
+        RPC_GROUP_CHECK_BATCH,
+        request,
+        this,
+        [this, items_cap = std::move(items)](error_code err, group_check_batch_response&& resp) mutable
+        {
+            on_group_check_batch_reply(err, std::move(items_cap), std::move(resp));
+        }
+        );
+}
+
+void replica_stub::on_group_check_batch_reply(error_code err, std::vector<group_check_batch_item_ptr>&& items, group_check_batch_response&& resp)
+{
+    if (err == ERR_OK && resp.responses.size() != items.size())
+    {
+        derror("%s: batched group check reply has %u responses for %u requests",
+            _primary_address.to_string(),
+            static_cast<uint32_t>(resp.responses.size()),
+            static_cast<uint32_t>(items.size())
+            );
+        err = ERR_INVALID_DATA;
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        auto& item = items[i];
+        item->err = err;
+        if (err == ERR_OK)
+        {
+            *item->response = std::move(resp.responses[i]);
+        }
+
+        // the callback may have been cancelled by the replica, in which case it is simply dropped
+        ::dsn::task_ptr callback = std::move(item->callback);
+        callback->enqueue();
+    }
+}
+
 void replica_stub::on_learn(dsn_message_t msg)
 {
     learn_request request;
@@ -640,6 +1052,76 @@ void replica_stub::on_learn(dsn_message_t msg)
     }
 }
 
+void replica_stub::on_bulk_load(dsn_message_t msg)
+{
+    bulk_load_request request;
+    ::dsn::unmarshall(msg, request);
+
+    replica_ptr rep = get_replica(request.pid);
+    if (rep != nullptr)
+    {
+        rep->on_bulk_load(msg, request);
+    }
+    else
+    {
+        bulk_load_response response;
+        response.err = ERR_OBJECT_NOT_FOUND;
+        response.decree = invalid_decree;
+        reply(msg, response);
+    }
+}
+
+void replica_stub::on_bulk_load_stage(dsn_message_t msg)
+{
+    bulk_load_request request;
+    ::dsn::unmarshall(msg, request);
+
+    replica_ptr rep = get_replica(request.pid);
+    if (rep != nullptr)
+    {
+        rep->on_bulk_load_stage(msg, request);
+    }
+    else
+    {
+        bulk_load_response response;
+        response.err = ERR_OBJECT_NOT_FOUND;
+        response.decree = invalid_decree;
+        reply(msg, response);
+    }
+}
+
+void replica_stub::on_split_partition(const split_partition_request& request)
+{
+    replica_ptr rep = get_replica(request.parent);
+    if (rep != nullptr)
+    {
+        rep->on_split_partition(request);
+    }
+    else
+    {
+        dwarn("%u.%u@%s: received split partition: replica not found, ignore",
+            request.parent.get_app_id(), request.parent.get_partition_index(), _primary_address.to_string());
+    }
+}
+
+void replica_stub::on_split_forward(dsn_message_t msg)
+{
+    split_forward_request request;
+    ::dsn::unmarshall(msg, request);
+
+    replica_ptr rep = get_replica(request.child);
+    if (rep != nullptr)
+    {
+        rep->on_split_forward(msg, request);
+    }
+    else
+    {
+        split_forward_response response;
+        response.err = ERR_OBJECT_NOT_FOUND;
+        reply(msg, response);
+    }
+}
+
 void replica_stub::on_copy_checkpoint(const replica_configuration& request, /*out*/ learn_response& response)
 {
     replica_ptr rep = get_replica(request.pid);
@@ -751,11 +1233,39 @@ void replica_stub::query_configuration_by_node()
 
     configuration_query_by_node_request req;
     req.node = _primary_address;
-    ::dsn::marshall(msg, req);
+    {
+        // a full sync now and then also catches the local replicas unknown to the meta server
+        zauto_lock l(_replicas_lock);
+        if (now_ms() < _last_full_config_sync_ms + _options.config_sync_full_interval_ms)
+        {
+            req.config_epoch = _config_epoch;
+            req.config_version = _config_version;
+        }
+        else
+        {
+            req.config_epoch = 0;
+            req.config_version = 0;
+        }
 
-    ddebug("send query node partitions request to meta server");
+        // piggyback the loads of the serving replicas for the load balancer on the meta server
+        req.loads.reserve(_replicas.size());
+        for (auto& r : _replicas)
+        {
+            partition_status::type st = r.second->status();
+            if (st != partition_status::PS_PRIMARY && st != partition_status::PS_SECONDARY)
+                continue;
 
-    ddebug("send query node partitions request to meta server");
+            replica_load load;
+            load.pid = r.first;
+            load.qps = r.second->get_request_qps();
+            load.bytes_per_second = r.second->get_request_bytes_per_second();
+            load.disk_usage_mb = r.second->get_disk_usage_mb();
+            req.loads.push_back(load);
+        }
+    }
+    ::dsn::marshall(msg, req);
+
+    ddebug("send query node partitions request to meta server, config version = %" PRId64, req.config_version);
 
     rpc_address target(_failure_detector->get_servers());
     _config_query_task = rpc::call(
@@ -777,6 +1287,7 @@ void replica_stub::on_meta_server_connected()
     if (_state == NS_Disconnected)
     {
         _state = NS_Connecting;
+        _last_full_config_sync_ms = 0;
         query_configuration_by_node();
     }
 }
@@ -810,7 +1321,36 @@ void replica_stub::on_node_query_reply(error_code err, dsn_message_t request, ds
 
         if (resp.err != ERR_OK)
             return;
-        
+
+        _config_epoch = resp.config_epoch;
+        _config_version = resp.config_version;
+
+        if (resp.is_incremental)
+        {
+            ddebug("query node partitions replied with %d changed and %d gone partitions, config version = %" PRId64,
+                (int)resp.partitions.size(), (int)resp.gone_partitions.size(), resp.config_version);
+            for (auto it = resp.partitions.begin(); it != resp.partitions.end(); ++it)
+            {
+                tasking::enqueue(
+                    LPC_QUERY_NODE_CONFIGURATION_SCATTER,
+                    this,
+                    std::bind(&replica_stub::on_node_query_reply_scatter, this, this, *it),
+                    gpid_to_hash(it->config.pid)
+                    );
+            }
+            for (auto it = resp.gone_partitions.begin(); it != resp.gone_partitions.end(); ++it)
+            {
+                tasking::enqueue(
+                    LPC_QUERY_NODE_CONFIGURATION_SCATTER,
+                    this,
+                    std::bind(&replica_stub::on_node_query_reply_scatter2, this, this, *it),
+                    gpid_to_hash(*it)
+                    );
+            }
+            return;
+        }
+
+        _last_full_config_sync_ms = now_ms();
         replicas rs = _replicas;
         for (auto it = resp.partitions.begin(); it != resp.partitions.end(); ++it)
         {
@@ -865,7 +1405,7 @@ void replica_stub::on_node_query_reply_scatter(replica_stub_ptr this_, const con
     replica_ptr replica = get_replica(req.config.pid);
     if (replica != nullptr)
     {
-        replica->on_config_sync(req.config);
+        replica->on_config_sync(req.info, req.config);
     }
     else
     {
@@ -1010,6 +1550,9 @@ void replica_stub::on_gc()
     {
         zauto_lock l(_replicas_lock);
         rs = _replicas;
+
+        // the directories whose readers were still around when they were replaced
+        gc_replica_directories();
     }
 
     // gc shared prepare log
@@ -1261,6 +1804,7 @@ void replica_stub::add_replica(replica_ptr r)
     zauto_lock l(_replicas_lock);
     auto pr = _replicas.insert(replicas::value_type(r->get_gpid(), r));
     dassert(pr.second, "replica %s is already in the collection", r->name());
+    publish_replica_directory();
 }
 
 bool replica_stub::remove_replica(replica_ptr r)
@@ -1269,6 +1813,7 @@ bool replica_stub::remove_replica(replica_ptr r)
     if (_replicas.erase(r->get_gpid()) > 0)
     {
         _counter_replicas_count.decrement();
+        publish_replica_directory();
         return true;
     }
     else
@@ -1277,6 +1822,56 @@ bool replica_stub::remove_replica(replica_ptr r)
     }
 }
 
+// _replicas_lock must be held
+void replica_stub::publish_replica_directory()
+{
+    auto dir = new replica_directory();
+    for (auto& kv : _replicas)
+    {
+        int32_t app_id = kv.first.get_app_id();
+        int32_t pidx = kv.first.get_partition_index();
+        dassert(app_id >= 0 && pidx >= 0, "invalid gpid %d.%d", app_id, pidx);
+
+        if (app_id >= (int32_t)dir->size())
+            dir->resize(app_id + 1);
+
+        auto& partitions = (*dir)[app_id];
+        if (pidx >= (int32_t)partitions.size())
+            partitions.resize(pidx + 1);
+        partitions[pidx] = kv.second;
+    }
+
+    replica_directory* old = _replica_directory.exchange(dir);
+    if (old != nullptr)
+    {
+        _retired_replica_directories.emplace_back(old, ++_replica_directory_epoch);
+    }
+    gc_replica_directories();
+}
+
+// _replicas_lock must be held
+void replica_stub::gc_replica_directories()
+{
+    if (_retired_replica_directories.empty())
+        return;
+
+    uint64_t min_reader_epoch = std::numeric_limits<uint64_t>::max();
+    for (auto& reader : _replica_directory_readers)
+    {
+        uint64_t e = reader.epoch.load();
+        if (e != 0 && e < min_reader_epoch)
+            min_reader_epoch = e;
+    }
+
+    // the list is in the order of the retiring epochs
+    auto it = _retired_replica_directories.begin();
+    for (; it != _retired_replica_directories.end() && it->second <= min_reader_epoch; ++it)
+    {
+        delete it->first;
+    }
+    _retired_replica_directories.erase(_retired_replica_directories.begin(), it);
+}
+
 void replica_stub::notify_replica_state_update(const replica_configuration& config, bool is_closing)
 {
     if (nullptr != _replica_state_subscriber)
@@ -1304,6 +1899,7 @@ void replica_stub::handle_log_failure(error_code err)
 void replica_stub::open_service()
 {
     register_rpc_handler(RPC_CONFIG_PROPOSAL, "ProposeConfig", &replica_stub::on_config_proposal);
+    register_rpc_handler(RPC_CONFIG_CHANGE_NOTIFY, "ConfigChangeNotify", &replica_stub::on_config_change_notify);
 
     register_rpc_handler(RPC_PREPARE, "prepare", &replica_stub::on_prepare);
     register_rpc_handler(RPC_LEARN, "Learn", &replica_stub::on_learn);
@@ -1311,9 +1907,14 @@ void replica_stub::open_service()
     register_rpc_handler(RPC_LEARN_ADD_LEARNER, "LearnAdd", &replica_stub::on_add_learner);
     register_rpc_handler(RPC_REMOVE_REPLICA, "remove", &replica_stub::on_remove);
     register_rpc_handler(RPC_GROUP_CHECK, "GroupCheck", &replica_stub::on_group_check);
+    register_async_rpc_handler(RPC_GROUP_CHECK_BATCH, "GroupCheckBatch", &replica_stub::on_group_check_batch);
     register_rpc_handler(RPC_QUERY_PN_DECREE, "query_decree", &replica_stub::on_query_decree);
     register_rpc_handler(RPC_QUERY_REPLICA_INFO, "query_replica_info", &replica_stub::on_query_replica_info);
     register_rpc_handler(RPC_REPLICA_COPY_LAST_CHECKPOINT, "copy_checkpoint", &replica_stub::on_copy_checkpoint);
+    register_rpc_handler(RPC_BULK_LOAD, "bulk_load", &replica_stub::on_bulk_load);
+    register_rpc_handler(RPC_BULK_LOAD_STAGE, "bulk_load_stage", &replica_stub::on_bulk_load_stage);
+    register_rpc_handler(RPC_SPLIT_PARTITION, "split_partition", &replica_stub::on_split_partition);
+    register_rpc_handler(RPC_SPLIT_FORWARD, "split_forward", &replica_stub::on_split_forward);
 
     /*_cli_replica_stub_json_state_handle = dsn_cli_app_register("info", "get the info of replica_stub on this node", "",
         this, &static_replica_stub_json_state, &static_replica_stub_json_state_freer);
@@ -1335,6 +1936,42 @@ void replica_stub::open_service()
             delete s;
         }
     );
+
+    _cli_learn_throttle = dsn_cli_app_register(
+        "learn_throttle",
+        "learn_throttle [max_concurrent_count]",
+        "show learning slots on this node, or set the max concurrent learning count (0 for unlimited); "
+        "learning copy bandwidth is limited by the nfs-rate-limit command",
+        (void*)this,
+        [](void *context, int argc, const char **argv, dsn_cli_reply *reply)
+        {
+            auto this_ = (replica_stub*)context;
+            this_->on_learn_throttle_cli(context, argc, argv, reply);
+        },
+        [](dsn_cli_reply reply)
+        {
+            std::string* s = (std::string*)reply.context;
+            delete s;
+        }
+    );
+
+    _cli_hotkey = dsn_cli_app_register(
+        "hotkey",
+        "hotkey [app_id.partition_index]",
+        "show the partitions on this node by sampled request qps, or the hottest keys "
+        "(partition hashes given by clients) of the given partition",
+        (void*)this,
+        [](void *context, int argc, const char **argv, dsn_cli_reply *reply)
+        {
+            auto this_ = (replica_stub*)context;
+            this_->on_hotkey_cli(context, argc, argv, reply);
+        },
+        [](dsn_cli_reply reply)
+        {
+            std::string* s = (std::string*)reply.context;
+            delete s;
+        }
+    );
 }
 
 void replica_stub::close()
@@ -1349,8 +1986,12 @@ void replica_stub::close()
 
     //dsn_cli_deregister(_cli_replica_stub_json_state_handle);
     dsn_cli_deregister(_cli_kill_partition);
+    dsn_cli_deregister(_cli_learn_throttle);
+    dsn_cli_deregister(_cli_hotkey);
     //_cli_replica_stub_json_state_handle = nullptr;
     _cli_kill_partition = nullptr;
+    _cli_learn_throttle = nullptr;
+    _cli_hotkey = nullptr;
 
     if (_config_sync_timer_task != nullptr)
     {
@@ -1370,6 +2011,19 @@ void replica_stub::close()
         _gc_timer_task->cancel(true);
         _gc_timer_task = nullptr;
     }
+
+    {
+        // break the reference cycles between the unsent items and their callbacks
+        zauto_lock l(_group_check_batch_lock);
+        for (auto& kv : _group_check_batches)
+        {
+            for (auto& item : kv.second)
+            {
+                item->callback = nullptr;
+            }
+        }
+        _group_check_batches.clear();
+    }
     
     {
         zauto_lock l(_replicas_lock);    
@@ -1408,6 +2062,7 @@ void replica_stub::close()
             _counter_replicas_count.decrement();
             _replicas.erase(_replicas.begin());
         }
+        publish_replica_directory();
     }
         
     if (_failure_detector != nullptr)
@@ -44,6 +44,8 @@
 # include "replication_common.h"
 # include <dsn/cpp/perf_counter_.h>
 # include <dsn/dist/failure_detector_multimaster.h>
+# include <unordered_set>
+# include <atomic>
 
 namespace dsn { namespace replication {
 
@@ -54,6 +56,19 @@ namespace test {
 }
 
 typedef std::unordered_map<gpid, replica_ptr> replicas;
+
+// the threads beyond this many look up replicas under replica_stub::_replicas_lock
+# define MAX_REPLICA_DIRECTORY_READERS 256
+
+// a group check waiting to be sent in a batch, see replica_stub::batch_group_check
+struct group_check_batch_item
+{
+    std::shared_ptr<group_check_request>  request;
+    std::shared_ptr<group_check_response> response;
+    error_code                            err;
+    ::dsn::task_ptr                       callback; // enqueued when err and response are ready
+};
+typedef std::shared_ptr<group_check_batch_item> group_check_batch_item_ptr;
 typedef std::function<void (::dsn::rpc_address /*from*/,
                             const replica_configuration& /*new_config*/,
                             bool /*is_closing*/)> replica_state_subscriber;
@@ -86,6 +101,7 @@ public:
     //    messages from meta server
     //
     void on_config_proposal(const configuration_update_request& proposal);
+    void on_config_change_notify(const config_change_notification& notification);
     void on_query_decree(const query_replica_decree_request& req, /*out*/ query_replica_decree_response& resp);
     void on_query_replica_info(const query_replica_info_request& req, /*out*/ query_replica_info_response& resp);
 
@@ -101,7 +117,12 @@ public:
     void on_add_learner(const group_check_request& request);
     void on_remove(const replica_configuration& request);
     void on_group_check(const group_check_request& request, /*out*/ group_check_response& response);
+    void on_group_check_batch(const group_check_batch_request& request, /*out*/ rpc_replier<group_check_batch_response>& reply);
     void on_copy_checkpoint(const replica_configuration& request, /*out*/ learn_response& response);
+    void on_bulk_load(dsn_message_t msg);
+    void on_bulk_load_stage(dsn_message_t msg);
+    void on_split_partition(const split_partition_request& request);
+    void on_split_forward(dsn_message_t msg);
 
     //
     //    local messages
@@ -126,6 +147,19 @@ public:
     replication_options& options() { return _options; }
     bool is_connected() const { return NS_Connected == _state; }
 
+    //
+    // node-wide learning scheduler, at most learn_max_concurrent_count replicas
+    // learn at the same time, and waiting replicas with larger lag go first
+    //
+    // return true when r may start a learning round now, otherwise r is queued and
+    // replica::on_learning_slot_granted(signature) is called later
+    bool acquire_learning_slot(replica* r, decree lag, uint64_t signature);
+    void release_learning_slot(gpid pid);
+
+    // queue a group check to be sent together with others to the same node,
+    // item->callback is enqueued once the batch is replied or fails
+    void batch_group_check(::dsn::rpc_address node, const group_check_batch_item_ptr& item);
+
     //void json_state(std::stringstream& out) const;
 
     //static void static_replica_stub_json_state(void* context, int argc, const char** argv, dsn_cli_reply* reply);
@@ -153,11 +187,18 @@ private:
     void close_replica(replica_ptr r);
     void add_replica(replica_ptr r);
     bool remove_replica(replica_ptr r);
+    void publish_replica_directory();
+    void gc_replica_directories();
     void notify_replica_state_update(const replica_configuration& config, bool is_closing);
     void handle_log_failure(error_code err);
 
     void install_perf_counters();
     void on_kill_app_cli(void *context, int argc, const char **argv, dsn_cli_reply *reply);
+    void on_learn_throttle_cli(void *context, int argc, const char **argv, dsn_cli_reply *reply);
+    void on_hotkey_cli(void *context, int argc, const char **argv, dsn_cli_reply *reply);
+    void schedule_waiting_learners();
+    void flush_group_check_batch(::dsn::rpc_address node);
+    void on_group_check_batch_reply(error_code err, std::vector<group_check_batch_item_ptr>&& items, group_check_batch_response&& resp);
 
 private:
     friend class ::dsn::replication::replication_checker;    
@@ -168,6 +209,22 @@ private:
 
     mutable zlock               _replicas_lock;
     replicas                    _replicas;
+
+    // read-only copy of _replicas indexed by app_id and partition_index, which is
+    // republished (under _replicas_lock) whenever _replicas changes so that the
+    // lookups on the request path need not take _replicas_lock.
+    // a replaced directory is retired at a new epoch, and deleted by
+    // gc_replica_directories() once no reader is in an older epoch, see get_replica
+    typedef std::vector<std::vector<replica_ptr>> replica_directory;
+    struct replica_directory_reader
+    {
+        std::atomic<uint64_t> epoch; // when the reader entered, 0 when it is not reading
+        char                  padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+    std::atomic<replica_directory*> _replica_directory;
+    std::atomic<uint64_t>           _replica_directory_epoch;
+    replica_directory_reader        _replica_directory_readers[MAX_REPLICA_DIRECTORY_READERS];
+    std::vector<std::pair<replica_directory*, uint64_t>> _retired_replica_directories; // with the retiring epoch
     opening_replicas            _opening_replicas;
     closing_replicas            _closing_replicas;
     
@@ -184,12 +241,34 @@ private:
     
     // temproal states
     ::dsn::task_ptr _config_query_task;
+
+    // of the last config sync with the meta server, for the incremental ones (under _replicas_lock)
+    int64_t         _config_epoch;
+    int64_t         _config_version;
+    uint64_t        _last_full_config_sync_ms;
     ::dsn::task_ptr _config_sync_timer_task;
     ::dsn::task_ptr _gc_timer_task;
 
+    // group checks to be sent in batches, by target node
+    zlock                       _group_check_batch_lock;
+    std::unordered_map< ::dsn::rpc_address, std::vector<group_check_batch_item_ptr>> _group_check_batches;
+
+    // learning scheduler
+    struct learning_waiter
+    {
+        decree   lag;
+        uint64_t signature;
+    };
+    zlock                       _learning_lock;
+    int32_t                     _learning_max_concurrent_count;
+    std::unordered_set<gpid>    _learning_replicas;
+    std::unordered_map<gpid, learning_waiter> _learning_waiters;
+
     //cli handle, for deregister cli command
     //dsn_handle_t    _cli_replica_stub_json_state_handle;
     dsn_handle_t    _cli_kill_partition;
+    dsn_handle_t    _cli_learn_throttle;
+    dsn_handle_t    _cli_hotkey;
 
     // performance counters
     perf_counter_    _counter_replicas_count;
@@ -200,6 +279,8 @@ private:
     perf_counter_    _counter_replicas_learning_failed_latency;
     perf_counter_    _counter_replicas_learning_success_latency;
     perf_counter_    _counter_replicas_learning_count;
+    perf_counter_    _counter_replicas_learning_running_count;
+    perf_counter_    _counter_replicas_learning_waiting_count;
 
     perf_counter_    _counter_shared_log_size;
 private:
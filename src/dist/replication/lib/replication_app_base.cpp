@@ -317,6 +317,10 @@ error_code replication_app_base::open_new_internal(replica* r, int64_t shared_lo
         argv[0] = (char*)info->app_name.c_str();
         err = dsn_hosted_app_start(_app_context, 1, argv);
     }
+    if (err == ERR_OK)
+    {
+        set_partition_count(_replica->get_app_partition_count());
+    }
     return err;
 }
 
@@ -473,6 +477,12 @@ error_code replication_app_base::open_new_internal(replica* r, int64_t shared_lo
     dassert(mu->data.updates.size() == mu->client_requests.size(), "");
     dassert(mu->data.updates.size() > 0, "");
 
+    if (mu->data.updates[0].code == RPC_BULK_LOAD)
+    {
+        dassert(mu->data.updates.size() == 1, "bulk load must be the only update of a mutation");
+        return write_bulk_load(mu);
+    }
+
     int request_count = static_cast<int>(mu->client_requests.size());
     dsn_message_t* batched_requests = (dsn_message_t*)alloca(sizeof(dsn_message_t) * request_count);
     dsn_message_t* faked_requests = (dsn_message_t*)alloca(sizeof(dsn_message_t) * request_count);
@@ -549,6 +559,66 @@ error_code replication_app_base::open_new_internal(replica* r, int64_t shared_lo
     return ERR_OK;
 }
 
+// the files staged by the bulk load are applied as a learned checkpoint of the
+// mutation's decree, which replaces the state of the app
+::dsn::error_code replication_app_base::write_bulk_load(mutation_ptr& mu)
+{
+    bulk_load_request request;
+    binary_reader reader(mu->data.updates[0].data);
+    unmarshall(reader, request, DSF_THRIFT_BINARY);
+
+    decree d = mu->data.header.decree;
+    std::string dir = _replica->bulk_load_dir(request.signature);
+
+    learn_state state;
+    state.from_decree_excluded = 0;
+    state.to_decree_included = d;
+
+    error_code err = ERR_OK;
+    for (auto& f : request.files)
+    {
+        std::string path = utils::filesystem::path_combine(dir, f);
+        if (!utils::filesystem::file_exists(path))
+        {
+            // e.g., replayed after the files are removed, the replica has to learn again
+            derror("%s: mutation %s: staged bulk load file %s is missing",
+                _replica->name(), mu->name(), path.c_str());
+            err = ERR_OBJECT_NOT_FOUND;
+            break;
+        }
+        state.files.push_back(path);
+    }
+
+    uint64_t start = dsn_now_ns();
+    if (err == ERR_OK)
+    {
+        err = apply_checkpoint(DSN_CHKPT_LEARN, state);
+    }
+    uint64_t latency = dsn_now_ns() - start;
+
+    if (err != ERR_OK || last_committed_decree() != d)
+    {
+        derror("%s: mutation %s: ingest bulk load with signature %" PRId64 " failed, err = %s",
+            _replica->name(), mu->name(), request.signature, err.to_string());
+        _replica->on_bulk_load_ingested(request.signature, ERR_LOCAL_APP_FAILURE, d);
+        return ERR_LOCAL_APP_FAILURE;
+    }
+
+    utils::filesystem::remove_path(dir);
+
+    ddebug("%s: mutation %s committed, bulk load with signature %" PRId64 " ingested, %d files",
+        _replica->name(), mu->name(), request.signature, (int)request.files.size());
+
+    _replica->on_bulk_load_ingested(request.signature, ERR_OK, d);
+    _replica->update_commit_statistics(1);
+    _app_commit_decree.increment();
+    _app_commit_throughput.add(1);
+    _app_commit_latency.set(latency);
+    _app_req_throughput.add(1);
+
+    return ERR_OK;
+}
+
 ::dsn::error_code replication_app_base::update_init_info(
     replica* r, 
     int64_t shared_log_offset, 
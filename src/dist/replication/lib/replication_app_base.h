@@ -164,6 +164,15 @@ public:
     // 
     ::dsn::error_code apply_checkpoint(dsn_chkpt_apply_mode mode, const learn_state& state);
 
+    //
+    // tell the app which key hashes it serves, see dsn_app_set_partition_count
+    //
+    void set_partition_count(int partition_count)
+    {
+        if (_app_context_callbacks && _callbacks.calls.set_partition_count)
+            _callbacks.calls.set_partition_count(_app_context_callbacks, partition_count);
+    }
+
     //
     // Query methods.
     //    
@@ -191,6 +200,7 @@ private:
     ::dsn::error_code open_internal(replica* r);
     ::dsn::error_code open_new_internal(replica* r, int64_t shared_log_start, int64_t private_log_start);
     ::dsn::error_code write_internal(mutation_ptr& mu);
+    ::dsn::error_code write_bulk_load(mutation_ptr& mu);
 
     const replica_init_info& init_info() const { return _info; }
     ::dsn::error_code update_init_info(
@@ -34,6 +34,8 @@
  */
 
 #include <algorithm>
+#include <queue>
+#include <climits>
 #include "greedy_load_balancer.h"
 
 # ifdef __TITLE__
@@ -43,6 +45,19 @@
 
 namespace dsn { namespace replication {
 
+greedy_load_balancer::greedy_load_balancer(meta_service* svc):
+    simple_load_balancer(svc),
+    _max_round_ms(svc != nullptr ? svc->get_meta_options().load_balancer_max_round_ms : 0),
+    _round_start_ms(0)
+{
+}
+
+// a round goes on till something is planned, as no proposal means balanced to the caller
+bool greedy_load_balancer::round_timed_out() const
+{
+    return _max_round_ms > 0 && !_migration->empty() && dsn_now_ms() - _round_start_ms >= _max_round_ms;
+}
+
 std::shared_ptr<configuration_balancer_request> greedy_load_balancer::generate_balancer_request(
     const partition_configuration &pc,
     const balance_type &type,
@@ -73,163 +88,326 @@ std::shared_ptr<configuration_balancer_request> greedy_load_balancer::generate_b
     return std::make_shared<configuration_balancer_request>(std::move(result));
 }
 
-void greedy_load_balancer::greedy_move_primary(const std::vector<rpc_address> &node_list, const std::vector<int> &prev, int flows)
+// depth first search along the levels for a path from source to a node taking
+// primaries, with an explicit stack as a path may be as long as the node count;
+// the primaries switched along the path are planned once it is found
+bool greedy_load_balancer::find_path(int source)
 {
-    dinfo("%u primaries are flew", flows);
-    int current = prev[node_list.size() - 1];
-    while (prev[current] != 0)
+    _path.clear();
+    _path.push_back(path_step{source, 0});
+    while (!_path.empty())
     {
-        rpc_address from = node_list[prev[current]];
-        rpc_address to = node_list[current];
-        int primaries_need_to_move = flows;
-        walk_through_primary(*_view, from, [&, this](const partition_configuration &pc)
+        int node = _path.back().node;
+        if (_excess[node] < 0)
         {
-            if (0 == primaries_need_to_move)
-                return false;
-            for (const rpc_address& addr: pc.secondaries)
+            ++_excess[node];
+            for (size_t k = _path.size() - 1; k > 0; --k)
+            {
+                int from = _path[k - 1].node, to = _path[k].node;
+                const partition_configuration* pc = _primaries[from][_next_primary[from]];
+                dinfo("plan to move primary, gpid(%d.%d), from(%s), to(%s)", pc->pid.get_app_id(), pc->pid.get_partition_index(),
+                      _node_list[from].to_string(), _node_list[to].to_string());
+                _migration->emplace_back( generate_balancer_request(*pc, balance_type::move_primary, _node_list[from], _node_list[to]) );
+                _planned.insert(pc->pid);
+                --_primary_count[from];
+                ++_primary_count[to];
+                ++_next_primary[from];
+            }
+            return true;
+        }
+
+        // the next secondary of a primary not planned yet one level down, a node
+        // found to reach nothing is left at level -1 so it is skipped from then on
+        std::vector<const partition_configuration*>& primaries = _primaries[node];
+        size_t& secondary = _path.back().secondary;
+        int next = -1;
+        for (size_t& i = _next_primary[node]; i < primaries.size(); ++i, secondary = 0)
+        {
+            const partition_configuration* pc = primaries[i];
+            if (_planned.find(pc->pid) != _planned.end())
+                continue;
+
+            for (; secondary < pc->secondaries.size(); ++secondary)
             {
-                if (addr == to)
+                auto it = _node_id.find(pc->secondaries[secondary]);
+                if (it != _node_id.end() && _level[it->second] == _level[node] + 1)
                 {
-                    dinfo("plan to move primary, gpid(%d.%d), from(%s), to(%s)", pc.pid.get_app_id(), pc.pid.get_partition_index(),
-                          from.to_string(), to.to_string());
-                    _migration->emplace_back( generate_balancer_request(pc, balance_type::move_primary, from, to) );
-                    --primaries_need_to_move;
+                    next = it->second;
                     break;
                 }
             }
-            return true;
-        });
-        current = prev[current];
+            if (next != -1)
+                break;
+        }
+
+        if (next != -1)
+        {
+            _path.push_back(path_step{next, 0});
+            continue;
+        }
+
+        // nothing is reachable from here in this phase
+        _level[node] = -1;
+        _path.pop_back();
     }
+    return false;
 }
 
-//assume all nodes are alive
-void greedy_load_balancer::greedy_copy_primary()
+// move primaries to their secondaries, along the paths from the nodes with too many
+// primaries to those with too few; like Dinic's max flow, each phase levels the nodes
+// by a breadth first search from all the givers, and then takes as many shortest
+// paths as possible, so a round costs O(P) per phase instead of O(V*V) per path
+int greedy_load_balancer::greedy_move_primary()
 {
-    std::unordered_map<dsn::rpc_address, int> changing_primaries;
-    for (auto iter=_view->nodes->begin(); iter!=_view->nodes->end(); ++iter)
-        changing_primaries[iter->first] = iter->second.primaries.size();
+    int replicas_low = total_partitions/alive_nodes;
+    int replicas_high = (total_partitions+alive_nodes-1)/alive_nodes;
+
+    _primaries.assign(alive_nodes + 1, std::vector<const partition_configuration*>());
+    for (int i = 1; i <= alive_nodes; ++i)
+    {
+        walk_through_primary(*_view, _node_list[i], [&, this](const partition_configuration& pc)
+        {
+            _primaries[i].push_back(&pc);
+            return true;
+        });
+    }
 
-    std::set<dsn::rpc_address, node_comparator> pri_queue([&changing_primaries](const dsn::rpc_address& r1, const dsn::rpc_address& r2)
+    int moves = 0;
+    while (true)
     {
-        int c1 = changing_primaries[r1], c2 = changing_primaries[r2];
-        if (c1 != c2)
-            return c1<c2;
-        return r1<r2;
-    });
-
-    for (auto iter=_view->nodes->begin(); iter!=_view->nodes->end(); ++iter) {
-        pri_queue.insert(iter->first);
+        // nodes above high give to those below high, and nodes above low give to
+        // those below low, so each path narrows the gap between its two ends
+        int higher_count = 0, lower_count = 0;
+        for (int i = 1; i <= alive_nodes; ++i)
+        {
+            if (_primary_count[i] > replicas_high)
+                ++higher_count;
+            if (_primary_count[i] < replicas_low)
+                ++lower_count;
+        }
+        if (higher_count == 0 && lower_count == 0)
+            break;
+
+        int give_above = (higher_count > 0 ? replicas_high : replicas_low);
+        int take_below = (lower_count > 0 ? replicas_low : replicas_high);
+
+        _excess.assign(alive_nodes + 1, 0);
+        _level.assign(alive_nodes + 1, -1);
+        _next_primary.assign(alive_nodes + 1, 0);
+
+        std::queue<int> q;
+        for (int i = 1; i <= alive_nodes; ++i)
+        {
+            if (_primary_count[i] > give_above)
+            {
+                _excess[i] = _primary_count[i] - give_above;
+                _level[i] = 0;
+                q.push(i);
+            }
+            else if (_primary_count[i] < take_below)
+                _excess[i] = _primary_count[i] - take_below;
+        }
+
+        bool reachable = false;
+        while (!q.empty())
+        {
+            int u = q.front();
+            q.pop();
+            if (_excess[u] < 0)
+            {
+                reachable = true;
+                continue;
+            }
+            for (const partition_configuration* pc: _primaries[u])
+            {
+                if (_planned.find(pc->pid) != _planned.end())
+                    continue;
+                for (const rpc_address& addr: pc->secondaries)
+                {
+                    auto it = _node_id.find(addr);
+                    if (it != _node_id.end() && _level[it->second] == -1)
+                    {
+                        _level[it->second] = _level[u] + 1;
+                        q.push(it->second);
+                    }
+                }
+            }
+        }
+
+        if (!reachable)
+            break;
+
+        int phase_moves = 0;
+        for (int i = 1; i <= alive_nodes && !round_timed_out(); ++i)
+        {
+            while (_excess[i] > 0 && _level[i] == 0)
+            {
+                size_t planned = _migration->size();
+                if (!find_path(i))
+                    break;
+                phase_moves += static_cast<int>(_migration->size() - planned);
+                --_excess[i];
+            }
+        }
+
+        // the taking ends of the paths are only known from the counts
+        if (phase_moves == 0)
+            break;
+        moves += phase_moves;
+        dinfo("%d primaries are moved in this phase", phase_moves);
+
+        if (round_timed_out())
+        {
+            ddebug("stop moving primaries after %d moves, for the round takes too long", moves);
+            break;
+        }
     }
+    return moves;
+}
 
+// assume all nodes are alive, and the nodes left unbalanced by the primary switches
+// get a primary copied from the most loaded ones
+void greedy_load_balancer::greedy_copy_primary()
+{
     int replicas_low = total_partitions/alive_nodes;
     int replicas_high = (total_partitions+alive_nodes-1)/alive_nodes;
 
+    // <primary count, node id>
+    std::set<std::pair<int, int>> pri_queue;
+    for (int i = 1; i <= alive_nodes; ++i)
+        pri_queue.emplace(_primary_count[i], i);
+
     node_mapper& nodes = *(_view->nodes);
-    while ( changing_primaries[*pri_queue.begin()]<replicas_low || changing_primaries[*pri_queue.rbegin()]>replicas_high )
+    while ( pri_queue.size() > 1 && (pri_queue.begin()->first < replicas_low || pri_queue.rbegin()->first > replicas_high) )
     {
-        dsn::rpc_address min_load = *pri_queue.begin();
-        dsn::rpc_address max_load = *pri_queue.rbegin();
+        if (round_timed_out())
+            break;
 
+        int min_id = pri_queue.begin()->second;
+        int max_id = pri_queue.rbegin()->second;
+        if (_primary_count[max_id] - _primary_count[min_id] < 2)
+            break;
+
+        const dsn::rpc_address& min_load = _node_list[min_id];
+        const dsn::rpc_address& max_load = _node_list[max_id];
         dinfo("server with min/max load: %s have %d/%s have %d",
-            min_load.to_string(), changing_primaries[min_load], max_load.to_string(), changing_primaries[max_load]);
+            min_load.to_string(), _primary_count[min_id], max_load.to_string(), _primary_count[max_id]);
 
         pri_queue.erase(pri_queue.begin());
         pri_queue.erase(--pri_queue.end());
 
-        dassert(min_load!=max_load, "min load and max load machines shouldn't the same");
-
-        //currently we simply random copy one primary from one machine to another
+        //currently we simply copy the first primary without replica on min_load
         //TODO: a better policy is necessary if considering the copying cost
-        const dsn::gpid& gpid = *(nodes[max_load].primaries.begin());
-        const partition_configuration& pc = *get_config(*(_view->apps), gpid);
+        const partition_configuration* pc = nullptr;
+        for (const dsn::gpid& gpid: nodes[max_load].primaries)
+        {
+            if (_planned.find(gpid) != _planned.end())
+                continue;
+            const partition_configuration* c = get_config(*(_view->apps), gpid);
+            if (c != nullptr && !is_member(*c, min_load))
+            {
+                pc = c;
+                break;
+            }
+        }
 
-        //we run greedy_copy_primary after we run the greedy_move_primary. If a secondary exist on min_load,
-        //we are able to do the move_primary in greedy_move_primary
-        dassert( std::find(pc.secondaries.begin(), pc.secondaries.end(), min_load)==pc.secondaries.end(), "");
+        if (pc == nullptr)
+        {
+            //max_load has no primary to give min_load, so it is left out
+            pri_queue.emplace(_primary_count[min_id], min_id);
+            continue;
+        }
 
-        _migration->emplace_back( generate_balancer_request(pc, balance_type::copy_primary, max_load, min_load) );
-        dinfo("copy gpid(%d:%d) primary from %s to %s", gpid.get_app_id(), gpid.get_partition_index(), max_load.to_string(), min_load.to_string());
+        _migration->emplace_back( generate_balancer_request(*pc, balance_type::copy_primary, max_load, min_load) );
+        _planned.insert(pc->pid);
+        dinfo("copy gpid(%d:%d) primary from %s to %s", pc->pid.get_app_id(), pc->pid.get_partition_index(), max_load.to_string(), min_load.to_string());
 
         //adjust the priority queue
-        ++changing_primaries[min_load];
-        pri_queue.insert(min_load);
+        ++_primary_count[min_id];
+        --_primary_count[max_id];
+        pri_queue.emplace(_primary_count[min_id], min_id);
+        pri_queue.emplace(_primary_count[max_id], max_id);
     }
 }
 
-//TODO: a better secondary balancer policy
+//copy secondaries from the nodes with the most replicas to those with the least,
+//a copy is taken only if it narrows the gap between the two nodes
 void greedy_load_balancer::greedy_copy_secondary()
 {
     int total_replicas = 0;
-    for (auto iter=_view->nodes->begin(); iter!=_view->nodes->end(); ++iter)
-    {
-        const node_state& state = iter->second;
-        if ( state.is_alive )
-            total_replicas += state.partitions.size();
-    }
+    for (int i = 1; i <= alive_nodes; ++i)
+        total_replicas += (*(_view->nodes))[_node_list[i]].partitions.size();
 
     int replicas_low = total_replicas/alive_nodes;
     int replicas_high = (total_replicas+alive_nodes-1)/alive_nodes;
 
-    std::unordered_map<dsn::rpc_address, int> changing_secondaries;
-    int maximum_secondaries = 0;
-    dsn::rpc_address output_server;
-    std::vector<node_state*> input_server;
-
-    node_mapper& nodes = *(_view->nodes);
-    for (auto iter=nodes.begin(); iter!=nodes.end(); ++iter)
+    // <replica count, node id>
+    std::vector<int> replica_count(alive_nodes + 1, 0);
+    std::set<std::pair<int, int>> rep_queue;
+    for (int i = 1; i <= alive_nodes; ++i)
     {
-        if ( iter->second.is_alive ) {
-            int l = iter->second.partitions.size();
-            changing_secondaries[iter->first] = l;
-            if (l > maximum_secondaries) {
-                maximum_secondaries = l;
-                output_server = iter->first;
-            }
-            if (l < replicas_low)
-                input_server.push_back( &(iter->second) );
-        }
+        replica_count[i] = (*(_view->nodes))[_node_list[i]].partitions.size();
+        rep_queue.emplace(replica_count[i], i);
     }
 
-    if (maximum_secondaries <= replicas_high)
+    if (rep_queue.rbegin()->first <= replicas_high && rep_queue.begin()->first >= replicas_low)
     {
         dinfo("secondaries is balanced, just ignore");
         return;
     }
 
-    walk_through_partitions(*_view, output_server, [&, this](const partition_configuration& pc)
+    node_mapper& nodes = *(_view->nodes);
+    for (int from = 1; from <= alive_nodes && !round_timed_out(); ++from)
     {
-        if (pc.primary == output_server)
-            return true;
-        if (maximum_secondaries <= replicas_high)
-            return false;
+        if (replica_count[from] <= replicas_low)
+            continue;
 
-        for (node_state* ns: input_server)
+        const rpc_address& from_addr = _node_list[from];
+        walk_through_partitions(*_view, from_addr, [&, this](const partition_configuration& pc)
         {
-            if ( changing_secondaries[ns->address] < replicas_low && ns->partitions.find(pc.pid)==ns->partitions.end() )
-            {
-                ++changing_secondaries[ns->address];
-                --maximum_secondaries;
-                dinfo("plan to cp secondary: gpid(%d.%d), from(%s), to(%s)", pc.pid.get_app_id(), pc.pid.get_partition_index(),
-                      output_server.to_string(), ns->address.to_string());
-                _migration->emplace_back( generate_balancer_request(pc, balance_type::copy_secondary, output_server, ns->address) );
-                break;
-            }
-        }
-        return true;
-    });
+            int& count = replica_count[from];
+            if (count <= replicas_low)
+                return false;
+            if (pc.primary == from_addr || _planned.find(pc.pid) != _planned.end())
+                return true;
+
+            //the least loaded node without a replica of pc
+            auto to = rep_queue.begin();
+            while (to != rep_queue.end() && nodes[_node_list[to->second]].partitions.find(pc.pid) != nodes[_node_list[to->second]].partitions.end())
+                ++to;
+            if (to == rep_queue.end())
+                return true;
+
+            int c = to->first;
+            if (!((count > replicas_high && c < replicas_high) || c < replicas_low))
+                return true;
+
+            int to_id = to->second;
+            dinfo("plan to cp secondary: gpid(%d.%d), from(%s), to(%s)", pc.pid.get_app_id(), pc.pid.get_partition_index(),
+                  from_addr.to_string(), _node_list[to_id].to_string());
+            _migration->emplace_back( generate_balancer_request(pc, balance_type::copy_secondary, from_addr, _node_list[to_id]) );
+            _planned.insert(pc.pid);
+
+            rep_queue.erase(to);
+            rep_queue.erase(std::make_pair(count, from));
+            ++replica_count[to_id];
+            --count;
+            rep_queue.emplace(replica_count[to_id], to_id);
+            rep_queue.emplace(count, from);
+            return true;
+        });
+    }
 }
 
-// load balancer based on ford-fulkerson
 void greedy_load_balancer::greedy_balancer()
 {
     dassert(alive_nodes>2, "too few alive nodes will lead to freeze");
 
     const node_mapper& nodes = *(_view->nodes);
-    size_t graph_nodes = alive_nodes + 2;
-    std::vector< std::vector<int> > network(graph_nodes, std::vector<int>(graph_nodes, 0));
-    std::unordered_map<dsn::rpc_address, int> node_id;
-    std::vector<dsn::rpc_address> node_list(graph_nodes);
+    _node_list.assign(alive_nodes + 2, dsn::rpc_address());
+    _node_id.clear();
+    _primary_count.assign(alive_nodes + 2, 0);
+    _planned.clear();
 
     // assign id for nodes
     int current_id = 1;
@@ -238,40 +416,20 @@ void greedy_load_balancer::greedy_balancer()
         dassert(!iter->first.is_invalid() &&
             !iter->second.address.is_invalid() &&
             iter->second.is_alive, "nodes(%s) not alive shouldn't here", iter->second.address.to_string());
-        node_id[ iter->first ] = current_id;
-        node_list[ current_id ] = iter->first;
+        _node_id[ iter->first ] = current_id;
+        _node_list[ current_id ] = iter->first;
+        _primary_count[ current_id ] = iter->second.primaries.size();
         ++current_id;
     }
 
     int replicas_low = total_partitions/alive_nodes;
     int replicas_high = (total_partitions+alive_nodes-1)/alive_nodes;
     int lower_count = 0, higher_count = 0;
-
-    // make graph
-    for (auto iter=nodes.begin(); iter!=nodes.end(); ++iter)
+    for (int i = 1; i <= alive_nodes; ++i)
     {
-        dassert(iter->second.is_alive, "");
-        dassert(node_id.find(iter->first) != node_id.end(), "");
-        int from = node_id[iter->first];
-        walk_through_primary(*_view, iter->first, [&, this](const partition_configuration& replica_in_primary){
-            for (auto& target: replica_in_primary.secondaries)
-            {
-                auto i = node_id.find(target);
-                dassert(i != node_id.end(), "");
-                network[from][ i->second ]++;
-            }
-            return true;
-        } );
-
-        int primaries_count = iter->second.primaries.size();
-        if (primaries_count > replicas_low)
-            network[0][from] = primaries_count - replicas_low;
-        else
-            network[from][graph_nodes - 1] = replicas_low - primaries_count;
-
-        if (primaries_count > replicas_high)
+        if (_primary_count[i] > replicas_high)
             higher_count++;
-        if (primaries_count < replicas_low)
+        if (_primary_count[i] < replicas_low)
             lower_count++;
     }
 
@@ -281,53 +439,11 @@ void greedy_load_balancer::greedy_balancer()
         greedy_copy_secondary();
         return;
     }
-    else if (higher_count>0 && lower_count==0)
-    {
-        for (int i=0; i!=graph_nodes; ++i){
-            if (network[0][i] > 0)
-                --network[0][i];
-            else
-                ++network[i][graph_nodes - 1];
-        }
-    }
-    ddebug("start to move primary");
-    std::vector<bool> visit(graph_nodes, false);
-    std::vector<int> flow(graph_nodes, 0);
-    std::vector<int> prev(graph_nodes, -1);
-    int pos, max_value;
-    flow[0] = INT_MAX;
-
-    while ( !visit[graph_nodes - 1] )
-    {
-        pos = -1, max_value = 0;
-        for (int i=0; i!=graph_nodes; ++i)
-        {
-            if (visit[i]==false && flow[i]>max_value)
-            {
-                pos = i;
-                max_value = flow[i];
-            }
-        }
-
-        if (pos == -1)
-            break;
-
-        visit[pos] = true;
-        for (int i=0; i!=graph_nodes; ++i)
-        {
-            if (!visit[i] && std::min(flow[pos], network[pos][i])>flow[i])
-            {
-                flow[i] = std::min(flow[pos], network[pos][i]);
-                prev[i] = pos;
-            }
-        }
-    }
 
-    //we can't make the server load more balanced by moving primaries to secondaries
-    if (!visit[graph_nodes - 1] || flow[graph_nodes - 1]==0)
+    ddebug("start to move primary");
+    //copy primaries only if no more can be balanced by the switches, which copy no data
+    if (greedy_move_primary() == 0)
         greedy_copy_primary();
-    else
-        greedy_move_primary(node_list, prev, flow[graph_nodes-1]);
 }
 
 bool greedy_load_balancer::balance(const meta_view &view, migration_list &list)
@@ -339,6 +455,7 @@ bool greedy_load_balancer::balance(const meta_view &view, migration_list &list)
     _view = &view;
     _migration = &list;
     _migration->clear();
+    _round_start_ms = dsn_now_ms();
     greedy_balancer();
     return !_migration->empty();
 }
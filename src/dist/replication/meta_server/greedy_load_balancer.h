@@ -26,7 +26,7 @@
 
 /*
  * Description:
- *     A greedy load balancer based on Dijkstra & Ford-Fulkerson
+ *     A greedy load balancer based on the blocking flows of Dinic's max flow
  *
  * Revision history:
  *     2016-02-03, Weijie Sun, first version
@@ -35,6 +35,8 @@
 # pragma once
 
 # include <functional>
+# include <unordered_map>
+# include <unordered_set>
 # include "server_load_balancer.h"
 
 namespace dsn { namespace replication {
@@ -42,31 +44,62 @@ namespace dsn { namespace replication {
 class greedy_load_balancer: public simple_load_balancer
 {
 public:
-    greedy_load_balancer(meta_service* svc): simple_load_balancer(svc) {}
+    greedy_load_balancer(meta_service* svc);
     bool balance(const meta_view &view, migration_list &list) override;
+    void set_max_round_ms(uint64_t ms) { _max_round_ms = ms; }
 
-private:
+protected:
     enum class balance_type
     {
         move_primary,
         copy_primary,
         copy_secondary
     };
+    std::shared_ptr<configuration_balancer_request> generate_balancer_request(
+        const partition_configuration& pc,
+        const balance_type& type,
+        const rpc_address& from,
+        const rpc_address& to);
+
+private:
     const meta_view* _view;
     migration_list* _migration;
     int total_partitions;
     int alive_nodes;
 
+    // alive nodes are numbered from 1 to alive_nodes
+    std::vector<dsn::rpc_address> _node_list;
+    std::unordered_map<dsn::rpc_address, int> _node_id;
+    // primary count of each node, with the planned moves applied
+    std::vector<int> _primary_count;
+    // a partition is moved at most once in a round
+    std::unordered_set<dsn::gpid> _planned;
+
+    // for the path search of greedy_move_primary, indexed by node id
+    std::vector< std::vector<const partition_configuration*> > _primaries;
+    std::vector<int> _excess; // primaries to give if positive, to take if negative
+    std::vector<int> _level;
+    std::vector<size_t> _next_primary;
+    // the nodes on the path being searched, each with the secondary it tries next
+    struct path_step
+    {
+        int node;
+        size_t secondary;
+    };
+    std::vector<path_step> _path;
+
+    // balance() runs under the lock of the server state, so a round stops planning
+    // once it takes this long, the rest is left to the next rounds; 0 for no limit
+    uint64_t _max_round_ms;
+    uint64_t _round_start_ms;
+
 private:
+    bool round_timed_out() const;
     void greedy_balancer();
-    void greedy_move_primary(const std::vector<dsn::rpc_address>& node_list, const std::vector<int>& prev, int flows);
+    int greedy_move_primary();
+    bool find_path(int node);
     void greedy_copy_secondary();
     void greedy_copy_primary();
-    std::shared_ptr<configuration_balancer_request> generate_balancer_request(
-        const partition_configuration& pc,
-        const balance_type& type,
-        const rpc_address& from,
-        const rpc_address& to);
 };
 
 }}
@@ -0,0 +1,287 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     A load balancer which minimizes the max weighted load of the nodes
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+#include <algorithm>
+#include "load_aware_balancer.h"
+
+# ifdef __TITLE__
+# undef __TITLE__
+# endif
+# define __TITLE__ "lb.load_aware"
+
+namespace dsn { namespace replication {
+
+load_aware_balancer::load_aware_balancer(meta_service* svc): greedy_load_balancer(svc)
+{
+    if (svc != nullptr)
+    {
+        const meta_options& opts = svc->get_meta_options();
+        _qps_weight = opts.load_balancer_qps_weight;
+        _bytes_weight = opts.load_balancer_bytes_weight;
+        _disk_weight = opts.load_balancer_disk_weight;
+        _count_weight = opts.load_balancer_count_weight;
+        _move_budget = opts.load_balancer_move_budget;
+        _tolerance_percentage = opts.load_balancer_tolerance_percentage;
+    }
+    else
+    {
+        _qps_weight = 1.0;
+        _bytes_weight = 0.5;
+        _disk_weight = 0.5;
+        _count_weight = 0.5;
+        _move_budget = 4;
+        _tolerance_percentage = 10;
+    }
+}
+
+void load_aware_balancer::report_load(const rpc_address& node, const std::vector<replica_load>& loads)
+{
+    std::unordered_map<dsn::gpid, replica_load> replicas;
+    for (const replica_load& load: loads)
+        replicas[load.pid] = load;
+
+    zauto_lock l(_lock);
+    _reported_loads[node] = std::move(replicas);
+}
+
+bool load_aware_balancer::calculate_loads(const meta_view& view, /*out*/ std::vector<node_load>& nodes)
+{
+    zauto_lock l(_lock);
+
+    // requests only go to the primary, so the serving load of a partition is the
+    // largest one reported by its replicas, which is then put on the current primary;
+    // reports of replicas moved away from the reporting node are ignored
+    std::unordered_map<dsn::gpid, replica_load> serving;
+    double sum_disk = 0;
+    int disk_count = 0;
+    for (auto& n: *(view.nodes))
+    {
+        auto it = _reported_loads.find(n.first);
+        if (!n.second.is_alive || it == _reported_loads.end())
+            continue;
+
+        for (auto& r: it->second)
+        {
+            if (n.second.partitions.find(r.first) == n.second.partitions.end())
+                continue;
+            replica_load& s = serving[r.first];
+            s.qps = std::max(s.qps, r.second.qps);
+            s.bytes_per_second = std::max(s.bytes_per_second, r.second.bytes_per_second);
+            sum_disk += r.second.disk_usage_mb;
+            ++disk_count;
+        }
+    }
+
+    if (disk_count == 0)
+        return false;
+
+    double sum_qps = 0, sum_bytes = 0;
+    for (auto& s: serving)
+    {
+        sum_qps += s.second.qps;
+        sum_bytes += s.second.bytes_per_second;
+    }
+    double avg_qps = sum_qps / serving.size();
+    double avg_bytes = sum_bytes / serving.size();
+    double avg_disk = sum_disk / disk_count;
+
+    auto weigh = [](double value, double avg, double weight)
+    {
+        return avg > 0 ? weight * value / avg : 0;
+    };
+
+    // replicas not reported yet are taken as average ones
+    weighted_load average = {
+        (avg_qps > 0 ? _qps_weight : 0) + (avg_bytes > 0 ? _bytes_weight : 0),
+        (avg_disk > 0 ? _disk_weight : 0) + _count_weight
+    };
+
+    nodes.clear();
+    for (auto& n: *(view.nodes))
+    {
+        if (!n.second.is_alive)
+            continue;
+
+        nodes.push_back(node_load{ n.first, 0, {} });
+        node_load& nl = nodes.back();
+        auto reported = _reported_loads.find(n.first);
+        for (const dsn::gpid& pid: n.second.partitions)
+        {
+            weighted_load wl = average;
+            if (n.second.primaries.find(pid) == n.second.primaries.end())
+            {
+                wl.serving = 0;
+            }
+            else
+            {
+                auto s = serving.find(pid);
+                if (s != serving.end())
+                    wl.serving = weigh(s->second.qps, avg_qps, _qps_weight) + weigh(s->second.bytes_per_second, avg_bytes, _bytes_weight);
+            }
+
+            if (reported != _reported_loads.end())
+            {
+                auto r = reported->second.find(pid);
+                if (r != reported->second.end())
+                    wl.stored = weigh(r->second.disk_usage_mb, avg_disk, _disk_weight) + _count_weight;
+            }
+
+            nl.replicas[pid] = wl;
+            nl.total += wl.serving + wl.stored;
+        }
+    }
+    return true;
+}
+
+// move load off the most loaded node, trying the primary switches first as they copy no data
+bool load_aware_balancer::plan_one_move(
+    const meta_view& view,
+    std::vector<node_load>& nodes,
+    std::set<dsn::gpid>& planned,
+    /*out*/ migration_list& list)
+{
+    double sum = 0;
+    for (node_load& nl: nodes)
+        sum += nl.total;
+    double average = sum / nodes.size();
+
+    node_load& from = *std::max_element(nodes.begin(), nodes.end(),
+        [](const node_load& l, const node_load& r) { return l.total < r.total; });
+    if (from.total <= average * (100 + _tolerance_percentage) / 100.0)
+    {
+        dinfo("max load %.2f on %s is within the tolerance, average = %.2f", from.total, from.address.to_string(), average);
+        return false;
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const partition_configuration* best_pc = nullptr;
+        node_load* best_to = nullptr;
+        balance_type best_type = balance_type::move_primary;
+        double best_delta = 0;
+        double best_peak = from.total;
+
+        for (auto& r: from.replicas)
+        {
+            if (planned.find(r.first) != planned.end())
+                continue;
+            const partition_configuration* pc = get_config(*(view.apps), r.first);
+            if (pc == nullptr)
+                continue;
+
+            bool is_primary = (pc->primary == from.address);
+            if (pass == 0 && !is_primary)
+                continue;
+
+            for (node_load& to: nodes)
+            {
+                if (&to == &from)
+                    continue;
+
+                bool is_secondary = std::find(pc->secondaries.begin(), pc->secondaries.end(), to.address) != pc->secondaries.end();
+                balance_type type;
+                double delta;
+                if (pass == 0)
+                {
+                    if (!is_secondary)
+                        continue;
+                    type = balance_type::move_primary;
+                    delta = r.second.serving;
+                }
+                else
+                {
+                    if (is_secondary || to.replicas.find(r.first) != to.replicas.end())
+                        continue;
+                    type = is_primary ? balance_type::copy_primary : balance_type::copy_secondary;
+                    delta = is_primary ? r.second.serving + r.second.stored : r.second.stored;
+                }
+
+                double peak = std::max(from.total - delta, to.total + delta);
+                if (delta > 0 && peak < best_peak)
+                {
+                    best_pc = pc;
+                    best_to = &to;
+                    best_type = type;
+                    best_delta = delta;
+                    best_peak = peak;
+                }
+            }
+        }
+
+        if (best_pc != nullptr)
+        {
+            ddebug("plan to %s gpid(%d.%d) from %s(%.2f) to %s(%.2f), load %.2f",
+                best_type == balance_type::move_primary ? "move primary" : "copy",
+                best_pc->pid.get_app_id(), best_pc->pid.get_partition_index(),
+                from.address.to_string(), from.total, best_to->address.to_string(), best_to->total, best_delta);
+
+            list.emplace_back( generate_balancer_request(*best_pc, best_type, from.address, best_to->address) );
+            planned.insert(best_pc->pid);
+            from.total -= best_delta;
+            best_to->total += best_delta;
+            return true;
+        }
+    }
+
+    dinfo("no move lowers the load %.2f of %s", from.total, from.address.to_string());
+    return false;
+}
+
+bool load_aware_balancer::balance(const meta_view &view, migration_list &list)
+{
+    list.clear();
+
+    std::vector<node_load> nodes;
+    if (!calculate_loads(view, nodes))
+    {
+        dinfo("no replica load is reported yet, balance by replica counts");
+        return greedy_load_balancer::balance(view, list);
+    }
+
+    if (nodes.size() < 2)
+        return false;
+
+    // each partition is moved at most once in a round, so the replicas of the
+    // planned ones are not updated in nodes
+    std::set<dsn::gpid> planned;
+    for (uint64_t i = 0; i < _move_budget; ++i)
+    {
+        if (!plan_one_move(view, nodes, planned, list))
+            break;
+    }
+    return !list.empty();
+}
+
+}}
@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Microsoft Corporation
+ *
+ * -=- Robust Distributed System Nucleus (rDSN) -=-
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Description:
+ *     A load balancer which minimizes the max weighted load of the nodes
+ *
+ *     the load of a replica is the weighted sum of its request qps, request bytes
+ *     and disk usage, each divided by its average over the replicas, plus a constant
+ *     weight for the replica itself; the qps and bytes part moves with the primary,
+ *     while the rest moves only with the data. in each round, up to move_budget
+ *     moves are planned greedily, each being the one which brings the most loaded
+ *     node down the most without raising the target above it
+ *
+ * Revision history:
+ *     xxxx-xx-xx, author, first version
+ *     xxxx-xx-xx, author, fix bug about xxx
+ */
+
+# pragma once
+
+# include <unordered_map>
+# include "greedy_load_balancer.h"
+
+namespace dsn { namespace replication {
+
+class load_aware_balancer: public greedy_load_balancer
+{
+public:
+    load_aware_balancer(meta_service* svc);
+    bool balance(const meta_view &view, migration_list &list) override;
+    void report_load(const rpc_address& node, const std::vector<replica_load>& loads) override;
+
+private:
+    struct weighted_load
+    {
+        double serving; // follows the primary
+        double stored;  // follows the data
+    };
+
+    struct node_load
+    {
+        rpc_address address;
+        double total;
+        std::unordered_map<dsn::gpid, weighted_load> replicas;
+    };
+
+    // returns false when no load is reported yet
+    bool calculate_loads(const meta_view& view, /*out*/ std::vector<node_load>& nodes);
+    bool plan_one_move(
+        const meta_view& view,
+        std::vector<node_load>& nodes,
+        std::set<dsn::gpid>& planned,
+        /*out*/ migration_list& list);
+
+private:
+    double   _qps_weight;
+    double   _bytes_weight;
+    double   _disk_weight;
+    double   _count_weight;
+    uint64_t _move_budget;
+    uint64_t _tolerance_percentage;
+
+    ::dsn::service::zlock _lock;
+    std::unordered_map<rpc_address, std::unordered_map<dsn::gpid, replica_load>> _reported_loads;
+};
+
+}}
@@ -117,4 +117,25 @@ std::shared_ptr<app_state> app_state::create(const app_info& info)
     return result;
 }
 
+dsn::blob encode_partition_configuration(const partition_configuration& pc)
+{
+    binary_writer writer;
+    dsn::marshall(writer, pc, DSF_THRIFT_BINARY);
+    return writer.get_buffer();
+}
+
+bool decode_partition_configuration(const dsn::blob& value, /*out*/ partition_configuration& pc)
+{
+    if (value.length() == 0)
+        return false;
+
+    // a thrift binary struct starts with the type of its first field, never with '{'
+    if (value.data()[0] == '{')
+        return dsn::json::json_forwarder<partition_configuration>::decode(value, pc);
+
+    binary_reader reader(value);
+    dsn::unmarshall(reader, pc, DSF_THRIFT_BINARY);
+    return true;
+}
+
 }}
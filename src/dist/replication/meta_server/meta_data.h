@@ -129,8 +129,9 @@ public:
     app_state* owner;
     std::atomic_int available_partitions;
     std::vector<config_context> contexts;
+    bool app_info_syncing; // the app info is being written to the remote storage
 public:
-    app_state_helper(): owner(nullptr), available_partitions(0)
+    app_state_helper(): owner(nullptr), available_partitions(0), app_info_syncing(false)
     {
         contexts.clear();
     }
@@ -235,6 +236,11 @@ inline int count_partitions(const app_mapper& apps)
 
 void maintain_drops(/*inout*/ std::vector<rpc_address>& drops, const rpc_address& node, bool is_add);
 
+// partition configurations are stored on the remote storage in thrift binary,
+// those written in json by former versions are still accepted on decoding
+dsn::blob encode_partition_configuration(const partition_configuration& pc);
+bool decode_partition_configuration(const dsn::blob& value, /*out*/ partition_configuration& pc);
+
 }}
 
 namespace dsn { namespace json {
@@ -101,6 +101,97 @@ void meta_options::initialize()
         3,
         "minimum live node count without which the state is freezed"
         );
+
+    config_sync_batch_interval_ms = dsn_config_get_value_uint64(
+        "meta_server",
+        "config_sync_batch_interval_ms",
+        10,
+        "partition config updates issued within this interval are written to the remote storage in one transaction"
+        );
+
+    config_sync_batch_max_count = dsn_config_get_value_uint64(
+        "meta_server",
+        "config_sync_batch_max_count",
+        512,
+        "max partition config updates in one remote storage transaction"
+        );
+
+    config_change_log_size = dsn_config_get_value_uint64(
+        "meta_server",
+        "config_change_log_size",
+        100000,
+        "recent partition config changes kept for the incremental config sync of replica servers"
+        );
+
+    config_change_push_disabled = dsn_config_get_value_bool(
+        "meta_server",
+        "config_change_push_disabled",
+        false,
+        "whether not to notify replica servers of their config changes, so they only learn them by polling"
+        );
+
+    config_change_push_interval_ms = dsn_config_get_value_uint64(
+        "meta_server",
+        "config_change_push_interval_ms",
+        100,
+        "config changes within this interval are notified to a replica server at once"
+        );
+
+    partition_full_check_rounds = dsn_config_get_value_uint64(
+        "meta_server",
+        "partition_full_check_rounds",
+        30,
+        "all partitions are cured once in this many rounds, besides the dirty and unhealthy ones checked in each round; 0 for never"
+        );
+
+    load_balancer_qps_weight = dsn_config_get_value_double(
+        "meta_server",
+        "load_balancer_qps_weight",
+        1.0,
+        "weight of the request qps in the replica load of load_aware_balancer"
+        );
+
+    load_balancer_bytes_weight = dsn_config_get_value_double(
+        "meta_server",
+        "load_balancer_bytes_weight",
+        0.5,
+        "weight of the request bytes per second in the replica load of load_aware_balancer"
+        );
+
+    load_balancer_disk_weight = dsn_config_get_value_double(
+        "meta_server",
+        "load_balancer_disk_weight",
+        0.5,
+        "weight of the disk usage in the replica load of load_aware_balancer"
+        );
+
+    load_balancer_count_weight = dsn_config_get_value_double(
+        "meta_server",
+        "load_balancer_count_weight",
+        0.5,
+        "weight of the replica itself in the replica load of load_aware_balancer"
+        );
+
+    load_balancer_move_budget = dsn_config_get_value_uint64(
+        "meta_server",
+        "load_balancer_move_budget",
+        4,
+        "max replica moves proposed by load_aware_balancer in one round"
+        );
+
+    load_balancer_tolerance_percentage = dsn_config_get_value_uint64(
+        "meta_server",
+        "load_balancer_tolerance_percentage",
+        10,
+        "load_aware_balancer stops when the max node load is within this percentage above the average"
+        );
+
+    load_balancer_max_round_ms = dsn_config_get_value_uint64(
+        "meta_server",
+        "load_balancer_max_round_ms",
+        100,
+        "greedy_load_balancer stops planning a round under the server state lock after this long, 0 for no limit"
+        );
 }
 
 }}
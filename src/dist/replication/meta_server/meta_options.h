@@ -54,6 +54,23 @@ public:
     uint64_t replica_assign_delay_ms_for_dropouts;
     uint64_t node_live_percentage_threshold_for_update;
     uint64_t min_live_node_count_for_unfreeze;
+
+    uint64_t config_sync_batch_interval_ms;
+    uint64_t config_sync_batch_max_count;
+
+    uint64_t config_change_log_size;
+    bool     config_change_push_disabled;
+    uint64_t config_change_push_interval_ms;
+
+    uint64_t partition_full_check_rounds;
+
+    double   load_balancer_qps_weight;
+    double   load_balancer_bytes_weight;
+    double   load_balancer_disk_weight;
+    double   load_balancer_count_weight;
+    uint64_t load_balancer_move_budget;
+    uint64_t load_balancer_tolerance_percentage;
+    uint64_t load_balancer_max_round_ms;
 public:
     void initialize();
 
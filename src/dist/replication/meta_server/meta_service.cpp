@@ -202,11 +202,12 @@ error_code meta_service::start()
 
     // we should start the FD service to response to the workers fd request
     _failure_detector.reset(new meta_server_failure_detector(this));
-    err = _failure_detector->start(
-        _opts.fd_check_interval_seconds,
-        _opts.fd_beacon_interval_seconds,
-        _opts.fd_lease_seconds,
-        _opts.fd_grace_seconds,
+    _failure_detector->set_phi_threshold(_opts.fd_phi_threshold, _opts.fd_phi_safety_margin_ms);
+    err = _failure_detector->start_ms(
+        _opts.fd_check_interval_ms > 0 ? _opts.fd_check_interval_ms : _opts.fd_check_interval_seconds * 1000,
+        _opts.fd_beacon_interval_ms > 0 ? _opts.fd_beacon_interval_ms : _opts.fd_beacon_interval_seconds * 1000,
+        _opts.fd_lease_ms > 0 ? _opts.fd_lease_ms : _opts.fd_lease_seconds * 1000,
+        _opts.fd_grace_ms > 0 ? _opts.fd_grace_ms : _opts.fd_grace_seconds * 1000,
         false
     );
 
@@ -270,6 +271,16 @@ void meta_service::register_rpc_handlers()
         "drop_app",
         &meta_service::on_drop_app
         );
+    register_rpc_handler(
+        RPC_CM_SPLIT_APP,
+        "split_app",
+        &meta_service::on_split_app
+        );
+    register_rpc_handler(
+        RPC_CM_NOTIFY_SPLIT_READY,
+        "notify_split_ready",
+        &meta_service::on_notify_split_ready
+        );
     register_rpc_handler(
         RPC_CM_LIST_APPS,
         "list_apps",
@@ -347,6 +358,24 @@ void meta_service::on_drop_app(dsn_message_t req)
     tasking::enqueue(LPC_META_STATE_NORMAL, nullptr, std::bind(&server_state::drop_app, _state.get(), req), server_state::s_state_write_hash);
 }
 
+void meta_service::on_split_app(dsn_message_t req)
+{
+    configuration_split_app_response response;
+    RPC_CHECK_STATUS(req, response);
+
+    dsn_msg_add_ref(req);
+    tasking::enqueue(LPC_META_STATE_NORMAL, nullptr, std::bind(&server_state::split_app, _state.get(), req), server_state::s_state_write_hash);
+}
+
+void meta_service::on_notify_split_ready(dsn_message_t req)
+{
+    notify_split_ready_response response;
+    RPC_CHECK_STATUS(req, response);
+
+    dsn_msg_add_ref(req);
+    tasking::enqueue(LPC_META_STATE_NORMAL, nullptr, std::bind(&server_state::notify_split_ready, _state.get(), req), server_state::s_state_write_hash);
+}
+
 void meta_service::on_list_apps(dsn_message_t req)
 {
     configuration_list_apps_response response;
@@ -425,6 +454,8 @@ void meta_service::on_query_configuration_by_node(dsn_message_t msg)
 
     configuration_query_by_node_request request;
     dsn::unmarshall(msg, request);
+    if (!request.loads.empty())
+        _balancer->report_load(request.node, request.loads);
     _state->query_configuration_by_node(request, response);
     reply(msg, response);    
 }
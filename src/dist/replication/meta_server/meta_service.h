@@ -92,6 +92,8 @@ private:
     // table operations
     void on_create_app(dsn_message_t req);
     void on_drop_app(dsn_message_t req);
+    void on_split_app(dsn_message_t req);
+    void on_notify_split_ready(dsn_message_t req);
     void on_list_apps(dsn_message_t req);
     void on_list_nodes(dsn_message_t req);
 
@@ -45,6 +45,7 @@
 
 # include "server_load_balancer.h"
 # include "greedy_load_balancer.h"
+# include "load_aware_balancer.h"
 
 # include "meta_service.h"
 
@@ -103,6 +104,7 @@ namespace dsn {
 
             register_component_provider("simple_load_balancer", replication::server_load_balancer::create<replication::simple_load_balancer>);
             register_component_provider("greedy_load_balancer", replication::server_load_balancer::create<replication::greedy_load_balancer>);
+            register_component_provider("load_aware_balancer", replication::server_load_balancer::create<replication::load_aware_balancer>);
             /////////////////////////////////////////////////////
             //// register more provides here used by meta servers
             /////////////////////////////////////////////////////
@@ -92,6 +92,11 @@ namespace dsn
         void meta_state_service_simple::write_log(blob&& log_blob, std::function<error_code()> internal_operation, task_ptr task)
         {
             _log_lock.lock();
+            if (!_compacting && _log_compaction_threshold > 0 && _offset >= _log_compaction_threshold)
+            {
+                roll_log();
+            }
+            dsn_handle_t log = _log;
             uint64_t log_offset = _offset;
             _offset += log_blob.length();
             auto continuation_task = std::unique_ptr<operation>(new operation(false, [=](bool log_succeed)
@@ -104,7 +109,7 @@ namespace dsn
             _log_lock.unlock();
 
             file::write(
-                _log,
+                log,
                 log_blob.data(),
                 log_blob.length(),
                 log_offset,
@@ -248,79 +253,322 @@ namespace dsn
             return ERR_OK;
         }
 
+        std::string meta_state_service_simple::log_path(int64_t index) const
+        {
+            std::string name = "meta_state_service.log";
+            if (index > 0)
+                name += "." + std::to_string(index);
+            return utils::filesystem::path_combine(_work_dir, name);
+        }
+
+        std::string meta_state_service_simple::snapshot_path() const
+        {
+            return utils::filesystem::path_combine(_work_dir, "meta_state_service.snapshot");
+        }
+
+        std::map<int64_t, std::string> meta_state_service_simple::list_logs() const
+        {
+            static const std::string prefix = "meta_state_service.log";
+            std::map<int64_t, std::string> logs;
+            std::vector<std::string> files;
+            utils::filesystem::get_subfiles(_work_dir, files, false);
+            for (auto& f : files)
+            {
+                std::string name = utils::filesystem::get_file_name(f);
+                if (name == prefix)
+                {
+                    logs[0] = log_path(0);
+                }
+                else if (name.length() > prefix.length() + 1 && name.compare(0, prefix.length() + 1, prefix + ".") == 0)
+                {
+                    std::string suffix = name.substr(prefix.length() + 1);
+                    if (suffix.find_first_not_of("0123456789") == std::string::npos)
+                    {
+                        int64_t index = std::stoll(suffix);
+                        logs[index] = log_path(index);
+                    }
+                }
+            }
+            return logs;
+        }
+
+        void meta_state_service_simple::remove_logs(int64_t up_to_index) const
+        {
+            for (auto& log : list_logs())
+            {
+                if (log.first > up_to_index)
+                    break;
+                if (!utils::filesystem::remove_path(log.second))
+                {
+                    dwarn("remove log %s failed, it will be removed on next compaction", log.second.c_str());
+                }
+            }
+        }
+
+        bool meta_state_service_simple::replay_log(const std::string& path, /*out*/ uint64_t& valid_size)
+        {
+            valid_size = 0;
+            FILE* fd = fopen(path.c_str(), "rb");
+            if (fd == nullptr)
+                return false;
+
+            for (;;)
+            {
+                log_header header;
+                if (fread(&header, sizeof(log_header), 1, fd) != 1)
+                {
+                    break;
+                }
+                if (header.magic != log_header::default_magic)
+                {
+                    break;
+                }
+                std::shared_ptr<char> buffer(new char[header.size], [](char* ptr){ delete []ptr; });
+                if (fread(buffer.get(), header.size, 1, fd) != 1)
+                {
+                    break;
+                }
+                valid_size += sizeof(header) + header.size;
+                blob blob_wrapper(buffer, (int)header.size);
+                binary_reader reader(blob_wrapper);
+                int op_type;
+                reader.read(op_type);
+
+                switch (static_cast<operation_type>(op_type))
+                {
+                case operation_type::create_node:
+                {
+                    std::string node;
+                    blob data;
+                    create_node_log::parse(reader, node, data);
+                    create_node_internal(node, data).end_tracking();
+                    break;
+                }
+                case operation_type::delete_node:
+                {
+                    std::string node;
+                    bool recursively_delete;
+                    delete_node_log::parse(reader, node, recursively_delete);
+                    delete_node_internal(node, recursively_delete).end_tracking();
+                    break;
+                }
+                case operation_type::set_data:
+                {
+                    std::string node;
+                    blob data;
+                    set_data_log::parse(reader, node, data);
+                    set_data_internal(node, data).end_tracking();
+                    break;
+                }
+                default:
+                    //The log is complete but its content is modified by cosmic ray. This is unacceptable
+                    dassert(false, "meta state server log corrupted");
+                }
+            }
+
+            int64_t file_size = 0;
+            fclose(fd);
+            utils::filesystem::file_size(path, file_size);
+            return valid_size == static_cast<uint64_t>(file_size);
+        }
+
+        error_code meta_state_service_simple::load_snapshot(/*out*/ int64_t& log_index)
+        {
+            log_index = -1;
+            std::string path = snapshot_path();
+            if (!utils::filesystem::file_exists(path))
+                return ERR_OK;
+
+            FILE* fd = fopen(path.c_str(), "rb");
+            if (fd == nullptr)
+            {
+                derror("open snapshot %s failed", path.c_str());
+                return ERR_FILE_OPERATION_FAILED;
+            }
+
+            // the snapshot is renamed into place only after it is completely written
+            snapshot_header header;
+            std::shared_ptr<char> buffer;
+            bool ok = fread(&header, sizeof(snapshot_header), 1, fd) == 1 && header.magic == snapshot_header::default_magic;
+            if (ok)
+            {
+                buffer.reset(new char[header.size], [](char* ptr){ delete []ptr; });
+                ok = header.size == 0 || fread(buffer.get(), header.size, 1, fd) == 1;
+            }
+            fclose(fd);
+            if (!ok)
+            {
+                derror("snapshot %s is corrupted", path.c_str());
+                return ERR_FILE_OPERATION_FAILED;
+            }
+
+            blob blob_wrapper(buffer, (int)header.size);
+            binary_reader reader(blob_wrapper);
+            int count;
+            reader.read(count);
+
+            // parents are dumped before their children
+            for (int i = 0; i < count; ++i)
+            {
+                std::string node;
+                blob data;
+                unmarshall(reader, node, DSF_THRIFT_BINARY);
+                unmarshall(reader, data, DSF_THRIFT_BINARY);
+                error_code err = (node == "/" ? set_data_internal(node, data) : create_node_internal(node, data));
+                dassert(err == ERR_OK, "load snapshot node %s failed, err = %s", node.c_str(), err.to_string());
+            }
+
+            log_index = header.log_index;
+            ddebug("load snapshot %s with %d nodes, logs up to %" PRId64 " are covered", path.c_str(), count, log_index);
+            return ERR_OK;
+        }
+
+        void meta_state_service_simple::roll_log()
+        {
+            std::string path = log_path(_log_index + 1);
+            dsn_handle_t new_log = dsn_file_open(path.c_str(), O_RDWR | O_CREAT | O_BINARY, 0666);
+            if (!new_log)
+            {
+                derror("open file failed: %s, keep appending to the current log", path.c_str());
+                return;
+            }
+
+            dsn_handle_t old_log = _log;
+            int64_t old_index = _log_index;
+            _log = new_log;
+            _log_index++;
+            _offset = 0;
+            _compacting = true;
+
+            // the queue applies the operations in the order they are logged, so when
+            // this one is reached, the tree has everything of the old log and nothing
+            // of the new one; it runs with _log_lock held
+            _task_queue.emplace(new operation(true, [this, old_log, old_index](bool)
+            {
+                dsn_file_close(old_log);
+                blob snapshot = dump_snapshot(old_index);
+                _snapshot_task = tasking::enqueue(
+                    LPC_META_STATE_SERVICE_SIMPLE_INTERNAL,
+                    this,
+                    [this, snapshot, old_index]()
+                    {
+                        write_snapshot(snapshot, old_index);
+                    });
+            }));
+        }
+
+        blob meta_state_service_simple::dump_snapshot(int64_t log_index)
+        {
+            zauto_lock _(_state_lock);
+            binary_writer writer;
+            writer.write_pod(snapshot_header());
+            writer.write(static_cast<int>(_quick_map.size()));
+
+            std::stack<std::pair<std::string, const state_node*>> nodes;
+            nodes.push(std::make_pair(std::string("/"), &_root));
+            while (!nodes.empty())
+            {
+                auto n = std::move(nodes.top());
+                nodes.pop();
+                marshall(writer, n.first, DSF_THRIFT_BINARY);
+                marshall(writer, n.second->data, DSF_THRIFT_BINARY);
+                for (auto& child : n.second->children)
+                {
+                    nodes.push(std::make_pair((n.first == "/" ? "" : n.first) + "/" + child.first, child.second));
+                }
+            }
+
+            auto snapshot = writer.get_buffer();
+            auto header = reinterpret_cast<snapshot_header*>((char*)snapshot.data());
+            header->log_index = log_index;
+            header->size = snapshot.length() - sizeof(snapshot_header);
+            return snapshot;
+        }
+
+        void meta_state_service_simple::write_snapshot(const blob& snapshot, int64_t log_index)
+        {
+            std::string path = snapshot_path();
+            std::string tmp_path = path + ".tmp";
+            bool ok = false;
+            if (FILE* fd = fopen(tmp_path.c_str(), "wb"))
+            {
+                ok = fwrite(snapshot.data(), snapshot.length(), 1, fd) == 1
+                    && utils::filesystem::sync_file(fd);
+                ok = (fclose(fd) == 0) && ok;
+            }
+
+            // the rename must be durable before the logs it covers are removed,
+            // and the data before the rename
+            if (ok && utils::filesystem::rename_path(tmp_path, path)
+                && utils::filesystem::sync_directory(_work_dir))
+            {
+                ddebug("snapshot %s written, %u bytes, logs up to %" PRId64 " are compacted",
+                    path.c_str(), snapshot.length(), log_index);
+                remove_logs(log_index);
+            }
+            else
+            {
+                derror("write snapshot %s failed, the logs are kept", tmp_path.c_str());
+                utils::filesystem::remove_path(tmp_path);
+            }
+
+            zauto_lock l(_log_lock);
+            _compacting = false;
+        }
+
         error_code meta_state_service_simple::initialize(const std::vector<std::string>& args)
         {
             const char* work_dir = args.empty()?dsn_get_app_data_dir():args[0].c_str();
+            _work_dir = work_dir;
+            _log_compaction_threshold = dsn_config_get_value_uint64(
+                "meta_state_service.simple",
+                "log_compaction_threshold_mb",
+                64,
+                "roll the log and snapshot the state when the log grows beyond this size, 0 for never"
+                ) * 1024 * 1024;
+
+            int64_t snapshot_index;
+            error_code err = load_snapshot(snapshot_index);
+            if (err != ERR_OK)
+            {
+                return err;
+            }
+
+            // leftovers of a compaction interrupted after the snapshot is written
+            remove_logs(snapshot_index);
+            if (utils::filesystem::file_exists(snapshot_path() + ".tmp"))
+                utils::filesystem::remove_path(snapshot_path() + ".tmp");
 
+            // replay the logs after the snapshot in order, and go on appending to the
+            // last one; the logs after a torn one are dropped, as their operations were
+            // never acknowledged
+            _log_index = snapshot_index + 1;
             _offset = 0;
-            std::string log_path = dsn::utils::filesystem::path_combine(work_dir, "meta_state_service.log");
-            if (utils::filesystem::file_exists(log_path))
+            int64_t expected_index = _log_index;
+            bool torn = false;
+            for (auto& log : list_logs())
             {
-                if (FILE* fd = fopen(log_path.c_str(), "rb"))
+                if (torn)
                 {
-                    for (;;)
-                    {
-                        log_header header;
-                        if (fread(&header, sizeof(log_header), 1, fd) != 1)
-                        {
-                            break;
-                        }
-                        if (header.magic != log_header::default_magic)
-                        {
-                            break;
-                        }
-                        std::shared_ptr<char> buffer(new char[header.size]);
-                        if (fread(buffer.get(), header.size, 1, fd) != 1)
-                        {
-                            break;
-                        }
-                        _offset += sizeof(header) + header.size;
-                        blob blob_wrapper(buffer, (int)header.size);
-                        binary_reader reader(blob_wrapper);
-                        int op_type;
-                        reader.read(op_type);
-
-                        switch (static_cast<operation_type>(op_type))
-                        {
-                        case operation_type::create_node:
-                        {
-                            std::string node;
-                            blob data;
-                            create_node_log::parse(reader, node, data);
-                            create_node_internal(node, data).end_tracking();
-                            break;
-                        }
-                        case operation_type::delete_node:
-                        {
-                            std::string node;
-                            bool recursively_delete;
-                            delete_node_log::parse(reader, node, recursively_delete);
-                            delete_node_internal(node, recursively_delete).end_tracking();
-                            break;
-                        }
-                        case operation_type::set_data:
-                        {
-                            std::string node;
-                            blob data;
-                            set_data_log::parse(reader, node, data);
-                            set_data_internal(node, data).end_tracking();
-                            break;
-                        }
-                        default:
-                            //The log is complete but its content is modified by cosmic ray. This is unacceptable
-                            dassert(false, "meta state server log corrupted");
-                        }   
-                    }
-                    fclose(fd);
+                    dwarn("drop log %s after the torn log %" PRId64, log.second.c_str(), _log_index);
+                    utils::filesystem::remove_path(log.second);
+                    continue;
                 }
+
+                dassert(log.first == expected_index, "log %" PRId64 " is missing", expected_index);
+                _log_index = expected_index++;
+                torn = !replay_log(log.second, _offset);
             }
 
-            _log = dsn_file_open(log_path.c_str(), O_RDWR | O_CREAT | O_BINARY, 0666);
+            std::string path = log_path(_log_index);
+            _log = dsn_file_open(path.c_str(), O_RDWR | O_CREAT | O_BINARY, 0666);
             if (!_log)
             {
-                derror("open file failed: %s", log_path.c_str());
+                derror("open file failed: %s", path.c_str());
                 return ERR_FILE_OPERATION_FAILED;
             }
+            ddebug("meta state service simple initialized at %s, appending to log %" PRId64 " from offset %" PRIu64,
+                _work_dir.c_str(), _log_index, _offset);
             return ERR_OK;
         }
 
@@ -31,12 +31,18 @@
  * Revision history:
  *     2015-11-03, @imzhenyu (Zhenyu.Guo@microsoft.com), setup the sketch
  *     2015-11-11, Tianyi WANG, first version done
+ *
+ *     all the updates are appended to a log, which is rolled to a new file once it
+ *     grows beyond log_compaction_threshold_mb; the tree is then dumped to a snapshot
+ *     which covers all the rolled logs, and those logs are removed, so initialize
+ *     only loads the snapshot and replays the logs after it
  */
 
 # include <dsn/dist/meta_state_service.h>
 # include "replication_common.h"
 
 #include <queue>
+#include <map>
 
 using namespace dsn::service;
 
@@ -50,7 +56,8 @@ namespace dsn
             : public meta_state_service, public clientlet
         {
         public:
-            explicit meta_state_service_simple() : _root("/", nullptr), _quick_map({std::make_pair("/", &_root)}), _log_lock(true), _log(nullptr), _offset(0){}
+            explicit meta_state_service_simple() : _root("/", nullptr), _quick_map({std::make_pair("/", &_root)}), _log_lock(true), _log(nullptr), _offset(0),
+                _log_index(0), _log_compaction_threshold(0), _compacting(false) {}
 
             // work_path = (argc > 0 ? argv[0] : current_app_data_dir)
             virtual error_code initialize(const std::vector<std::string>& args) override;
@@ -105,6 +112,20 @@ namespace dsn
                 clientlet* tracker = nullptr) override;
             virtual ~meta_state_service_simple() override;
 
+            // overrides log_compaction_threshold_mb of the config, 0 for never
+            void set_log_compaction_threshold_mb(uint64_t threshold_mb)
+            {
+                zauto_lock l(_log_lock);
+                _log_compaction_threshold = threshold_mb * 1024 * 1024;
+            }
+
+            // the task writing the latest snapshot, nullptr if no log has been rolled
+            task_ptr last_snapshot_task()
+            {
+                zauto_lock l(_log_lock);
+                return _snapshot_task;
+            }
+
         private:
             struct operation
             {
@@ -122,6 +143,16 @@ namespace dsn
                 {}
             };
 
+            struct snapshot_header
+            {
+                int magic;
+                int64_t log_index; // logs up to this index are covered
+                size_t size;
+                static const int default_magic = 0xcafebabe;
+                snapshot_header() : magic(default_magic), log_index(-1), size(0)
+                {}
+            };
+
             struct state_node
             {
                 std::string name;
@@ -241,6 +272,21 @@ namespace dsn
 
             void write_log(blob&& log_blob, std::function<error_code(void)> internal_operation, task_ptr task);
 
+            // log 0 is meta_state_service.log, and log i is meta_state_service.log.i
+            std::string log_path(int64_t index) const;
+            std::string snapshot_path() const;
+            std::map<int64_t, std::string> list_logs() const;
+            void remove_logs(int64_t up_to_index) const;
+
+            // replay one log, returns false if it stops before the end of the file
+            bool replay_log(const std::string& path, /*out*/ uint64_t& valid_size);
+            error_code load_snapshot(/*out*/ int64_t& log_index);
+
+            // called with _log_lock held
+            void roll_log();
+            blob dump_snapshot(int64_t log_index);
+            void write_snapshot(const blob& snapshot, int64_t log_index);
+
             error_code create_node_internal(const std::string &node, const blob& blob);
             error_code delete_node_internal(const std::string &node, bool recursive);
             error_code set_data_internal(const std::string &node, const blob& blob);
@@ -258,6 +304,11 @@ namespace dsn
             zlock          _log_lock;
             dsn_handle_t   _log;
             uint64_t       _offset;
+            int64_t        _log_index;
+            uint64_t       _log_compaction_threshold; // in bytes, 0 for never
+            bool           _compacting;
+            task_ptr       _snapshot_task;
+            std::string    _work_dir;
         };
     }
 }
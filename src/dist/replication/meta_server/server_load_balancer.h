@@ -65,6 +65,9 @@ public:
     //and if provider wants to modify the context for this gpid, "get_context" can be used
     virtual pc_status cure(const meta_view& view, const dsn::gpid& gpid, configuration_proposal_action& action/*out*/) = 0;
     virtual bool balance(const meta_view& view, migration_list& list) = 0;
+    //replica servers report the loads of their replicas along with the config sync,
+    //which are simply ignored by balancers not considering the load
+    virtual void report_load(const rpc_address& node, const std::vector<replica_load>& loads) {}
 
 public:
     typedef std::function<bool (const rpc_address& addr1, const rpc_address& addr2)> node_comparator;
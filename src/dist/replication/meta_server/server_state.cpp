@@ -65,8 +65,9 @@ static inline void reply_message(meta_service* svc, dsn_message_t request_msg, T
 }
 
 server_state::server_state():
-    _meta_svc(nullptr), _creating_apps_count(0), _dropping_apps_count(0),
-    _cli_json_state_handle(nullptr), _cli_dump_handle(nullptr)
+    _meta_svc(nullptr), _creating_apps_count(0), _dropping_apps_count(0), _remote_sync_scheduled(false),
+    _config_epoch(0), _config_version(0), _config_push_scheduled(false), _check_rounds(0),
+    _cli_json_state_handle(nullptr), _cli_dump_handle(nullptr), _cli_drain_node_handle(nullptr)
 {
 }
 
@@ -82,6 +83,11 @@ server_state::~server_state()
         dsn_cli_deregister(_cli_dump_handle);
         _cli_dump_handle = nullptr;
     }
+    if (_cli_drain_node_handle != nullptr)
+    {
+        dsn_cli_deregister(_cli_drain_node_handle);
+        _cli_drain_node_handle = nullptr;
+    }
 }
 
 void server_state::register_cli_commands()
@@ -103,12 +109,27 @@ void server_state::register_cli_commands()
         &static_cli_dump_app_states_cleanup
         );
     dassert(_cli_dump_handle != nullptr, "register cli handler failed");
+
+    _cli_drain_node_handle = dsn_cli_app_register(
+        "drain_node",
+        "hand off the primaries of a replica server to its secondaries, e.g., before a restart",
+        "usage: ip:port [-c|--cancel], run again to see how many primaries are left; the drain ends once "
+        "none is left or the node is dead, and is not kept across meta server failovers",
+        this,
+        &static_cli_drain_node,
+        &static_cli_json_state_cleanup
+        );
+    dassert(_cli_drain_node_handle != nullptr, "register cli handler failed");
 }
 
 void server_state::initialize(meta_service *meta_svc, const std::string &apps_root)
 {
     _meta_svc = meta_svc;
     _apps_root = apps_root;
+
+    //versions of different meta servers or runs are not comparable, so replica
+    //servers holding those of another epoch get a full sync
+    _config_epoch = static_cast<int64_t>((dsn_now_ms() << 16) | dsn_random32(0, 0xffff));
 }
 
 bool server_state::spin_wait_creating(int timeout_seconds)
@@ -383,8 +404,7 @@ dsn::error_code server_state::sync_apps_from_remote_storage()
                 if (ec == ERR_OK)
                 {
                     partition_configuration pc;
-                    dsn::json::string_tokenizer tokenizer(value);
-                    json_decode(tokenizer, pc);
+                    dassert(decode_partition_configuration(value, pc), "invalid partition config data");
                     dassert(pc.pid.get_app_id() == app->app_id && pc.pid.get_partition_index() == partition_id, "invalid partition config");
                     {
                         zauto_write_lock l(_lock);
@@ -517,9 +537,27 @@ error_code server_state::initialize_data_structure()
         ddebug("sync apps from remote storage ok, get %d apps, init the node state accordingly", _all_apps.size());
         initialize_node_state();
     }
+
+    //the partitions may be ill since the former meta server, e.g., lacking a
+    //secondary or with a cure proposal lost in flight, so all are checked once
+    if (err == ERR_OK)
+        mark_all_partitions_dirty();
     return err;
 }
 
+void server_state::mark_all_partitions_dirty()
+{
+    zauto_write_lock l(_lock);
+    for (auto& kv: _all_apps)
+    {
+        std::shared_ptr<app_state>& app = kv.second;
+        if (app->status != app_status::AS_AVAILABLE)
+            continue;
+        for (int i = 0; i < app->partition_count; ++i)
+            _dirty_partitions.insert(dsn::gpid(app->app_id, i));
+    }
+}
+
 void server_state::set_config_change_subscriber_for_test(config_change_subscriber subscriber)
 {
     _config_change_subscriber = subscriber;
@@ -538,13 +576,53 @@ void server_state::query_configuration_by_node(const configuration_query_by_node
     if (it == _nodes.end())
     {
         response.err = ERR_OBJECT_NOT_FOUND;
+        return;
+    }
+
+    response.err = ERR_OK;
+    response.config_epoch = _config_epoch;
+    response.config_version = _config_version;
+
+    //the changes after the requested version must all be in the log for an incremental sync
+    int64_t log_start = _config_changes.empty() ? _config_version + 1 : _config_changes.front().version;
+    response.is_incremental = (request.config_epoch != 0
+        && request.config_epoch == _config_epoch
+        && request.config_version <= _config_version
+        && request.config_version + 1 >= log_start);
+
+    const node_state& ns = it->second;
+    if (response.is_incremental)
+    {
+        auto change = std::upper_bound(_config_changes.begin(), _config_changes.end(), request.config_version,
+            [](int64_t version, const config_change& c) { return version < c.version; });
+
+        std::set<dsn::gpid> changed;
+        for (; change != _config_changes.end(); ++change)
+        {
+            if (std::find(change->nodes.begin(), change->nodes.end(), request.node) != change->nodes.end())
+                changed.insert(change->pid);
+        }
+
+        for (const dsn::gpid& p: changed)
+        {
+            if (ns.partitions.find(p) == ns.partitions.end())
+            {
+                response.gone_partitions.push_back(p);
+                continue;
+            }
+
+            std::shared_ptr<app_state> app = get_app(p.get_app_id());
+            dassert(app != nullptr, "");
+            response.partitions.emplace_back();
+            response.partitions.back().config = app->partitions[p.get_partition_index()];
+            response.partitions.back().info = *app;
+        }
     }
     else
     {
-        response.err = ERR_OK;
-        response.partitions.resize(it->second.partitions.size());
+        response.partitions.resize(ns.partitions.size());
         unsigned i = 0;
-        for (auto& p: it->second.partitions)
+        for (auto& p: ns.partitions)
         {
             std::shared_ptr<app_state> app = get_app(p.get_app_id());
             dassert(app != nullptr, "");
@@ -587,12 +665,43 @@ void server_state::query_configuration_by_index(const configuration_query_by_ind
     response.partition_count = app->partition_count;
     response.is_stateful = app->is_stateful;
 
+    int parent_count = replica_helper::get_split_parent_count(*app);
+    if (parent_count == 0)
+    {
+        for (const int32_t& index: request.partition_indices) {
+            if (index>=0 && index<app->partitions.size())
+                response.partitions.push_back( app->partitions[index]);
+        }
+        if (response.partitions.empty())
+            response.partitions = app->partitions;
+        return;
+    }
+
+    //a split child is hidden from the clients till it is ready, and its parent
+    //is returned along with it, so that its keys are sent to the parent
+    std::set<int> indices;
     for (const int32_t& index: request.partition_indices) {
         if (index>=0 && index<app->partitions.size())
-            response.partitions.push_back( app->partitions[index]);
+            indices.insert(index);
+    }
+    if (indices.empty()) {
+        for (int i = 0; i < app->partition_count; ++i)
+            indices.insert(i);
+    }
+    for (int i = parent_count; i < app->partition_count; ++i) {
+        if (indices.find(i) != indices.end() && !replica_helper::is_split_child_ready(*app, i))
+            indices.insert(i - parent_count);
+    }
+
+    for (int index: indices) {
+        response.partitions.push_back(app->partitions[index]);
+        if (index >= parent_count && !replica_helper::is_split_child_ready(*app, index)) {
+            partition_configuration& pc = response.partitions.back();
+            pc.ballot = -1;
+            pc.primary.set_invalid();
+            pc.secondaries.clear();
+        }
     }
-    if (response.partitions.empty())
-        response.partitions = app->partitions;
 }
 
 void server_state::init_app_partition_node(std::shared_ptr<app_state>& app, int pidx)
@@ -621,7 +730,7 @@ void server_state::init_app_partition_node(std::shared_ptr<app_state>& app, int
     };
 
     std::string app_partition_path = get_partition_path(*app, pidx);
-    dsn::blob value = dsn::json::json_forwarder<partition_configuration>::encode(app->partitions[pidx]);
+    dsn::blob value = encode_partition_configuration(app->partitions[pidx]);
     _meta_svc->get_remote_storage()->create_node(app_partition_path,
         LPC_META_STATE_HIGH,
         on_create_app_partition,
@@ -759,6 +868,7 @@ void server_state::do_app_drop(std::shared_ptr<app_state>& app, dsn_message_t ms
                             _nodes[addr].partitions.erase(pc.pid);
                         }
                     }
+                    record_config_change(pc, partition_configuration());
                 }
                 for (config_context& cc: app->helpers->contexts)
                     cc.cancel_sync();
@@ -805,6 +915,11 @@ void server_state::drop_app(dsn_message_t msg)
             switch (app->status)
             {
             case app_status::AS_AVAILABLE:
+                //or the app info written by the split overwrites the dropped one
+                if (app->helpers->app_info_syncing) {
+                    response.err = ERR_BUSY;
+                    break;
+                }
                 do_dropping = true;
                 app->status = app_status::AS_DROPPING;
                 ++_dropping_apps_count;
@@ -830,6 +945,266 @@ void server_state::drop_app(dsn_message_t msg)
     }
 }
 
+void server_state::do_app_split(std::shared_ptr<app_state>& app, dsn_message_t msg)
+{
+    int parent_count = app->partition_count;
+    app_info new_info = *app;
+    new_info.partition_count = parent_count * 2;
+    new_info.status = app_status::AS_AVAILABLE;
+    new_info.envs[replica_helper::split_parent_count_env] = boost::lexical_cast<std::string>(parent_count);
+    new_info.envs.emplace(replica_helper::split_original_count_env, boost::lexical_cast<std::string>(parent_count));
+
+    std::vector<partition_configuration> children(parent_count);
+    for (int i = 0; i != parent_count; ++i)
+    {
+        partition_configuration& pc = children[i];
+        pc.pid = dsn::gpid(app->app_id, parent_count + i);
+        pc.ballot = 0;
+        pc.last_committed_decree = 0;
+        pc.max_replica_count = app->max_replica_count;
+        pc.primary.set_invalid();
+    }
+
+    //the children and the new app info are written at once, so a restarted
+    //meta server sees either the old partitions or all of the new ones
+    dist::meta_state_service* storage = _meta_svc->get_remote_storage();
+    std::shared_ptr<dist::meta_state_service::transaction_entries> entries = storage->new_transaction_entries(parent_count + 1);
+    for (const partition_configuration& pc: children)
+    {
+        error_code ec = entries->create_node(get_partition_path(pc.pid), encode_partition_configuration(pc));
+        dassert(ec == ERR_OK, "add child gpid(%d.%d) to transaction failed, err = %s",
+            pc.pid.get_app_id(), pc.pid.get_partition_index(), ec.to_string());
+    }
+    error_code ec = entries->set_data(get_app_path(*app), dsn::json::json_forwarder<app_info>::encode(new_info));
+    dassert(ec == ERR_OK, "add app info of %s to transaction failed, err = %s", app->app_name.c_str(), ec.to_string());
+
+    auto after_split_app = [this, app, msg, new_info, children](error_code ec) mutable
+    {
+        //a timed out transaction may have been applied, so its retry finds the children
+        if (ERR_OK == ec || ERR_NODE_ALREADY_EXIST == ec)
+        {
+            configuration_split_app_response response;
+            {
+                zauto_write_lock l(_lock);
+                int parent_count = app->partition_count;
+                app->partition_count = new_info.partition_count;
+                app->envs = new_info.envs;
+                app->partitions.insert(app->partitions.end(), children.begin(), children.end());
+
+                config_context context;
+                context.stage = config_status::not_pending;
+                context.pending_sync_task = nullptr;
+                context.msg = nullptr;
+                app->helpers->contexts.resize(app->partition_count, context);
+
+                //each child is placed on the members of its parent, with the parent
+                //primary as its primary, so the seeding checkpoint is copied locally
+                for (int i = parent_count; i != app->partition_count; ++i)
+                {
+                    const partition_configuration& parent = app->partitions[i - parent_count];
+                    std::shared_ptr<configuration_balancer_request> proposal = std::make_shared<configuration_balancer_request>();
+                    proposal->gpid = app->partitions[i].pid;
+                    if (!parent.primary.is_invalid())
+                    {
+                        proposal->action_list.emplace_back(parent.primary, parent.primary, config_type::CT_ASSIGN_PRIMARY);
+                        for (const dsn::rpc_address& sec: parent.secondaries)
+                            proposal->action_list.emplace_back(parent.primary, sec, config_type::CT_ADD_SECONDARY);
+                    }
+                    app->helpers->contexts[i].balancer_proposal = std::move(proposal);
+                    _dirty_partitions.insert(app->partitions[i].pid);
+                }
+                app->helpers->app_info_syncing = false;
+                response.partition_count = app->partition_count;
+            }
+            ddebug("split app(id:%d, name:%s) to %d partitions", app->app_id, app->app_name.c_str(), response.partition_count);
+            response.err = ERR_OK;
+            reply_message(_meta_svc, msg, response);
+            dsn_msg_release_ref(msg);
+        }
+        else if (ERR_TIMEOUT == ec)
+        {
+            dwarn("split app(id:%d, name:%s) timeout, retry later", app->app_id, app->app_name.c_str());
+            tasking::enqueue(LPC_META_STATE_HIGH, nullptr, std::bind(&server_state::do_app_split, this, app, msg),
+                             0, std::chrono::seconds(1));
+        }
+        else
+        {
+            dassert(false, "we can't handle this, error(%s)", ec.to_string());
+        }
+    };
+    storage->submit_transaction(entries, LPC_META_STATE_HIGH, after_split_app);
+}
+
+void server_state::split_app(dsn_message_t msg)
+{
+    configuration_split_app_request request;
+    configuration_split_app_response response;
+    response.partition_count = 0;
+    std::shared_ptr<app_state> app;
+    bool do_split = false;
+    dsn::unmarshall(msg, request);
+    ddebug("split app request, name(%s)", request.app_name.c_str());
+    {
+        zauto_write_lock l(_lock);
+        app = get_app(request.app_name);
+        if (nullptr == app) {
+            response.err = ERR_APP_NOT_EXIST;
+        }
+        else {
+            response.partition_count = app->partition_count;
+            if (app->status != app_status::AS_AVAILABLE)
+                response.err = (app->status==app_status::AS_CREATING?ERR_BUSY_CREATING:ERR_BUSY_DROPPING);
+            else if (!app->is_stateful)
+                response.err = ERR_INVALID_PARAMETERS;
+            else if (replica_helper::get_split_parent_count(*app) != 0 || app->helpers->app_info_syncing)
+                response.err = ERR_BUSY;
+            else {
+                //the parents must be able to seed their children
+                response.err = ERR_OK;
+                for (const partition_configuration& pc: app->partitions) {
+                    if (pc.primary.is_invalid()) {
+                        response.err = ERR_INVALID_STATE;
+                        break;
+                    }
+                }
+                if (response.err == ERR_OK) {
+                    do_split = true;
+                    app->helpers->app_info_syncing = true;
+                }
+            }
+        }
+    }
+
+    if (do_split) {
+        do_app_split(app, msg);
+    }
+    else {
+        reply_message(_meta_svc, msg, response);
+        dsn_msg_release_ref(msg);
+    }
+}
+
+void server_state::do_split_ready(std::shared_ptr<app_state>& app, int child_index, dsn_message_t msg)
+{
+    app_info new_info = *app;
+    replica_helper::mark_split_child_ready(new_info, child_index);
+
+    auto after_mark_ready = [this, app, child_index, new_info, msg](error_code ec) mutable
+    {
+        if (ERR_OK == ec)
+        {
+            {
+                zauto_write_lock l(_lock);
+                int parent_count = app->partition_count / 2;
+                app->envs = new_info.envs;
+                app->helpers->app_info_syncing = false;
+
+                //so that both partitions sync the new app info soon
+                record_config_change(app->partitions[child_index - parent_count], app->partitions[child_index - parent_count]);
+                record_config_change(app->partitions[child_index], app->partitions[child_index]);
+            }
+            ddebug("split child gpid(%d.%d) is ready", app->app_id, child_index);
+            notify_split_ready_response response;
+            response.err = ERR_OK;
+            reply_message(_meta_svc, msg, response);
+            dsn_msg_release_ref(msg);
+        }
+        else if (ERR_TIMEOUT == ec)
+        {
+            dwarn("mark split child gpid(%d.%d) ready timeout, retry later", app->app_id, child_index);
+            tasking::enqueue(LPC_META_STATE_HIGH, nullptr, std::bind(&server_state::do_split_ready, this, app, child_index, msg),
+                             0, std::chrono::seconds(1));
+        }
+        else
+        {
+            dassert(false, "we can't handle this, error(%s)", ec.to_string());
+        }
+    };
+    _meta_svc->get_remote_storage()->set_data(get_app_path(*app),
+        dsn::json::json_forwarder<app_info>::encode(new_info),
+        LPC_META_STATE_HIGH,
+        after_mark_ready);
+}
+
+void server_state::notify_split_ready(dsn_message_t msg)
+{
+    notify_split_ready_request request;
+    notify_split_ready_response response;
+    std::shared_ptr<app_state> app;
+    bool do_ready = false;
+    dsn::unmarshall(msg, request);
+    int parent_index = request.parent.get_partition_index();
+    int child_index = request.child.get_partition_index();
+    ddebug("notify split ready request, parent gpid(%d.%d), child gpid(%d.%d)",
+        request.parent.get_app_id(), parent_index, request.child.get_app_id(), child_index);
+    {
+        zauto_write_lock l(_lock);
+        app = get_app(request.parent.get_app_id());
+        int parent_count = (app == nullptr ? 0 : replica_helper::get_split_parent_count(*app));
+        if (nullptr == app || app->status != app_status::AS_AVAILABLE)
+            response.err = ERR_APP_NOT_EXIST;
+        else if (request.child.get_app_id() != app->app_id || parent_index < 0 || child_index >= app->partition_count
+            || child_index != parent_index + app->partition_count / 2)
+            response.err = ERR_INVALID_PARAMETERS;
+        else if (parent_count == 0 || replica_helper::is_split_child_ready(*app, child_index))
+            response.err = ERR_OK;
+        else if (app->partitions[parent_index].ballot != request.parent_ballot)
+            response.err = ERR_INVALID_VERSION;
+        else if (app->partitions[child_index].primary.is_invalid())
+            response.err = ERR_INVALID_STATE;
+        else if (app->helpers->app_info_syncing)
+            response.err = ERR_BUSY;
+        else {
+            do_ready = true;
+            app->helpers->app_info_syncing = true;
+        }
+    }
+
+    if (do_ready) {
+        do_split_ready(app, child_index, msg);
+    }
+    else {
+        reply_message(_meta_svc, msg, response);
+        dsn_msg_release_ref(msg);
+    }
+}
+
+//called under the write lock, the parents are asked again and again till their
+//children are ready, as any failure resets the split on the parent
+void server_state::trigger_partition_splits()
+{
+    for (auto& kv: _exist_apps)
+    {
+        std::shared_ptr<app_state>& app = kv.second;
+        if (app->status != app_status::AS_AVAILABLE)
+            continue;
+
+        int parent_count = replica_helper::get_split_parent_count(*app);
+        for (int i = parent_count; i < 2 * parent_count; ++i)
+        {
+            const partition_configuration& parent = app->partitions[i - parent_count];
+            const partition_configuration& child = app->partitions[i];
+            if (replica_helper::is_split_child_ready(*app, i) || parent.primary.is_invalid() || child.primary.is_invalid()
+                || app->helpers->contexts[i - parent_count].stage == config_status::pending_remote_sync
+                || _unhealthy_partitions.find(child.pid) != _unhealthy_partitions.end())
+                continue;
+
+            split_partition_request request;
+            request.parent = parent.pid;
+            request.parent_ballot = parent.ballot;
+            request.child = child.pid;
+            request.child_primary = child.primary;
+            request.partition_count = app->partition_count;
+
+            dinfo("trigger split of gpid(%d.%d) to gpid(%d.%d)",
+                parent.pid.get_app_id(), parent.pid.get_partition_index(), child.pid.get_app_id(), child.pid.get_partition_index());
+            dsn_message_t msg = dsn_msg_create_request(RPC_SPLIT_PARTITION, 0, gpid_to_hash(parent.pid));
+            ::marshall(msg, request);
+            _meta_svc->send_message(parent.primary, msg);
+        }
+    }
+}
+
 void server_state::list_apps(const configuration_list_apps_request& request, configuration_list_apps_response& response)
 {
     ddebug("list app request, status(%d)", request.status);
@@ -958,7 +1333,9 @@ void server_state::update_configuration_locally(app_state& app, std::shared_ptr<
 
     //we assume config in config_request stores the proper new config
     //as we sync to remote storage according to it
+    record_config_change(old_cfg, config_request->config);
     old_cfg = config_request->config;
+    _dirty_partitions.insert(gpid);
     std::stringstream cf;
     cf << *config_request;
     ddebug("meta update config ok: %s", cf.str().c_str());
@@ -972,21 +1349,172 @@ void server_state::update_configuration_locally(app_state& app, std::shared_ptr<
     }
 }
 
+// the update is queued and written with the others of the same tick in one transaction,
+// the returned task runs on_update_configuration_on_remote_reply with the result
 task_ptr server_state::update_configuration_on_remote(std::shared_ptr<configuration_update_request>& config_request)
 {
-    partition_configuration& pc = config_request->config;
-    std::string storage_path = get_partition_path(pc.pid);
-
-    blob json_config = dsn::json::json_forwarder<partition_configuration>::encode(pc);
-    return _meta_svc->get_remote_storage()->set_data(
-        storage_path,
-        json_config,
+    task_ptr callback = tasking::create_late_task(
         LPC_META_STATE_HIGH,
-        std::bind(&server_state::on_update_configuration_on_remote_reply,
+        dist::meta_state_service::err_callback(std::bind(&server_state::on_update_configuration_on_remote_reply,
             this,
             std::placeholders::_1,
-            config_request)
-    );
+            config_request))
+        );
+
+    bool schedule = false;
+    {
+        zauto_lock l(_remote_sync_lock);
+        //a queued one of the same partition is already cancelled by the caller
+        _remote_syncs[config_request->config.pid] = remote_config_sync{config_request, callback};
+        if (!_remote_sync_scheduled)
+        {
+            _remote_sync_scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule)
+    {
+        tasking::enqueue(LPC_META_STATE_HIGH,
+            nullptr,
+            std::bind(&server_state::flush_remote_config_syncs, this),
+            0,
+            std::chrono::milliseconds(_meta_svc->get_meta_options().config_sync_batch_interval_ms));
+    }
+    return callback;
+}
+
+static void reply_remote_config_sync(const task_ptr& callback, error_code ec)
+{
+    auto t = reinterpret_cast<safe_late_task<dist::meta_state_service::err_callback>*>(callback.get());
+    t->bind_and_enqueue([ec](dist::meta_state_service::err_callback& handler) {
+        return std::bind(handler, ec);
+    });
+}
+
+void server_state::flush_remote_config_syncs()
+{
+    std::map<dsn::gpid, remote_config_sync> syncs;
+    {
+        zauto_lock l(_remote_sync_lock);
+        syncs.swap(_remote_syncs);
+        _remote_sync_scheduled = false;
+    }
+
+    dist::meta_state_service* storage = _meta_svc->get_remote_storage();
+    size_t max_count = std::max<uint64_t>(1, _meta_svc->get_meta_options().config_sync_batch_max_count);
+    size_t left = syncs.size();
+    auto it = syncs.begin();
+    while (left > 0)
+    {
+        size_t count = std::min(left, max_count);
+        left -= count;
+
+        std::shared_ptr<dist::meta_state_service::transaction_entries> entries = storage->new_transaction_entries(count);
+        std::vector<remote_config_sync> batch;
+        batch.reserve(count);
+        for (; batch.size() < count; ++it)
+        {
+            const partition_configuration& pc = it->second.request->config;
+            error_code ec = entries->set_data(get_partition_path(pc.pid), encode_partition_configuration(pc));
+            dassert(ec == ERR_OK, "add config of gpid(%d.%d) to transaction failed, err = %s",
+                pc.pid.get_app_id(), pc.pid.get_partition_index(), ec.to_string());
+            batch.push_back(it->second);
+        }
+
+        dinfo("sync %d partition configs to remote storage in one transaction", (int)count);
+        storage->submit_transaction(entries,
+            LPC_META_STATE_HIGH,
+            [this, storage, batch](error_code ec)
+            {
+                //the whole transaction fails with a bad entry, so the entries are tried one by one
+                //to tell the bad one from the others, a timeout is retried by each of them anyway
+                if (ec != ERR_OK && ec != ERR_TIMEOUT && batch.size() > 1)
+                {
+                    dwarn("sync %d partition configs in one transaction failed, err = %s, sync them one by one",
+                        (int)batch.size(), ec.to_string());
+                    for (const remote_config_sync& sync : batch)
+                    {
+                        const partition_configuration& pc = sync.request->config;
+                        task_ptr callback = sync.callback;
+                        storage->set_data(get_partition_path(pc.pid),
+                            encode_partition_configuration(pc),
+                            LPC_META_STATE_HIGH,
+                            [callback](error_code ec) { reply_remote_config_sync(callback, ec); });
+                    }
+                    return;
+                }
+
+                for (const remote_config_sync& sync : batch)
+                    reply_remote_config_sync(sync.callback, ec);
+            });
+    }
+}
+
+//called under the write lock, new_cfg is empty when the partition is dropped
+void server_state::record_config_change(const partition_configuration& old_cfg, const partition_configuration& new_cfg)
+{
+    config_change change;
+    change.version = ++_config_version;
+    change.pid = old_cfg.pid;
+
+    auto add_node = [&change](const dsn::rpc_address& node)
+    {
+        if (!node.is_invalid() && std::find(change.nodes.begin(), change.nodes.end(), node) == change.nodes.end())
+            change.nodes.push_back(node);
+    };
+    for (const partition_configuration* pc: {&old_cfg, &new_cfg})
+    {
+        add_node(pc->primary);
+        for (const dsn::rpc_address& node: pc->secondaries)
+            add_node(node);
+    }
+
+    const meta_options& opts = _meta_svc->get_meta_options();
+    if (!opts.config_change_push_disabled)
+    {
+        _config_push_nodes.insert(change.nodes.begin(), change.nodes.end());
+        if (!_config_push_scheduled && !_config_push_nodes.empty())
+        {
+            _config_push_scheduled = true;
+            tasking::enqueue(LPC_META_STATE_NORMAL,
+                nullptr,
+                std::bind(&server_state::push_config_changes, this),
+                0,
+                std::chrono::milliseconds(opts.config_change_push_interval_ms));
+        }
+    }
+
+    _config_changes.push_back(std::move(change));
+    while (_config_changes.size() > opts.config_change_log_size)
+        _config_changes.pop_front();
+}
+
+//notify the replica servers to query their changed configs now instead of on next poll
+void server_state::push_config_changes()
+{
+    std::vector<dsn::rpc_address> nodes;
+    config_change_notification notification;
+    {
+        zauto_write_lock l(_lock);
+        for (const dsn::rpc_address& node: _config_push_nodes)
+        {
+            if (is_node_alive(_nodes, node))
+                nodes.push_back(node);
+        }
+        _config_push_nodes.clear();
+        _config_push_scheduled = false;
+        notification.config_epoch = _config_epoch;
+        notification.config_version = _config_version;
+    }
+
+    dinfo("notify %d nodes of config changes, config version = %" PRId64, (int)nodes.size(), notification.config_version);
+    for (const dsn::rpc_address& node: nodes)
+    {
+        dsn_message_t msg = dsn_msg_create_request(RPC_CONFIG_CHANGE_NOTIFY, 0, 0);
+        ::marshall(msg, notification);
+        _meta_svc->send_message(node, msg);
+    }
 }
 
 void server_state::on_update_configuration_on_remote_reply(error_code ec, std::shared_ptr<configuration_update_request>& config_request)
@@ -1000,9 +1528,11 @@ void server_state::on_update_configuration_on_remote_reply(error_code ec, std::s
     dassert(app->status==app_status::AS_AVAILABLE || app->status==app_status::AS_DROPPING, "if app removed, this task should be cancelled");
     if (ec == ERR_TIMEOUT)
     {
-        cc.pending_sync_task = tasking::enqueue(LPC_META_STATE_HIGH, nullptr, [this, config_request, &cc] () mutable
+        //the contexts may be reallocated by a split in the meantime
+        cc.pending_sync_task = tasking::enqueue(LPC_META_STATE_HIGH, nullptr, [this, config_request, app] () mutable
         {
-            cc.pending_sync_task = update_configuration_on_remote(config_request);
+            app->helpers->contexts[config_request->config.pid.get_partition_index()].pending_sync_task =
+                update_configuration_on_remote(config_request);
         },
         0, std::chrono::seconds(1));
     }
@@ -1034,7 +1564,23 @@ void server_state::on_update_configuration_on_remote_reply(error_code ec, std::s
     }
     else
     {
-        dassert(false, "we can't handle this right now, err = %s", ec.to_string());
+        //e.g., the partition is no longer on remote storage, the update is given up with the
+        //config unchanged, a replica proposing it retries on the error and the others are
+        //proposed again by the partition check
+        std::stringstream ss;
+        ss << *config_request;
+        derror("sync config to remote storage failed, err = %s, give up the update(%s)", ec.to_string(), ss.str().c_str());
+        cc.pending_sync_task = nullptr;
+        cc.stage = config_status::not_pending;
+        if (cc.msg)
+        {
+            configuration_update_response resp;
+            resp.err = ec;
+            resp.config = app->partitions[gpid.get_partition_index()];
+            reply_message(_meta_svc, cc.msg, resp);
+            dsn_msg_release_ref(cc.msg);
+            cc.msg = nullptr;
+        }
     }
 }
 
@@ -1286,6 +1832,7 @@ void server_state::on_change_node_state(rpc_address node, bool is_alive)
                 std::shared_ptr<app_state> app = get_app(gpid.get_app_id());
                 dassert(app != nullptr && app->status!=app_status::AS_DROPPED, "");
                 on_partition_node_dead(app, gpid.get_partition_index(), node);
+                _dirty_partitions.insert(gpid);
             }
         }
     }
@@ -1322,6 +1869,7 @@ void server_state::on_propose_balancer(const configuration_balancer_request& req
             for (configuration_proposal_action& act: cc.balancer_proposal->action_list)
                 if (act.target.is_invalid())
                     act.target = pc.primary;
+            _dirty_partitions.insert(request.gpid);
         }
         response.err = ERR_OK;
     }
@@ -1347,6 +1895,7 @@ void server_state::apply_migration_actions(migration_list &ml)
         dassert(app->status==app_status::AS_AVAILABLE, "");
         config_context& cc = app->helpers->contexts[gpid.get_partition_index()];
         cc.balancer_proposal = std::move(req);
+        _dirty_partitions.insert(gpid);
     }
     ml.clear();
 }
@@ -1387,38 +1936,62 @@ bool server_state::is_server_state_stable(int healthy_partitions)
     return true;
 }
 
+//only the partitions touched since the last round and those not healthy in it
+//are cured, as a healthy partition can't turn ill without a config update,
+//a node state change or a balancer proposal, which all mark it dirty; all the
+//partitions are marked on start, and once in partition_full_check_rounds rounds
+//in case a mark is missed
 bool server_state::check_all_partitions()
 {
-    int healthy_partitions = 0;
     bool is_service_freeze = _meta_svc->is_service_freezed();
     bool is_migration_disabled = (_meta_svc->get_control_flags()&meta_ctrl_flags::ctrl_disable_replica_migration);
+    uint64_t full_check_rounds = _meta_svc->get_meta_options().partition_full_check_rounds;
+
+    if (!is_service_freeze && full_check_rounds > 0 && ++_check_rounds % full_check_rounds == 0)
+    {
+        dinfo("check all partitions in round %" PRIu64, _check_rounds);
+        mark_all_partitions_dirty();
+    }
 
     zauto_write_lock l(_lock);
-    for (auto& app_pair: _exist_apps)
+    if (!is_service_freeze)
     {
-        std::shared_ptr<app_state>& app = app_pair.second;
-        if (app->status == app_status::AS_CREATING || app->status == app_status::AS_DROPPING)
-            continue;
-        for (unsigned int i=0; i!=app->partition_count; ++i)
+        drain_primaries();
+
+        std::set<dsn::gpid> candidates;
+        candidates.swap(_dirty_partitions);
+        candidates.insert(_unhealthy_partitions.begin(), _unhealthy_partitions.end());
+        _unhealthy_partitions.clear();
+
+        dinfo("check %d partitions", (int)candidates.size());
+        for (const dsn::gpid& gpid: candidates)
         {
-            partition_configuration& pc = app->partitions[i];
-            config_context& cc = app->helpers->contexts[i];
+            std::shared_ptr<app_state> app = get_app(gpid.get_app_id());
+            if (app == nullptr || app->status != app_status::AS_AVAILABLE)
+                continue;
 
-            if (cc.stage != config_status::pending_remote_sync && !is_service_freeze)
+            partition_configuration& pc = app->partitions[gpid.get_partition_index()];
+            config_context& cc = app->helpers->contexts[gpid.get_partition_index()];
+            if (cc.stage == config_status::pending_remote_sync)
             {
-                configuration_proposal_action action;
-                pc_status s = _meta_svc->get_balancer()->cure({&_all_apps, &_nodes}, pc.pid, action);
-                dinfo("gpid(%d.%d) is in status(%s)", pc.pid.get_app_id(), pc.pid.get_partition_index(), enum_to_string(s));
-                if (pc_status::healthy == s)
-                {
-                    ++healthy_partitions;
-                }
-                else if (action.type != config_type::CT_INVALID)
+                _unhealthy_partitions.insert(gpid);
+                continue;
+            }
+
+            configuration_proposal_action action;
+            pc_status s = _meta_svc->get_balancer()->cure({&_all_apps, &_nodes}, pc.pid, action);
+            dinfo("gpid(%d.%d) is in status(%s)", pc.pid.get_app_id(), pc.pid.get_partition_index(), enum_to_string(s));
+            if (pc_status::healthy != s)
+            {
+                _unhealthy_partitions.insert(gpid);
+                if (action.type != config_type::CT_INVALID)
                 {
                     send_proposal(action, pc, *app);
                 }
             }
         }
+
+        trigger_partition_splits();
     }
 
     if (is_service_freeze || is_migration_disabled)
@@ -1427,9 +2000,16 @@ bool server_state::check_all_partitions()
         return false;
     }
 
+    int healthy_partitions = count_partitions(_all_apps) - static_cast<int>(_unhealthy_partitions.size());
     if ( !is_server_state_stable(healthy_partitions) )
         return false;
 
+    if (!_draining_nodes.empty())
+    {
+        ddebug("don't do replica migration coz %d nodes are draining", (int)_draining_nodes.size());
+        return false;
+    }
+
     dinfo("try to do replica migration");
     if (_meta_svc->get_balancer()->balance({&_all_apps, &_nodes}, _temporary_list) )
     {
@@ -1443,6 +2023,114 @@ bool server_state::check_all_partitions()
     return true;
 }
 
+//called under the write lock, each primary of a draining node is downgraded to
+//secondary and one of its secondaries upgraded, as one balancer proposal; the
+//primary hands off only after its secondaries have acked all it prepared (see
+//replica::downgrade_to_secondary_on_primary), so no write is lost and the
+//writes stall only for the two config updates
+void server_state::drain_primaries()
+{
+    for (auto nit = _draining_nodes.begin(); nit != _draining_nodes.end(); )
+    {
+        const dsn::rpc_address& node = *nit;
+        auto it = _nodes.find(node);
+        if (it == _nodes.end() || !it->second.is_alive || it->second.primaries.empty())
+        {
+            //the replica migration held off for the drain goes on then
+            ddebug("drain of %s is done, %s", node.to_string(),
+                (it == _nodes.end() || !it->second.is_alive) ? "the node is dead" : "no primary is left");
+            nit = _draining_nodes.erase(nit);
+            continue;
+        }
+        ++nit;
+
+        for (const dsn::gpid& gpid: it->second.primaries)
+        {
+            std::shared_ptr<app_state> app = get_app(gpid.get_app_id());
+            if (app == nullptr || app->status != app_status::AS_AVAILABLE)
+                continue;
+
+            partition_configuration& pc = app->partitions[gpid.get_partition_index()];
+            config_context& cc = app->helpers->contexts[gpid.get_partition_index()];
+            if (cc.stage == config_status::pending_remote_sync || !cc.empty_balancer_proposals())
+                continue;
+
+            //the secondary with the fewest primaries which is not draining as well
+            dsn::rpc_address target;
+            size_t target_primaries = 0;
+            for (const dsn::rpc_address& sec: pc.secondaries)
+            {
+                auto sit = _nodes.find(sec);
+                if (sit == _nodes.end() || !sit->second.is_alive || _draining_nodes.find(sec) != _draining_nodes.end())
+                    continue;
+                if (target.is_invalid() || sit->second.primaries.size() < target_primaries)
+                {
+                    target = sec;
+                    target_primaries = sit->second.primaries.size();
+                }
+            }
+            if (target.is_invalid())
+            {
+                dwarn("gpid(%d.%d) has no secondary to take over the primary from draining node %s",
+                    gpid.get_app_id(), gpid.get_partition_index(), node.to_string());
+                continue;
+            }
+
+            ddebug("hand off the primary of gpid(%d.%d) from %s to %s",
+                gpid.get_app_id(), gpid.get_partition_index(), node.to_string(), target.to_string());
+            std::shared_ptr<configuration_balancer_request> proposal = std::make_shared<configuration_balancer_request>();
+            proposal->gpid = gpid;
+            proposal->action_list.emplace_back(node, node, config_type::CT_DOWNGRADE_TO_SECONDARY);
+            proposal->action_list.emplace_back(target, target, config_type::CT_UPGRADE_TO_PRIMARY);
+            cc.balancer_proposal = std::move(proposal);
+            _dirty_partitions.insert(gpid);
+        }
+    }
+}
+
+std::string server_state::drain_node(const dsn::rpc_address& node, bool cancel)
+{
+    zauto_write_lock l(_lock);
+    std::stringstream out;
+    if (cancel)
+    {
+        _draining_nodes.erase(node);
+        out << "drain of " << node.to_string() << " is cancelled";
+        return out.str();
+    }
+
+    auto it = _nodes.find(node);
+    if (it == _nodes.end())
+    {
+        out << node.to_string() << " is not found";
+        return out.str();
+    }
+
+    _draining_nodes.insert(node);
+    out << node.to_string() << " is draining, " << it->second.primaries.size() << " primaries left";
+    return out.str();
+}
+
+void server_state::static_cli_drain_node(void* context, int argc, const char** argv, dsn_cli_reply* reply)
+{
+    auto _server_state = reinterpret_cast<server_state*>(context);
+    std::string* result;
+    dsn::rpc_address node;
+    bool cancel = (argc == 2 && (strcmp(argv[1], "-c") == 0 || strcmp(argv[1], "--cancel") == 0));
+    if ((argc != 1 && !cancel) || !node.from_string_ipv4(argv[0]))
+    {
+        result = new std::string("invalid command parameter");
+    }
+    else
+    {
+        result = new std::string(_server_state->drain_node(node, cancel));
+    }
+
+    reply->message = result->c_str();
+    reply->size = result->size();
+    reply->context = result;
+}
+
 void server_state::check_consistency(const dsn::gpid& gpid)
 {
     auto iter = _all_apps.find(gpid.get_app_id());
@@ -36,6 +36,7 @@
 #pragma once
 
 # include <unordered_map>
+# include <deque>
 # include <boost/lexical_cast.hpp>
 
 # include <dsn/dist/replication/replication_other_types.h>
@@ -77,6 +78,8 @@ public:
     // table options
     void create_app(dsn_message_t msg);
     void drop_app(dsn_message_t msg);
+    void split_app(dsn_message_t msg);
+    void notify_split_ready(dsn_message_t msg);
     void list_apps(const configuration_list_apps_request& request, configuration_list_apps_response& response);
 
     // update configuration
@@ -104,6 +107,7 @@ private:
     error_code sync_apps_from_remote_storage();
     error_code sync_apps_to_remote_storage();
     error_code initialize_default_apps();
+    void mark_all_partitions_dirty();
     void initialize_node_state();
 
     void check_consistency(const dsn::gpid& gpid);
@@ -111,8 +115,15 @@ private:
     void do_app_create(std::shared_ptr<app_state>& app, dsn_message_t msg);
     void do_app_drop(std::shared_ptr<app_state> &app, dsn_message_t msg);
     void init_app_partition_node(std::shared_ptr<app_state> &app, int pidx);
+    void do_app_split(std::shared_ptr<app_state>& app, dsn_message_t msg);
+    void do_split_ready(std::shared_ptr<app_state>& app, int child_index, dsn_message_t msg);
+    void trigger_partition_splits();
+    void drain_primaries();
 
     task_ptr update_configuration_on_remote(std::shared_ptr<configuration_update_request>& config_request);
+    void flush_remote_config_syncs();
+    void record_config_change(const partition_configuration& old_cfg, const partition_configuration& new_cfg);
+    void push_config_changes();
     void on_update_configuration_on_remote_reply(error_code ec, std::shared_ptr<configuration_update_request>& request);
     void update_configuration_locally(app_state& app, std::shared_ptr<configuration_update_request>& config_request);
     void apply_migration_actions(migration_list& ml);
@@ -169,6 +180,8 @@ private:
         {
             zauto_write_lock l(_lock);
             app->status = app_status::AS_AVAILABLE;
+            for (int i = 0; i < app->partition_count; ++i)
+                _dirty_partitions.insert(dsn::gpid(app->app_id, i));
             --_creating_apps_count;
         }
     }
@@ -194,12 +207,48 @@ private:
     //for load balancer
     migration_list                                      _temporary_list;
 
+    //recent config changes for the incremental config sync by node, the versions
+    //are consecutive, and only comparable within one _config_epoch
+    struct config_change
+    {
+        int64_t                                         version;
+        dsn::gpid                                       pid;
+        std::vector<dsn::rpc_address>                   nodes; // members before and after the change
+    };
+    int64_t                                             _config_epoch;
+    int64_t                                             _config_version;
+    std::deque<config_change>                           _config_changes;
+    std::set<dsn::rpc_address>                          _config_push_nodes;
+    bool                                                _config_push_scheduled;
+
+    //partitions check_all_partitions has to cure in the next round
+    std::set<dsn::gpid>                                 _dirty_partitions;
+    std::set<dsn::gpid>                                 _unhealthy_partitions;
+    uint64_t                                            _check_rounds;
+
+    //nodes whose primaries are handed off to their secondaries, e.g., before a restart,
+    //a node is dropped once it has no primary or is dead; kept in memory only, so a new
+    //meta leader forgets the drains and the command is issued to it again
+    std::set<dsn::rpc_address>                          _draining_nodes;
+
+    //config updates waiting to be written to remote storage in one transaction,
+    //a partition has at most one, as a newer request always cancels the older
+    struct remote_config_sync
+    {
+        std::shared_ptr<configuration_update_request>   request;
+        task_ptr                                        callback;
+    };
+    zlock                                               _remote_sync_lock;
+    std::map<dsn::gpid, remote_config_sync>             _remote_syncs;
+    bool                                                _remote_sync_scheduled;
+
     // for test
     config_change_subscriber                            _config_change_subscriber;
     replica_migration_subscriber                        _replica_migration_subscriber;
 
     dsn_handle_t                                        _cli_json_state_handle;
     dsn_handle_t                                        _cli_dump_handle;
+    dsn_handle_t                                        _cli_drain_node_handle;
 public:
     void json_state(std::stringstream& out) const;
     static void static_cli_json_state(void* context, int argc, const char** argv, dsn_cli_reply* reply);
@@ -207,6 +256,9 @@ public:
 
     static void static_cli_dump_app_states(void* context, int argc, const char** argv, dsn_cli_reply* reply);
     static void static_cli_dump_app_states_cleanup(dsn_cli_reply reply);
+
+    std::string drain_node(const dsn::rpc_address& node, bool cancel);
+    static void static_cli_drain_node(void* context, int argc, const char** argv, dsn_cli_reply* reply);
 };
 
 }}
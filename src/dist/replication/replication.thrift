@@ -156,6 +156,19 @@ struct group_check_response
     7:dsn.rpc_address     node;
 }
 
+// group checks of all partitions sent to the same node in one round
+struct group_check_batch_request
+{
+    1:dsn.rpc_address             node;
+    2:list<group_check_request>   requests;
+}
+
+// responses[i] is for requests[i]
+struct group_check_batch_response
+{
+    1:list<group_check_response>  responses;
+}
+
 /////////////////// meta server messages ////////////////////
 enum config_type
 {
@@ -207,16 +220,44 @@ struct configuration_update_response
     2:dsn.layer2.partition_configuration  config;
 }
 
+// load of one replica, as measured on its replica server
+struct replica_load
+{
+    1:dsn.gpid         pid;
+    2:double           qps;              // client requests per second
+    3:double           bytes_per_second; // client request bytes per second
+    4:i64              disk_usage_mb;    // of the replica dir
+}
+
 // client => meta server
+// config_epoch and config_version are those of the last response,
+// a full sync is replied when config_epoch is 0 or not the current one;
+// replica servers piggyback the loads of their replicas for the balancer
 struct configuration_query_by_node_request
 {
     1:dsn.rpc_address  node;
+    2:i64              config_epoch;
+    3:i64              config_version;
+    4:list<replica_load> loads;
 }
 
+// when is_incremental, partitions are only those changed after the requested
+// version, and gone_partitions are those moved away from the node since then
 struct configuration_query_by_node_response
 {
     1:dsn.error_code                    err;
     2:list<configuration_update_request> partitions;
+    3:bool                              is_incremental;
+    4:list<dsn.gpid>                    gone_partitions;
+    5:i64                               config_epoch;
+    6:i64                               config_version;
+}
+
+// meta server => replica server, the config of some partitions on the node is changed
+struct config_change_notification
+{
+    1:i64              config_epoch;
+    2:i64              config_version;
 }
 
 struct create_app_options
@@ -376,6 +417,69 @@ struct node_state
     4:set<dsn.gpid>   partitions;
 }
 
+// ingest checkpoint files built offline into all replicas of a partition
+struct bulk_load_request
+{
+    1:dsn.gpid        pid;
+    2:dsn.rpc_address source;     // node serving the files
+    3:string          source_dir;
+    4:list<string>    files;      // relative to source_dir, in the app's checkpoint format
+    5:i64             ballot;     // set by the primary
+    6:i64             signature;  // set by the primary
+}
+
+struct bulk_load_response
+{
+    1:dsn.error_code  err;
+    2:i64             decree;     // where the files are ingested
+}
+
+// the meta server asks the parent primary to seed its child partition
+struct split_partition_request
+{
+    1:dsn.gpid        parent;
+    2:i64             parent_ballot;
+    3:dsn.gpid        child;
+    4:dsn.rpc_address child_primary;
+    5:i32             partition_count; // after the split
+}
+
+// committed writes on the parent which belong to the child, in decree order
+struct split_forward_request
+{
+    1:dsn.gpid              child;
+    2:i64                   bulk_load_decree; // of the parent checkpoint on the child
+    3:list<mutation_update> updates;
+}
+
+struct split_forward_response
+{
+    1:dsn.error_code  err;
+}
+
+struct notify_split_ready_request
+{
+    1:dsn.gpid        parent;
+    2:i64             parent_ballot;
+    3:dsn.gpid        child;
+}
+
+struct notify_split_ready_response
+{
+    1:dsn.error_code  err;
+}
+
+struct configuration_split_app_request
+{
+    1:string          app_name;
+}
+
+struct configuration_split_app_response
+{
+    1:dsn.error_code  err;
+    2:i32             partition_count; // after the split
+}
+
 /*
 service replica_s
 {
@@ -1,9 +1,13 @@
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
 #include <gtest/gtest.h>
 
 #include "meta_data.h"
 #include "server_load_balancer.h"
 #include "greedy_load_balancer.h"
+#include "load_aware_balancer.h"
 #include "../misc/misc.h"
 
 using namespace dsn::replication;
@@ -27,9 +31,10 @@ class simple_priority_queue {
 public:
     simple_priority_queue(const std::vector<dsn::rpc_address>& nl,
         server_load_balancer::node_comparator&& compare):
-        container(nl),
-        cmp(std::move(compare))
+        container(nl)
     {
+        //std heaps pop the largest, so the comparator is reversed to pop the least loaded
+        cmp = [compare](const dsn::rpc_address& r1, const dsn::rpc_address& r2) { return compare(r2, r1); };
         std::make_heap(container.begin(), container.end(), cmp);
     }
     void push(const dsn::rpc_address& addr)
@@ -58,7 +63,10 @@ void generate_balanced_apps(/*out*/app_mapper& apps, node_mapper& nodes, const s
 {
     nodes.clear();
     for (const auto& node: node_list)
+    {
         nodes[node].is_alive = true;
+        nodes[node].address = node;
+    }
 
     int partitions_per_node = random32(20, 100);
     dsn::app_info info;
@@ -98,6 +106,35 @@ void generate_balanced_apps(/*out*/app_mapper& apps, node_mapper& nodes, const s
             pq2.push(n);
     }
 
+    //a node is skipped for the secondaries of its own primaries, which may leave the replicas
+    //off by 2, so a secondary is moved from the most loaded node to the least loaded one then
+    while (true)
+    {
+        auto cmp = [](const node_mapper::value_type& l, const node_mapper::value_type& r)
+        {
+            return l.second.partitions.size() < r.second.partitions.size();
+        };
+        node_state& most = std::max_element(nodes.begin(), nodes.end(), cmp)->second;
+        node_state& least = std::min_element(nodes.begin(), nodes.end(), cmp)->second;
+        if (most.partitions.size() - least.partitions.size() <= 1)
+            break;
+
+        dsn::partition_configuration* moved = nullptr;
+        for (const dsn::gpid& pid: most.partitions)
+        {
+            dsn::partition_configuration& pc = the_app->partitions[pid.get_partition_index()];
+            if (pc.primary != most.address && !is_member(pc, least.address))
+            {
+                moved = &pc;
+                break;
+            }
+        }
+        ASSERT_TRUE(moved != nullptr);
+        std::replace(moved->secondaries.begin(), moved->secondaries.end(), most.address, least.address);
+        most.partitions.erase(moved->pid);
+        least.partitions.emplace(moved->pid);
+    }
+
     //check if balanced
     int pri_min, part_min;
     pri_min = part_min = the_app->partition_count + 1;
@@ -106,14 +143,11 @@ void generate_balanced_apps(/*out*/app_mapper& apps, node_mapper& nodes, const s
 
     for (auto& kv: nodes)
     {
-        if (kv.second.primaries.size() > pri_max)
-            pri_max = kv.second.primaries.size();
-        if (kv.second.primaries.size() < pri_min)
-            pri_min = kv.second.primaries.size();
-        if (kv.second.partitions.size() > part_max)
-            part_max = kv.second.partitions.size();
-        if (kv.second.partitions.size() < part_min)
-            part_min = kv.second.partitions.size();
+        int p = kv.second.primaries.size(), r = kv.second.partitions.size();
+        pri_max = std::max(pri_max, p);
+        pri_min = std::min(pri_min, p);
+        part_max = std::max(part_max, r);
+        part_min = std::min(part_min, r);
     }
 
     apps.emplace(the_app->app_id, the_app);
@@ -124,7 +158,7 @@ void generate_balanced_apps(/*out*/app_mapper& apps, node_mapper& nodes, const s
 
 void random_move_primary(app_mapper& apps, node_mapper& nodes, int primary_move_ratio)
 {
-    app_state& the_app = *(apps[0]);
+    app_state& the_app = *(apps.begin()->second);
     int space_size = the_app.partition_count*100;
     for (dsn::partition_configuration& pc: the_app.partitions) {
         int n = random32(1, space_size)/100;
@@ -153,6 +187,7 @@ void greedy_balancer_perfect_move_primary()
     greedy_load_balancer glb(nullptr);
     migration_list ml;
 
+    //the replicas are balanced already, so only primary switches are expected
     while ( glb.balance({&apps, &nodes}, ml) )
     {
         for (std::shared_ptr<configuration_balancer_request>& req: ml) {
@@ -160,12 +195,255 @@ void greedy_balancer_perfect_move_primary()
                 ASSERT_TRUE( act.type!=config_type::CT_ADD_SECONDARY_FOR_LB );
             }
         }
+        migration_check_and_apply(apps, nodes, ml);
+    }
+}
+
+//every replica reports the same disk usage, and only the primary of a partition
+//reports its qps, as the requests only go to the primary
+static void report_loads(load_aware_balancer& lb, const app_mapper& apps, const node_mapper& nodes, const std::vector<double>& qps)
+{
+    const app_state& the_app = *(apps.begin()->second);
+    for (auto& kv: nodes)
+    {
+        std::vector<replica_load> loads;
+        for (const dsn::gpid& pid: kv.second.partitions)
+        {
+            replica_load load;
+            load.pid = pid;
+            load.qps = (the_app.partitions[pid.get_partition_index()].primary == kv.first ? qps[pid.get_partition_index()] : 0);
+            load.bytes_per_second = 0;
+            load.disk_usage_mb = 100;
+            loads.push_back(load);
+        }
+        lb.report_load(kv.first, loads);
+    }
+}
+
+//the node loads as load_aware_balancer weighs the reports above with its default weights:
+//a replica weighs 1 (count 0.5 and disk 0.5) and a primary its qps over the average
+static void node_loads(const app_mapper& apps, const node_mapper& nodes, const std::vector<double>& qps, double& max_load, double& avg_load)
+{
+    const app_state& the_app = *(apps.begin()->second);
+    double avg_qps = 0;
+    for (double q: qps)
+        avg_qps += q;
+    avg_qps /= qps.size();
+
+    max_load = avg_load = 0;
+    for (auto& kv: nodes)
+    {
+        double load = kv.second.partitions.size();
+        for (const dsn::gpid& pid: kv.second.primaries)
+            load += qps[pid.get_partition_index()] / avg_qps;
+        max_load = std::max(max_load, load);
+        avg_load += load;
+    }
+    avg_load /= nodes.size();
+    ASSERT_EQ(the_app.partition_count, (int)qps.size());
+}
+
+void load_aware_balancer_skewed_load()
+{
+    app_mapper apps;
+    node_mapper nodes;
+    std::vector<dsn::rpc_address> node_list;
+
+    generate_node_list(node_list, 10, 10);
+    generate_balanced_apps(apps, nodes, node_list);
+
+    //the partitions with primaries on two of the nodes are 20 times as hot as the others
+    const app_state& the_app = *(apps.begin()->second);
+    std::vector<double> qps(the_app.partition_count, 1);
+    for (const dsn::partition_configuration& pc: the_app.partitions)
+    {
+        if (pc.primary == node_list[0] || pc.primary == node_list[1])
+            qps[pc.pid.get_partition_index()] = 20;
     }
+
+    double max_load, avg_load;
+    node_loads(apps, nodes, qps, max_load, avg_load);
+    double initial_max = max_load;
+    ASSERT_TRUE(max_load > avg_load * 1.1);
+
+    //each round never raises the max node load, and the balancer stops once it is
+    //within the default tolerance of 10% above the average
+    load_aware_balancer lb(nullptr);
+    migration_list ml;
+    int rounds = 0;
+    while (true)
+    {
+        report_loads(lb, apps, nodes, qps);
+        if (!lb.balance({&apps, &nodes}, ml))
+            break;
+
+        ASSERT_TRUE(++rounds < 1000);
+        migration_check_and_apply(apps, nodes, ml);
+
+        double last_max = max_load;
+        node_loads(apps, nodes, qps, max_load, avg_load);
+        ASSERT_TRUE(max_load <= last_max + 1e-9);
+    }
+
+    ASSERT_TRUE(max_load < initial_max);
+    ASSERT_TRUE(max_load <= avg_load * 1.1 + 1e-9);
+
+    //and it stays stopped
+    report_loads(lb, apps, nodes, qps);
+    ASSERT_FALSE(lb.balance({&apps, &nodes}, ml));
 }
 
-int main(int, char**)
+//
+// benchmark of balance() on large clusters, each round is timed and its proposals
+// are applied before the next one, till the balancer has nothing more to do
+//
+struct benchmark_result
+{
+    int rounds;
+    int switches; // primary switches, which copy no data
+    int copies;   // replica copies
+    double total_ms;
+    double max_round_ms;
+    bool balanced;
+};
+
+static void generate_large_cluster(
+    /*out*/app_mapper& apps,
+    /*out*/node_mapper& nodes,
+    int node_count,
+    int partition_count,
+    bool scale_out)
+{
+    std::vector<dsn::rpc_address> node_list(node_count);
+    for (int i=0; i<node_count; ++i)
+        node_list[i].assign_ipv4("127.0.0.1", i+1);
+
+    dsn::app_info info;
+    info.status = dsn::app_status::AS_AVAILABLE;
+    info.is_stateful = true;
+    info.app_id = 1; info.app_name = "bench"; info.app_type = "test";
+    info.partition_count = partition_count;
+    info.max_replica_count = 3;
+    std::shared_ptr<app_state> the_app = app_state::create(info);
+
+    apps.clear();
+    if (scale_out)
+    {
+        //a balanced cluster with 10% new empty nodes
+        int old_count = node_count*9/10;
+        for (dsn::partition_configuration& pc: the_app->partitions)
+        {
+            int i = pc.pid.get_partition_index();
+            pc.primary = node_list[i % old_count];
+            pc.secondaries.clear();
+            pc.secondaries.push_back(node_list[(i + 1 + i / old_count % (old_count - 2)) % old_count]);
+            pc.secondaries.push_back(node_list[(i + 2 + i / old_count % (old_count - 2)) % old_count]);
+        }
+        apps.emplace(the_app->app_id, the_app);
+    }
+    else
+    {
+        //replicas are put on random nodes
+        apps.emplace(the_app->app_id, the_app);
+        generate_app(the_app, node_list);
+    }
+    generate_node_mapper(nodes, apps, node_list);
+}
+
+static benchmark_result run_benchmark(server_load_balancer& lb, app_mapper& apps, node_mapper& nodes, int max_rounds)
+{
+    benchmark_result result = {0, 0, 0, 0, 0, false};
+    migration_list ml;
+    for (; result.rounds < max_rounds; ++result.rounds)
+    {
+        auto start = std::chrono::steady_clock::now();
+        bool has_proposals = lb.balance({&apps, &nodes}, ml);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        result.total_ms += ms;
+        result.max_round_ms = std::max(result.max_round_ms, ms);
+        if (!has_proposals)
+        {
+            result.balanced = true;
+            break;
+        }
+
+        for (std::shared_ptr<configuration_balancer_request>& req: ml)
+        {
+            if (req->action_list.size() == 2 && req->action_list[0].type == config_type::CT_DOWNGRADE_TO_SECONDARY)
+                ++result.switches;
+            else
+                ++result.copies;
+        }
+        migration_check_and_apply(apps, nodes, ml);
+    }
+    return result;
+}
+
+static void print_spread(const node_mapper& nodes)
+{
+    size_t pri_min = SIZE_MAX, pri_max = 0, part_min = SIZE_MAX, part_max = 0;
+    for (auto& kv: nodes)
+    {
+        pri_min = std::min(pri_min, kv.second.primaries.size());
+        pri_max = std::max(pri_max, kv.second.primaries.size());
+        part_min = std::min(part_min, kv.second.partitions.size());
+        part_max = std::max(part_max, kv.second.partitions.size());
+    }
+    printf("    primaries per node: [%d, %d], replicas per node: [%d, %d]\n",
+        (int)pri_min, (int)pri_max, (int)part_min, (int)part_max);
+}
+
+static void greedy_balancer_benchmark(const std::vector<int>& node_counts, int partition_count, int max_rounds, int max_round_ms)
+{
+    for (int node_count: node_counts)
+    {
+        for (int scale_out = 0; scale_out < 2; ++scale_out)
+        {
+            app_mapper apps;
+            node_mapper nodes;
+            generate_large_cluster(apps, nodes, node_count, partition_count, scale_out != 0);
+
+            printf("greedy_load_balancer, %d nodes, %d partitions, %s, %d ms per round at most\n",
+                node_count, partition_count, scale_out ? "10% new nodes" : "random layout", max_round_ms);
+            print_spread(nodes);
+
+            greedy_load_balancer glb(nullptr);
+            glb.set_max_round_ms(max_round_ms);
+            benchmark_result r = run_benchmark(glb, apps, nodes, max_rounds);
+            printf("    %s after %d rounds, %d switches, %d copies, balance() took %.1f ms in total, %.1f ms at most\n",
+                r.balanced ? "balanced" : "not balanced", r.rounds, r.switches, r.copies, r.total_ms, r.max_round_ms);
+            print_spread(nodes);
+        }
+    }
+}
+
+// sim_lb [node counts, e.g. 1000,5000,10000] [partition count] [max rounds] [max ms per round, 0 for no limit]
+int main(int argc, char** argv)
 {
     dsn_run_config("config.ini", false);
     greedy_balancer_perfect_move_primary();
+    load_aware_balancer_skewed_load();
+
+    std::vector<int> node_counts = {1000, 5000, 10000};
+    int partition_count = 1000000;
+    int max_rounds = 1000;
+    int max_round_ms = 100;
+    if (argc > 1)
+    {
+        node_counts.clear();
+        std::stringstream ss(argv[1]);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            node_counts.push_back(atoi(item.c_str()));
+    }
+    if (argc > 2)
+        partition_count = atoi(argv[2]);
+    if (argc > 3)
+        max_rounds = atoi(argv[3]);
+    if (argc > 4)
+        max_round_ms = atoi(argv[4]);
+
+    greedy_balancer_benchmark(node_counts, partition_count, max_rounds, max_round_ms);
     return 0;
 }
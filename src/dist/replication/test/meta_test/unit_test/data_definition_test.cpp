@@ -47,6 +47,13 @@ public:
         &dsn::replication::server_state::drop_app, \
         request_data)
 
+#define fake_split_app(state, request_data) \
+    fake_rpc_call(RPC_CM_SPLIT_APP, \
+        LPC_META_STATE_NORMAL, \
+        state, \
+        &dsn::replication::server_state::split_app, \
+        request_data)
+
 #define fake_wait_rpc(context, response_data) do {\
     context->e.wait();\
     ::dsn::unmarshall(context->response, response_data);\
@@ -179,4 +186,89 @@ void meta_service_test_app::data_definition_op_test()
             ASSERT_EQ(info.status, dsn::app_status::AS_AVAILABLE);
         }
     }
+
+    //split is refused when the app is missing, or the parents have no primary to seed the children
+    dsn::replication::configuration_split_app_request split_request;
+    dsn::replication::configuration_split_app_response split_response;
+    split_request.app_name = "not_exist_app";
+    result = fake_split_app(svc->_state.get(), split_request);
+    fake_wait_rpc(result, split_response);
+    ASSERT_EQ(dsn::ERR_APP_NOT_EXIST, split_response.err);
+
+    split_request.app_name = create_request.app_name;
+    result = fake_split_app(svc->_state.get(), split_request);
+    fake_wait_rpc(result, split_response);
+    ASSERT_EQ(dsn::ERR_INVALID_STATE, split_response.err);
+    ASSERT_EQ(create_request.options.partition_count, split_response.partition_count);
+
+    //split happy path: the children are hidden from the clients and their keys are
+    //served by the parents, till each child is ready and takes its half over
+    std::shared_ptr<dsn::replication::app_state> app = svc->_state->get_app(create_request.app_name);
+    int parent_count = app->partition_count;
+    for (dsn::partition_configuration& pc: app->partitions)
+        pc.primary = dsn::rpc_address("127.0.0.1", 34801);
+
+    result = fake_split_app(svc->_state.get(), split_request);
+    fake_wait_rpc(result, split_response);
+    ASSERT_EQ(dsn::ERR_OK, split_response.err);
+    ASSERT_EQ(2*parent_count, split_response.partition_count);
+    ASSERT_EQ(2*parent_count, app->partition_count);
+    ASSERT_EQ(2*parent_count, app->partitions.size());
+    ASSERT_EQ(parent_count, dsn::replication::replica_helper::get_split_parent_count(*app));
+
+    //exactly one partition serves a key hash, and it is the one the clients route it to
+    auto check_routing = [&]()
+    {
+        dsn::configuration_query_by_index_request query_request;
+        dsn::configuration_query_by_index_response query_response;
+        query_request.app_name = app->app_name;
+        svc->_state->query_configuration_by_index(query_request, query_response);
+        ASSERT_EQ(dsn::ERR_OK, query_response.err);
+        ASSERT_EQ(app->partition_count, query_response.partition_count);
+
+        for (uint64_t hash = 0; hash != 10*app->partition_count; ++hash) {
+            int route = static_cast<int>(hash % app->partition_count);
+            for (const dsn::partition_configuration& pc: query_response.partitions) {
+                if (pc.pid.get_partition_index() == route && pc.ballot < 0)
+                    route -= parent_count;
+            }
+
+            int serving = -1;
+            for (int i = 0; i != app->partition_count; ++i) {
+                int count = dsn::replication::replica_helper::get_serving_partition_count(*app, i);
+                if (count > 0 && hash % count == static_cast<uint64_t>(i)) {
+                    ASSERT_EQ(-1, serving);
+                    serving = i;
+                }
+            }
+            ASSERT_EQ(route, serving);
+        }
+    };
+
+    check_routing();
+    for (int i = 0; i != parent_count; ++i) {
+        ASSERT_EQ(parent_count, dsn::replication::replica_helper::get_serving_partition_count(*app, i));
+        ASSERT_EQ(0, dsn::replication::replica_helper::get_serving_partition_count(*app, i + parent_count));
+    }
+
+    //the seeded child gets a primary, and its parent reports it ready
+    int child_index = parent_count + 3;
+    app->partitions[child_index].primary = app->partitions[3].primary;
+
+    dsn::replication::notify_split_ready_request ready_request;
+    dsn::replication::notify_split_ready_response ready_response;
+    ready_request.parent = app->partitions[3].pid;
+    ready_request.parent_ballot = app->partitions[3].ballot;
+    ready_request.child = app->partitions[child_index].pid;
+    result = fake_rpc_call(RPC_CM_NOTIFY_SPLIT_READY, LPC_META_STATE_NORMAL, svc->_state.get(),
+        &dsn::replication::server_state::notify_split_ready, ready_request);
+    fake_wait_rpc(result, ready_response);
+    ASSERT_EQ(dsn::ERR_OK, ready_response.err);
+    ASSERT_TRUE(dsn::replication::replica_helper::is_split_child_ready(*app, child_index));
+
+    check_routing();
+    ASSERT_EQ(2*parent_count, dsn::replication::replica_helper::get_serving_partition_count(*app, 3));
+    ASSERT_EQ(2*parent_count, dsn::replication::replica_helper::get_serving_partition_count(*app, child_index));
+    ASSERT_EQ(parent_count, dsn::replication::replica_helper::get_serving_partition_count(*app, 4));
+    ASSERT_EQ(0, dsn::replication::replica_helper::get_serving_partition_count(*app, child_index + 1));
 }
@@ -27,6 +27,21 @@ TEST(meta, update_configuration)
     g_app->update_configuration_test();
 }
 
+TEST(meta, remote_sync_failure)
+{
+    g_app->remote_sync_failure_test();
+}
+
+TEST(meta, drain_node)
+{
+    g_app->drain_node_test();
+}
+
+TEST(meta, config_sync)
+{
+    g_app->config_sync_test();
+}
+
 TEST(meta, balancer_validator)
 {
     g_app->balancer_validator();
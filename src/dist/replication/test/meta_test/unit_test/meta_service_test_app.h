@@ -39,6 +39,9 @@ public:
     void state_sync_test();
     void data_definition_op_test();
     void update_configuration_test();
+    void remote_sync_failure_test();
+    void drain_node_test();
+    void config_sync_test();
     void balancer_validator();
     void apply_balancer_test();
 
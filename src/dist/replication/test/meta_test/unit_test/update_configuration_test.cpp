@@ -22,6 +22,17 @@ public:
     virtual void reply_message(dsn_message_t request, dsn_message_t response) override {}
     virtual void send_message(const dsn::rpc_address& target, dsn_message_t request) override
     {
+        if (dsn_msg_task_code(request) == RPC_CONFIG_CHANGE_NOTIFY)
+        {
+            {
+                ::dsn::service::zauto_lock l(_notified_lock);
+                _notified_nodes.insert(target);
+            }
+            dsn_msg_add_ref(request);
+            dsn_msg_release_ref(request);
+            return;
+        }
+
         //we expect this is a configuration_update_request proposal
         dsn_message_t recv_request = create_corresponding_receive(request);
 
@@ -68,6 +79,81 @@ public:
 
         _app->call_update_configuration(this, update_req);
     }
+
+    bool is_notified(const dsn::rpc_address& node)
+    {
+        ::dsn::service::zauto_lock l(_notified_lock);
+        return _notified_nodes.find(node) != _notified_nodes.end();
+    }
+
+private:
+    ::dsn::service::zlock _notified_lock;
+    std::set<dsn::rpc_address> _notified_nodes;
+};
+
+//fails every transaction and the set_data of one node, other calls go to the wrapped storage
+class failing_remote_storage: public dsn::dist::meta_state_service
+{
+public:
+    failing_remote_storage(const std::shared_ptr<dsn::dist::meta_state_service>& storage, const std::string& bad_node):
+        _storage(storage), _bad_node(bad_node), failed_transactions(0), set_data_count(0)
+    {
+    }
+
+    virtual dsn::error_code initialize(const std::vector<std::string>& args) override { return dsn::ERR_OK; }
+    virtual dsn::error_code finalize() override { return dsn::ERR_OK; }
+
+    virtual std::shared_ptr<transaction_entries> new_transaction_entries(unsigned int capacity) override
+    {
+        return _storage->new_transaction_entries(capacity);
+    }
+    virtual dsn::task_ptr submit_transaction(const std::shared_ptr<transaction_entries>& entries,
+        dsn::task_code cb_code, const err_callback& cb_transaction, dsn::clientlet* tracker) override
+    {
+        ++failed_transactions;
+        return dsn::tasking::enqueue(cb_code, tracker, std::bind(cb_transaction, dsn::ERR_OBJECT_NOT_FOUND));
+    }
+    virtual dsn::task_ptr create_node(const std::string& node,
+        dsn::task_code cb_code, const err_callback& cb_create, const dsn::blob& value, dsn::clientlet* tracker) override
+    {
+        return _storage->create_node(node, cb_code, cb_create, value, tracker);
+    }
+    virtual dsn::task_ptr delete_node(const std::string& node, bool recursively_delete,
+        dsn::task_code cb_code, const err_callback& cb_delete, dsn::clientlet* tracker) override
+    {
+        return _storage->delete_node(node, recursively_delete, cb_code, cb_delete, tracker);
+    }
+    virtual dsn::task_ptr node_exist(const std::string& node,
+        dsn::task_code cb_code, const err_callback& cb_exist, dsn::clientlet* tracker) override
+    {
+        return _storage->node_exist(node, cb_code, cb_exist, tracker);
+    }
+    virtual dsn::task_ptr get_data(const std::string& node,
+        dsn::task_code cb_code, const err_value_callback& cb_get_data, dsn::clientlet* tracker) override
+    {
+        return _storage->get_data(node, cb_code, cb_get_data, tracker);
+    }
+    virtual dsn::task_ptr set_data(const std::string& node, const dsn::blob& value,
+        dsn::task_code cb_code, const err_callback& cb_set_data, dsn::clientlet* tracker) override
+    {
+        ++set_data_count;
+        if (node == _bad_node)
+            return dsn::tasking::enqueue(cb_code, tracker, std::bind(cb_set_data, dsn::ERR_OBJECT_NOT_FOUND));
+        return _storage->set_data(node, value, cb_code, cb_set_data, tracker);
+    }
+    virtual dsn::task_ptr get_children(const std::string& node,
+        dsn::task_code cb_code, const err_stringv_callback& cb_get_children, dsn::clientlet* tracker) override
+    {
+        return _storage->get_children(node, cb_code, cb_get_children, tracker);
+    }
+
+private:
+    std::shared_ptr<dsn::dist::meta_state_service> _storage;
+    std::string _bad_node;
+
+public:
+    std::atomic_int failed_transactions;
+    std::atomic_int set_data_count;
 };
 
 void meta_service_test_app::call_update_configuration(meta_service *svc,
@@ -186,6 +272,313 @@ void meta_service_test_app::update_configuration_test()
     ASSERT_TRUE(wait_state(ss, validator3, 10));
 }
 
+void meta_service_test_app::remote_sync_failure_test()
+{
+    dsn::error_code ec;
+    std::shared_ptr<fake_sender_meta_service> svc(new fake_sender_meta_service(this));
+    ec = svc->remote_storage_initialize();
+    ASSERT_EQ(ec, dsn::ERR_OK);
+    svc->_balancer.reset(new simple_load_balancer(svc.get()));
+    //both updates go in one transaction
+    svc->_meta_opts.config_sync_batch_interval_ms = 500;
+
+    server_state* ss = svc->_state.get();
+    ss->initialize(svc.get(), meta_options::concat_path_unix_style(svc->_cluster_root, "apps"));
+    dsn::app_info info;
+    info.is_stateful = true;
+    info.status = dsn::app_status::AS_CREATING;
+    info.app_id = 1; info.app_name = "simple_kv.instance0"; info.app_type = "simple_kv";
+    info.max_replica_count = 2; info.partition_count = 2;
+    std::shared_ptr<app_state> app = app_state::create(info);
+
+    ss->_all_apps.emplace(1, app);
+
+    std::vector<dsn::rpc_address> nodes;
+    generate_node_list(nodes, 3, 3);
+
+    //a replica more than max_replica_count, so no cure is proposed once one is removed
+    for (int i = 0; i != 2; ++i)
+    {
+        dsn::partition_configuration& pc = app->partitions[i];
+        pc.primary = nodes[i];
+        pc.secondaries.push_back(nodes[1 - i]);
+        pc.secondaries.push_back(nodes[2]);
+        pc.ballot = 3;
+    }
+
+    ss->sync_apps_to_remote_storage();
+    ASSERT_TRUE(ss->spin_wait_creating(30));
+    ss->initialize_node_state();
+    svc->set_node_state(nodes, true);
+    svc->_started = true;
+
+    //the config of partition 1 can't be written, which must not fail that of partition 0
+    std::shared_ptr<failing_remote_storage> storage = std::make_shared<failing_remote_storage>(
+        svc->_storage, ss->get_partition_path(app->partitions[1].pid));
+    svc->_storage = storage;
+
+    dsn::task_ptr t = dsn::tasking::enqueue(
+        LPC_META_STATE_HIGH,
+        nullptr,
+        [ss, app, &nodes]()
+        {
+            for (int i = 0; i != 2; ++i)
+            {
+                std::shared_ptr<configuration_update_request> request = std::make_shared<configuration_update_request>();
+                request->info = *app;
+                request->config = app->partitions[i];
+                request->type = config_type::CT_DOWNGRADE_TO_INACTIVE;
+                request->node = nodes[2];
+                request->config.ballot++;
+                replica_helper::remove_node(nodes[2], request->config.secondaries);
+
+                dsn_message_t msg = dsn_msg_create_request(RPC_CM_UPDATE_PARTITION_CONFIGURATION);
+                ::dsn::marshall(msg, *request);
+                dsn_message_t received = create_corresponding_receive(msg);
+                dsn_msg_add_ref(received);
+                dsn_msg_add_ref(msg);
+                dsn_msg_release_ref(msg);
+
+                ss->on_update_configuration(request, received);
+            }
+        },
+        server_state::s_state_write_hash
+        );
+    t->wait();
+
+    bool synced = false;
+    for (int i = 0; i != 30 && !synced; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        zauto_read_lock l(ss->_lock);
+        synced = app->helpers->contexts[0].stage == config_status::not_pending
+            && app->helpers->contexts[1].stage == config_status::not_pending;
+    }
+    ASSERT_TRUE(synced);
+
+    //one failed transaction of the two, then one set_data each
+    ASSERT_EQ(1, storage->failed_transactions.load());
+    ASSERT_EQ(2, storage->set_data_count.load());
+
+    {
+        zauto_read_lock l(ss->_lock);
+        const dsn::partition_configuration& pc0 = app->partitions[0];
+        ASSERT_EQ(4, pc0.ballot);
+        ASSERT_EQ(1u, pc0.secondaries.size());
+        ASSERT_EQ(nodes[1], pc0.secondaries[0]);
+
+        const dsn::partition_configuration& pc1 = app->partitions[1];
+        ASSERT_EQ(3, pc1.ballot);
+        ASSERT_EQ(2u, pc1.secondaries.size());
+        ASSERT_TRUE(app->helpers->contexts[1].msg == nullptr);
+    }
+}
+
+void meta_service_test_app::drain_node_test()
+{
+    dsn::error_code ec;
+    std::shared_ptr<fake_sender_meta_service> svc(new fake_sender_meta_service(this));
+    ec = svc->remote_storage_initialize();
+    ASSERT_EQ(ec, dsn::ERR_OK);
+    svc->_balancer.reset(new simple_load_balancer(svc.get()));
+
+    server_state* ss = svc->_state.get();
+    ss->initialize(svc.get(), meta_options::concat_path_unix_style(svc->_cluster_root, "apps"));
+    dsn::app_info info;
+    info.is_stateful = true;
+    info.status = dsn::app_status::AS_CREATING;
+    info.app_id = 1; info.app_name = "simple_kv.instance0"; info.app_type = "simple_kv";
+    info.max_replica_count = 3; info.partition_count = 6;
+    std::shared_ptr<app_state> app = app_state::create(info);
+
+    ss->_all_apps.emplace(1, app);
+
+    std::vector<dsn::rpc_address> nodes;
+    generate_node_list(nodes, 4, 4);
+
+    //primaries are spread over nodes 0-2, each with the other two as secondaries
+    for (int i = 0; i != info.partition_count; ++i)
+    {
+        dsn::partition_configuration& pc = app->partitions[i];
+        pc.primary = nodes[i % 3];
+        pc.secondaries.push_back(nodes[(i + 1) % 3]);
+        pc.secondaries.push_back(nodes[(i + 2) % 3]);
+        pc.ballot = 3;
+    }
+
+    ss->sync_apps_to_remote_storage();
+    ASSERT_TRUE(ss->spin_wait_creating(30));
+    ss->initialize_node_state();
+    svc->set_node_state({nodes[0], nodes[1], nodes[2]}, true);
+    svc->_started = true;
+
+    auto primary_count = [](const app_mapper& apps, const dsn::rpc_address& node)
+    {
+        int count = 0;
+        for (const dsn::partition_configuration& pc: apps.begin()->second->partitions)
+        {
+            if (pc.primary == node)
+                ++count;
+        }
+        return count;
+    };
+
+    //the primaries of node 0 are handed off to the secondaries, and the drain ends then
+    ASSERT_EQ(std::string::npos, ss->drain_node(nodes[3], false).find("is draining"));
+    ASSERT_NE(std::string::npos, ss->drain_node(nodes[0], false).find("2 primaries left"));
+    dsn::rpc_address drained = nodes[0];
+    state_validator handed_off = [ss, drained, primary_count](const app_mapper& apps)
+    {
+        for (const dsn::partition_configuration& pc: apps.begin()->second->partitions)
+        {
+            if (pc.primary.is_invalid() || pc.secondaries.size() != 2)
+                return false;
+        }
+        return primary_count(apps, drained) == 0 && ss->_draining_nodes.empty();
+    };
+    ASSERT_TRUE(wait_state(ss, handed_off, 30));
+    {
+        zauto_read_lock l(ss->_lock);
+        //node 0 is still a replica of every partition
+        for (const dsn::partition_configuration& pc: app->partitions)
+            ASSERT_TRUE(is_secondary(pc, drained));
+    }
+
+    //a drain of a dead node ends as well, not to hold off the replica migration for ever
+    ASSERT_NE(std::string::npos, ss->drain_node(nodes[1], false).find("is draining"));
+    svc->set_node_state({nodes[1]}, false);
+    dsn::rpc_address dead = nodes[1];
+    state_validator drain_ended = [ss, dead, primary_count](const app_mapper& apps)
+    {
+        return ss->_draining_nodes.empty() && primary_count(apps, dead) == 0;
+    };
+    ASSERT_TRUE(wait_state(ss, drain_ended, 30));
+}
+
+void meta_service_test_app::config_sync_test()
+{
+    dsn::error_code ec;
+    std::shared_ptr<fake_sender_meta_service> svc(new fake_sender_meta_service(this));
+    ec = svc->remote_storage_initialize();
+    ASSERT_EQ(ec, dsn::ERR_OK);
+    svc->_balancer.reset(new simple_load_balancer(svc.get()));
+
+    server_state* ss = svc->_state.get();
+    ss->initialize(svc.get(), meta_options::concat_path_unix_style(svc->_cluster_root, "apps"));
+    dsn::app_info info;
+    info.is_stateful = true;
+    info.status = dsn::app_status::AS_CREATING;
+    info.app_id = 1; info.app_name = "simple_kv.instance0"; info.app_type = "simple_kv";
+    info.max_replica_count = 3; info.partition_count = 4;
+    std::shared_ptr<app_state> app = app_state::create(info);
+
+    ss->_all_apps.emplace(1, app);
+
+    std::vector<dsn::rpc_address> nodes;
+    generate_node_list(nodes, 4, 4);
+
+    //partition i is on nodes i, i+1 and i+2, so node 3 is on all but partition 0,
+    //and node 0 on all but partition 1
+    for (int i = 0; i != info.partition_count; ++i)
+    {
+        dsn::partition_configuration& pc = app->partitions[i];
+        pc.primary = nodes[i];
+        pc.secondaries.push_back(nodes[(i + 1) % 4]);
+        pc.secondaries.push_back(nodes[(i + 2) % 4]);
+        pc.ballot = 3;
+    }
+
+    ss->sync_apps_to_remote_storage();
+    ASSERT_TRUE(ss->spin_wait_creating(30));
+    ss->initialize_node_state();
+    svc->set_node_state(nodes, true);
+    svc->_started = true;
+
+    auto query = [ss](const dsn::rpc_address& node, int64_t epoch, int64_t version)
+    {
+        configuration_query_by_node_request request;
+        request.node = node;
+        request.config_epoch = epoch;
+        request.config_version = version;
+        configuration_query_by_node_response response;
+        ss->query_configuration_by_node(request, response);
+        EXPECT_EQ(dsn::ERR_OK, response.err);
+        return response;
+    };
+    auto pids = [](const configuration_query_by_node_response& response)
+    {
+        std::set<dsn::gpid> result;
+        for (const configuration_update_request& p: response.partitions)
+            result.insert(p.config.pid);
+        return result;
+    };
+
+    //a node without an epoch gets a full sync
+    configuration_query_by_node_response base = query(nodes[0], 0, 0);
+    ASSERT_FALSE(base.is_incremental);
+    ASSERT_EQ(3u, base.partitions.size());
+    ASSERT_NE(0, base.config_epoch);
+
+    //and nothing once it is up to date
+    configuration_query_by_node_response resp = query(nodes[0], base.config_epoch, base.config_version);
+    ASSERT_TRUE(resp.is_incremental);
+    ASSERT_TRUE(resp.partitions.empty());
+    ASSERT_TRUE(resp.gone_partitions.empty());
+
+    dsn::rpc_address dead = nodes[3];
+    svc->set_node_state({dead}, false);
+    state_validator removed = [dead](const app_mapper& apps)
+    {
+        for (const dsn::partition_configuration& pc: apps.begin()->second->partitions)
+        {
+            if (pc.primary.is_invalid() || pc.primary == dead || is_secondary(pc, dead))
+                return false;
+        }
+        return true;
+    };
+    ASSERT_TRUE(wait_state(ss, removed, 30));
+
+    //partitions 2 and 3 of node 0 lost node 3, while partition 0 is untouched
+    //and partition 1 doesn't concern node 0
+    resp = query(nodes[0], base.config_epoch, base.config_version);
+    ASSERT_TRUE(resp.is_incremental);
+    ASSERT_LT(base.config_version, resp.config_version);
+    ASSERT_EQ(std::set<dsn::gpid>({app->partitions[2].pid, app->partitions[3].pid}), pids(resp));
+    ASSERT_TRUE(resp.gone_partitions.empty());
+    for (const configuration_update_request& p: resp.partitions)
+    {
+        ASSERT_FALSE(is_member(p.config, dead));
+    }
+
+    //the partitions node 3 was removed from are gone for it
+    resp = query(dead, base.config_epoch, base.config_version);
+    ASSERT_TRUE(resp.is_incremental);
+    ASSERT_TRUE(resp.partitions.empty());
+    std::set<dsn::gpid> gone(resp.gone_partitions.begin(), resp.gone_partitions.end());
+    ASSERT_EQ(std::set<dsn::gpid>({app->partitions[1].pid, app->partitions[2].pid, app->partitions[3].pid}), gone);
+
+    //the changed nodes are notified
+    for (int i = 0; i != 30 && !svc->is_notified(nodes[0]); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_TRUE(svc->is_notified(nodes[0]));
+
+    //versions of another epoch are not comparable
+    resp = query(nodes[0], base.config_epoch + 1, base.config_version);
+    ASSERT_FALSE(resp.is_incremental);
+    ASSERT_EQ(3u, resp.partitions.size());
+    ASSERT_TRUE(resp.gone_partitions.empty());
+
+    //nor are the ones older than the change log
+    {
+        zauto_write_lock l(ss->_lock);
+        ASSERT_LT(1u, ss->_config_changes.size());
+        ss->_config_changes.pop_front();
+    }
+    resp = query(nodes[0], base.config_epoch, base.config_version);
+    ASSERT_FALSE(resp.is_incremental);
+    ASSERT_EQ(3u, resp.partitions.size());
+}
+
 static void generate_apps(app_mapper& mapper, const std::vector<dsn::rpc_address>& node_list)
 {
     mapper.clear();
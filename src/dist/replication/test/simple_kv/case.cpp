@@ -143,6 +143,12 @@ std::string set_case_line::to_string() const
         oss << "simple_kv_apply_checkpoint_fail=" << _simple_kv_apply_checkpoint_fail;
         count++;
     }
+    if (_remove_staged_bulk_load_set)
+    {
+        if (count > 0) oss << ",";
+        oss << "remove_staged_bulk_load=" << address_to_node(_remove_staged_bulk_load);
+        count++;
+    }
     return oss.str();
 }
 
@@ -164,6 +170,7 @@ bool set_case_line::parse(const std::string& params)
     _simple_kv_close_fail_set = false;
     _simple_kv_get_checkpoint_fail_set = false;
     _simple_kv_apply_checkpoint_fail_set = false;
+    _remove_staged_bulk_load_set = false;
     for (auto& kv : kv_map)
     {
         const std::string& k = kv.first;
@@ -213,6 +220,17 @@ bool set_case_line::parse(const std::string& params)
             _simple_kv_apply_checkpoint_fail = boost::lexical_cast<bool>(v);
             _simple_kv_apply_checkpoint_fail_set = true;
         }
+        else if (k == "remove_staged_bulk_load")
+        {
+            _remove_staged_bulk_load = node_to_address(v);
+            if (_remove_staged_bulk_load.is_invalid())
+            {
+                std::cerr << "bad line: line_no=" << line_no()
+                          << ": unknown node " << v << std::endl;
+                return false;
+            }
+            _remove_staged_bulk_load_set = true;
+        }
         else
         {
             std::cerr << "bad line: line_no=" << line_no()
@@ -261,6 +279,10 @@ void set_case_line::apply_set() const
     {
         simple_kv_service_impl::s_simple_kv_apply_checkpoint_fail = _simple_kv_apply_checkpoint_fail;
     }
+    if (_remove_staged_bulk_load_set)
+    {
+        test_checker::instance().remove_staged_bulk_load(_remove_staged_bulk_load);
+    }
 }
 
 std::string skip_case_line::to_string() const
@@ -810,6 +832,22 @@ std::string client_case_line::to_string() const
             << ",node=" << address_to_node(_config_node);
         break;
     }
+    case begin_bulk_load:
+    {
+        oss << "id=" << _id
+            << ",receiver=" << address_to_node(_config_receiver)
+            << ",key=" << _key
+            << ",value=" << _value
+            << ",timeout=" << _timeout;
+        break;
+    }
+    case end_bulk_load:
+    {
+        oss << "id=" << _id
+            << ",err=" << _err.to_string()
+            << ",resp=" << _bulk_load_resp;
+        break;
+    }
     default:
         dassert(false, "");
     }
@@ -881,6 +919,26 @@ bool client_case_line::parse(const std::string& params)
             parse_ok = false;
         break;
     }
+    case begin_bulk_load:
+    {
+        _id = boost::lexical_cast<int>(kv_map["id"]);
+        _config_receiver = node_to_address(kv_map["receiver"]);
+        _key = kv_map["key"];
+        _value = kv_map["value"];
+        _timeout = boost::lexical_cast<int>(kv_map["timeout"]);
+        if (_config_receiver.is_invalid())
+            parse_ok = false;
+        break;
+    }
+    case end_bulk_load:
+    {
+        _id = boost::lexical_cast<int>(kv_map["id"]);
+        _err = dsn_error_from_string(boost::algorithm::to_upper_copy(kv_map["err"]).c_str(), ERR_UNKNOWN);
+        _bulk_load_resp = boost::lexical_cast<int64_t>(kv_map["resp"]);
+        if (_err == ERR_UNKNOWN)
+            parse_ok = false;
+        break;
+    }
     default:
         dassert(false, "");
     }
@@ -907,6 +965,10 @@ std::string client_case_line::type_name() const
         return "end_read";
     case replica_config:
         return "replica_config";
+    case begin_bulk_load:
+        return "begin_bulk_load";
+    case end_bulk_load:
+        return "end_bulk_load";
     default:
         dassert(false, "");
     }
@@ -925,6 +987,10 @@ bool client_case_line::parse_type_name(const std::string& name)
         _type = end_read;
     else if (name == "replica_config")
         _type = replica_config;
+    else if (name == "begin_bulk_load")
+        _type = begin_bulk_load;
+    else if (name == "end_bulk_load")
+        _type = end_bulk_load;
     else
         return false;
     return true;
@@ -977,6 +1043,16 @@ void client_case_line::get_replica_config_params(rpc_address& receiver, dsn::rep
     node = _config_node;
 }
 
+void client_case_line::get_bulk_load_params(int& id, rpc_address& receiver, std::string& key, std::string& value, int& timeout_ms) const
+{
+    dassert(_type == begin_bulk_load, "");
+    id = _id;
+    receiver = _config_receiver;
+    key = _key;
+    value = _value;
+    timeout_ms = _timeout;
+}
+
 bool client_case_line::check_write_result(int id, ::dsn::error_code err, int32_t resp)
 {
     return id == _id && err == _err && (err != dsn::ERR_OK || resp == _write_resp);
@@ -987,6 +1063,11 @@ bool client_case_line::check_read_result(int id, ::dsn::error_code err, const st
     return id == _id && err == _err && (err != dsn::ERR_OK || resp == _read_resp);
 }
 
+bool client_case_line::check_bulk_load_result(int id, ::dsn::error_code err, int64_t decree)
+{
+    return id == _id && err == _err && (err != dsn::ERR_OK || decree == _bulk_load_resp);
+}
+
 bool test_case::s_inited = false;
 int test_case::s_null_loop = 10000;
 bool test_case::s_close_replica_stub_on_exit = false;
@@ -1273,6 +1354,16 @@ bool test_case::check_client_read(int& id, std::string& key, int& timeout_ms)
     return true;
 }
 
+bool test_case::check_bulk_load(int& id, rpc_address& receiver, std::string& key, std::string& value, int& timeout_ms)
+{
+    if ( !check_client_instruction(client_case_line::begin_bulk_load) )
+        return false;
+    client_case_line* cl = static_cast<client_case_line*>(_case_lines[_next]);
+    cl->get_bulk_load_params(id, receiver, key, value, timeout_ms);
+    forward();
+    return true;
+}
+
 void test_case::on_end_write(int id, ::dsn::error_code err, int32_t resp)
 {
     if (g_done) return;
@@ -1353,6 +1444,46 @@ void test_case::on_end_read(int id, ::dsn::error_code err, const std::string& re
     forward();
 }
 
+void test_case::on_end_bulk_load(int id, ::dsn::error_code err, int64_t decree)
+{
+    if (g_done) return;
+
+    char buf[1024];
+    snprintf_p(buf, 1024, "%s:end_bulk_load:id=%d,err=%s,resp=%" PRId64,
+             client_case_line::NAME(), id, err.to_string(), decree);
+
+    ddebug("=== on_end_bulk_load:id=%d,err=%s,resp=%" PRId64, id, err.to_string(), decree);
+
+    if (check_skip(true))
+    {
+        output(buf);
+        print(nullptr, buf, true);
+        return;
+    }
+
+    case_line* c = _case_lines[_next];
+    if (c->name() != client_case_line::NAME())
+    {
+        output(buf);
+        print(nullptr, buf, true);
+        return;
+    }
+    client_case_line* cl = static_cast<client_case_line*>(c);
+    if (cl->type() != client_case_line::end_bulk_load)
+    {
+        output(buf);
+        print(nullptr, buf, true);
+        return;
+    }
+    if (!cl->check_bulk_load_result(id, err, decree))
+    {
+        output(buf);
+        print(nullptr, buf, true);
+        return;
+    }
+    forward();
+}
+
 bool test_case::on_event(const event* ev)
 {
     if (g_done) return true;
@@ -97,6 +97,8 @@ private:
     bool _simple_kv_get_checkpoint_fail_set;
     bool _simple_kv_apply_checkpoint_fail;
     bool _simple_kv_apply_checkpoint_fail_set;
+    rpc_address _remove_staged_bulk_load;
+    bool _remove_staged_bulk_load_set;
 };
 
 // SKIP:100
@@ -364,6 +366,8 @@ public:
         end_write,        // id=xxx,err=xxx,resp=xxx
         end_read,         // id=xxx,err=xxx,resp=xxx
         replica_config,   // receiver=xxx,type=xxx,node=xxx
+        begin_bulk_load,  // id=xxx,receiver=xxx,key=xxx,value=xxx,timeout=xxx
+        end_bulk_load,    // id=xxx,err=xxx,resp=xxx (the decree loaded at)
     };
 
 public:
@@ -378,8 +382,10 @@ public:
     void get_write_params(int& id, std::string& key, std::string& value, int& timeout_ms) const;
     void get_read_params(int& id, std::string& key, int& timeout_ms) const;
     void get_replica_config_params(rpc_address& receiver, dsn::replication::config_type::type& type, rpc_address& node) const;
+    void get_bulk_load_params(int& id, rpc_address& receiver, std::string& key, std::string& value, int& timeout_ms) const;
     bool check_write_result(int id, ::dsn::error_code err, int32_t resp);
     bool check_read_result(int id, ::dsn::error_code err, const std::string& resp);
+    bool check_bulk_load_result(int id, ::dsn::error_code err, int64_t decree);
 
     dsn::replication::config_type::type parse_config_command(const std::string& command_str) const;
     std::string config_command_to_string(dsn::replication::config_type::type cfg_command) const;
@@ -392,6 +398,7 @@ private:
     dsn::error_code _err;
     int _write_resp;
     std::string _read_resp;
+    int64_t _bulk_load_resp;
 
     rpc_address _config_receiver;
     dsn::replication::config_type::type _config_type;
@@ -424,8 +431,10 @@ public:
     bool check_client_write(int& id, std::string& key, std::string& value, int& timeout_ms);
     bool check_replica_config(rpc_address& receiver, dsn::replication::config_type::type& type, rpc_address& node);
     bool check_client_read(int& id, std::string& key, int& timeout_ms);
+    bool check_bulk_load(int& id, rpc_address& receiver, std::string& key, std::string& value, int& timeout_ms);
     void on_end_write(int id, ::dsn::error_code err, int32_t resp);
     void on_end_read(int id, ::dsn::error_code err, const std::string& resp);
+    void on_end_bulk_load(int id, ::dsn::error_code err, int64_t decree);
 
     // checker
     void on_check();
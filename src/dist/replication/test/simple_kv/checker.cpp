@@ -308,6 +308,30 @@ void test_checker::get_current_states(state_snapshot& states)
     }
 }
 
+void test_checker::remove_staged_bulk_load(rpc_address node)
+{
+    std::string name = address_to_node_name(node);
+    for (auto& app : _replica_servers)
+    {
+        if (!app->is_started() || name != app->name())
+            continue;
+
+        for (auto& kv : app->_stub->_replicas)
+        {
+            std::vector<std::string> sub_dirs;
+            utils::filesystem::get_subdirectories(kv.second->dir(), sub_dirs, false);
+            for (auto& d : sub_dirs)
+            {
+                if (utils::filesystem::get_file_name(d).substr(0, strlen("bulk_load.")) == "bulk_load.")
+                {
+                    ddebug("=== remove staged bulk load %s", d.c_str());
+                    utils::filesystem::remove_path(d);
+                }
+            }
+        }
+    }
+}
+
 bool test_checker::get_current_config(parti_config& config)
 {
     meta_service_app* meta = meta_leader();
@@ -77,6 +77,9 @@ public:
 
     void get_current_states(state_snapshot& states);
     bool get_current_config(parti_config& config);
+
+    // as if the staged files of the bulk loads on the node were lost
+    void remove_staged_bulk_load(rpc_address node);
 private:
     std::vector<dsn_app_info>             _apps;
     std::vector<meta_service_app*>        _meta_servers;
@@ -1,4 +1,4 @@
 #!/bin/bash
 
-rm -rf data core*
+rm -rf data core* bulk_load.source
 
@@ -38,6 +38,7 @@
 # include <dsn/dist/replication/replication_other_types.h>
 
 # include <sstream>
+# include <fstream>
 
 # ifdef __TITLE__
 # undef __TITLE__
@@ -116,6 +117,11 @@ void simple_kv_client_app::run()
             begin_read(id, key, timeout_ms);
             continue;
         }
+        if (test_case::fast_instance().check_bulk_load(id, receiver, key, value, timeout_ms))
+        {
+            begin_bulk_load(id, receiver, key, value, timeout_ms);
+            continue;
+        }
         test_case::fast_instance().wait_check_client();
     }
 }
@@ -185,5 +191,53 @@ void simple_kv_client_app::begin_read(int id, const std::string& key, int timeou
 }
 
 
+// the loaded file is a checkpoint of simple_kv_service_impl holding the only pair,
+// which the receiver serves from its own file system as the source
+void simple_kv_client_app::begin_bulk_load(int id, const rpc_address& receiver, const std::string& key, const std::string& value, int timeout_ms)
+{
+    ddebug("=== on_begin_bulk_load:id=%d,receiver=%s,key=%s,value=%s,timeout=%d",
+        id, receiver.to_string(), key.c_str(), value.c_str(), timeout_ms);
+
+    std::string source_dir = "./bulk_load.source";
+    if (!dsn::utils::filesystem::path_exists(source_dir))
+        dsn::utils::filesystem::create_directory(source_dir);
+    {
+        std::ofstream os(dsn::utils::filesystem::path_combine(source_dir, "checkpoint").c_str(), std::ios::binary | std::ios::trunc);
+        uint64_t count = 1;
+        int magic = 0xdeadbeef;
+        os.write((const char*)&count, (uint32_t)sizeof(count));
+        os.write((const char*)&magic, (uint32_t)sizeof(magic));
+        for (const std::string* s : {&key, &value})
+        {
+            uint32_t sz = (uint32_t)s->length();
+            os.write((const char*)&sz, (uint32_t)sizeof(sz));
+            os.write(s->c_str(), sz);
+        }
+    }
+
+    bulk_load_request req;
+    req.pid = g_default_gpid;
+    req.source = receiver;
+    req.source_dir = source_dir;
+    req.files.push_back("checkpoint");
+    req.ballot = 0;
+    req.signature = 0;
+    rpc::call(
+        receiver,
+        RPC_BULK_LOAD,
+        req,
+        this,
+        [id](error_code err, bulk_load_response&& resp)
+        {
+            if (err == ERR_OK)
+                test_case::fast_instance().on_end_bulk_load(id, resp.err, resp.decree);
+            else
+                test_case::fast_instance().on_end_bulk_load(id, err, invalid_decree);
+        },
+        gpid_to_hash(g_default_gpid),
+        std::chrono::milliseconds(timeout_ms)
+        );
+}
+
 }}}
 
@@ -1,4 +1,4 @@
 #!/bin/bash
 
-rm -rf client core* log.* *.log data
+rm -rf client core* log.* *.log data meta_state_service_compaction meta_state_service_truncated
 
@@ -133,6 +133,14 @@ public:
         zauto_lock l(failure_detector::_lock);
         register_worker(node);
     }
+    void test_set_intervals(uint32_t check_ms, uint32_t beacon_ms, uint32_t lease_ms, uint32_t grace_ms)
+    {
+        set_intervals_ms(check_ms, beacon_ms, lease_ms, grace_ms);
+    }
+    bool test_is_worker_expired(uint64_t elapsed_ms, const phi_accrual_window& intervals) const
+    {
+        return is_worker_expired(elapsed_ms, intervals);
+    }
     void clear()
     {
         _connected_cb = {};
@@ -561,3 +569,84 @@ TEST(fd, worker_died_when_switch_master)
     worker->fd()->toggle_send_ping(false);
     ASSERT_TRUE( spin_wait_condition( [&wait_count]{ return wait_count==0; }, 20 ) );
 }
+
+TEST(fd, phi_accrual_window)
+{
+    phi_accrual_window regular, jittery;
+    ASSERT_EQ(0, regular.phi(1000, 50));
+
+    for (int i = 0; i < 20; i++)
+    {
+        regular.add(i % 2 ? 95 : 105);
+        jittery.add(i % 2 ? 20 : 180);
+    }
+    ASSERT_EQ(20, regular.count());
+
+    // on time is not suspected, a long silence is
+    ASSERT_LT(regular.phi(100, 25), 1.0);
+    ASSERT_GT(regular.phi(1000, 25), 8.0);
+
+    // the same silence is less suspicious when the intervals vary more
+    ASSERT_LT(jittery.phi(300, 25), regular.phi(300, 25));
+
+    // and the minimum deviation keeps regular beacons from being suspected on a small delay
+    ASSERT_LT(regular.phi(150, 100), regular.phi(150, 5));
+
+    // only the recent intervals count
+    for (int i = 0; i < 2 * phi_accrual_window::max_samples; i++)
+    {
+        jittery.add(100);
+    }
+    ASSERT_EQ(phi_accrual_window::max_samples, jittery.count());
+    ASSERT_NEAR(regular.phi(200, 25), jittery.phi(200, 25), 0.01);
+
+    jittery.clear();
+    ASSERT_EQ(0, jittery.count());
+}
+
+TEST(fd, is_worker_expired)
+{
+    phi_accrual_window regular;
+    for (int i = 0; i < 20; i++)
+    {
+        regular.add(i % 2 ? 95 : 105);
+    }
+
+    // check 100 ms, beacon 100 ms, lease 1 s, grace 5 s
+    master_fd_test fd;
+    fd.test_set_intervals(100, 100, 1000, 5000);
+
+    // without phi, only the grace counts
+    ASSERT_FALSE(fd.test_is_worker_expired(4000, regular));
+    ASSERT_FALSE(fd.test_is_worker_expired(5000, regular));
+    ASSERT_TRUE(fd.test_is_worker_expired(5001, regular));
+
+    // phi never declares a worker dead within lease + check + max(check, margin),
+    // however high it is
+    fd.set_phi_threshold(8, 2000);
+    ASSERT_GT(regular.phi(2000, 25), 8.0);
+    ASSERT_FALSE(fd.test_is_worker_expired(1200, regular));
+    ASSERT_FALSE(fd.test_is_worker_expired(3100, regular));
+    ASSERT_TRUE(fd.test_is_worker_expired(3101, regular));
+    ASSERT_TRUE(fd.test_is_worker_expired(5001, regular));
+
+    // the margin is at least one check interval
+    fd.set_phi_threshold(8, 0);
+    ASSERT_FALSE(fd.test_is_worker_expired(1200, regular));
+    ASSERT_TRUE(fd.test_is_worker_expired(1201, regular));
+
+    // too few samples, or beacons that are late as usual, wait for the grace
+    phi_accrual_window few, slow;
+    for (int i = 0; i < phi_accrual_window::min_samples - 1; i++)
+    {
+        few.add(100);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        slow.add(i % 2 ? 500 : 3500);
+    }
+    fd.set_phi_threshold(8, 2000);
+    ASSERT_FALSE(fd.test_is_worker_expired(4000, few));
+    ASSERT_FALSE(fd.test_is_worker_expired(4000, slow));
+    ASSERT_TRUE(fd.test_is_worker_expired(5001, slow));
+}